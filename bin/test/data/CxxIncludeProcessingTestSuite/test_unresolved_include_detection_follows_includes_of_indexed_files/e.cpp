@@ -0,0 +1,2 @@
+#include "include/b.h"
+#include "missing_a.h"
@@ -0,0 +1 @@
+#include "missing_d.h"
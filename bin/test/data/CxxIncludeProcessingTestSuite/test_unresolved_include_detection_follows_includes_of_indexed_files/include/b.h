@@ -0,0 +1,3 @@
+#include "c.h"
+#include <missing_b.h>
+#include "../external/d.h"
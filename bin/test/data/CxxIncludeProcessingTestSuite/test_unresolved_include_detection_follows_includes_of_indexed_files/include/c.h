@@ -0,0 +1,2 @@
+#include "b.h"
+#include "missing_c.h"
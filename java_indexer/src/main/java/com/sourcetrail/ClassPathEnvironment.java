@@ -0,0 +1,222 @@
+package com.sourcetrail;
+
+import java.io.File;
+import java.io.FileOutputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.io.OutputStream;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.StandardCopyOption;
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.HashSet;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+import java.util.jar.JarFile;
+import java.util.zip.ZipEntry;
+
+// The jars and source directories passed to the JDT parser for a given classpath string. An
+// environment is built once per classpath and shared by all files indexed with it until the caches
+// are cleared. While building, the classes.jar files of aar entries are extracted, entries that do
+// not exist or do not contain any class files are dropped and jars with identical content are only
+// added once. If a cache directory is set, extracted aar files and the jar index are kept there and
+// reused by the next run.
+public class ClassPathEnvironment
+{
+	private static Map<String, ClassPathEnvironment> s_environments = new HashMap<>();
+	private static File s_cacheDirectory = null;
+	private static JarIndex s_jarIndex = null;
+
+	private final String[] m_classPath;
+	private final String[] m_sourcePath;
+
+	public static synchronized void setCacheDirectory(String cacheDirectoryPath)
+	{
+		File cacheDirectory = cacheDirectoryPath.isEmpty() ? null : new File(cacheDirectoryPath);
+		if ((cacheDirectory == null && s_cacheDirectory == null) ||
+			(cacheDirectory != null && cacheDirectory.equals(s_cacheDirectory)))
+		{
+			return;
+		}
+
+		s_cacheDirectory = cacheDirectory;
+		s_jarIndex = null;
+		s_environments.clear();
+	}
+
+	public static synchronized ClassPathEnvironment get(
+		String classPath, AstVisitorClient astVisitorClient)
+	{
+		ClassPathEnvironment environment = s_environments.get(classPath);
+		if (environment == null)
+		{
+			if (s_jarIndex == null)
+			{
+				s_jarIndex = new JarIndex(s_cacheDirectory);
+			}
+
+			environment = new ClassPathEnvironment(classPath, astVisitorClient);
+			s_environments.put(classPath, environment);
+
+			s_jarIndex.save();
+		}
+		return environment;
+	}
+
+	public static synchronized void clear()
+	{
+		s_environments.clear();
+		s_jarIndex = null;
+	}
+
+	public String[] getClassPath()
+	{
+		return m_classPath;
+	}
+
+	public String[] getSourcePath()
+	{
+		return m_sourcePath;
+	}
+
+	private ClassPathEnvironment(String classPath, AstVisitorClient astVisitorClient)
+	{
+		List<String> classpath = new ArrayList<>();
+		List<String> sources = new ArrayList<>();
+		Set<String> contentHashes = new HashSet<>();
+		int droppedEntryCount = 0;
+
+		// the separator used here should be the same as the one used in JavaParser.cpp
+		for (String classPathEntry: classPath.split("\\;"))
+		{
+			if (classPathEntry.isEmpty())
+			{
+				continue;
+			}
+
+			if (!classPathEntry.endsWith(".jar") && !classPathEntry.endsWith(".aar"))
+			{
+				sources.add(classPathEntry);
+				continue;
+			}
+
+			File file = new File(classPathEntry);
+			if (!file.isFile())
+			{
+				droppedEntryCount++;
+				continue;
+			}
+
+			try
+			{
+				JarIndex.Entry entry = s_jarIndex.getEntry(file);
+				if (entry.classFileCount == 0 || !contentHashes.add(entry.contentHash))
+				{
+					droppedEntryCount++;
+					continue;
+				}
+
+				if (classPathEntry.endsWith(".aar"))
+				{
+					File extractedJarFile = extractClassesJarFileFromAarFile(
+						file.toPath(), entry.contentHash, astVisitorClient);
+					if (extractedJarFile != null)
+					{
+						classpath.add(extractedJarFile.getAbsolutePath());
+					}
+				}
+				else
+				{
+					classpath.add(classPathEntry);
+				}
+			}
+			catch (IOException e)
+			{
+				astVisitorClient.logWarning(
+					"Unable to read classpath entry \"" + classPathEntry + "\": " + e.getMessage());
+				classpath.add(classPathEntry);
+			}
+		}
+
+		m_classPath = classpath.toArray(new String[0]);
+		m_sourcePath = sources.toArray(new String[0]);
+
+		astVisitorClient.logInfo(
+			"prepared classpath with " + m_classPath.length + " jars and " + m_sourcePath.length +
+			" source directories, dropped " + droppedEntryCount +
+			" missing, duplicate or empty entries");
+	}
+
+	private static File extractClassesJarFileFromAarFile(
+		Path aarFilePath, String contentHash, AstVisitorClient astVisitorClient) throws IOException
+	{
+		File cachedFile = null;
+		if (s_cacheDirectory != null)
+		{
+			cachedFile = new File(new File(s_cacheDirectory, "aar"), contentHash + ".jar");
+			if (cachedFile.isFile())
+			{
+				return cachedFile;
+			}
+		}
+
+		try (JarFile jarFile = new JarFile(aarFilePath.toString()))
+		{
+			ZipEntry classesJarEntry = jarFile.getEntry("classes.jar");
+			if (classesJarEntry == null)
+			{
+				astVisitorClient.logError(
+					"Classpath entry \"" + aarFilePath +
+					"\" is malformed. No internal \"classes.jar\" entry could be found.");
+				return null;
+			}
+
+			String tempFilePrefix = "jar_file_from_" +
+				Utility.getFilenameWithoutExtension(aarFilePath) + "_";
+			File tempFile;
+			if (cachedFile != null)
+			{
+				// extract next to the cached file, so it can be moved there atomically
+				cachedFile.getParentFile().mkdirs();
+				tempFile = File.createTempFile(tempFilePrefix, ".tmp", cachedFile.getParentFile());
+			}
+			else
+			{
+				tempFile = File.createTempFile(tempFilePrefix, ".jar");
+			}
+			tempFile.deleteOnExit();
+
+			try (InputStream inputStream = jarFile.getInputStream(classesJarEntry);
+				 OutputStream output = new FileOutputStream(tempFile))
+			{
+				byte[] buffer = new byte[8 * 1024];
+				int bytesRead;
+				while ((bytesRead = inputStream.read(buffer)) != -1)
+				{
+					output.write(buffer, 0, bytesRead);
+				}
+			}
+
+			if (cachedFile != null)
+			{
+				Files.move(
+					tempFile.toPath(), cachedFile.toPath(), StandardCopyOption.REPLACE_EXISTING);
+
+				astVisitorClient.logInfo(
+					"Extracted classes.jar file from \"" + aarFilePath.toString() + "\" to \"" +
+					cachedFile.getAbsolutePath() + "\".");
+
+				return cachedFile;
+			}
+
+			astVisitorClient.logInfo(
+				"Extracted classes.jar file from \"" + aarFilePath.toString() + "\" to \"" +
+				tempFile.getAbsolutePath() + "\". "
+				+ "This file will be automatically deleted when the session ends.");
+
+			return tempFile;
+		}
+	}
+}
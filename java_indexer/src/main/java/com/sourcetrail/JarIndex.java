@@ -0,0 +1,202 @@
+package com.sourcetrail;
+
+import java.io.BufferedReader;
+import java.io.BufferedWriter;
+import java.io.File;
+import java.io.FileInputStream;
+import java.io.IOException;
+import java.io.InputStream;
+import java.nio.charset.StandardCharsets;
+import java.nio.file.Files;
+import java.nio.file.StandardCopyOption;
+import java.security.MessageDigest;
+import java.security.NoSuchAlgorithmException;
+import java.util.Enumeration;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.zip.ZipEntry;
+import java.util.zip.ZipFile;
+
+// Keeps the content hash and the number of class files of each jar and aar file on the classpath.
+// The index is stored in the cache directory and entries are reused across runs as long as size
+// and modification time of the file did not change, so the content only needs to be hashed once.
+public class JarIndex
+{
+	public static class Entry
+	{
+		public long size;
+		public long lastModified;
+		public String contentHash;
+		public int classFileCount;
+	}
+
+	private static final String INDEX_FILE_NAME = "jar_index.txt";
+	private static final int INDEX_VERSION = 1;
+
+	private File m_indexFile;
+	private Map<String, Entry> m_entries = new HashMap<>();
+	private boolean m_modified = false;
+
+	public JarIndex(File cacheDirectory)
+	{
+		if (cacheDirectory != null)
+		{
+			m_indexFile = new File(cacheDirectory, INDEX_FILE_NAME);
+			load();
+		}
+	}
+
+	public Entry getEntry(File file) throws IOException
+	{
+		String path = file.getAbsolutePath();
+		long size = file.length();
+		long lastModified = file.lastModified();
+
+		Entry entry = m_entries.get(path);
+		if (entry != null && entry.size == size && entry.lastModified == lastModified)
+		{
+			return entry;
+		}
+
+		entry = new Entry();
+		entry.size = size;
+		entry.lastModified = lastModified;
+		entry.contentHash = computeContentHash(file);
+		entry.classFileCount = countClassFiles(file);
+
+		m_entries.put(path, entry);
+		m_modified = true;
+		return entry;
+	}
+
+	public void save()
+	{
+		if (m_indexFile == null || !m_modified)
+		{
+			return;
+		}
+
+		File tempFile = null;
+		try
+		{
+			// concurrent indexer processes write their own temporary file and replace the index
+			// atomically, so a reader never sees a partially written index
+			m_indexFile.getParentFile().mkdirs();
+			tempFile = File.createTempFile(INDEX_FILE_NAME, ".tmp", m_indexFile.getParentFile());
+			try (BufferedWriter writer = Files.newBufferedWriter(
+					 tempFile.toPath(), StandardCharsets.UTF_8))
+			{
+				writer.write(Integer.toString(INDEX_VERSION));
+				writer.newLine();
+				for (Map.Entry<String, Entry> mapEntry: m_entries.entrySet())
+				{
+					Entry entry = mapEntry.getValue();
+					writer.write(
+						entry.size + "\t" + entry.lastModified + "\t" + entry.contentHash + "\t" +
+						entry.classFileCount + "\t" + mapEntry.getKey());
+					writer.newLine();
+				}
+			}
+			Files.move(tempFile.toPath(), m_indexFile.toPath(), StandardCopyOption.ATOMIC_MOVE);
+			m_modified = false;
+		}
+		catch (IOException e)
+		{
+			// the index is only a cache, it will be rebuilt on the next run
+		}
+		finally
+		{
+			if (tempFile != null && tempFile.exists())
+			{
+				tempFile.delete();
+			}
+		}
+	}
+
+	public static String computeContentHash(File file) throws IOException
+	{
+		MessageDigest digest;
+		try
+		{
+			digest = MessageDigest.getInstance("SHA-1");
+		}
+		catch (NoSuchAlgorithmException e)
+		{
+			throw new IOException(e);
+		}
+
+		byte[] buffer = new byte[64 * 1024];
+		try (InputStream inputStream = new FileInputStream(file))
+		{
+			int bytesRead;
+			while ((bytesRead = inputStream.read(buffer)) != -1)
+			{
+				digest.update(buffer, 0, bytesRead);
+			}
+		}
+
+		StringBuilder hash = new StringBuilder();
+		for (byte b: digest.digest())
+		{
+			hash.append(String.format("%02x", b));
+		}
+		return hash.toString();
+	}
+
+	private static int countClassFiles(File file) throws IOException
+	{
+		int classFileCount = 0;
+		try (ZipFile zipFile = new ZipFile(file))
+		{
+			Enumeration<? extends ZipEntry> zipEntries = zipFile.entries();
+			while (zipEntries.hasMoreElements())
+			{
+				ZipEntry zipEntry = zipEntries.nextElement();
+				if (zipEntry.getName().endsWith(".class") ||
+					zipEntry.getName().equals("classes.jar"))
+				{
+					classFileCount++;
+				}
+			}
+		}
+		return classFileCount;
+	}
+
+	private void load()
+	{
+		if (!m_indexFile.exists())
+		{
+			return;
+		}
+
+		try (BufferedReader reader = Files.newBufferedReader(
+				 m_indexFile.toPath(), StandardCharsets.UTF_8))
+		{
+			String line = reader.readLine();
+			if (line == null || !line.equals(Integer.toString(INDEX_VERSION)))
+			{
+				return;
+			}
+
+			while ((line = reader.readLine()) != null)
+			{
+				String[] fields = line.split("\t", 5);
+				if (fields.length != 5)
+				{
+					continue;
+				}
+
+				Entry entry = new Entry();
+				entry.size = Long.parseLong(fields[0]);
+				entry.lastModified = Long.parseLong(fields[1]);
+				entry.contentHash = fields[2];
+				entry.classFileCount = Integer.parseInt(fields[3]);
+				m_entries.put(fields[4], entry);
+			}
+		}
+		catch (IOException | NumberFormatException e)
+		{
+			m_entries.clear();
+		}
+	}
+}
@@ -1,19 +1,11 @@
 package com.sourcetrail;
 
-import java.io.File;
-import java.io.FileOutputStream;
-import java.io.IOException;
-import java.io.InputStream;
-import java.io.OutputStream;
 import java.io.PrintWriter;
 import java.io.StringWriter;
+import java.nio.ByteBuffer;
 import java.nio.file.Path;
 import java.nio.file.Paths;
-import java.util.ArrayList;
 import java.util.Hashtable;
-import java.util.List;
-import java.util.jar.JarFile;
-import java.util.zip.ZipEntry;
 import org.eclipse.jdt.core.JavaCore;
 import org.eclipse.jdt.core.compiler.IProblem;
 import org.eclipse.jdt.core.dom.AST;
@@ -33,15 +25,15 @@ public class JavaIndexer
 		String fileContent,
 		String languageStandard,
 		String classPath,
-		int verbose)
+		int verbose,
+		int batchRecords)
 	{
-		processFile(
-			new JavaIndexerAstVisitorClient(address),
-			filePath,
-			fileContent,
-			languageStandard,
-			classPath,
-			verbose);
+		JavaIndexerAstVisitorClient astVisitorClient = new JavaIndexerAstVisitorClient(
+			address, batchRecords != 0);
+
+		processFile(astVisitorClient, filePath, fileContent, languageStandard, classPath, verbose);
+
+		astVisitorClient.flush();
 	}
 
 	public static void processFile(
@@ -83,32 +75,10 @@ public class JavaIndexer
 
 			parser.setUnitName(path.getFileName().toString());
 
-			List<String> classpath = new ArrayList<>();
-			List<String> sources = new ArrayList<>();
-
-			for (String classPathEntry: classPath.split("\\;"))
-			{
-				if (classPathEntry.endsWith(".jar"))
-				{
-					classpath.add(classPathEntry);
-				}
-				else if (classPathEntry.endsWith(".aar"))
-				{
-					File extractedJarFile = extractClassesJarFileFromAarFile(
-						Paths.get(classPathEntry), astVisitorClient);
-					if (extractedJarFile != null)
-					{
-						classpath.add(extractedJarFile.getAbsolutePath());
-					}
-				}
-				else if (!classPathEntry.isEmpty())
-				{
-					sources.add(classPathEntry);
-				}
-			}
-
+			ClassPathEnvironment classPathEnvironment = ClassPathEnvironment.get(
+				classPath, astVisitorClient);
 			parser.setEnvironment(
-				classpath.toArray(new String[0]), sources.toArray(new String[0]), null, true);
+				classPathEnvironment.getClassPath(), classPathEnvironment.getSourcePath(), null, true);
 			parser.setSource(fileContent.toCharArray());
 
 			CompilationUnit cu = (CompilationUnit)parser.createAST(null);
@@ -177,8 +147,15 @@ public class JavaIndexer
 		return packageName;
 	}
 
+	public static void setCacheDirectory(String cacheDirectoryPath)
+	{
+		ClassPathEnvironment.setCacheDirectory(cacheDirectoryPath);
+	}
+
 	public static void clearCaches()
 	{
+		ParallelJavaIndexer.shutdown();
+		ClassPathEnvironment.clear();
 		Runtime.getRuntime().gc();
 	}
 
@@ -214,59 +191,6 @@ public class JavaIndexer
 		}
 	}
 
-	private static File extractClassesJarFileFromAarFile(
-		Path aarFilePath, AstVisitorClient astVisitorClient) throws IOException
-	{
-		JarFile jarFile = new JarFile(aarFilePath.toString());
-		ZipEntry classesJarEntry = jarFile.getEntry("classes.jar");
-		if (classesJarEntry != null)
-		{
-			InputStream inputStream = jarFile.getInputStream(classesJarEntry);
-			File tempFile = File.createTempFile(
-				"jar_file_from_" + Utility.getFilenameWithoutExtension(aarFilePath) + "_", ".jar");
-			tempFile.deleteOnExit();
-
-			byte[] buffer = new byte[8 * 1024];
-
-			try
-			{
-				OutputStream output = new FileOutputStream(tempFile);
-				try
-				{
-					int bytesRead;
-					while ((bytesRead = inputStream.read(buffer)) != -1)
-					{
-						output.write(buffer, 0, bytesRead);
-					}
-				}
-				finally
-				{
-					output.close();
-				}
-			}
-			finally
-			{
-				inputStream.close();
-			}
-
-			astVisitorClient.logInfo(
-				"Extracted classes.jar file from \"" + aarFilePath.toString() + "\" to \"" +
-				tempFile.getAbsolutePath() + "\". "
-				+ "This file will be automatically deleted when the session ends.");
-
-			return tempFile;
-		}
-		else
-		{
-			astVisitorClient.logError(
-				"Classpath entry \"" + aarFilePath +
-				"\" is malformed. No internal \"classes.jar\" entry could be found.");
-		}
-		jarFile.close();
-
-		return null;
-	}
-
 	// the following methods are defined in the native c++ code
 
 	static public native boolean getInterrupted(int address);
@@ -277,6 +201,8 @@ public class JavaIndexer
 
 	static public native void logError(int address, String error);
 
+	static public native void recordBatch(int address, ByteBuffer buffer, int size);
+
 	static public native void recordSymbol(
 		int address, String symbolName, int symbolType, int access, int definitionKind);
 
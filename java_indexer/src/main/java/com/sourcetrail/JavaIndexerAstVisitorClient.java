@@ -2,16 +2,40 @@ package com.sourcetrail;
 
 import com.sourcetrail.name.NameElement;
 import com.sourcetrail.name.NameHierarchy;
+import java.util.concurrent.Executor;
+import java.util.concurrent.atomic.AtomicBoolean;
 
 public class JavaIndexerAstVisitorClient extends AstVisitorClient
 {
 	private int m_address;
 	private String m_javaLangPackageName;
 	private boolean m_javaLangPackageRecorded;
+	private JavaIndexerRecordBuffer m_recordBuffer;
+	private Executor m_nativeCalls;
+	private AtomicBoolean m_interrupted;
 
-	public JavaIndexerAstVisitorClient(int address)
+	public JavaIndexerAstVisitorClient(int address, boolean batchRecords)
+	{
+		this(address, batchRecords ? new JavaIndexerRecordBuffer(address) : null, null, null);
+	}
+
+	// used on worker threads, all native calls are passed to the executor and records are always
+	// sent in batches. The interrupted flag is updated by the thread that runs the native calls.
+	public JavaIndexerAstVisitorClient(int address, Executor nativeCalls, AtomicBoolean interrupted)
+	{
+		this(address, new JavaIndexerRecordBuffer(address, nativeCalls), nativeCalls, interrupted);
+	}
+
+	private JavaIndexerAstVisitorClient(
+		int address,
+		JavaIndexerRecordBuffer recordBuffer,
+		Executor nativeCalls,
+		AtomicBoolean interrupted)
 	{
 		m_address = address;
+		m_recordBuffer = recordBuffer;
+		m_nativeCalls = nativeCalls;
+		m_interrupted = interrupted;
 
 		NameHierarchy javaLangPackageNameHierarchy = new NameHierarchy();
 		javaLangPackageNameHierarchy.push(new NameElement("java"));
@@ -20,23 +44,50 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 		m_javaLangPackageRecorded = false;
 	}
 
+	public void flush()
+	{
+		if (m_recordBuffer != null)
+		{
+			m_recordBuffer.flush();
+		}
+	}
+
 	@Override public boolean getInterrupted()
 	{
+		if (m_interrupted != null)
+		{
+			return m_interrupted.get();
+		}
 		return JavaIndexer.getInterrupted(m_address);
 	}
 
 	@Override public void logInfo(String info)
 	{
+		if (m_nativeCalls != null)
+		{
+			m_nativeCalls.execute(() -> JavaIndexer.logInfo(m_address, info));
+			return;
+		}
 		JavaIndexer.logInfo(m_address, info);
 	}
 
 	@Override public void logWarning(String warning)
 	{
+		if (m_nativeCalls != null)
+		{
+			m_nativeCalls.execute(() -> JavaIndexer.logWarning(m_address, warning));
+			return;
+		}
 		JavaIndexer.logWarning(m_address, warning);
 	}
 
 	@Override public void logError(String error)
 	{
+		if (m_nativeCalls != null)
+		{
+			m_nativeCalls.execute(() -> JavaIndexer.logError(m_address, error));
+			return;
+		}
 		JavaIndexer.logError(m_address, error);
 	}
 
@@ -44,6 +95,16 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 	public void recordSymbol(
 		NameHierarchy symbolName, SymbolKind symbolKind, AccessKind access, DefinitionKind definitionKind)
 	{
+		if (m_recordBuffer != null)
+		{
+			m_recordBuffer.recordSymbol(
+				symbolName.serialize(),
+				symbolKind.getValue(),
+				access.getValue(),
+				definitionKind.getValue());
+			return;
+		}
+
 		JavaIndexer.recordSymbol(
 			m_address,
 			symbolName.serialize(),
@@ -60,6 +121,17 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 		AccessKind access,
 		DefinitionKind definitionKind)
 	{
+		if (m_recordBuffer != null)
+		{
+			m_recordBuffer.recordSymbolWithLocation(
+				symbolName.serialize(),
+				symbolKind.getValue(),
+				range,
+				access.getValue(),
+				definitionKind.getValue());
+			return;
+		}
+
 		JavaIndexer.recordSymbolWithLocation(
 			m_address,
 			symbolName.serialize(),
@@ -81,6 +153,18 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 		AccessKind access,
 		DefinitionKind definitionKind)
 	{
+		if (m_recordBuffer != null)
+		{
+			m_recordBuffer.recordSymbolWithLocationAndScope(
+				symbolName.serialize(),
+				symbolKind.getValue(),
+				range,
+				scopeRange,
+				access.getValue(),
+				definitionKind.getValue());
+			return;
+		}
+
 		JavaIndexer.recordSymbolWithLocationAndScope(
 			m_address,
 			symbolName.serialize(),
@@ -107,6 +191,19 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 		AccessKind access,
 		DefinitionKind definitionKind)
 	{
+		if (m_recordBuffer != null)
+		{
+			m_recordBuffer.recordSymbolWithLocationAndScopeAndSignature(
+				symbolName.serialize(),
+				symbolKind.getValue(),
+				range,
+				scopeRange,
+				signatureRange,
+				access.getValue(),
+				definitionKind.getValue());
+			return;
+		}
+
 		JavaIndexer.recordSymbolWithLocationAndScopeAndSignature(
 			m_address,
 			symbolName.serialize(),
@@ -134,16 +231,34 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 		String serializedReferencedName = referencedName.serialize();
 		if (!m_javaLangPackageRecorded && serializedReferencedName.startsWith(m_javaLangPackageName))
 		{
-			JavaIndexer.recordSymbol(
-				m_address,
-				m_javaLangPackageName,
-				SymbolKind.PACKAGE.getValue(),
-				AccessKind.NONE.getValue(),
-				DefinitionKind.NONE.getValue());
+			if (m_recordBuffer != null)
+			{
+				m_recordBuffer.recordSymbol(
+					m_javaLangPackageName,
+					SymbolKind.PACKAGE.getValue(),
+					AccessKind.NONE.getValue(),
+					DefinitionKind.NONE.getValue());
+			}
+			else
+			{
+				JavaIndexer.recordSymbol(
+					m_address,
+					m_javaLangPackageName,
+					SymbolKind.PACKAGE.getValue(),
+					AccessKind.NONE.getValue(),
+					DefinitionKind.NONE.getValue());
+			}
 
 			m_javaLangPackageRecorded = true;
 		}
 
+		if (m_recordBuffer != null)
+		{
+			m_recordBuffer.recordReference(
+				referenceKind.getValue(), serializedReferencedName, contextName.serialize(), range);
+			return;
+		}
+
 		JavaIndexer.recordReference(
 			m_address,
 			referenceKind.getValue(),
@@ -157,6 +272,12 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 
 	@Override public void recordQualifierLocation(NameHierarchy qualifierName, Range range)
 	{
+		if (m_recordBuffer != null)
+		{
+			m_recordBuffer.recordQualifierLocation(qualifierName.serialize(), range);
+			return;
+		}
+
 		JavaIndexer.recordQualifierLocation(
 			m_address,
 			qualifierName.serialize(),
@@ -168,6 +289,12 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 
 	@Override public void recordLocalSymbol(NameHierarchy symbolName, Range range)
 	{
+		if (m_recordBuffer != null)
+		{
+			m_recordBuffer.recordLocalSymbol(symbolName.serialize(), range);
+			return;
+		}
+
 		JavaIndexer.recordLocalSymbol(
 			m_address,
 			symbolName.serialize(),
@@ -179,12 +306,24 @@ public class JavaIndexerAstVisitorClient extends AstVisitorClient
 
 	@Override public void recordComment(Range range)
 	{
+		if (m_recordBuffer != null)
+		{
+			m_recordBuffer.recordComment(range);
+			return;
+		}
+
 		JavaIndexer.recordComment(
 			m_address, range.begin.line, range.begin.column, range.end.line, range.end.column);
 	}
 
 	@Override public void recordError(String message, boolean fatal, boolean indexed, Range range)
 	{
+		if (m_recordBuffer != null)
+		{
+			m_recordBuffer.recordError(message, (fatal ? 1 : 0), (indexed ? 1 : 0), range);
+			return;
+		}
+
 		JavaIndexer.recordError(
 			m_address,
 			message,
@@ -0,0 +1,271 @@
+package com.sourcetrail;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.charset.StandardCharsets;
+import java.util.HashMap;
+import java.util.Map;
+import java.util.concurrent.ArrayBlockingQueue;
+import java.util.concurrent.Executor;
+
+// Collects the records of a single file in a direct ByteBuffer and hands them to the native code
+// in batches, instead of crossing the JNI boundary once per record. Every record starts with an
+// int opcode followed by int fields in native byte order. Strings are sent only once per file as
+// STRING records (opcode, byte length, UTF-8 bytes) and are referenced by their index afterwards.
+// The opcodes have to match the ones used in JavaParser.cpp. If an executor for native calls is
+// passed, full buffers are handed to it and replaced by a free one, so the records of other files
+// can be written while the native code processes them.
+public class JavaIndexerRecordBuffer
+{
+	public static final int RECORD_STRING = 1;
+	public static final int RECORD_SYMBOL = 2;
+	public static final int RECORD_SYMBOL_WITH_LOCATION = 3;
+	public static final int RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE = 4;
+	public static final int RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE = 5;
+	public static final int RECORD_REFERENCE = 6;
+	public static final int RECORD_QUALIFIER_LOCATION = 7;
+	public static final int RECORD_LOCAL_SYMBOL = 8;
+	public static final int RECORD_COMMENT = 9;
+	public static final int RECORD_ERROR = 10;
+
+	private static final int DEFAULT_CAPACITY = 256 * 1024;
+
+	// direct buffers are expensive to allocate, so each thread keeps its buffer between files
+	private static final ThreadLocal<ByteBuffer> s_buffers = new ThreadLocal<>();
+
+	private static final int MAX_FREE_BUFFER_COUNT = 16;
+
+	// buffers that have been processed by the native code after being handed to an executor, grown
+	// buffers and buffers beyond the maximum count are left to the garbage collector
+	private static final ArrayBlockingQueue<ByteBuffer> s_freeBuffers =
+		new ArrayBlockingQueue<>(MAX_FREE_BUFFER_COUNT);
+
+	private int m_address;
+	private Executor m_nativeCalls;
+	private ByteBuffer m_buffer;
+	private Map<String, Integer> m_stringIndices = new HashMap<>();
+
+	public JavaIndexerRecordBuffer(int address)
+	{
+		m_address = address;
+		m_nativeCalls = null;
+
+		m_buffer = s_buffers.get();
+		if (m_buffer == null)
+		{
+			m_buffer = allocate(DEFAULT_CAPACITY);
+			s_buffers.set(m_buffer);
+		}
+		m_buffer.clear();
+	}
+
+	public JavaIndexerRecordBuffer(int address, Executor nativeCalls)
+	{
+		m_address = address;
+		m_nativeCalls = nativeCalls;
+		m_buffer = takeFreeBuffer();
+	}
+
+	public void recordSymbol(String symbolName, int symbolKind, int access, int definitionKind)
+	{
+		int symbolNameIndex = getStringIndex(symbolName);
+		reserve(5);
+		m_buffer.putInt(RECORD_SYMBOL);
+		m_buffer.putInt(symbolNameIndex);
+		m_buffer.putInt(symbolKind);
+		m_buffer.putInt(access);
+		m_buffer.putInt(definitionKind);
+	}
+
+	public void recordSymbolWithLocation(
+		String symbolName, int symbolKind, Range range, int access, int definitionKind)
+	{
+		int symbolNameIndex = getStringIndex(symbolName);
+		reserve(9);
+		m_buffer.putInt(RECORD_SYMBOL_WITH_LOCATION);
+		m_buffer.putInt(symbolNameIndex);
+		m_buffer.putInt(symbolKind);
+		putRange(range);
+		m_buffer.putInt(access);
+		m_buffer.putInt(definitionKind);
+	}
+
+	public void recordSymbolWithLocationAndScope(
+		String symbolName,
+		int symbolKind,
+		Range range,
+		Range scopeRange,
+		int access,
+		int definitionKind)
+	{
+		int symbolNameIndex = getStringIndex(symbolName);
+		reserve(13);
+		m_buffer.putInt(RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE);
+		m_buffer.putInt(symbolNameIndex);
+		m_buffer.putInt(symbolKind);
+		putRange(range);
+		putRange(scopeRange);
+		m_buffer.putInt(access);
+		m_buffer.putInt(definitionKind);
+	}
+
+	public void recordSymbolWithLocationAndScopeAndSignature(
+		String symbolName,
+		int symbolKind,
+		Range range,
+		Range scopeRange,
+		Range signatureRange,
+		int access,
+		int definitionKind)
+	{
+		int symbolNameIndex = getStringIndex(symbolName);
+		reserve(17);
+		m_buffer.putInt(RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE);
+		m_buffer.putInt(symbolNameIndex);
+		m_buffer.putInt(symbolKind);
+		putRange(range);
+		putRange(scopeRange);
+		putRange(signatureRange);
+		m_buffer.putInt(access);
+		m_buffer.putInt(definitionKind);
+	}
+
+	public void recordReference(
+		int referenceKind, String referencedName, String contextName, Range range)
+	{
+		int referencedNameIndex = getStringIndex(referencedName);
+		int contextNameIndex = getStringIndex(contextName);
+		reserve(8);
+		m_buffer.putInt(RECORD_REFERENCE);
+		m_buffer.putInt(referenceKind);
+		m_buffer.putInt(referencedNameIndex);
+		m_buffer.putInt(contextNameIndex);
+		putRange(range);
+	}
+
+	public void recordQualifierLocation(String qualifierName, Range range)
+	{
+		int qualifierNameIndex = getStringIndex(qualifierName);
+		reserve(6);
+		m_buffer.putInt(RECORD_QUALIFIER_LOCATION);
+		m_buffer.putInt(qualifierNameIndex);
+		putRange(range);
+	}
+
+	public void recordLocalSymbol(String symbolName, Range range)
+	{
+		int symbolNameIndex = getStringIndex(symbolName);
+		reserve(6);
+		m_buffer.putInt(RECORD_LOCAL_SYMBOL);
+		m_buffer.putInt(symbolNameIndex);
+		putRange(range);
+	}
+
+	public void recordComment(Range range)
+	{
+		reserve(5);
+		m_buffer.putInt(RECORD_COMMENT);
+		putRange(range);
+	}
+
+	public void recordError(String message, int fatal, int indexed, Range range)
+	{
+		int messageIndex = getStringIndex(message);
+		reserve(8);
+		m_buffer.putInt(RECORD_ERROR);
+		m_buffer.putInt(messageIndex);
+		m_buffer.putInt(fatal);
+		m_buffer.putInt(indexed);
+		putRange(range);
+	}
+
+	public void flush()
+	{
+		if (m_buffer.position() <= 0)
+		{
+			return;
+		}
+
+		if (m_nativeCalls == null)
+		{
+			JavaIndexer.recordBatch(m_address, m_buffer, m_buffer.position());
+			m_buffer.clear();
+			return;
+		}
+
+		final int address = m_address;
+		final ByteBuffer buffer = m_buffer;
+		final int size = m_buffer.position();
+		m_nativeCalls.execute(() -> {
+			JavaIndexer.recordBatch(address, buffer, size);
+			buffer.clear();
+			if (buffer.capacity() == DEFAULT_CAPACITY)
+			{
+				s_freeBuffers.offer(buffer);
+			}
+		});
+		m_buffer = takeFreeBuffer();
+	}
+
+	private int getStringIndex(String s)
+	{
+		Integer index = m_stringIndices.get(s);
+		if (index != null)
+		{
+			return index;
+		}
+
+		byte[] bytes = s.getBytes(StandardCharsets.UTF_8);
+		reserveBytes(2 * Integer.BYTES + bytes.length);
+		m_buffer.putInt(RECORD_STRING);
+		m_buffer.putInt(bytes.length);
+		m_buffer.put(bytes);
+
+		index = m_stringIndices.size();
+		m_stringIndices.put(s, index);
+		return index;
+	}
+
+	private void putRange(Range range)
+	{
+		m_buffer.putInt(range.begin.line);
+		m_buffer.putInt(range.begin.column);
+		m_buffer.putInt(range.end.line);
+		m_buffer.putInt(range.end.column);
+	}
+
+	private void reserve(int intCount)
+	{
+		reserveBytes(intCount * Integer.BYTES);
+	}
+
+	private void reserveBytes(int byteCount)
+	{
+		if (m_buffer.remaining() >= byteCount)
+		{
+			return;
+		}
+
+		flush();
+
+		if (m_buffer.capacity() < byteCount)
+		{
+			m_buffer = allocate(Math.max(byteCount, 2 * m_buffer.capacity()));
+			if (m_nativeCalls == null)
+			{
+				s_buffers.set(m_buffer);
+			}
+		}
+	}
+
+	private static ByteBuffer takeFreeBuffer()
+	{
+		ByteBuffer buffer = s_freeBuffers.poll();
+		return buffer != null ? buffer : allocate(DEFAULT_CAPACITY);
+	}
+
+	private static ByteBuffer allocate(int capacity)
+	{
+		return ByteBuffer.allocateDirect(capacity).order(ByteOrder.nativeOrder());
+	}
+}
@@ -0,0 +1,182 @@
+package com.sourcetrail;
+
+import java.io.PrintWriter;
+import java.io.StringWriter;
+import java.util.ArrayList;
+import java.util.List;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.Executor;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.LinkedBlockingQueue;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicBoolean;
+
+// Indexes a batch of files on a pool of worker threads inside the JVM. The workers share the
+// classpath environments, the jar index and the JIT compiled code of this JVM. The native code is
+// not thread safe, so all native calls of the workers are queued and run on the thread that called
+// processFiles. The pool is kept between batches. The queue of native calls is bounded, so workers
+// wait for the native code instead of piling up record buffers.
+public class ParallelJavaIndexer
+{
+	private static final long NATIVE_CALL_POLL_INTERVAL_MS = 50;
+	private static final int QUEUED_NATIVE_CALLS_PER_WORKER = 16;
+
+	private static ExecutorService s_workers = null;
+	private static int s_workerCount = 0;
+
+	public static void processFiles(
+		int[] addresses,
+		String[] filePaths,
+		String[] fileContents,
+		String[] languageStandards,
+		String[] classPaths,
+		int verbose,
+		int threadCount)
+	{
+		if (addresses.length == 0)
+		{
+			return;
+		}
+
+		ExecutorService workers = getWorkers(Math.max(1, threadCount));
+		LinkedBlockingQueue<Runnable> nativeCalls =
+			new LinkedBlockingQueue<>(Math.max(1, threadCount) * QUEUED_NATIVE_CALLS_PER_WORKER);
+		AtomicBoolean interrupted = new AtomicBoolean(false);
+
+		Executor nativeCallQueue = nativeCall -> {
+			try
+			{
+				nativeCalls.put(nativeCall);
+			}
+			catch (InterruptedException e)
+			{
+				interrupted.set(true);
+				Thread.currentThread().interrupt();
+			}
+		};
+
+		List<Future<?>> futures = new ArrayList<>();
+		for (int i = 0; i < addresses.length; i++)
+		{
+			final int index = i;
+			futures.add(workers.submit(() -> {
+				JavaIndexerAstVisitorClient astVisitorClient = new JavaIndexerAstVisitorClient(
+					addresses[index], nativeCallQueue, interrupted);
+
+				JavaIndexer.processFile(
+					astVisitorClient,
+					filePaths[index],
+					fileContents[index],
+					languageStandards[index],
+					classPaths[index],
+					verbose);
+
+				astVisitorClient.flush();
+			}));
+		}
+
+		// all parsers of a batch share the same interrupted state on the native side
+		boolean done = false;
+		while (!done)
+		{
+			// calls queued by a finished worker are visible after checking its future
+			done = isDone(futures);
+
+			Runnable nativeCall;
+			while ((nativeCall = nativeCalls.poll()) != null)
+			{
+				nativeCall.run();
+			}
+
+			if (!done)
+			{
+				if (!interrupted.get() && JavaIndexer.getInterrupted(addresses[0]))
+				{
+					interrupted.set(true);
+				}
+
+				try
+				{
+					nativeCall = nativeCalls.poll(
+						NATIVE_CALL_POLL_INTERVAL_MS, TimeUnit.MILLISECONDS);
+					if (nativeCall != null)
+					{
+						nativeCall.run();
+					}
+				}
+				catch (InterruptedException e)
+				{
+					interrupted.set(true);
+				}
+			}
+		}
+
+		// errors like a StackOverflowError end the worker without reaching the native code
+		for (int i = 0; i < futures.size(); i++)
+		{
+			try
+			{
+				futures.get(i).get();
+			}
+			catch (ExecutionException e)
+			{
+				reportError(addresses[i], e.getCause());
+			}
+			catch (InterruptedException e)
+			{
+				interrupted.set(true);
+			}
+		}
+	}
+
+	public static synchronized void shutdown()
+	{
+		if (s_workers != null)
+		{
+			s_workers.shutdown();
+			s_workers = null;
+			s_workerCount = 0;
+		}
+	}
+
+	private static synchronized ExecutorService getWorkers(int threadCount)
+	{
+		if (s_workers == null || s_workerCount != threadCount)
+		{
+			shutdown();
+
+			s_workers = Executors.newFixedThreadPool(threadCount, runnable -> {
+				Thread thread = new Thread(runnable, "java-indexer-worker");
+				thread.setDaemon(true);
+				return thread;
+			});
+			s_workerCount = threadCount;
+		}
+		return s_workers;
+	}
+
+	private static void reportError(int address, Throwable error)
+	{
+		StringWriter sw = new StringWriter();
+		PrintWriter pw = new PrintWriter(sw);
+		error.printStackTrace(pw);
+		JavaIndexer.logError(address, sw.toString());
+
+		// a fatal error keeps the partial index of the file from being treated as complete
+		JavaIndexer.recordError(address, "Indexing aborted: " + error.toString(), 1, 1, 1, 1, 1, 1);
+	}
+
+	private static boolean isDone(List<Future<?>> futures)
+	{
+		for (Future<?> future: futures)
+		{
+			if (!future.isDone())
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
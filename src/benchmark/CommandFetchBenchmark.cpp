@@ -0,0 +1,80 @@
+#include "CommandFetchBenchmark.h"
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+
+#	include <algorithm>
+#	include <memory>
+#	include <thread>
+#	include <vector>
+
+#	include <boost/filesystem.hpp>
+
+#	include "IndexerCommandCxx.h"
+#	include "InterprocessIndexerCommandManager.h"
+#	include "utilityBenchmark.h"
+
+CommandFetchBenchmark::CommandFetchBenchmark(const Settings& settings): m_settings(settings) {}
+
+void CommandFetchBenchmark::run(std::ostream& out)
+{
+	const size_t indexerCount = m_settings.indexerCount
+		? m_settings.indexerCount
+		: std::max<size_t>(4, std::thread::hardware_concurrency());
+
+	// a unique instance keeps the shared memory apart from running Sourcetrail instances
+	const std::string instanceUuid =
+		boost::filesystem::unique_path("command_fetch_benchmark_%%%%-%%%%").string();
+	InterprocessIndexerCommandManager mainManager(instanceUuid, 0, true);
+
+	// source files that don't exist are treated as empty, so all of them are tiny
+	std::vector<std::shared_ptr<IndexerCommand>> indexerCommands;
+	for (size_t i = 0; i < m_settings.commandCount; i++)
+	{
+		indexerCommands.push_back(std::make_shared<IndexerCommandCxx>(
+			FilePath(L"tiny_" + std::to_wstring(i) + L".cpp"),
+			std::set<FilePath>(),
+			std::set<FilePathFilter>(),
+			std::set<FilePathFilter>(),
+			FilePath(),
+			std::vector<std::wstring>({L"-std=c++17"})));
+	}
+
+	for (bool fetchBatches: {false, true})
+	{
+		mainManager.pushIndexerCommands(indexerCommands);
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		std::vector<std::thread> threads;
+		for (size_t i = 0; i < indexerCount; i++)
+		{
+			threads.emplace_back([&instanceUuid, i, fetchBatches]() {
+				InterprocessIndexerCommandManager indexerManager(instanceUuid, i + 1, false);
+				while (fetchBatches ? !indexerManager.fetchIndexerCommands().empty()
+									: indexerManager.popIndexerCommand() != nullptr)
+				{
+				}
+			});
+		}
+
+		for (std::thread& thread: threads)
+		{
+			thread.join();
+		}
+
+		const double milliseconds = utility::getMillisecondsSince(start);
+		out << utility::getBenchmarkResultPrefix("command_fetch", m_settings.label)
+			<< ", \"commands\": " << m_settings.commandCount << ", \"indexers\": " << indexerCount
+			<< ", \"metric\": \"" << (fetchBatches ? "fetch_batches" : "pop_single_commands")
+			<< "\", \"milliseconds\": " << milliseconds
+			<< ", \"commands_per_second\": " << m_settings.commandCount / (milliseconds / 1000)
+			<< ", \"remaining_commands\": " << mainManager.indexerCommandCount() << "}"
+			<< std::endl;
+
+		mainManager.clearIndexerCommands();
+	}
+}
+
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
@@ -0,0 +1,29 @@
+#ifndef COMMAND_FETCH_BENCHMARK_H
+#define COMMAND_FETCH_BENCHMARK_H
+
+#include <ostream>
+#include <string>
+
+// Measures how fast indexer processes take many commands of tiny source files from the shared
+// memory queue of the InterprocessIndexerCommandManager, once popping single commands and once
+// fetching them in batches. Each indexer process is simulated by a thread with its own manager.
+class CommandFetchBenchmark
+{
+public:
+	struct Settings
+	{
+		size_t commandCount = 20000;
+		// 0 uses at least 4 indexers or one per hardware thread
+		size_t indexerCount = 0;
+		std::string label;
+	};
+
+	CommandFetchBenchmark(const Settings& settings);
+
+	void run(std::ostream& out);
+
+private:
+	const Settings m_settings;
+};
+
+#endif	  // COMMAND_FETCH_BENCHMARK_H
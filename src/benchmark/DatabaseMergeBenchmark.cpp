@@ -0,0 +1,114 @@
+#include "DatabaseMergeBenchmark.h"
+
+#include <vector>
+
+#include "Edge.h"
+#include "FilePath.h"
+#include "FileSystem.h"
+#include "IntermediateStorage.h"
+#include "NameHierarchy.h"
+#include "PersistentStorage.h"
+#include "TaskExecuteCustomCommands.h"
+#include "utilityBenchmark.h"
+
+DatabaseMergeBenchmark::DatabaseMergeBenchmark(const Settings& settings): m_settings(settings) {}
+
+void DatabaseMergeBenchmark::run(std::ostream& out)
+{
+	const FilePath directoryPath = utility::createBenchmarkDirectory("database_merge");
+	const FilePath targetFilePath = directoryPath.getConcatenated(L"target.srctrldb");
+
+	std::vector<FilePath> sourceFilePaths;
+	for (size_t i = 1; i < m_settings.databaseCount; i++)
+	{
+		sourceFilePaths.push_back(
+			directoryPath.getConcatenated(L"target.srctrldb_thread" + std::to_wstring(i)));
+	}
+
+	const auto createDatabases = [&]() {
+		createDatabase(targetFilePath, L"thread0");
+		for (size_t i = 0; i < sourceFilePaths.size(); i++)
+		{
+			createDatabase(sourceFilePaths[i], L"thread" + std::to_wstring(i + 1));
+		}
+	};
+
+	{
+		createDatabases();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		{
+			PersistentStorage targetStorage(targetFilePath, FilePath());
+			targetStorage.setup();
+			targetStorage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+			targetStorage.buildCaches();
+			for (const FilePath& sourceFilePath: sourceFilePaths)
+			{
+				PersistentStorage sourceStorage(sourceFilePath, FilePath());
+				sourceStorage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+				sourceStorage.buildCaches();
+				targetStorage.inject(&sourceStorage);
+			}
+		}
+		writeDuration("sequential_inject", utility::getMillisecondsSince(start), out);
+	}
+
+	{
+		createDatabases();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		TaskExecuteCustomCommands::mergeDatabases(targetFilePath, sourceFilePaths);
+		writeDuration("parallel_merge", utility::getMillisecondsSince(start), out);
+	}
+
+	utility::removeBenchmarkDirectory(directoryPath);
+}
+
+void DatabaseMergeBenchmark::createDatabase(
+	const FilePath& databaseFilePath, const std::wstring& prefix) const
+{
+	FileSystem::remove(databaseFilePath);
+
+	IntermediateStorage intermediateStorage;
+	const Id sharedTypeId = intermediateStorage
+								.addNode(StorageNodeData(
+									nodeKindToInt(NODE_CLASS),
+									NameHierarchy::serialize(
+										NameHierarchy(L"shared_type", NAME_DELIMITER_CXX))))
+								.first;
+	for (size_t i = 0; i < m_settings.fileCount; i++)
+	{
+		const std::wstring filePath = prefix + L"/file_" + std::to_wstring(i) + L".py";
+		const Id fileId =
+			intermediateStorage
+				.addNode(StorageNodeData(
+					nodeKindToInt(NODE_FILE),
+					NameHierarchy::serialize(NameHierarchy(filePath, NAME_DELIMITER_FILE))))
+				.first;
+		intermediateStorage.addFile(
+			StorageFile(fileId, filePath, L"python", "someTime", true, true));
+
+		const Id functionId = intermediateStorage
+								  .addNode(StorageNodeData(
+									  nodeKindToInt(NODE_FUNCTION),
+									  NameHierarchy::serialize(NameHierarchy(
+										  prefix + L"_function_" + std::to_wstring(i),
+										  NAME_DELIMITER_CXX))))
+								  .first;
+		intermediateStorage.addEdge(StorageEdgeData(
+			Edge::typeToInt(Edge::EDGE_TYPE_USAGE), functionId, sharedTypeId));
+	}
+
+	PersistentStorage storage(databaseFilePath, FilePath());
+	storage.setup();
+	storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+	storage.buildCaches();
+	storage.inject(&intermediateStorage);
+}
+
+void DatabaseMergeBenchmark::writeDuration(
+	const std::string& metric, double milliseconds, std::ostream& out) const
+{
+	out << utility::getBenchmarkResultPrefix("database_merge", m_settings.label)
+		<< ", \"databases\": " << m_settings.databaseCount
+		<< ", \"files\": " << m_settings.fileCount << ", \"metric\": \"" << metric
+		<< "\", \"milliseconds\": " << milliseconds << "}" << std::endl;
+}
@@ -0,0 +1,34 @@
+#ifndef DATABASE_MERGE_BENCHMARK_H
+#define DATABASE_MERGE_BENCHMARK_H
+
+#include <ostream>
+#include <string>
+
+class FilePath;
+
+// Measures merging the databases that the threads of a custom command run write into the project
+// database, once by injecting them one after another and once by the parallel merge of
+// TaskExecuteCustomCommands.
+class DatabaseMergeBenchmark
+{
+public:
+	struct Settings
+	{
+		size_t databaseCount = 16;
+		size_t fileCount = 2000;
+		std::string label;
+	};
+
+	DatabaseMergeBenchmark(const Settings& settings);
+
+	void run(std::ostream& out);
+
+private:
+	// every file has a function that uses a type shared by all databases
+	void createDatabase(const FilePath& databaseFilePath, const std::wstring& prefix) const;
+	void writeDuration(const std::string& metric, double milliseconds, std::ostream& out) const;
+
+	const Settings m_settings;
+};
+
+#endif	  // DATABASE_MERGE_BENCHMARK_H
@@ -0,0 +1,241 @@
+#include "FullTextSearchBenchmark.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <regex>
+#include <sstream>
+#include <vector>
+
+#include "FileSystem.h"
+#include "FullTextSearchIndex.h"
+#include "SuffixArray.h"
+#include "TrigramQuery.h"
+#include "utilityBenchmark.h"
+#include "utilityMemory.h"
+#include "utilityString.h"
+
+namespace
+{
+std::wstring createFileText(size_t lineCount, size_t fileIndex)
+{
+	std::wstring text;
+	for (size_t i = 0; i < lineCount; i++)
+	{
+		text += L"\tconst int value" + std::to_wstring(i % 97) + L" = compute(item_" +
+			std::to_wstring(fileIndex) + L", " + std::to_wstring(i) + L");\n";
+	}
+	return text;
+}
+
+std::vector<FullTextSearchFileInfo> getFileInfos(const std::map<Id, std::wstring>& fileTexts)
+{
+	std::vector<FullTextSearchFileInfo> fileInfos;
+	for (const auto& it: fileTexts)
+	{
+		fileInfos.emplace_back(it.first, "2020-01-01 10:00:00");
+	}
+	return fileInfos;
+}
+
+// returns the number of files with a line matching the regular expression
+size_t searchLines(const std::map<Id, std::wstring>& fileTexts, const std::wregex& regex)
+{
+	size_t fileCount = 0;
+	for (const auto& it: fileTexts)
+	{
+		std::wistringstream stream(it.second);
+		std::wstring line;
+		while (std::getline(stream, line))
+		{
+			if (std::regex_search(line, regex))
+			{
+				fileCount++;
+				break;
+			}
+		}
+	}
+	return fileCount;
+}
+
+size_t getMemoryIncrease(size_t memoryBefore)
+{
+	const size_t memoryAfter = utility::getProcessMemoryUsage();
+	return memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0;
+}
+}	 // namespace
+
+FullTextSearchBenchmark::FullTextSearchBenchmark(const Settings& settings): m_settings(settings) {}
+
+void FullTextSearchBenchmark::run(std::ostream& out)
+{
+	const FilePath directoryPath = utility::createBenchmarkDirectory("fulltext");
+	const FilePath indexFilePath = directoryPath.getConcatenated(L"index_fulltext");
+
+	std::map<Id, std::wstring> fileTexts;
+	for (size_t i = 0; i < m_settings.fileCount; i++)
+	{
+		fileTexts[i + 1] = createFileText(m_settings.lineCount, i);
+	}
+
+	measureFirstQuery(fileTexts, indexFilePath, out);
+	measureRegexSearch(fileTexts, indexFilePath, out);
+	measureSourceByteSize(indexFilePath, out);
+
+	utility::removeBenchmarkDirectory(directoryPath);
+}
+
+void FullTextSearchBenchmark::measureFirstQuery(
+	const std::map<Id, std::wstring>& fileTexts,
+	const FilePath& indexFilePath,
+	std::ostream& out) const
+{
+	const std::wstring term = L"value42 = compute";
+
+	{
+		const size_t memoryBefore = utility::getProcessMemoryUsage();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		FullTextSearchIndex index;
+		for (const auto& it: fileTexts)
+		{
+			index.addFile(it.first, it.second);
+		}
+		const size_t resultCount = index.searchForTerm(term).size();
+
+		out << getResultPrefix("first_query") << ", \"index\": \"memory\", \"milliseconds\": "
+			<< utility::getMillisecondsSince(start) << ", \"results\": " << resultCount
+			<< ", \"memory_bytes\": " << getMemoryIncrease(memoryBefore) << "}" << std::endl;
+	}
+
+	{
+		FullTextSearchIndex index;
+		index.updateFile(indexFilePath, "UTF-8", getFileInfos(fileTexts), [&](Id fileId) {
+			return fileTexts.at(fileId);
+		});
+	}
+
+	{
+		const size_t memoryBefore = utility::getProcessMemoryUsage();
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		FullTextSearchIndex index;
+		index.loadFile(indexFilePath, "UTF-8");
+		const size_t resultCount = index.searchForTerm(term).size();
+
+		out << getResultPrefix("first_query") << ", \"index\": \"mapped_file\", \"milliseconds\": "
+			<< utility::getMillisecondsSince(start) << ", \"results\": " << resultCount
+			<< ", \"memory_bytes\": " << getMemoryIncrease(memoryBefore) << "}" << std::endl;
+
+		const std::chrono::steady_clock::time_point secondStart = std::chrono::steady_clock::now();
+		const size_t secondResultCount = index.searchForTerm(L"item_17, ").size();
+
+		out << getResultPrefix("second_query") << ", \"index\": \"mapped_file\", \"milliseconds\": "
+			<< utility::getMillisecondsSince(secondStart) << ", \"results\": " << secondResultCount
+			<< "}" << std::endl;
+	}
+
+	FileSystem::remove(indexFilePath);
+}
+
+void FullTextSearchBenchmark::measureRegexSearch(
+	const std::map<Id, std::wstring>& fileTexts,
+	const FilePath& indexFilePath,
+	std::ostream& out) const
+{
+	const std::wstring pattern = L"compute\\(item_" + std::to_wstring(fileTexts.size() / 2) +
+		L", \\d+\\)";
+	const std::wregex regex(pattern);
+
+	{
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		const size_t resultCount = searchLines(fileTexts, regex);
+
+		out << getResultPrefix("regex_search") << ", \"prefilter\": \"none\", \"milliseconds\": "
+			<< utility::getMillisecondsSince(start) << ", \"results\": " << resultCount
+			<< ", \"scanned_files\": " << fileTexts.size() << "}" << std::endl;
+	}
+
+	{
+		FullTextSearchIndex index;
+		index.updateFile(indexFilePath, "UTF-8", getFileInfos(fileTexts), [&](Id fileId) {
+			return fileTexts.at(fileId);
+		});
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		std::map<Id, std::wstring> candidateFileTexts;
+		for (Id fileId: index.getFilesForTrigramQuery(TrigramQuery::fromRegex(pattern)))
+		{
+			candidateFileTexts[fileId] = fileTexts.at(fileId);
+		}
+		const size_t resultCount = searchLines(candidateFileTexts, regex);
+
+		out << getResultPrefix("regex_search")
+			<< ", \"prefilter\": \"trigram_index\", \"milliseconds\": "
+			<< utility::getMillisecondsSince(start) << ", \"results\": " << resultCount
+			<< ", \"scanned_files\": " << candidateFileTexts.size() << "}" << std::endl;
+	}
+
+	FileSystem::remove(indexFilePath);
+}
+
+void FullTextSearchBenchmark::measureSourceByteSize(
+	const FilePath& indexFilePath, std::ostream& out) const
+{
+	const FilePath sourceDirectoryPath = m_settings.sourceDirectoryPath.empty()
+		? FilePath(std::string(__FILE__)).getAbsolute().getParentDirectory().getParentDirectory()
+		: m_settings.sourceDirectoryPath;
+
+	std::map<Id, std::wstring> fileTexts;
+	unsigned long long sourceByteSize = 0;
+	for (const FilePath& directoryPath: FileSystem::getDirectSubDirectories(sourceDirectoryPath))
+	{
+		if (directoryPath.fileName() == L"external")
+		{
+			continue;
+		}
+
+		for (const FilePath& filePath:
+			 FileSystem::getFilePathsFromDirectory(directoryPath, {L".cpp", L".h"}))
+		{
+			std::ifstream file(filePath.str(), std::ios::binary);
+			const std::string content(
+				(std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+			fileTexts[fileTexts.size() + 1] = utility::decodeFromUtf8(content);
+			sourceByteSize += content.size();
+		}
+	}
+
+	size_t memoryByteSize = 0;
+	size_t wideCharFileCount = 0;
+	for (const auto& it: fileTexts)
+	{
+		const SuffixArray array(it.second);
+		memoryByteSize += array.getByteSize();
+		wideCharFileCount += array.getData().charSize > 1 ? 1 : 0;
+	}
+
+	FullTextSearchIndex index;
+	index.updateFile(indexFilePath, "UTF-8", getFileInfos(fileTexts), [&](Id fileId) {
+		return fileTexts.at(fileId);
+	});
+	const unsigned long long indexFileByteSize = FileSystem::getFileByteSize(indexFilePath);
+	const double divisor = std::max<double>(sourceByteSize, 1);
+
+	out << getResultPrefix("source_byte_size") << ", \"source_files\": " << fileTexts.size()
+		<< ", \"source_bytes\": " << sourceByteSize
+		<< ", \"wide_char_files\": " << wideCharFileCount
+		<< ", \"memory_bytes_per_source_byte\": " << memoryByteSize / divisor
+		<< ", \"index_file_bytes_per_source_byte\": " << indexFileByteSize / divisor << "}"
+		<< std::endl;
+
+	FileSystem::remove(indexFilePath);
+}
+
+std::string FullTextSearchBenchmark::getResultPrefix(const std::string& metric) const
+{
+	return utility::getBenchmarkResultPrefix("fulltext", m_settings.label) +
+		", \"files\": " + std::to_string(m_settings.fileCount) +
+		", \"lines\": " + std::to_string(m_settings.lineCount) + ", \"metric\": \"" + metric +
+		"\"";
+}
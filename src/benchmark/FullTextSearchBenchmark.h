@@ -0,0 +1,51 @@
+#ifndef FULL_TEXT_SEARCH_BENCHMARK_H
+#define FULL_TEXT_SEARCH_BENCHMARK_H
+
+#include <map>
+#include <ostream>
+#include <string>
+
+#include "FilePath.h"
+#include "types.h"
+
+// Measures the FullTextSearchIndex on generated files that look like source code with many
+// repeated words, and the size of the index of real source files.
+class FullTextSearchBenchmark
+{
+public:
+	struct Settings
+	{
+		size_t fileCount = 200;
+		size_t lineCount = 2000;
+		// the .cpp and .h files below it are indexed to measure the index size, empty uses the
+		// sources of this project
+		FilePath sourceDirectoryPath;
+		std::string label;
+	};
+
+	FullTextSearchBenchmark(const Settings& settings);
+
+	void run(std::ostream& out);
+
+private:
+	// latency and resident memory of the first query, once with an index built in memory and once
+	// with a memory mapped index file
+	void measureFirstQuery(
+		const std::map<Id, std::wstring>& fileTexts,
+		const FilePath& indexFilePath,
+		std::ostream& out) const;
+	// a regular expression search scanning the lines of all files, and of the candidate files of
+	// the trigram index only
+	void measureRegexSearch(
+		const std::map<Id, std::wstring>& fileTexts,
+		const FilePath& indexFilePath,
+		std::ostream& out) const;
+	// bytes of the suffix arrays in memory and of the index file per byte of the source files
+	void measureSourceByteSize(const FilePath& indexFilePath, std::ostream& out) const;
+
+	std::string getResultPrefix(const std::string& metric) const;
+
+	const Settings m_settings;
+};
+
+#endif	  // FULL_TEXT_SEARCH_BENCHMARK_H
@@ -0,0 +1,183 @@
+#include "PythonPostProcessingBenchmark.h"
+
+#include <fstream>
+
+#include "Edge.h"
+#include "FilePath.h"
+#include "IntermediateStorage.h"
+#include "LocationType.h"
+#include "NameHierarchy.h"
+#include "PersistentStorage.h"
+#include "TaskExecuteCustomCommands.h"
+#include "utilityBenchmark.h"
+#include "utilityString.h"
+
+namespace
+{
+Id addNode(IntermediateStorage* storage, NodeKind kind, const std::vector<std::wstring>& names)
+{
+	NameHierarchy nameHierarchy(NAME_DELIMITER_JAVA);
+	for (const std::wstring& name: names)
+	{
+		nameHierarchy.push(name);
+	}
+	return storage
+		->addNode(StorageNodeData(nodeKindToInt(kind), NameHierarchy::serialize(nameHierarchy)))
+		.first;
+}
+
+// stores an edge to the unsolved symbol with an unsolved location at the token of the line
+void addUnsolvedReference(
+	IntermediateStorage* storage,
+	Edge::EdgeType edgeType,
+	Id sourceId,
+	Id unsolvedSymbolId,
+	Id fileId,
+	size_t lineNumber,
+	const std::string& line,
+	const std::string& token,
+	size_t tokenPos)
+{
+	const size_t startCol = line.find(token, tokenPos) + 1;
+	const Id edgeId = storage->addEdge(
+		StorageEdgeData(Edge::typeToInt(edgeType), sourceId, unsolvedSymbolId));
+	const Id locationId = storage->addSourceLocation(StorageSourceLocationData(
+		fileId,
+		lineNumber,
+		startCol,
+		lineNumber,
+		startCol + token.size() - 1,
+		locationTypeToInt(LOCATION_UNSOLVED)));
+	storage->addOccurrence(StorageOccurrence(edgeId, locationId));
+}
+}	 // namespace
+
+PythonPostProcessingBenchmark::PythonPostProcessingBenchmark(const Settings& settings)
+	: m_settings(settings)
+{
+}
+
+void PythonPostProcessingBenchmark::run(std::ostream& out)
+{
+	const FilePath directoryPath = utility::createBenchmarkDirectory("python_post_processing");
+	const FilePath databaseFilePath = directoryPath.getConcatenated(L"project.srctrldb");
+
+	size_t unsolvedReferenceCount = 0;
+	{
+		IntermediateStorage intermediateStorage;
+		const Id unsolvedSymbolId = addNode(
+			&intermediateStorage, NODE_SYMBOL, {L"unsolved symbol"});
+		for (size_t i = 0; i < m_settings.fileCount; i++)
+		{
+			const std::wstring moduleName = L"module" + std::to_wstring(i);
+			unsolvedReferenceCount += createFile(
+				directoryPath.getConcatenated(moduleName + L".py"),
+				moduleName,
+				unsolvedSymbolId,
+				&intermediateStorage);
+		}
+
+		PersistentStorage storage(databaseFilePath, FilePath());
+		storage.setup();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		storage.buildCaches();
+		storage.inject(&intermediateStorage);
+	}
+
+	double milliseconds = 0;
+	{
+		PersistentStorage storage(databaseFilePath, FilePath());
+		storage.setup();
+		storage.buildCaches();
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		TaskExecuteCustomCommands::runPythonPostProcessing(storage);
+		milliseconds = utility::getMillisecondsSince(start);
+	}
+
+	out << utility::getBenchmarkResultPrefix("python_post_processing", m_settings.label)
+		<< ", \"files\": " << m_settings.fileCount << ", \"classes\": " << m_settings.classCount
+		<< ", \"metric\": \"post_processing\", \"unsolved_references\": " << unsolvedReferenceCount
+		<< ", \"milliseconds\": " << milliseconds << "}" << std::endl;
+
+	utility::removeBenchmarkDirectory(directoryPath);
+}
+
+size_t PythonPostProcessingBenchmark::createFile(
+	const FilePath& filePath,
+	const std::wstring& moduleName,
+	Id unsolvedSymbolId,
+	IntermediateStorage* storage) const
+{
+	const Id fileId = storage
+						  ->addNode(StorageNodeData(
+							  nodeKindToInt(NODE_FILE),
+							  NameHierarchy::serialize(
+								  NameHierarchy(filePath.wstr(), NAME_DELIMITER_FILE))))
+						  .first;
+	storage->addFile(StorageFile(fileId, filePath.wstr(), L"python", "someTime", true, true));
+
+	std::ofstream file(filePath.str());
+	size_t lineNumber = 0;
+	const auto writeLine = [&file, &lineNumber](const std::string& line) {
+		file << line << "\n";
+		return ++lineNumber;
+	};
+
+	// each base class is followed by a class calling its method by name and one calling it with
+	// super(), only the base classes and calls of the same module are found by name
+	size_t unsolvedReferenceCount = 0;
+	for (size_t i = 0; i < m_settings.classCount; i++)
+	{
+		const std::wstring id = moduleName + L"_" + std::to_wstring(i);
+		const std::wstring baseName = L"A" + id;
+
+		addNode(storage, NODE_CLASS, {moduleName, baseName});
+		addNode(storage, NODE_METHOD, {moduleName, baseName, L"__init__"});
+		writeLine("class " + utility::encodeToUtf8(baseName) + ":");
+		writeLine("\tdef __init__(self):");
+		writeLine("\t\tpass");
+		writeLine("");
+
+		for (const std::wstring& childName: {L"B" + id, L"C" + id})
+		{
+			const Id childId = addNode(storage, NODE_CLASS, {moduleName, childName});
+			const Id childMethodId = addNode(
+				storage, NODE_METHOD, {moduleName, childName, L"__init__"});
+
+			const std::string classLine = "class " + utility::encodeToUtf8(childName) + "(" +
+				utility::encodeToUtf8(baseName) + "):";
+			addUnsolvedReference(
+				storage,
+				Edge::EDGE_INHERITANCE,
+				childId,
+				unsolvedSymbolId,
+				fileId,
+				writeLine(classLine),
+				classLine,
+				utility::encodeToUtf8(baseName),
+				classLine.find('('));
+
+			writeLine("\tdef __init__(self):");
+
+			const std::string callLine = childName[0] == L'B'
+				? "\t\t" + utility::encodeToUtf8(baseName) + ".__init__()"
+				: "\t\tsuper().__init__()";
+			addUnsolvedReference(
+				storage,
+				Edge::EDGE_CALL,
+				childMethodId,
+				unsolvedSymbolId,
+				fileId,
+				writeLine(callLine),
+				callLine,
+				"__init__",
+				0);
+
+			writeLine("");
+			unsolvedReferenceCount += 2;
+		}
+	}
+
+	return unsolvedReferenceCount;
+}
@@ -0,0 +1,40 @@
+#ifndef PYTHON_POST_PROCESSING_BENCHMARK_H
+#define PYTHON_POST_PROCESSING_BENCHMARK_H
+
+#include <ostream>
+#include <string>
+
+#include "types.h"
+
+class FilePath;
+class IntermediateStorage;
+
+// Measures resolving the unsolved references the Python indexer leaves for the post processing of
+// TaskExecuteCustomCommands. The generated files contain class hierarchies with base classes and
+// calls of base class methods, which are stored like the Python indexer stores them.
+class PythonPostProcessingBenchmark
+{
+public:
+	struct Settings
+	{
+		size_t fileCount = 16;
+		size_t classCount = 250;
+		std::string label;
+	};
+
+	PythonPostProcessingBenchmark(const Settings& settings);
+
+	void run(std::ostream& out);
+
+private:
+	// writes the source file and returns the number of stored unsolved references
+	size_t createFile(
+		const FilePath& filePath,
+		const std::wstring& moduleName,
+		Id unsolvedSymbolId,
+		IntermediateStorage* storage) const;
+
+	const Settings m_settings;
+};
+
+#endif	  // PYTHON_POST_PROCESSING_BENCHMARK_H
@@ -0,0 +1,308 @@
+#include "SearchIndexBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <sstream>
+
+#ifdef __GLIBC__
+#	include <malloc.h>
+#endif	  // __GLIBC__
+
+#include "utilityBenchmark.h"
+#include "utilityMemory.h"
+
+namespace
+{
+// the name behind the last delimiter, e.g. the name of a method
+std::wstring getUnqualifiedName(const std::wstring& name)
+{
+	const size_t pos = name.rfind(L"::");
+	return pos == std::wstring::npos ? name : name.substr(pos + 2);
+}
+
+// the name of the enclosing scope, e.g. the name of a class
+std::wstring getScopeName(const std::wstring& name)
+{
+	const size_t pos = name.rfind(L"::");
+	return pos == std::wstring::npos ? L"" : getUnqualifiedName(name.substr(0, pos));
+}
+
+// same limits as the autocompletion of PersistentStorage
+size_t getMaxResultCount(const std::wstring& query)
+{
+	return static_cast<size_t>(std::pow(3, query.size() + 3));
+}
+
+const size_t s_maxBestScoredResultsLength = 100;
+}	 // namespace
+
+SearchIndexBenchmark::SearchIndexBenchmark(const Settings& settings): m_settings(settings) {}
+
+void SearchIndexBenchmark::run(std::ostream& out)
+{
+	const std::vector<SymbolSetGenerator::Symbol> symbols =
+		SymbolSetGenerator(m_settings.shape, m_settings.seed).generate(m_settings.symbolCount);
+
+	size_t nameCharCount = 0;
+	for (const SymbolSetGenerator::Symbol& symbol: symbols)
+	{
+		nameCharCount += symbol.name.size();
+	}
+
+#ifdef __GLIBC__
+	// otherwise the index reuses memory freed by earlier runs without growing the process
+	malloc_trim(0);
+#endif	  // __GLIBC__
+
+	const size_t memoryBefore = utility::getProcessMemoryUsage();
+	const std::chrono::steady_clock::time_point buildStart = std::chrono::steady_clock::now();
+
+	SearchIndex index(m_settings.threadCount);
+	index.setElementMemoryBudget(m_settings.elementMemoryBudget);
+	for (const SymbolSetGenerator::Symbol& symbol: symbols)
+	{
+		index.addNode(symbol.id, symbol.name, symbol.type, symbol.flags);
+	}
+	index.finishSetup();
+
+	const double buildMilliseconds = utility::getMillisecondsSince(buildStart);
+	const size_t memoryAfter = utility::getProcessMemoryUsage();
+
+	out << getResultPrefix("build") << ", \"milliseconds\": " << buildMilliseconds
+		<< ", \"memory_bytes\": " << (memoryAfter > memoryBefore ? memoryAfter - memoryBefore : 0)
+		<< ", \"name_characters\": " << nameCharCount
+		<< ", \"element_bytes\": " << index.getElementTable().getTotalByteSize()
+		<< ", \"resident_element_bytes\": " << index.getElementTable().getResidentByteSize() << "}"
+		<< std::endl;
+
+	for (const QueryPattern& pattern: getQueryPatterns())
+	{
+		measureQueries(index, symbols, pattern, out);
+	}
+	// the short prefixes have the most candidates to split between the threads
+	measureThreadScaling(index, symbols, getQueryPatterns().front(), out);
+	measureTyping(index, symbols, true, out);
+	measureTyping(index, symbols, false, out);
+}
+
+std::vector<SearchIndexBenchmark::QueryPattern> SearchIndexBenchmark::getQueryPatterns()
+{
+	const auto getShortPrefix = [](const std::wstring& name) {
+		return getUnqualifiedName(name).substr(0, 2);
+	};
+	const auto getWordPrefix = [](const std::wstring& name) {
+		return getUnqualifiedName(name).substr(0, 5);
+	};
+
+	// the filtered patterns use the flags required by the definition and language filters of the
+	// autocompletion, their short prefixes have the most candidates to skip
+	return {
+		{"short_prefix", NodeTypeSet::all(), getShortPrefix},
+		{"word_prefix", NodeTypeSet::all(), getWordPrefix},
+		{"camel_case_initials",
+		 NodeTypeSet::all(),
+		 [](const std::wstring& name) {
+			 const std::wstring unqualifiedName = getUnqualifiedName(name);
+			 std::wstring query = unqualifiedName.substr(0, 1);
+			 for (size_t i = 1; i < unqualifiedName.size(); i++)
+			 {
+				 if (iswupper(unqualifiedName[i]))
+				 {
+					 query += unqualifiedName[i];
+				 }
+			 }
+			 return query.size() > 1 ? query : unqualifiedName.substr(0, 3);
+		 }},
+		{"qualified",
+		 NodeTypeSet::all(),
+		 [](const std::wstring& name) {
+			 return getScopeName(name) + L"::" + getUnqualifiedName(name).substr(0, 3);
+		 }},
+		{"no_match",
+		 NodeTypeSet::all(),
+		 [](const std::wstring& name) { return getUnqualifiedName(name) + L"qzx"; }},
+		{"classes_word_prefix", NodeTypeSet(NodeType(NODE_CLASS)), getWordPrefix},
+		{"defined_word_prefix",
+		 SearchIndex::Filter(
+			 NodeTypeSet::all(), SearchIndex::ELEMENT_SYMBOL | SearchIndex::ELEMENT_DEFINED),
+		 getWordPrefix},
+		{"classes_short_prefix", NodeTypeSet(NodeType(NODE_CLASS)), getShortPrefix},
+		{"non_indexed_short_prefix",
+		 SearchIndex::Filter(
+			 NodeTypeSet::all(), SearchIndex::ELEMENT_SYMBOL | SearchIndex::ELEMENT_NON_INDEXED),
+		 getShortPrefix},
+		{"defined_cxx_classes_short_prefix",
+		 SearchIndex::Filter(
+			 NodeTypeSet(NodeType(NODE_CLASS)),
+			 SearchIndex::ELEMENT_SYMBOL | SearchIndex::ELEMENT_DEFINED |
+				 SearchIndex::ELEMENT_LANGUAGE_CXX),
+		 getShortPrefix},
+		{"java_short_prefix",
+		 SearchIndex::Filter(
+			 NodeTypeSet::all(), SearchIndex::ELEMENT_SYMBOL | SearchIndex::ELEMENT_LANGUAGE_JAVA),
+		 getShortPrefix}};
+}
+
+void SearchIndexBenchmark::measureQueries(
+	const SearchIndex& index,
+	const std::vector<SymbolSetGenerator::Symbol>& symbols,
+	const QueryPattern& pattern,
+	std::ostream& out) const
+{
+	// every pattern uses the same symbols, so patterns can be compared
+	std::mt19937 random(m_settings.seed);
+	std::uniform_int_distribution<size_t> distribution(0, symbols.size() - 1);
+
+	std::vector<double> milliseconds;
+	size_t resultCount = 0;
+	for (size_t i = 0; i < m_settings.queryCount && !symbols.empty(); i++)
+	{
+		const std::wstring query = pattern.createQuery(symbols[distribution(random)].name);
+		if (query.empty())
+		{
+			continue;
+		}
+
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		resultCount += index
+						   .search(
+							   query,
+							   pattern.filter,
+							   getMaxResultCount(query),
+							   s_maxBestScoredResultsLength)
+						   .size();
+		milliseconds.push_back(utility::getMillisecondsSince(start));
+	}
+
+	writeLatencies(pattern.name, std::move(milliseconds), resultCount, out);
+}
+
+void SearchIndexBenchmark::measureThreadScaling(
+	const SearchIndex& index,
+	const std::vector<SymbolSetGenerator::Symbol>& symbols,
+	const QueryPattern& pattern,
+	std::ostream& out) const
+{
+	SearchIndex singleThreadedIndex(1);
+	singleThreadedIndex.setElementMemoryBudget(m_settings.elementMemoryBudget);
+	for (const SymbolSetGenerator::Symbol& symbol: symbols)
+	{
+		singleThreadedIndex.addNode(symbol.id, symbol.name, symbol.type, symbol.flags);
+	}
+	singleThreadedIndex.finishSetup();
+
+	std::mt19937 random(m_settings.seed);
+	std::uniform_int_distribution<size_t> distribution(0, symbols.size() - 1);
+
+	// both indices run each query in turn, so both see the same state of the machine
+	std::vector<double> singleThreadedMilliseconds;
+	std::vector<double> milliseconds;
+	for (size_t i = 0; i < m_settings.queryCount && !symbols.empty(); i++)
+	{
+		const std::wstring query = pattern.createQuery(symbols[distribution(random)].name);
+		if (query.empty())
+		{
+			continue;
+		}
+
+		const auto measureSearch = [&](const SearchIndex& searchedIndex) {
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			searchedIndex.search(
+				query, pattern.filter, getMaxResultCount(query), s_maxBestScoredResultsLength);
+			return utility::getMillisecondsSince(start);
+		};
+		singleThreadedMilliseconds.push_back(measureSearch(singleThreadedIndex));
+		milliseconds.push_back(measureSearch(index));
+	}
+
+	std::sort(singleThreadedMilliseconds.begin(), singleThreadedMilliseconds.end());
+	std::sort(milliseconds.begin(), milliseconds.end());
+	const double singleThreadedTotal =
+		std::accumulate(singleThreadedMilliseconds.begin(), singleThreadedMilliseconds.end(), 0.0);
+	const double total = std::accumulate(milliseconds.begin(), milliseconds.end(), 0.0);
+	const double queryCount = std::max<double>(milliseconds.size(), 1);
+
+	out << getResultPrefix("thread_scaling") << ", \"pattern\": \"" << pattern.name
+		<< "\", \"queries\": " << milliseconds.size()
+		<< ", \"single_thread_mean_ms\": " << singleThreadedTotal / queryCount
+		<< ", \"single_thread_p99_ms\": "
+		<< utility::getPercentile(singleThreadedMilliseconds, 99)
+		<< ", \"mean_ms\": " << total / queryCount
+		<< ", \"p99_ms\": " << utility::getPercentile(milliseconds, 99)
+		<< ", \"speedup\": " << (total > 0 ? singleThreadedTotal / total : 0.0) << "}"
+		<< std::endl;
+}
+
+void SearchIndexBenchmark::measureTyping(
+	const SearchIndex& index,
+	const std::vector<SymbolSetGenerator::Symbol>& symbols,
+	bool useCursor,
+	std::ostream& out) const
+{
+	std::mt19937 random(m_settings.seed);
+	std::uniform_int_distribution<size_t> distribution(0, symbols.size() - 1);
+
+	// each keystroke of typing the scope and name of a symbol is a query continuing the last one
+	std::vector<double> milliseconds;
+	size_t resultCount = 0;
+	for (size_t i = 0; i < std::max<size_t>(m_settings.queryCount / 5, 1) && !symbols.empty(); i++)
+	{
+		const std::wstring& name = symbols[distribution(random)].name;
+		const std::wstring typedName = getScopeName(name) + L"::" + getUnqualifiedName(name);
+
+		SearchIndex::SearchCursor cursor;
+		for (size_t length = 1; length <= typedName.size(); length++)
+		{
+			const std::wstring query = typedName.substr(0, length);
+
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+			resultCount += index
+							   .search(
+								   query,
+								   NodeTypeSet::all(),
+								   getMaxResultCount(query),
+								   s_maxBestScoredResultsLength,
+								   useCursor ? &cursor : nullptr)
+							   .size();
+			milliseconds.push_back(utility::getMillisecondsSince(start));
+		}
+	}
+
+	writeLatencies(
+		useCursor ? "typing" : "typing_without_cursor", std::move(milliseconds), resultCount, out);
+}
+
+void SearchIndexBenchmark::writeLatencies(
+	const std::string& pattern,
+	std::vector<double> milliseconds,
+	size_t resultCount,
+	std::ostream& out) const
+{
+	std::sort(milliseconds.begin(), milliseconds.end());
+	const double total = std::accumulate(milliseconds.begin(), milliseconds.end(), 0.0);
+	const double queryCount = std::max<double>(milliseconds.size(), 1);
+
+	out << getResultPrefix("query") << ", \"pattern\": \"" << pattern
+		<< "\", \"queries\": " << milliseconds.size()
+		<< ", \"mean_results\": " << resultCount / queryCount
+		<< ", \"mean_ms\": " << total / queryCount
+		<< ", \"p50_ms\": " << utility::getPercentile(milliseconds, 50)
+		<< ", \"p90_ms\": " << utility::getPercentile(milliseconds, 90)
+		<< ", \"p99_ms\": " << utility::getPercentile(milliseconds, 99)
+		<< ", \"max_ms\": " << (milliseconds.empty() ? 0.0 : milliseconds.back()) << "}"
+		<< std::endl;
+}
+
+std::string SearchIndexBenchmark::getResultPrefix(const std::string& metric) const
+{
+	std::stringstream ss;
+	ss << utility::getBenchmarkResultPrefix("search_index", m_settings.label) << ", \"shape\": \""
+	   << SymbolSetGenerator::shapeToString(m_settings.shape)
+	   << "\", \"symbols\": " << m_settings.symbolCount << ", \"seed\": " << m_settings.seed
+	   << ", \"threads\": " << m_settings.threadCount
+	   << ", \"element_memory_budget\": " << m_settings.elementMemoryBudget << ", \"metric\": \""
+	   << metric << "\"";
+	return ss.str();
+}
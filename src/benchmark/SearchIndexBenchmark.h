@@ -0,0 +1,73 @@
+#ifndef SEARCH_INDEX_BENCHMARK_H
+#define SEARCH_INDEX_BENCHMARK_H
+
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "SearchIndex.h"
+#include "SymbolSetGenerator.h"
+
+// Measures building a SearchIndex of a generated symbol set, its memory and the latencies of
+// typical autocompletion queries. Each measurement is written as one JSON object per line, so the
+// results of different commits can be collected and compared by scripts.
+class SearchIndexBenchmark
+{
+public:
+	struct Settings
+	{
+		size_t symbolCount = 100000;
+		SymbolSetGenerator::Shape shape = SymbolSetGenerator::SHAPE_MIXED;
+		unsigned int seed = 1;
+		size_t queryCount = 50;
+		size_t threadCount = 0;
+		size_t elementMemoryBudget = 0;
+		std::string label;
+	};
+
+	SearchIndexBenchmark(const Settings& settings);
+
+	void run(std::ostream& out);
+
+private:
+	struct QueryPattern
+	{
+		std::string name;
+		SearchIndex::Filter filter;
+		// creates a query from the name of a symbol of the index
+		std::function<std::wstring(const std::wstring&)> createQuery;
+	};
+
+	static std::vector<QueryPattern> getQueryPatterns();
+
+	void measureQueries(
+		const SearchIndex& index,
+		const std::vector<SymbolSetGenerator::Symbol>& symbols,
+		const QueryPattern& pattern,
+		std::ostream& out) const;
+	// compares the queries on the configured threads to the same queries on a single thread
+	void measureThreadScaling(
+		const SearchIndex& index,
+		const std::vector<SymbolSetGenerator::Symbol>& symbols,
+		const QueryPattern& pattern,
+		std::ostream& out) const;
+	// without a cursor each keystroke searches the whole index again
+	void measureTyping(
+		const SearchIndex& index,
+		const std::vector<SymbolSetGenerator::Symbol>& symbols,
+		bool useCursor,
+		std::ostream& out) const;
+
+	void writeLatencies(
+		const std::string& pattern,
+		std::vector<double> milliseconds,
+		size_t resultCount,
+		std::ostream& out) const;
+	// starts a JSON object with the settings of the run
+	std::string getResultPrefix(const std::string& metric) const;
+
+	const Settings m_settings;
+};
+
+#endif	  // SEARCH_INDEX_BENCHMARK_H
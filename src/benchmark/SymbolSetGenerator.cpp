@@ -0,0 +1,240 @@
+#include "SymbolSetGenerator.h"
+
+#include <cwctype>
+
+namespace
+{
+const std::vector<std::wstring> s_words = {
+	L"get", L"set", L"value", L"node", L"index", L"storage", L"file", L"path", L"type", L"name",
+	L"search", L"result", L"token", L"edge", L"graph", L"view", L"controller", L"message",
+	L"handler", L"task", L"thread", L"buffer", L"stream", L"reader", L"writer", L"parser", L"lexer",
+	L"symbol", L"scope", L"context", L"config", L"project", L"source", L"location", L"range",
+	L"item", L"list", L"map", L"cache", L"entry", L"count", L"size", L"create", L"update",
+	L"remove", L"insert", L"find", L"load", L"save", L"build", L"visit", L"resolve", L"compute",
+	L"format", L"is", L"has", L"default", L"internal", L"detail", L"base", L"impl", L"abstract",
+	L"manager"};
+
+const std::vector<std::wstring> s_builtinTypes = {
+	L"int", L"bool", L"char", L"double", L"size_t", L"std::string", L"std::wstring"};
+
+const std::vector<std::wstring> s_templates = {
+	L"std::vector", L"std::map", L"std::shared_ptr", L"std::pair", L"std::function", L"Optional"};
+
+std::wstring capitalize(std::wstring word)
+{
+	word[0] = towupper(word[0]);
+	return word;
+}
+}	 // namespace
+
+std::vector<SymbolSetGenerator::Shape> SymbolSetGenerator::getAllShapes()
+{
+	return {SHAPE_FLAT, SHAPE_DEEP_NAMESPACES, SHAPE_LONG_TEMPLATES, SHAPE_OVERLOADS, SHAPE_MIXED};
+}
+
+std::string SymbolSetGenerator::shapeToString(Shape shape)
+{
+	switch (shape)
+	{
+	case SHAPE_FLAT:
+		return "flat";
+	case SHAPE_DEEP_NAMESPACES:
+		return "deep_namespaces";
+	case SHAPE_LONG_TEMPLATES:
+		return "long_templates";
+	case SHAPE_OVERLOADS:
+		return "overloads";
+	case SHAPE_MIXED:
+		return "mixed";
+	}
+	return "";
+}
+
+bool SymbolSetGenerator::stringToShape(const std::string& name, Shape* shape)
+{
+	for (Shape s: getAllShapes())
+	{
+		if (shapeToString(s) == name)
+		{
+			*shape = s;
+			return true;
+		}
+	}
+	return false;
+}
+
+SymbolSetGenerator::SymbolSetGenerator(Shape shape, unsigned int seed)
+	: m_shape(shape), m_random(seed)
+{
+}
+
+std::vector<SymbolSetGenerator::Symbol> SymbolSetGenerator::generate(size_t count)
+{
+	std::vector<Symbol> symbols;
+	symbols.reserve(count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const Shape shape = m_shape == SHAPE_MIXED
+			? static_cast<Shape>(getRandomIndex(SHAPE_MIXED))
+			: m_shape;
+
+		NodeType type(NODE_SYMBOL);
+		std::wstring name = createSymbolName(shape, &type);
+
+		// every fourth symbol is only referenced, like the symbols of libraries
+		const SearchIndex::ElementFlags flags = SearchIndex::ELEMENT_SYMBOL |
+			SearchIndex::ELEMENT_LANGUAGE_CXX |
+			(getRandomIndex(4) ? SearchIndex::ELEMENT_DEFINED : SearchIndex::ELEMENT_NON_INDEXED);
+
+		symbols.push_back({static_cast<Id>(i + 1), std::move(name), type, flags});
+	}
+
+	return symbols;
+}
+
+std::wstring SymbolSetGenerator::createSymbolName(Shape shape, NodeType* type)
+{
+	switch (shape)
+	{
+	case SHAPE_DEEP_NAMESPACES:
+		if (getRandomIndex(3) == 0)
+		{
+			*type = NodeType(NODE_CLASS);
+			return createNamespace(3, 8) + L"::" + createTypeName();
+		}
+		*type = NodeType(NODE_METHOD);
+		return createNamespace(3, 8) + L"::" + createTypeName() + L"::" + createFunctionName();
+
+	case SHAPE_LONG_TEMPLATES:
+	{
+		std::wstring arguments;
+		for (size_t i = 0, argumentCount = 2 + getRandomIndex(4); i < argumentCount; i++)
+		{
+			arguments += (i ? L", " : L"") + createTemplateArgument(0);
+		}
+		*type = NodeType(getRandomIndex(2) ? NODE_METHOD : NODE_FIELD);
+		return createNamespace(1, 2) + L"::" + createTypeName() + L"<" + arguments + L">::" +
+			createFunctionName();
+	}
+
+	case SHAPE_OVERLOADS:
+		// names are shared by about twenty symbols, as the search index ignores signatures
+		if (m_overloadedNames.empty() || getRandomIndex(20) == 0)
+		{
+			m_overloadedNames.push_back(
+				createNamespace(1, 3) + L"::" + createTypeName() + L"::" + createFunctionName());
+		}
+		*type = NodeType(NODE_METHOD);
+		return m_overloadedNames[getRandomIndex(m_overloadedNames.size())];
+
+	case SHAPE_FLAT:
+	case SHAPE_MIXED:
+		break;
+	}
+
+	switch (getRandomIndex(3))
+	{
+	case 0:
+		*type = NodeType(NODE_CLASS);
+		return createNamespace(1, 1) + L"::" + createTypeName();
+	case 1:
+		*type = NodeType(NODE_FUNCTION);
+		return createNamespace(1, 1) + L"::" + createFunctionName();
+	default:
+		*type = NodeType(NODE_FIELD);
+		return createNamespace(1, 1) + L"::" + createTypeName() + L"::m_" + createWord();
+	}
+}
+
+std::wstring SymbolSetGenerator::createWord()
+{
+	return s_words[getRandomIndex(s_words.size())];
+}
+
+std::wstring SymbolSetGenerator::createTypeName()
+{
+	if (m_typeNames.size() < 200 || getRandomIndex(10) == 0)
+	{
+		std::wstring name;
+		for (size_t i = 0, wordCount = 1 + getRandomIndex(3); i < wordCount; i++)
+		{
+			name += capitalize(createWord());
+		}
+		m_typeNames.push_back(name);
+		return name;
+	}
+	return m_typeNames[getRandomIndex(m_typeNames.size())];
+}
+
+std::wstring SymbolSetGenerator::createFunctionName()
+{
+	std::wstring name = createWord();
+	for (size_t i = 0, wordCount = getRandomIndex(3); i < wordCount; i++)
+	{
+		name += capitalize(createWord());
+	}
+	return name;
+}
+
+std::wstring SymbolSetGenerator::createNamespace(size_t minDepth, size_t maxDepth)
+{
+	const size_t depth = minDepth + getRandomIndex(maxDepth - minDepth + 1);
+
+	// extend a namespace of the pool, so deep namespaces form a tree
+	std::wstring name;
+	size_t nameDepth = 0;
+	if (!m_namespaces.empty() && getRandomIndex(8))
+	{
+		name = m_namespaces[getRandomIndex(m_namespaces.size())];
+		nameDepth = 1;
+		for (size_t pos = name.find(L"::"); pos != std::wstring::npos;
+			 pos = name.find(L"::", pos + 2))
+		{
+			nameDepth++;
+			if (nameDepth > depth)
+			{
+				name = name.substr(0, pos);
+				nameDepth = depth;
+				break;
+			}
+		}
+	}
+
+	for (; nameDepth < depth; nameDepth++)
+	{
+		name += (name.empty() ? L"" : L"::") + createWord();
+	}
+
+	if (m_namespaces.size() < 1000)
+	{
+		m_namespaces.push_back(name);
+	}
+	return name;
+}
+
+std::wstring SymbolSetGenerator::createTemplateArgument(size_t depth)
+{
+	switch (depth < 2 ? getRandomIndex(3) : getRandomIndex(2))
+	{
+	case 0:
+		return s_builtinTypes[getRandomIndex(s_builtinTypes.size())];
+	case 1:
+		return createNamespace(1, 2) + L"::" + createTypeName();
+	default:
+	{
+		std::wstring argument = s_templates[getRandomIndex(s_templates.size())] + L"<" +
+			createTemplateArgument(depth + 1);
+		if (getRandomIndex(2))
+		{
+			argument += L", " + createTemplateArgument(depth + 1);
+		}
+		return argument + L">";
+	}
+	}
+}
+
+size_t SymbolSetGenerator::getRandomIndex(size_t count)
+{
+	return std::uniform_int_distribution<size_t>(0, count - 1)(m_random);
+}
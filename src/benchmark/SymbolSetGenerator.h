@@ -0,0 +1,64 @@
+#ifndef SYMBOL_SET_GENERATOR_H
+#define SYMBOL_SET_GENERATOR_H
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "NodeType.h"
+#include "SearchIndex.h"
+#include "types.h"
+
+// Generates reproducible sets of qualified symbol names that are shaped like the symbols of real
+// code bases, so the search index can be measured without indexing a project.
+class SymbolSetGenerator
+{
+public:
+	enum Shape
+	{
+		SHAPE_FLAT,				  // short names in a few namespaces
+		SHAPE_DEEP_NAMESPACES,	  // names nested in up to eight namespaces and classes
+		SHAPE_LONG_TEMPLATES,	  // members of template specializations with long arguments
+		SHAPE_OVERLOADS,		  // many symbols sharing the same name, like overloaded functions
+		SHAPE_MIXED				  // all of the above
+	};
+
+	struct Symbol
+	{
+		Id id;
+		std::wstring name;
+		NodeType type;
+		SearchIndex::ElementFlags flags;
+	};
+
+	static std::vector<Shape> getAllShapes();
+	static std::string shapeToString(Shape shape);
+	// returns false if the name doesn't belong to a shape
+	static bool stringToShape(const std::string& name, Shape* shape);
+
+	SymbolSetGenerator(Shape shape, unsigned int seed);
+
+	std::vector<Symbol> generate(size_t count);
+
+private:
+	std::wstring createSymbolName(Shape shape, NodeType* type);
+
+	std::wstring createWord();
+	std::wstring createTypeName();
+	std::wstring createFunctionName();
+	std::wstring createNamespace(size_t minDepth, size_t maxDepth);
+	std::wstring createTemplateArgument(size_t depth);
+
+	size_t getRandomIndex(size_t count);
+
+	const Shape m_shape;
+	std::mt19937 m_random;
+
+	// names are picked from pools that grow while generating, so symbols share prefixes like the
+	// symbols of a real code base
+	std::vector<std::wstring> m_namespaces;
+	std::vector<std::wstring> m_typeNames;
+	std::vector<std::wstring> m_overloadedNames;
+};
+
+#endif	  // SYMBOL_SET_GENERATOR_H
@@ -0,0 +1,148 @@
+#include <fstream>
+#include <iostream>
+
+#include <boost/program_options.hpp>
+
+#include "language_packages.h"
+
+#include "CommandFetchBenchmark.h"
+#include "DatabaseMergeBenchmark.h"
+#include "FullTextSearchBenchmark.h"
+#include "PythonPostProcessingBenchmark.h"
+#include "SearchIndexBenchmark.h"
+#include "SymbolSetGenerator.h"
+
+namespace po = boost::program_options;
+
+int main(int argc, char* argv[])
+{
+	SearchIndexBenchmark::Settings settings;
+	std::string benchmarkName;
+	std::string shapeName;
+	std::string outputPath;
+	size_t elementMemoryBudgetMb = 0;
+
+	po::options_description options("Search Index Benchmark Options");
+	options.add_options()("help,h", "Print this help message")(
+		"benchmark,b",
+		po::value<std::string>(&benchmarkName)->default_value("search_index"),
+		"Benchmark to run: search_index, fulltext, database_merge, python_post_processing or "
+		"command_fetch (only with the C++ language package)")(
+		"symbols,n",
+		po::value<size_t>(&settings.symbolCount)->default_value(settings.symbolCount),
+		"Number of generated symbols")(
+		"shape",
+		po::value<std::string>(&shapeName)->default_value("all"),
+		"Shape of the generated symbols: flat, deep_namespaces, long_templates, overloads, mixed "
+		"or all")(
+		"seed",
+		po::value<unsigned int>(&settings.seed)->default_value(settings.seed),
+		"Random seed")(
+		"queries,q",
+		po::value<size_t>(&settings.queryCount)->default_value(settings.queryCount),
+		"Number of queries per query pattern")(
+		"threads,t",
+		po::value<size_t>(&settings.threadCount)->default_value(settings.threadCount),
+		"Number of search threads (0 uses the ideal thread count)")(
+		"memory-budget,m",
+		po::value<size_t>(&elementMemoryBudgetMb)->default_value(elementMemoryBudgetMb),
+		"Memory budget of the search index elements in MB (0 keeps all of them in memory)")(
+		"label,l",
+		po::value<std::string>(&settings.label),
+		"Label written to each result, e.g. the commit hash")(
+		"output,o",
+		po::value<std::string>(&outputPath),
+		"File the results are appended to (omit to write to stdout)");
+
+	po::variables_map vm;
+	try
+	{
+		po::store(po::parse_command_line(argc, argv, options), vm);
+		po::notify(vm);
+	}
+	catch (po::error& e)
+	{
+		std::cerr << "ERROR: " << e.what() << std::endl << std::endl;
+		std::cerr << options << std::endl;
+		return 1;
+	}
+
+	if (vm.count("help"))
+	{
+		std::cout << options << std::endl;
+		return 0;
+	}
+
+	settings.elementMemoryBudget = elementMemoryBudgetMb * 1024 * 1024;
+
+	std::vector<SymbolSetGenerator::Shape> shapes;
+	SymbolSetGenerator::Shape shape;
+	if (shapeName == "all")
+	{
+		shapes = SymbolSetGenerator::getAllShapes();
+	}
+	else if (SymbolSetGenerator::stringToShape(shapeName, &shape))
+	{
+		shapes.push_back(shape);
+	}
+	else
+	{
+		std::cerr << "ERROR: unknown shape \"" << shapeName << "\"" << std::endl;
+		return 1;
+	}
+
+	std::ofstream outputFile;
+	if (!outputPath.empty())
+	{
+		outputFile.open(outputPath, std::ios::app);
+		if (!outputFile)
+		{
+			std::cerr << "ERROR: can't open output file \"" << outputPath << "\"" << std::endl;
+			return 1;
+		}
+	}
+
+	std::ostream& out = outputPath.empty() ? std::cout : outputFile;
+
+	if (benchmarkName == "search_index")
+	{
+		for (SymbolSetGenerator::Shape s: shapes)
+		{
+			settings.shape = s;
+			SearchIndexBenchmark(settings).run(out);
+		}
+	}
+	else if (benchmarkName == "fulltext")
+	{
+		FullTextSearchBenchmark::Settings fullTextSettings;
+		fullTextSettings.label = settings.label;
+		FullTextSearchBenchmark(fullTextSettings).run(out);
+	}
+	else if (benchmarkName == "database_merge")
+	{
+		DatabaseMergeBenchmark::Settings mergeSettings;
+		mergeSettings.label = settings.label;
+		DatabaseMergeBenchmark(mergeSettings).run(out);
+	}
+	else if (benchmarkName == "python_post_processing")
+	{
+		PythonPostProcessingBenchmark::Settings postProcessingSettings;
+		postProcessingSettings.label = settings.label;
+		PythonPostProcessingBenchmark(postProcessingSettings).run(out);
+	}
+#if BUILD_CXX_LANGUAGE_PACKAGE
+	else if (benchmarkName == "command_fetch")
+	{
+		CommandFetchBenchmark::Settings fetchSettings;
+		fetchSettings.label = settings.label;
+		CommandFetchBenchmark(fetchSettings).run(out);
+	}
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+	else
+	{
+		std::cerr << "ERROR: unknown benchmark \"" << benchmarkName << "\"" << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
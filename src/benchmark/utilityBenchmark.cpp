@@ -0,0 +1,61 @@
+#include "utilityBenchmark.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <boost/filesystem.hpp>
+
+#include "FileSystem.h"
+
+double utility::getMillisecondsSince(const std::chrono::steady_clock::time_point& start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+		.count();
+}
+
+double utility::getPercentile(const std::vector<double>& sortedValues, double percentile)
+{
+	if (sortedValues.empty())
+	{
+		return 0;
+	}
+
+	const size_t rank = static_cast<size_t>(std::ceil(percentile / 100 * sortedValues.size()));
+	return sortedValues[std::max<size_t>(rank, 1) - 1];
+}
+
+std::string utility::escapeJson(const std::string& s)
+{
+	std::string escaped;
+	for (char c: s)
+	{
+		if (c == '"' || c == '\\')
+		{
+			escaped += '\\';
+		}
+		escaped += c;
+	}
+	return escaped;
+}
+
+std::string utility::getBenchmarkResultPrefix(
+	const std::string& benchmark, const std::string& label)
+{
+	return "{\"benchmark\": \"" + benchmark + "\", \"label\": \"" + escapeJson(label) + "\"";
+}
+
+FilePath utility::createBenchmarkDirectory(const std::string& benchmark)
+{
+	const FilePath directoryPath(
+		(boost::filesystem::temp_directory_path() /
+		 boost::filesystem::unique_path("sourcetrail_" + benchmark + "_%%%%-%%%%-%%%%-%%%%"))
+			.wstring());
+	FileSystem::createDirectory(directoryPath);
+	return directoryPath;
+}
+
+void utility::removeBenchmarkDirectory(const FilePath& directoryPath)
+{
+	boost::system::error_code ec;
+	boost::filesystem::remove_all(directoryPath.getPath(), ec);
+}
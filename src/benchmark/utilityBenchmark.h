@@ -0,0 +1,29 @@
+#ifndef UTILITY_BENCHMARK_H
+#define UTILITY_BENCHMARK_H
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "FilePath.h"
+
+namespace utility
+{
+double getMillisecondsSince(const std::chrono::steady_clock::time_point& start);
+
+// nearest rank percentile of sorted values
+double getPercentile(const std::vector<double>& sortedValues, double percentile);
+
+std::string escapeJson(const std::string& s);
+
+// Starts the JSON object of one result line. The benchmarks append their settings and values and
+// close it, so the results of different commits can be collected and compared by scripts.
+std::string getBenchmarkResultPrefix(const std::string& benchmark, const std::string& label);
+
+// Creates an empty directory for the files of a benchmark in the temporary directory, which is
+// removed again with all its files by removeBenchmarkDirectory().
+FilePath createBenchmarkDirectory(const std::string& benchmark);
+void removeBenchmarkDirectory(const FilePath& directoryPath);
+}	 // namespace utility
+
+#endif	  // UTILITY_BENCHMARK_H
@@ -10,6 +10,7 @@
 #include "LanguagePackageManager.h"
 #include "LogManager.h"
 #include "logging.h"
+#include "utilityMemory.h"
 
 #if BUILD_CXX_LANGUAGE_PACKAGE
 #	include "LanguagePackageCxx.h"
@@ -48,6 +49,10 @@ int main(int argc, char* argv[])
 	std::string appPath;
 	std::string userDataPath;
 	std::string logFilePath;
+	size_t memoryLimitMb = 0;
+	bool lowMemoryMode = false;
+	IndexerCommandType batchIndexerCommandType = INDEXER_COMMAND_UNKNOWN;
+	size_t batchThreadCount = 0;
 
 	if (argc >= 2)
 	{
@@ -71,7 +76,35 @@ int main(int argc, char* argv[])
 
 	if (argc >= 6)
 	{
-		logFilePath = argv[5];
+		try
+		{
+			memoryLimitMb = std::stoul(argv[5]);
+		}
+		catch (const std::exception&)
+		{
+			// an unparsable memory limit disables the limit instead of crashing the indexer
+			memoryLimitMb = 0;
+		}
+	}
+
+	if (argc >= 7)
+	{
+		lowMemoryMode = std::string(argv[6]) == "1";
+	}
+
+	if (argc >= 8)
+	{
+		batchIndexerCommandType = stringToIndexerCommandType(argv[7]);
+	}
+
+	if (argc >= 9)
+	{
+		batchThreadCount = std::stoul(argv[8]);
+	}
+
+	if (argc >= 10)
+	{
+		logFilePath = argv[9];
 	}
 
 	AppPath::setSharedDataPath(FilePath(appPath));
@@ -100,8 +133,36 @@ int main(int argc, char* argv[])
 	LanguagePackageManager::getInstance()->addPackage(std::make_shared<LanguagePackageJava>());
 #endif	  // BUILD_JAVA_LANGUAGE_PACKAGE
 
-	InterprocessIndexer indexer(instanceUuid, processId);
+	const size_t memoryLimit = memoryLimitMb << 20;
+	if (memoryLimit)
+	{
+		// the indexer monitors its memory usage and quits gracefully when exceeding the limit, the
+		// hard limit only catches allocation spikes between two checks
+		if (!utility::setProcessMemoryLimit(memoryLimit + memoryLimit / 2))
+		{
+			LOG_WARNING("Unable to set memory limit of indexer process.");
+		}
+		LOG_INFO("memory limit: " + std::to_string(memoryLimitMb) + " MB");
+	}
+
+	const int storageChunkSizeMb = appSettings->getIndexerStorageChunkSizeMb();
+	const size_t storageChunkByteSize =
+		storageChunkSizeMb > 0 ? static_cast<size_t>(storageChunkSizeMb) << 20 : 0;
+
+	InterprocessIndexer indexer(
+		instanceUuid,
+		processId,
+		memoryLimit,
+		lowMemoryMode,
+		batchIndexerCommandType,
+		batchThreadCount,
+		storageChunkByteSize);
 	indexer.work();
 
+	if (indexer.hasExceededMemoryLimit())
+	{
+		return InterprocessIndexer::s_memoryLimitExceededExitCode;
+	}
+
 	return 0;
 }
@@ -26,3 +26,8 @@ FilePath UserPaths::getLogPath()
 {
 	return getUserDataPath().concatenate(L"log/");
 }
+
+FilePath UserPaths::getJavaCachePath()
+{
+	return getUserDataPath().concatenate(L"java_cache/");
+}
@@ -14,6 +14,7 @@ public:
 	static FilePath getAppSettingsPath();
 	static FilePath getWindowSettingsPath();
 	static FilePath getLogPath();
+	static FilePath getJavaCachePath();
 
 private:
 	static FilePath s_userDataPath;
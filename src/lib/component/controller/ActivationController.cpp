@@ -147,6 +147,8 @@ void ActivationController::handleMessage(MessageSearch* message)
 		{
 		case SearchMatch::COMMAND_ALL:
 		case SearchMatch::COMMAND_NODE_FILTER:
+		case SearchMatch::COMMAND_DEFINITION_FILTER:
+		case SearchMatch::COMMAND_LANGUAGE_FILTER:
 		{
 			MessageActivateOverview msg(message->acceptedNodeTypes);
 			msg.setSchedulerId(message->getSchedulerId());
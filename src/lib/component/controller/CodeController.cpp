@@ -65,17 +65,11 @@ void CodeController::handleMessage(MessageActivateFullTextSearch* message)
 
 	saveOrRestoreViewMode(message);
 
-	m_collection = m_storageAccess->getFullTextSearchLocations(
-		message->searchTerm, message->caseSensitive);
-
-	CodeView::CodeParams params;
-	params.clearSnippets = true;
-	params.useSingleFileCache = false;
+	m_fullTextSearchMessage = std::make_shared<MessageActivateFullTextSearch>(*message);
+	m_collection = std::make_shared<SourceLocationCollection>();
+	m_files.clear();
 
-	m_files = getFilesForCollection(m_collection);
-	createReferences();
-	expandVisibleFiles(params.useSingleFileCache);
-	showFiles(params, firstReferenceScrollParams(), !message->isReplayed());
+	showFullTextSearchLocations(false, !message->isReplayed());
 }
 
 void CodeController::handleMessage(MessageActivateLegend* message)
@@ -454,6 +448,12 @@ void CodeController::handleMessage(MessageFocusOut* message)
 	getView()->deCoFocusTokenIds();
 }
 
+void CodeController::handleMessage(MessageFullTextSearchInterrupted* message)
+{
+	// handled on the message loop thread while the search is running
+	m_fullTextSearchInterruptCount++;
+}
+
 void CodeController::handleMessage(MessageScrollToLine* message)
 {
 	getView()->scrollTo(
@@ -483,6 +483,17 @@ void CodeController::handleMessage(MessageShowError* message)
 	}
 }
 
+void CodeController::handleMessage(MessageShowMoreFullTextSearchResults* message)
+{
+	// the shown results are kept and the search continues where it stopped
+	if (m_fullTextSearchMessage)
+	{
+		m_fullTextSearchMessage->maxLocationCount +=
+			MessageActivateFullTextSearch::MAX_LOCATION_COUNT_STEP;
+		showFullTextSearchLocations(true, true);
+	}
+}
+
 void CodeController::handleMessage(MessageShowReference* message)
 {
 	m_referenceIndex = static_cast<int>(message->refIndex);
@@ -1659,6 +1670,74 @@ void CodeController::showFirstActiveReference(Id tokenId, bool updateView)
 	showFiles(m_codeParams, scrollParams, updateView);
 }
 
+void CodeController::showFullTextSearchLocations(bool continueSearch, bool updateView)
+{
+	CodeView::CodeParams params;
+	params.clearSnippets = !continueSearch;
+	params.useSingleFileCache = false;
+
+	// results are shown while searching, until a newer search interrupts this one
+	const size_t interruptCount = m_fullTextSearchInterruptCount;
+	auto onLocations = [&](std::shared_ptr<SourceLocationCollection> locations) {
+		if (m_fullTextSearchInterruptCount != interruptCount)
+		{
+			return false;
+		}
+
+		if (!locations->getSourceLocationCount())
+		{
+			return true;
+		}
+
+		for (CodeFileParams& file: getFilesForCollection(locations))
+		{
+			m_collection->addSourceLocationFile(file.locationFile);
+			m_files.push_back(file);
+		}
+
+		if (updateView)
+		{
+			createReferences();
+			expandVisibleFiles(params.useSingleFileCache);
+			showFiles(
+				params,
+				params.clearSnippets ? firstReferenceScrollParams() : CodeScrollParams(),
+				true);
+			params.clearSnippets = false;
+		}
+		return true;
+	};
+
+	if (continueSearch)
+	{
+		params.hasMoreResults = m_storageAccess->continueFullTextSearch(
+			&m_fullTextSearchCursor,
+			MessageActivateFullTextSearch::MAX_LOCATION_COUNT_STEP,
+			onLocations);
+	}
+	else
+	{
+		params.hasMoreResults = m_storageAccess->getFullTextSearchLocations(
+			m_fullTextSearchMessage->searchTerm,
+			m_fullTextSearchMessage->caseSensitive,
+			m_fullTextSearchMessage->maxLocationCount,
+			onLocations,
+			&m_fullTextSearchCursor);
+	}
+
+	if (m_fullTextSearchInterruptCount != interruptCount)
+	{
+		return;
+	}
+
+	createReferences();
+	expandVisibleFiles(params.useSingleFileCache);
+	showFiles(
+		params,
+		params.clearSnippets ? firstReferenceScrollParams() : CodeScrollParams(),
+		updateView);
+}
+
 void CodeController::showFiles(CodeView::CodeParams params, CodeScrollParams scrollParams, bool updateView)
 {
 	if (updateView)
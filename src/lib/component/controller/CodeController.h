@@ -1,10 +1,12 @@
 #ifndef CODE_CONTROLLER_H
 #define CODE_CONTROLLER_H
 
+#include <atomic>
 #include <map>
 #include <string>
 
 #include "FilePath.h"
+#include "FullTextSearchCursor.h"
 #include "LocationType.h"
 #include "MessageActivateErrors.h"
 #include "MessageActivateFullTextSearch.h"
@@ -23,10 +25,12 @@
 #include "MessageFocusChanged.h"
 #include "MessageFocusIn.h"
 #include "MessageFocusOut.h"
+#include "MessageFullTextSearchInterrupted.h"
 #include "MessageListener.h"
 #include "MessageScrollCode.h"
 #include "MessageScrollToLine.h"
 #include "MessageShowError.h"
+#include "MessageShowMoreFullTextSearchResults.h"
 #include "MessageShowReference.h"
 #include "MessageShowScope.h"
 #include "MessageToNextCodeReference.h"
@@ -60,9 +64,11 @@ class CodeController
 	, public MessageListener<MessageFlushUpdates>
 	, public MessageListener<MessageFocusIn>
 	, public MessageListener<MessageFocusOut>
+	, public MessageListener<MessageFullTextSearchInterrupted>
 	, public MessageListener<MessageScrollCode>
 	, public MessageListener<MessageScrollToLine>
 	, public MessageListener<MessageShowError>
+	, public MessageListener<MessageShowMoreFullTextSearchResults>
 	, public MessageListener<MessageShowReference>
 	, public MessageListener<MessageShowScope>
 	, public MessageListener<MessageToNextCodeReference>
@@ -102,9 +108,11 @@ private:
 	void handleMessage(MessageFlushUpdates* message) override;
 	void handleMessage(MessageFocusIn* message) override;
 	void handleMessage(MessageFocusOut* message) override;
+	void handleMessage(MessageFullTextSearchInterrupted* message) override;
 	void handleMessage(MessageScrollCode* message) override;
 	void handleMessage(MessageScrollToLine* message) override;
 	void handleMessage(MessageShowError* message) override;
+	void handleMessage(MessageShowMoreFullTextSearchResults* message) override;
 	void handleMessage(MessageShowReference* message) override;
 	void handleMessage(MessageShowScope* message) override;
 	void handleMessage(MessageToNextCodeReference* message) override;
@@ -167,6 +175,8 @@ private:
 	void saveOrRestoreViewMode(MessageBase* message);
 
 	void showFirstActiveReference(Id tokenId, bool updateView);
+	// continueSearch adds further results to the ones of the last fulltext search
+	void showFullTextSearchLocations(bool continueSearch, bool updateView);
 	void showFiles(CodeView::CodeParams params, CodeScrollParams scrollParams, bool updateView);
 
 	StorageAccess* m_storageAccess;
@@ -186,6 +196,10 @@ private:
 
 	std::vector<Reference> m_localReferences;
 	int m_localReferenceIndex = -1;
+
+	std::shared_ptr<MessageActivateFullTextSearch> m_fullTextSearchMessage;
+	FullTextSearchCursor m_fullTextSearchCursor;
+	std::atomic<size_t> m_fullTextSearchInterruptCount = 0;
 };
 
 #endif	  // CODE_CONTROLLER_H
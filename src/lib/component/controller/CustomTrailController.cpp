@@ -24,7 +24,7 @@ void CustomTrailController::autocomplete(const std::wstring query, bool from)
 	nodeTypes.remove(NodeType(NODE_PACKAGE));
 
 	getView()->showAutocompletions(
-		m_storageAccess->getAutocompletionMatches(query, nodeTypes, false), from);
+		m_storageAccess->getAutocompletionMatches(query, nodeTypes, SearchFilter(), false), from);
 }
 
 void CustomTrailController::activateTrail(MessageActivateTrail message)
@@ -61,7 +61,7 @@ void SearchController::handleMessage(MessageSearchAutocomplete* message)
 
 	LOG_INFO(L"autocomplete string: \"" + message->query + L"\"");
 	view->setAutocompletionList(m_storageAccess->getAutocompletionMatches(
-		message->query, message->acceptedNodeTypes, true));
+		message->query, message->acceptedNodeTypes, message->filter, true));
 }
 
 SearchView* SearchController::getView()
@@ -64,6 +64,8 @@ void UndoRedoController::handleMessage(MessageActivateFullTextSearch* message)
 		static_cast<MessageActivateFullTextSearch*>(lastMessage())->caseSensitive ==
 			message->caseSensitive)
 	{
+		static_cast<MessageActivateFullTextSearch*>(lastMessage())->maxLocationCount =
+			message->maxLocationCount;
 		return;
 	}
 
@@ -424,6 +426,26 @@ void UndoRedoController::handleMessage(MessageShowError* message)
 	processCommand(command);
 }
 
+void UndoRedoController::handleMessage(MessageShowMoreFullTextSearchResults* message)
+{
+	// the additional results are shown again when the fulltext search is replayed
+	std::list<Command>::iterator it = m_iterator;
+	while (it != m_list.begin())
+	{
+		std::advance(it, -1);
+		if (it->order == Command::ORDER_ACTIVATE)
+		{
+			if (MessageActivateFullTextSearch* fullTextSearchMessage =
+					dynamic_cast<MessageActivateFullTextSearch*>(it->message.get()))
+			{
+				fullTextSearchMessage->maxLocationCount +=
+					MessageActivateFullTextSearch::MAX_LOCATION_COUNT_STEP;
+			}
+			break;
+		}
+	}
+}
+
 void UndoRedoController::handleMessage(MessageShowReference* message)
 {
 	if (sameMessageTypeAsLast(message) &&
@@ -29,6 +29,7 @@
 #include "MessageScrollCode.h"
 #include "MessageScrollGraph.h"
 #include "MessageShowError.h"
+#include "MessageShowMoreFullTextSearchResults.h"
 #include "MessageShowReference.h"
 #include "MessageShowScope.h"
 
@@ -63,6 +64,7 @@ class UndoRedoController
 	, public MessageListener<MessageScrollCode>
 	, public MessageListener<MessageScrollGraph>
 	, public MessageListener<MessageShowError>
+	, public MessageListener<MessageShowMoreFullTextSearchResults>
 	, public MessageListener<MessageShowReference>
 	, public MessageListener<MessageShowScope>
 {
@@ -117,6 +119,7 @@ private:
 	void handleMessage(MessageScrollCode* message) override;
 	void handleMessage(MessageScrollGraph* message) override;
 	void handleMessage(MessageShowError* message) override;
+	void handleMessage(MessageShowMoreFullTextSearchResults* message) override;
 	void handleMessage(MessageShowReference* message) override;
 	void handleMessage(MessageShowScope* message) override;
 
@@ -38,6 +38,7 @@ public:
 		size_t referenceIndex = 0;
 		size_t localReferenceCount = 0;
 		size_t localReferenceIndex = 0;
+		bool hasMoreResults = false;
 
 		std::vector<Id> activeTokenIds;
 		std::vector<Id> activeLocationIds;
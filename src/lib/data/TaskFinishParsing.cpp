@@ -32,6 +32,9 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
 {
 	TimeStamp start = TimeStamp::now();
 
+	m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Building fulltext\nsearch index");
+	m_storage->updateFullTextSearchIndex();
+
 	m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Optimizing database");
 	m_storage->optimizeMemory();
 	m_dialogView->hideUnknownProgressDialog();
@@ -61,6 +64,15 @@ Task::TaskState TaskFinishParsing::doUpdate(std::shared_ptr<Blackboard> blackboa
 	bool interruptedIndexing = false;
 	blackboard->get("interrupted_indexing", interruptedIndexing);
 
+	if (interruptedIndexing)
+	{
+		m_storage->checkpointInjectedSourceFiles();
+	}
+	else
+	{
+		m_storage->setPendingSourceFiles({});
+	}
+
 	bool shallowIndexing = false;
 	blackboard->get("shallow_indexing", shallowIndexing);
 
@@ -1,11 +1,13 @@
 #include "TaskInjectStorage.h"
 
-#include "Storage.h"
+#include "PersistentStorage.h"
 #include "StorageProvider.h"
 
+const size_t TaskInjectStorage::s_checkpointIntervalMs = 10000;
+
 TaskInjectStorage::TaskInjectStorage(
-	std::shared_ptr<StorageProvider> storageProvider, std::weak_ptr<Storage> target)
-	: m_storageProvider(storageProvider), m_target(target)
+	std::shared_ptr<StorageProvider> storageProvider, std::weak_ptr<PersistentStorage> target)
+	: m_storageProvider(storageProvider), m_target(target), m_lastCheckpointTime(TimeStamp::now())
 {
 }
 
@@ -18,9 +20,19 @@ Task::TaskState TaskInjectStorage::doUpdate(std::shared_ptr<Blackboard> blackboa
 		std::shared_ptr<IntermediateStorage> source = m_storageProvider->consumeLargestStorage();
 		if (source)
 		{
-			if (std::shared_ptr<Storage> target = m_target.lock())
+			if (std::shared_ptr<PersistentStorage> target = m_target.lock())
 			{
 				target->inject(source.get());
+				target->addInjectedSourceFileChunkCounts(source->getSourceFileChunkCounts());
+
+				// the checkpoint is written periodically and whenever injection catches up, so a
+				// resumed run only needs to index the source files that were not injected before
+				if (m_storageProvider->getStorageCount() == 0 ||
+					TimeStamp::now().deltaMS(m_lastCheckpointTime) >= s_checkpointIntervalMs)
+				{
+					target->checkpointInjectedSourceFiles();
+					m_lastCheckpointTime = TimeStamp::now();
+				}
 				return STATE_SUCCESS;
 			}
 		}
@@ -6,8 +6,9 @@
 #include "MessageIndexingInterrupted.h"
 #include "MessageListener.h"
 #include "Task.h"
+#include "TimeStamp.h"
 
-class Storage;
+class PersistentStorage;
 class StorageProvider;
 
 class TaskInjectStorage
@@ -15,7 +16,8 @@ class TaskInjectStorage
 	, public MessageListener<MessageIndexingInterrupted>
 {
 public:
-	TaskInjectStorage(std::shared_ptr<StorageProvider> storageProvider, std::weak_ptr<Storage> target);
+	TaskInjectStorage(
+		std::shared_ptr<StorageProvider> storageProvider, std::weak_ptr<PersistentStorage> target);
 
 private:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -25,8 +27,12 @@ private:
 
 	void handleMessage(MessageIndexingInterrupted* message) override;
 
+	static const size_t s_checkpointIntervalMs;
+
 	std::shared_ptr<StorageProvider> m_storageProvider;
-	std::weak_ptr<Storage> m_target;
+	std::weak_ptr<PersistentStorage> m_target;
+
+	TimeStamp m_lastCheckpointTime;
 };
 
 #endif	  // TASK_INJECT_STORAGE_H
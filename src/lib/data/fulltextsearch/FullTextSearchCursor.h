@@ -0,0 +1,41 @@
+#ifndef FULLTEXT_SEARCH_CURSOR_H
+#define FULLTEXT_SEARCH_CURSOR_H
+
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "FullTextSearchIndex.h"
+#include "ParseLocation.h"
+#include "types.h"
+
+// State of a fulltext search that stopped after its maximum location count. The search continues
+// from here without searching the files again whose locations were already passed on.
+struct FullTextSearchCursor
+{
+	struct FileLocations
+	{
+		Id fileId;
+		std::vector<ParseLocation> locations;
+		size_t passedLocationCount;
+	};
+
+	void clear()
+	{
+		*this = FullTextSearchCursor();
+	}
+
+	std::wstring searchTerm;
+	bool caseSensitive = false;
+
+	std::vector<FullTextSearchResult> fileResults;
+	// the first file that was not searched yet
+	size_t nextFileIndex = 0;
+	// the searched files with locations that were not passed on yet, in the order of passing on
+	std::deque<FileLocations> pendingFileLocations;
+
+	size_t locationCount = 0;
+	size_t fileCount = 0;
+};
+
+#endif	  // FULLTEXT_SEARCH_CURSOR_H
@@ -1,9 +1,111 @@
 #include "FullTextSearchIndex.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
 #include <limits>
 
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "FilePath.h"
+#include "FileSystem.h"
+#include "ThreadPool.h"
+#include "TrigramQuery.h"
 #include "logging.h"
 #include "tracing.h"
 
+namespace
+{
+// The index file starts with a header, followed by the compact lower case text and suffix array of
+// each file (see SuffixArray), the indices of the files containing each trigram, a sorted table of
+// trigrams pointing to these file indices and a table of entries pointing to the arrays of each
+// file. All data is 8 byte aligned.
+const char s_indexFileMagic[8] = {'S', 'R', 'C', 'T', 'R', 'L', 'F', 'T'};
+const uint32_t s_indexFileVersion = 3;
+
+struct IndexFileHeader
+{
+	char magic[8];
+	uint32_t version;
+	uint32_t charSize;
+	uint64_t fileCount;
+	uint64_t entryOffset;
+	uint64_t trigramCount;
+	uint64_t trigramOffset;
+	char codecName[64];
+};
+
+struct IndexFileEntry
+{
+	uint64_t fileId;
+	uint64_t textOffset;
+	uint64_t textLength;
+	uint64_t arrayOffset;
+	uint32_t charSize;
+	uint32_t bitsPerIndex;
+	char modificationTime[24];
+};
+
+template <size_t N>
+void copyToField(char (&field)[N], const std::string& value)
+{
+	std::memset(field, 0, N);
+	std::memcpy(field, value.data(), std::min(value.size(), N - 1));
+}
+
+template <size_t N>
+std::string getFieldValue(const char (&field)[N])
+{
+	return std::string(field, strnlen(field, N));
+}
+
+// modification times are only stored up to the size of the field
+std::string getStoredModificationTime(const std::string& modificationTime)
+{
+	return modificationTime.substr(0, sizeof(IndexFileEntry::modificationTime) - 1);
+}
+
+bool isValidEntry(const IndexFileEntry& entry, uint64_t fileSize)
+{
+	if (entry.textLength >= static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+		(entry.charSize != 1 && entry.charSize != 2 && entry.charSize != 4))
+	{
+		return false;
+	}
+
+	const int textLength = static_cast<int>(entry.textLength);
+	if (static_cast<int>(entry.bitsPerIndex) != SuffixArray::getBitsPerIndex(textLength))
+	{
+		return false;
+	}
+
+	const uint64_t textByteSize = SuffixArray::getTextWordCount(textLength, entry.charSize) *
+		sizeof(uint64_t);
+	const uint64_t arrayByteSize = SuffixArray::getArrayWordCount(textLength, entry.bitsPerIndex) *
+		sizeof(uint64_t);
+	return entry.textOffset + textByteSize <= fileSize &&
+		entry.arrayOffset + arrayByteSize <= fileSize;
+}
+
+uint64_t writeBlock(std::ofstream& out, uint64_t& offset, const void* data, uint64_t byteSize)
+{
+	const uint64_t blockOffset = offset;
+	out.write(static_cast<const char*>(data), byteSize);
+
+	const char padding[8] = {};
+	const uint64_t paddingSize = (8 - byteSize % 8) % 8;
+	out.write(padding, paddingSize);
+
+	offset += byteSize + paddingSize;
+	return blockOffset;
+}
+}	 // namespace
+
+FullTextSearchIndex::FullTextSearchIndex() = default;
+
+FullTextSearchIndex::~FullTextSearchIndex() = default;
+
 void FullTextSearchIndex::addFile(Id fileId, const std::wstring& fileContent)
 {
 	if (fileContent.empty())
@@ -17,10 +119,16 @@ void FullTextSearchIndex::addFile(Id fileId, const std::wstring& fileContent)
 	}
 
 	FullTextSearchFile fts_file(fileId, SuffixArray(fileContent));
+	const std::wstring text = fts_file.array.getText();
+	const std::vector<uint64_t> trigrams = TrigramQuery::getTrigrams(text.data(), text.size());
 
 	{
 		std::lock_guard<std::mutex> lock(m_filesMutex);
-		m_files.push_back(fts_file);
+		for (uint64_t trigram: trigrams)
+		{
+			m_fileIndicesForTrigrams[trigram].push_back(m_files.size());
+		}
+		m_files.push_back(std::move(fts_file));
 	}
 }
 
@@ -42,19 +150,346 @@ std::vector<FullTextSearchResult> FullTextSearchIndex::searchForTerm(const std::
 				ret.push_back(hit);
 			}
 		}
+
+		for (const MappedFile& f: m_mappedFiles)
+		{
+			FullTextSearchResult hit;
+			hit.fileId = f.fileId;
+			hit.positions = SuffixArray::searchForTerm(term, f.data);
+			if (!hit.positions.empty())
+			{
+				ret.push_back(hit);
+			}
+		}
 	}
 
 	return ret;
 }
 
+std::vector<Id> FullTextSearchIndex::getFilesForTrigramQuery(const TrigramQuery& query) const
+{
+	TRACE();
+
+	std::vector<Id> fileIds;
+	{
+		std::lock_guard<std::mutex> lock(m_filesMutex);
+		for (size_t index: query.evaluate(m_files.size(), [this](uint64_t trigram) {
+				 auto it = m_fileIndicesForTrigrams.find(trigram);
+				 return it != m_fileIndicesForTrigrams.end() ? it->second : std::vector<size_t>();
+			 }))
+		{
+			fileIds.push_back(m_files[index].fileId);
+		}
+
+		for (size_t index: query.evaluate(m_mappedFiles.size(), [this](uint64_t trigram) {
+				 return getMappedFileIndicesForTrigram(trigram);
+			 }))
+		{
+			fileIds.push_back(m_mappedFiles[index].fileId);
+		}
+	}
+	return fileIds;
+}
+
 size_t FullTextSearchIndex::fileCount() const
 {
 	std::lock_guard<std::mutex> lock(m_filesMutex);
-	return m_files.size();
+	return m_files.size() + m_mappedFiles.size();
 }
 
 void FullTextSearchIndex::clear()
 {
 	std::lock_guard<std::mutex> lock(m_filesMutex);
 	m_files.clear();
+	m_fileIndicesForTrigrams.clear();
+	unmapFile();
+}
+
+bool FullTextSearchIndex::loadFile(const FilePath& filePath, const std::string& codecName)
+{
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+	return mapFile(filePath, codecName);
+}
+
+bool FullTextSearchIndex::isUpToDate(const std::vector<FullTextSearchFileInfo>& files) const
+{
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+	if (!m_mappedRegion || files.size() != m_mappedFiles.size())
+	{
+		return false;
+	}
+
+	for (const FullTextSearchFileInfo& file: files)
+	{
+		auto it = m_mappedFileIndices.find(file.fileId);
+		if (it == m_mappedFileIndices.end() ||
+			m_mappedFiles[it->second].modificationTime !=
+				getStoredModificationTime(file.modificationTime))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FullTextSearchIndex::updateFile(
+	const FilePath& filePath,
+	const std::string& codecName,
+	const std::vector<FullTextSearchFileInfo>& files,
+	std::function<std::wstring(Id)> getFileText)
+{
+	TRACE();
+
+	std::lock_guard<std::mutex> lock(m_filesMutex);
+
+	const FilePath tempFilePath(filePath.wstr() + L"_tmp");
+	size_t copiedFileCount = 0;
+	{
+		std::ofstream out(tempFilePath.str(), std::ios::binary | std::ios::trunc);
+		if (!out.is_open())
+		{
+			LOG_ERROR(L"Unable to write fulltext search index file: " + tempFilePath.wstr());
+			return false;
+		}
+
+		IndexFileHeader header = {};
+		std::memcpy(header.magic, s_indexFileMagic, sizeof(header.magic));
+		header.version = s_indexFileVersion;
+		header.charSize = sizeof(wchar_t);
+		header.fileCount = files.size();
+		copyToField(header.codecName, codecName);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		std::vector<IndexFileEntry> entries(files.size());
+		uint64_t offset = sizeof(header);
+		std::mutex outMutex;
+
+		const auto writeFile = [&](size_t index, const SuffixArray::Data& data) {
+			std::lock_guard<std::mutex> outLock(outMutex);
+			IndexFileEntry& entry = entries[index];
+			entry.fileId = files[index].fileId;
+			copyToField(entry.modificationTime, files[index].modificationTime);
+			entry.textLength = data.textLength;
+			entry.charSize = data.charSize;
+			entry.bitsPerIndex = data.bitsPerIndex;
+			entry.textOffset = writeBlock(
+				out,
+				offset,
+				data.text,
+				SuffixArray::getTextWordCount(data.textLength, data.charSize) * sizeof(uint64_t));
+			entry.arrayOffset = writeBlock(
+				out,
+				offset,
+				data.array,
+				SuffixArray::getArrayWordCount(data.textLength, data.bitsPerIndex) *
+					sizeof(uint64_t));
+		};
+
+		std::vector<const MappedFile*> upToDateFiles(files.size(), nullptr);
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			auto it = m_mappedFileIndices.find(files[i].fileId);
+			if (it != m_mappedFileIndices.end() &&
+				m_mappedFiles[it->second].modificationTime ==
+					getStoredModificationTime(files[i].modificationTime))
+			{
+				upToDateFiles[i] = &m_mappedFiles[it->second];
+				copiedFileCount++;
+			}
+		}
+
+		std::vector<std::vector<uint64_t>> fileTrigrams(files.size());
+		ThreadPool::getInstance()->parallelFor(files.size(), [&](size_t index) {
+			if (const MappedFile* mappedFile = upToDateFiles[index])
+			{
+				const std::wstring text = SuffixArray::getText(mappedFile->data);
+				fileTrigrams[index] = TrigramQuery::getTrigrams(text.data(), text.size());
+				writeFile(index, mappedFile->data);
+				return;
+			}
+
+			const SuffixArray array(getFileText(files[index].fileId));
+			const std::wstring text = array.getText();
+			fileTrigrams[index] = TrigramQuery::getTrigrams(text.data(), text.size());
+			writeFile(index, array.getData());
+		});
+
+		std::unordered_map<uint64_t, std::vector<uint32_t>> fileIndicesForTrigrams;
+		for (size_t i = 0; i < fileTrigrams.size(); i++)
+		{
+			for (uint64_t trigram: fileTrigrams[i])
+			{
+				fileIndicesForTrigrams[trigram].push_back(static_cast<uint32_t>(i));
+			}
+			std::vector<uint64_t>().swap(fileTrigrams[i]);
+		}
+
+		std::vector<MappedTrigram> trigrams;
+		trigrams.reserve(fileIndicesForTrigrams.size());
+		for (const auto& it: fileIndicesForTrigrams)
+		{
+			MappedTrigram trigram;
+			trigram.trigram = it.first;
+			trigram.fileIndexCount = it.second.size();
+			trigram.fileIndexOffset = writeBlock(
+				out, offset, it.second.data(), it.second.size() * sizeof(uint32_t));
+			trigrams.push_back(trigram);
+		}
+		std::sort(
+			trigrams.begin(), trigrams.end(), [](const MappedTrigram& a, const MappedTrigram& b) {
+				return a.trigram < b.trigram;
+			});
+
+		header.trigramCount = trigrams.size();
+		header.trigramOffset = writeBlock(
+			out, offset, trigrams.data(), trigrams.size() * sizeof(MappedTrigram));
+
+		header.entryOffset = offset;
+		for (const IndexFileEntry& entry: entries)
+		{
+			writeBlock(out, offset, &entry, sizeof(entry));
+		}
+
+		out.seekp(0);
+		out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		if (!out.good())
+		{
+			LOG_ERROR(L"Unable to write fulltext search index file: " + tempFilePath.wstr());
+			out.close();
+			FileSystem::remove(tempFilePath);
+			return false;
+		}
+	}
+
+	// the old file needs to be unmapped before it can be replaced
+	unmapFile();
+	try
+	{
+		FileSystem::remove(filePath);
+		FileSystem::rename(tempFilePath, filePath);
+	}
+	catch (std::exception& e)
+	{
+		LOG_ERROR("Unable to replace fulltext search index file: " + std::string(e.what()));
+		return false;
+	}
+
+	LOG_INFO(
+		"Updated fulltext search index: " + std::to_string(files.size() - copiedFileCount) +
+		" files indexed, " + std::to_string(copiedFileCount) + " files up to date");
+
+	return mapFile(filePath, codecName);
+}
+
+bool FullTextSearchIndex::mapFile(const FilePath& filePath, const std::string& codecName)
+{
+	unmapFile();
+
+	if (!filePath.recheckExists())
+	{
+		return false;
+	}
+
+	try
+	{
+		boost::interprocess::file_mapping mapping(
+			filePath.str().c_str(), boost::interprocess::read_only);
+		m_mappedRegion = std::make_unique<boost::interprocess::mapped_region>(
+			mapping, boost::interprocess::read_only);
+	}
+	catch (boost::interprocess::interprocess_exception& e)
+	{
+		LOG_ERROR("Unable to map fulltext search index file: " + std::string(e.what()));
+		return false;
+	}
+
+	const char* data = static_cast<const char*>(m_mappedRegion->get_address());
+	const uint64_t size = m_mappedRegion->get_size();
+
+	const IndexFileHeader* header = reinterpret_cast<const IndexFileHeader*>(data);
+	if (size < sizeof(IndexFileHeader) ||
+		std::memcmp(header->magic, s_indexFileMagic, sizeof(header->magic)) != 0 ||
+		header->version != s_indexFileVersion || header->charSize != sizeof(wchar_t) ||
+		getFieldValue(header->codecName) != codecName || header->entryOffset > size ||
+		header->fileCount > (size - header->entryOffset) / sizeof(IndexFileEntry) ||
+		header->fileCount > std::numeric_limits<uint32_t>::max() ||
+		header->trigramOffset > size ||
+		header->trigramCount > (size - header->trigramOffset) / sizeof(MappedTrigram))
+	{
+		LOG_INFO(L"Fulltext search index file is outdated: " + filePath.wstr());
+		unmapFile();
+		return false;
+	}
+
+	const IndexFileEntry* entries = reinterpret_cast<const IndexFileEntry*>(
+		data + header->entryOffset);
+	for (uint64_t i = 0; i < header->fileCount; i++)
+	{
+		const IndexFileEntry& entry = entries[i];
+		if (!isValidEntry(entry, size))
+		{
+			LOG_ERROR(L"Fulltext search index file is broken: " + filePath.wstr());
+			unmapFile();
+			return false;
+		}
+
+		MappedFile mappedFile;
+		mappedFile.fileId = static_cast<Id>(entry.fileId);
+		mappedFile.modificationTime = getFieldValue(entry.modificationTime);
+		mappedFile.data.text = reinterpret_cast<const uint64_t*>(data + entry.textOffset);
+		mappedFile.data.array = reinterpret_cast<const uint64_t*>(data + entry.arrayOffset);
+		mappedFile.data.textLength = static_cast<int>(entry.textLength);
+		mappedFile.data.charSize = static_cast<int>(entry.charSize);
+		mappedFile.data.bitsPerIndex = static_cast<int>(entry.bitsPerIndex);
+
+		m_mappedFileIndices[mappedFile.fileId] = m_mappedFiles.size();
+		m_mappedFiles.push_back(mappedFile);
+	}
+
+	m_mappedTrigrams = reinterpret_cast<const MappedTrigram*>(data + header->trigramOffset);
+	m_mappedTrigramCount = header->trigramCount;
+
+	return true;
+}
+
+void FullTextSearchIndex::unmapFile()
+{
+	m_mappedFiles.clear();
+	m_mappedFileIndices.clear();
+	m_mappedTrigrams = nullptr;
+	m_mappedTrigramCount = 0;
+	m_mappedRegion.reset();
+}
+
+std::vector<size_t> FullTextSearchIndex::getMappedFileIndicesForTrigram(uint64_t trigram) const
+{
+	std::vector<size_t> fileIndices;
+
+	const MappedTrigram* end = m_mappedTrigrams + m_mappedTrigramCount;
+	const MappedTrigram* it = std::lower_bound(
+		m_mappedTrigrams, end, trigram, [](const MappedTrigram& mappedTrigram, uint64_t trigram) {
+			return mappedTrigram.trigram < trigram;
+		});
+	if (it == end || it->trigram != trigram)
+	{
+		return fileIndices;
+	}
+
+	// the file indices are only checked when used, so mapping the file doesn't need to read them
+	if (it->fileIndexOffset + it->fileIndexCount * sizeof(uint32_t) > m_mappedRegion->get_size())
+	{
+		LOG_ERROR("Fulltext search index file is broken, ignoring trigram");
+		return fileIndices;
+	}
+
+	const uint32_t* indices = reinterpret_cast<const uint32_t*>(
+		static_cast<const char*>(m_mappedRegion->get_address()) + it->fileIndexOffset);
+	for (uint64_t i = 0; i < it->fileIndexCount; i++)
+	{
+		if (indices[i] < m_mappedFiles.size())
+		{
+			fileIndices.push_back(indices[i]);
+		}
+	}
+	return fileIndices;
 }
@@ -1,14 +1,28 @@
 #ifndef FULLTEXTSEARCH_INDEX_H
 #define FULLTEXTSEARCH_INDEX_H
 
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "SuffixArray.h"
 #include "types.h"
 
+namespace boost
+{
+namespace interprocess
+{
+class mapped_region;
+}
+}	 // namespace boost
+
+class FilePath;
 class StorageAccess;
+class TrigramQuery;
 
 // contains all fulltextsearch results of one file
 struct FullTextSearchResult
@@ -19,24 +33,84 @@ struct FullTextSearchResult
 
 struct FullTextSearchFile
 {
-	FullTextSearchFile(Id fileId, SuffixArray array): fileId(fileId), array(array) {};
+	FullTextSearchFile(Id fileId, SuffixArray array): fileId(fileId), array(std::move(array)) {};
 	Id fileId;
 	SuffixArray array;
 };
 
+// identifies the version of a file's content that is indexed
+struct FullTextSearchFileInfo
+{
+	FullTextSearchFileInfo(Id fileId, const std::string& modificationTime)
+		: fileId(fileId), modificationTime(modificationTime) {};
+	Id fileId;
+	std::string modificationTime;
+};
+
+// Files are either added to memory or kept in an index file that is memory mapped for searching,
+// so the suffix arrays are neither rebuilt nor loaded when a project is opened.
 class FullTextSearchIndex
 {
 public:
+	FullTextSearchIndex();
+	~FullTextSearchIndex();
+
 	void addFile(Id fileId, const std::wstring& file);
 	std::vector<FullTextSearchResult> searchForTerm(const std::wstring& term) const;
 
+	// returns the ids of all files that contain the trigrams required by the query, which is a
+	// superset of the files matching the regular expression the query was created from
+	std::vector<Id> getFilesForTrigramQuery(const TrigramQuery& query) const;
+
 	size_t fileCount() const;
 
 	void clear();
 
+	// maps the index file for searching, returns false if the file is missing, broken or was built
+	// with a different text codec
+	bool loadFile(const FilePath& filePath, const std::string& codecName);
+
+	// returns whether the mapped index file holds exactly the given versions of the files
+	bool isUpToDate(const std::vector<FullTextSearchFileInfo>& files) const;
+
+	// Writes an index file of the given files and maps it. The index of a file that is up to date
+	// in the currently mapped index file is copied, other files are indexed from the text returned
+	// by getFileText, which may be called from several threads at once.
+	bool updateFile(
+		const FilePath& filePath,
+		const std::string& codecName,
+		const std::vector<FullTextSearchFileInfo>& files,
+		std::function<std::wstring(Id)> getFileText);
+
 private:
+	struct MappedFile
+	{
+		Id fileId;
+		std::string modificationTime;
+		SuffixArray::Data data;
+	};
+
+	struct MappedTrigram
+	{
+		uint64_t trigram;
+		uint64_t fileIndexOffset;
+		uint64_t fileIndexCount;
+	};
+
+	bool mapFile(const FilePath& filePath, const std::string& codecName);
+	void unmapFile();
+
+	std::vector<size_t> getMappedFileIndicesForTrigram(uint64_t trigram) const;
+
 	mutable std::mutex m_filesMutex;
 	std::vector<FullTextSearchFile> m_files;
+	std::unordered_map<uint64_t, std::vector<size_t>> m_fileIndicesForTrigrams;
+
+	std::unique_ptr<boost::interprocess::mapped_region> m_mappedRegion;
+	std::vector<MappedFile> m_mappedFiles;
+	std::unordered_map<Id, size_t> m_mappedFileIndices;
+	const MappedTrigram* m_mappedTrigrams = nullptr;
+	size_t m_mappedTrigramCount = 0;
 };
 
 #endif	  // FULLTEXTSEARCH_INDEX_H
@@ -1,137 +1,276 @@
 #include "SuffixArray.h"
 
 #include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <string>
 
+namespace
+{
 struct suffix
 {
 	int index;
 	int rank[2];
 };
 
-int SuffixArray::cmp(const struct suffix& a, const struct suffix& b)
+int cmp(const struct suffix& a, const struct suffix& b)
 {
 	return (a.rank[0] == b.rank[0]) ? (a.rank[1] < b.rank[1] ? 1 : 0)
 									: (a.rank[0] < b.rank[0] ? 1 : 0);
 }
 
-SuffixArray::SuffixArray(const std::wstring& text): m_text(text)
+int getCharSize(const std::wstring& text)
 {
-	std::transform(m_text.begin(), m_text.end(), m_text.begin(), ::towlower);
-	m_array = buildSuffixArray();
-	m_lcp = buildLCP();
+	uint32_t maxChar = 0;
+	for (wchar_t c: text)
+	{
+		maxChar = std::max(maxChar, static_cast<uint32_t>(c));
+	}
+	return maxChar <= 0xFF ? 1 : (maxChar <= 0xFFFF ? 2 : 4);
 }
 
-void SuffixArray::printArray() const
+template <typename CharType>
+void packText(const std::wstring& text, std::vector<uint64_t>& words)
 {
-	std::cout << "Suffix Array : \n";
-	printArr(m_array);
-	for (size_t i = 0; i < m_array.size(); i++)
+	const std::vector<CharType> chars(text.begin(), text.end());
+	if (!chars.empty())
 	{
-		std::wstring suffix = m_text.substr(m_array[i]);
-		std::wcout << i << ": \"" << suffix << "\"" << std::endl;
+		std::memcpy(words.data(), chars.data(), chars.size() * sizeof(CharType));
 	}
 }
 
-void SuffixArray::printLCP() const
+template <typename CharType>
+void unpackText(const SuffixArray::Data& data, std::wstring& text)
+{
+	const CharType* chars = reinterpret_cast<const CharType*>(data.text);
+	text.assign(chars, chars + data.textLength);
+}
+
+int getIndex(const uint64_t* array, int bitsPerIndex, int i)
 {
-	std::cout << "\nLCP Array : \n";
-	printArr(m_lcp);
-	for (size_t i = 0; i < m_array.size(); i++)
+	const uint64_t bitOffset = static_cast<uint64_t>(i) * bitsPerIndex;
+	const uint64_t word = bitOffset / 64;
+	const int shift = static_cast<int>(bitOffset % 64);
+
+	uint64_t value = array[word] >> shift;
+	if (shift + bitsPerIndex > 64)
 	{
-		std::wstring prefix = m_text.substr(m_array[i], m_lcp[i]);
-		std::wcout << i << ": \"" << prefix << "\"" << std::endl;
+		value |= array[word + 1] << (64 - shift);
 	}
+	return static_cast<int>(value & ((uint64_t(1) << bitsPerIndex) - 1));
 }
 
-std::vector<int> SuffixArray::buildLCP()
+void setIndex(std::vector<uint64_t>& array, int bitsPerIndex, int i, int index)
 {
-	const int n = static_cast<int>(m_array.size());
+	const uint64_t bitOffset = static_cast<uint64_t>(i) * bitsPerIndex;
+	const uint64_t word = bitOffset / 64;
+	const int shift = static_cast<int>(bitOffset % 64);
 
-	std::vector<int> lcp(n, 0);
-	std::vector<int> invSuff(n, 0);
-
-	for (int i = 0; i < n; i++)
+	array[word] |= static_cast<uint64_t>(index) << shift;
+	if (shift + bitsPerIndex > 64)
 	{
-		invSuff[m_array[i]] = i;
+		array[word + 1] |= static_cast<uint64_t>(index) >> (64 - shift);
 	}
+}
 
-	int k = 0;
-
-	for (int i = 0; i < n; i++)
+// returns the first position in [first, last) for which isRight is true, isRight has to be false
+// for all positions before and true for all positions after it
+template <typename Predicate>
+int partitionPoint(int first, int last, Predicate isRight)
+{
+	while (first < last)
 	{
-		if (invSuff[i] == n - 1)
+		const int middle = first + (last - first) / 2;
+		if (isRight(middle))
 		{
-			k = 0;
-			continue;
+			last = middle;
 		}
+		else
+		{
+			first = middle + 1;
+		}
+	}
+	return first;
+}
 
-		int j = m_array[invSuff[i] + 1];
-
-		while (i + k < n && j + k < n && m_text[i + k] == m_text[j + k])
+template <typename CharType>
+std::vector<int> searchText(const std::wstring& term, const SuffixArray::Data& data)
+{
+	std::vector<CharType> termChars;
+	for (wchar_t c: term)
+	{
+		// the text can't contain a character that doesn't fit its character size
+		if (static_cast<uint32_t>(c) > std::numeric_limits<CharType>::max())
 		{
-			k++;
+			return {};
 		}
+		termChars.push_back(static_cast<CharType>(c));
+	}
 
-		lcp[invSuff[i]] = k;
+	const CharType* text = reinterpret_cast<const CharType*>(data.text);
+	const int textLength = data.textLength;
+	const int termLength = static_cast<int>(termChars.size());
 
-		if (k > 0)
+	// same as comparing the term to the substring of the text starting at the suffix
+	auto compareToSuffix = [&](int i) {
+		const int suffix = getIndex(data.array, data.bitsPerIndex, i);
+		const int suffixLength = std::min(termLength, textLength - suffix);
+		for (int k = 0; k < suffixLength; k++)
 		{
-			k--;
+			if (termChars[k] != text[suffix + k])
+			{
+				return termChars[k] < text[suffix + k] ? -1 : 1;
+			}
 		}
+		return termLength - suffixLength;
+	};
+
+	// the suffixes starting with the term are a contiguous range of the suffix array
+	const int lower = partitionPoint(
+		0, textLength, [&compareToSuffix](int i) { return compareToSuffix(i) <= 0; });
+	const int upper = partitionPoint(
+		lower, textLength, [&compareToSuffix](int i) { return compareToSuffix(i) < 0; });
+
+	std::vector<int> matches;
+	matches.reserve(upper - lower);
+	for (int i = lower; i < upper; i++)
+	{
+		matches.push_back(getIndex(data.array, data.bitsPerIndex, i));
 	}
 
-	return lcp;
+	std::sort(matches.begin(), matches.end());
+
+	return matches;
 }
+}	 // namespace
 
-std::vector<int> SuffixArray::searchForTerm(const std::wstring& searchTerm) const
+int SuffixArray::getBitsPerIndex(int textLength)
+{
+	int bitsPerIndex = 1;
+	while ((int64_t(1) << bitsPerIndex) < textLength)
+	{
+		bitsPerIndex++;
+	}
+	return bitsPerIndex;
+}
+
+size_t SuffixArray::getTextWordCount(int textLength, int charSize)
+{
+	return (static_cast<uint64_t>(textLength) * charSize + 7) / 8;
+}
+
+size_t SuffixArray::getArrayWordCount(int textLength, int bitsPerIndex)
+{
+	return (static_cast<uint64_t>(textLength) * bitsPerIndex + 63) / 64;
+}
+
+std::vector<int> SuffixArray::searchForTerm(const std::wstring& searchTerm, const Data& data)
 {
 	std::wstring term = searchTerm;
 	std::transform(term.begin(), term.end(), term.begin(), ::towlower);
 
-	const int termLength = static_cast<int>(term.length());
-	const int textLength = static_cast<int>(m_text.length());
-	int l = -1;
-	int r = textLength;
-	int m;
+	switch (data.charSize)
+	{
+	case 1:
+		return searchText<uint8_t>(term, data);
+	case 2:
+		return searchText<uint16_t>(term, data);
+	default:
+		return searchText<uint32_t>(term, data);
+	}
+}
+
+std::wstring SuffixArray::getText(const Data& data)
+{
+	std::wstring text;
+	switch (data.charSize)
+	{
+	case 1:
+		unpackText<uint8_t>(data, text);
+		break;
+	case 2:
+		unpackText<uint16_t>(data, text);
+		break;
+	default:
+		unpackText<uint32_t>(data, text);
+		break;
+	}
+	return text;
+}
+
+SuffixArray::SuffixArray(const std::wstring& text)
+{
+	std::wstring lowerText = text;
+	std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::towlower);
+
+	m_textLength = static_cast<int>(lowerText.length());
+	m_charSize = getCharSize(lowerText);
+	m_bitsPerIndex = getBitsPerIndex(m_textLength);
 
-	std::vector<int> matches;
-	int compareResult;
-	while (l + 1 < r)
+	m_text.resize(getTextWordCount(m_textLength, m_charSize), 0);
+	switch (m_charSize)
 	{
-		m = (l + r + 1) / 2;
-		compareResult = term.compare(m_text.substr(m_array[m], termLength));
-		if (compareResult < 0)
-		{
-			r = m;
-		}
-		else if (compareResult > 0)
-		{
-			l = m;
-		}
-		else
-		{
-			matches.push_back(m_array[m]);
-			for (int lower = m - 1; lower >= 0 && m_lcp[lower] >= termLength; lower--)
-			{
-				matches.push_back(m_array[lower]);
-			}
-			for (int higher = m + 1; higher < textLength && m_lcp[higher - 1] >= termLength; higher++)
-			{
-				matches.push_back(m_array[higher]);
-			}
-			break;
-		}
+	case 1:
+		packText<uint8_t>(lowerText, m_text);
+		break;
+	case 2:
+		packText<uint16_t>(lowerText, m_text);
+		break;
+	default:
+		packText<uint32_t>(lowerText, m_text);
+		break;
 	}
 
-	std::sort(matches.begin(), matches.end());
+	const std::vector<int> array = buildSuffixArray(lowerText);
+	m_array.resize(getArrayWordCount(m_textLength, m_bitsPerIndex), 0);
+	for (int i = 0; i < m_textLength; i++)
+	{
+		setIndex(m_array, m_bitsPerIndex, i, array[i]);
+	}
+}
 
-	return matches;
+std::vector<int> SuffixArray::searchForTerm(const std::wstring& searchTerm) const
+{
+	return searchForTerm(searchTerm, getData());
+}
+
+SuffixArray::Data SuffixArray::getData() const
+{
+	Data data;
+	data.text = m_text.data();
+	data.array = m_array.data();
+	data.textLength = m_textLength;
+	data.charSize = m_charSize;
+	data.bitsPerIndex = m_bitsPerIndex;
+	return data;
+}
+
+std::wstring SuffixArray::getText() const
+{
+	return getText(getData());
+}
+
+size_t SuffixArray::getByteSize() const
+{
+	return (m_text.size() + m_array.size()) * sizeof(uint64_t);
+}
+
+void SuffixArray::printArray() const
+{
+	const std::wstring text = getText();
+
+	std::cout << "Suffix Array : \n";
+	for (int i = 0; i < m_textLength; i++)
+	{
+		const int index = getIndex(m_array.data(), m_bitsPerIndex, i);
+		std::wcout << i << ": " << index << " \"" << text.substr(index) << "\"" << std::endl;
+	}
 }
 
-std::vector<int> SuffixArray::buildSuffixArray()
+std::vector<int> SuffixArray::buildSuffixArray(const std::wstring& text)
 {
-	const int n = static_cast<int>(m_text.length());
+	const int n = static_cast<int>(text.length());
 	std::vector<suffix> suffixes;
 	suffixes.reserve(n);
 
@@ -139,12 +278,12 @@ std::vector<int> SuffixArray::buildSuffixArray()
 	for (int i = 0; i < n; i++)
 	{
 		s.index = i;
-		s.rank[0] = m_text[i];
-		s.rank[1] = ((i + 1) < n) ? (m_text[i + 1]) : -1;
+		s.rank[0] = text[i];
+		s.rank[1] = ((i + 1) < n) ? (text[i + 1]) : -1;
 		suffixes.push_back(s);
 	}
 
-	std::sort(suffixes.begin(), suffixes.end(), SuffixArray::cmp);
+	std::sort(suffixes.begin(), suffixes.end(), cmp);
 
 	std::vector<int> ind(n, 0);
 	for (int k = 4; k < 2 * n; k = k * 2)
@@ -1,36 +1,59 @@
 #ifndef SUFFIX_ARRAY_H
 #define SUFFIX_ARRAY_H
 
+#include <cstdint>
 #include <iostream>
 #include <string>
 #include <vector>
 
+// Suffix array of the lower case text of a file in a compact layout. The text is kept with the
+// smallest character size that holds all of its characters, which is a single byte for almost all
+// source files, and each entry of the suffix array only takes as many bits as are needed to
+// address the text. Terms are found with two binary searches, so no LCP array is needed.
 class SuffixArray
 {
 public:
+	// Text and suffix array of a file, either owned by a SuffixArray or stored elsewhere, e.g. in a
+	// memory mapped file. Both are stored in 64 bit words, the array holds textLength entries of
+	// bitsPerIndex bits each.
+	struct Data
+	{
+		const uint64_t* text = nullptr;
+		const uint64_t* array = nullptr;
+		int textLength = 0;
+		int charSize = 1;
+		int bitsPerIndex = 1;
+	};
+
+	static int getBitsPerIndex(int textLength);
+	static size_t getTextWordCount(int textLength, int charSize);
+	static size_t getArrayWordCount(int textLength, int bitsPerIndex);
+
+	// searches the text of a suffix array that is stored elsewhere
+	static std::vector<int> searchForTerm(const std::wstring& searchTerm, const Data& data);
+
+	// returns the lower case text
+	static std::wstring getText(const Data& data);
+
 	SuffixArray(const std::wstring& text);
 	std::vector<int> searchForTerm(const std::wstring& searchTerm) const;
-	static int cmp(const struct suffix& a, const struct suffix& b);
+
+	Data getData() const;
+	std::wstring getText() const;
+
+	// memory used by text and suffix array
+	size_t getByteSize() const;
 
 	void printArray() const;
-	void printLCP() const;
 
 private:
-	template <typename T>
-	void printArr(std::vector<T> arr) const
-	{
-		for (size_t i = 0; i < arr.size(); i++)
-		{
-			std::cout << arr[i] << " ";
-		}
-		std::cout << std::endl;
-	}
-
-	std::vector<int> buildLCP();
-	std::vector<int> buildSuffixArray();
-	std::vector<int> m_array;
-	std::vector<int> m_lcp;
-	std::wstring m_text;
+	static std::vector<int> buildSuffixArray(const std::wstring& text);
+
+	std::vector<uint64_t> m_text;
+	std::vector<uint64_t> m_array;
+	int m_textLength;
+	int m_charSize;
+	int m_bitsPerIndex;
 };
 
 #endif	  // SUFFIX_ARRAY_H
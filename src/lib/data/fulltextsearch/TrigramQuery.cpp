@@ -0,0 +1,767 @@
+#include "TrigramQuery.h"
+
+#include <algorithm>
+#include <cwctype>
+#include <iterator>
+#include <set>
+
+#include "utility.h"
+
+namespace
+{
+// sets of exact strings are turned into trigram queries once they would grow beyond this size
+const size_t s_maxExactStringCount = 16;
+
+// Information about the texts matched by a part of a regular expression. If exact is true, every
+// match is one of the strings. In any case a text containing a match satisfies the query.
+struct RegexInfo
+{
+	bool exact = false;
+	std::set<std::wstring> strings;
+	TrigramQuery query;
+};
+
+RegexInfo getEmptyInfo()
+{
+	RegexInfo info;
+	info.exact = true;
+	info.strings.insert(L"");
+	return info;
+}
+
+RegexInfo getAnyInfo()
+{
+	return RegexInfo();
+}
+
+RegexInfo getCharactersInfo(const std::set<wchar_t>& characters)
+{
+	std::set<wchar_t> lowerCharacters;
+	for (wchar_t c: characters)
+	{
+		lowerCharacters.insert(static_cast<wchar_t>(towlower(c)));
+	}
+
+	if (lowerCharacters.size() > s_maxExactStringCount)
+	{
+		return getAnyInfo();
+	}
+
+	RegexInfo info;
+	info.exact = true;
+	for (wchar_t c: lowerCharacters)
+	{
+		info.strings.insert(std::wstring(1, c));
+	}
+	return info;
+}
+
+TrigramQuery getQuery(const RegexInfo& info)
+{
+	if (!info.exact)
+	{
+		return info.query;
+	}
+
+	TrigramQuery stringsQuery(TrigramQuery::OPERATION_NONE);
+	for (const std::wstring& str: info.strings)
+	{
+		stringsQuery = stringsQuery.orWith(TrigramQuery::fromString(str));
+	}
+	return info.query.andWith(stringsQuery);
+}
+
+RegexInfo getQueryInfo(const TrigramQuery& query)
+{
+	RegexInfo info;
+	info.query = query;
+	return info;
+}
+
+RegexInfo concatenate(const RegexInfo& a, const RegexInfo& b)
+{
+	if (a.exact && b.exact && a.strings.size() * b.strings.size() <= s_maxExactStringCount)
+	{
+		RegexInfo info;
+		info.exact = true;
+		for (const std::wstring& aString: a.strings)
+		{
+			for (const std::wstring& bString: b.strings)
+			{
+				info.strings.insert(aString + bString);
+			}
+		}
+		info.query = a.query.andWith(b.query);
+		return info;
+	}
+
+	return getQueryInfo(getQuery(a).andWith(getQuery(b)));
+}
+
+RegexInfo alternate(const RegexInfo& a, const RegexInfo& b)
+{
+	if (a.exact && b.exact && a.strings.size() + b.strings.size() <= s_maxExactStringCount)
+	{
+		RegexInfo info;
+		info.exact = true;
+		info.strings = a.strings;
+		info.strings.insert(b.strings.begin(), b.strings.end());
+		info.query = a.query.orWith(b.query);
+		return info;
+	}
+
+	return getQueryInfo(getQuery(a).orWith(getQuery(b)));
+}
+
+RegexInfo makeOptional(const RegexInfo& info)
+{
+	if (info.exact && info.strings.size() < s_maxExactStringCount)
+	{
+		RegexInfo optionalInfo;
+		optionalInfo.exact = true;
+		optionalInfo.strings = info.strings;
+		optionalInfo.strings.insert(L"");
+		return optionalInfo;
+	}
+	return getAnyInfo();
+}
+
+// Parses the ECMAScript syntax used by std::wregex. The regular expression is expected to be
+// valid, anything that is not understood is treated as matching any text.
+class RegexParser
+{
+public:
+	RegexParser(const std::wstring& regex): m_regex(regex), m_pos(0) {}
+
+	RegexInfo parse()
+	{
+		RegexInfo info = parseAlternation();
+		if (m_pos < m_regex.size())
+		{
+			return getAnyInfo();
+		}
+		return info;
+	}
+
+private:
+	bool isEnd() const
+	{
+		return m_pos >= m_regex.size();
+	}
+
+	wchar_t peek() const
+	{
+		return m_regex[m_pos];
+	}
+
+	bool consume(wchar_t c)
+	{
+		if (!isEnd() && peek() == c)
+		{
+			m_pos++;
+			return true;
+		}
+		return false;
+	}
+
+	RegexInfo parseAlternation()
+	{
+		RegexInfo info = parseConcatenation();
+		while (consume(L'|'))
+		{
+			info = alternate(info, parseConcatenation());
+		}
+		return info;
+	}
+
+	RegexInfo parseConcatenation()
+	{
+		// exact parts are collected until they can't be combined anymore, so their trigrams
+		// don't get lost when they follow a part that isn't exact
+		TrigramQuery query;
+		RegexInfo exactInfo = getEmptyInfo();
+		while (!isEnd() && peek() != L'|' && peek() != L')')
+		{
+			const RegexInfo info = parseRepetition();
+			const RegexInfo concatenatedInfo = concatenate(exactInfo, info);
+			if (concatenatedInfo.exact)
+			{
+				exactInfo = concatenatedInfo;
+			}
+			else if (info.exact)
+			{
+				query = query.andWith(getQuery(exactInfo));
+				exactInfo = info;
+			}
+			else
+			{
+				query = query.andWith(getQuery(exactInfo)).andWith(getQuery(info));
+				exactInfo = getEmptyInfo();
+			}
+		}
+
+		if (query.getOperation() == TrigramQuery::OPERATION_ALL)
+		{
+			return exactInfo;
+		}
+		return getQueryInfo(query.andWith(getQuery(exactInfo)));
+	}
+
+	RegexInfo parseRepetition()
+	{
+		RegexInfo info = parseAtom();
+		while (!isEnd())
+		{
+			if (consume(L'*'))
+			{
+				info = getAnyInfo();
+			}
+			else if (consume(L'+'))
+			{
+				info = getQueryInfo(getQuery(info));
+			}
+			else if (consume(L'?'))
+			{
+				info = makeOptional(info);
+			}
+			else if (peek() == L'{')
+			{
+				size_t minCount = 0;
+				size_t maxCount = 0;
+				if (!parseRange(minCount, maxCount))
+				{
+					break;
+				}
+
+				if (maxCount == 0)
+				{
+					info = getEmptyInfo();
+				}
+				else if (minCount == 0 && maxCount == 1)
+				{
+					info = makeOptional(info);
+				}
+				else if (minCount == 0)
+				{
+					info = getAnyInfo();
+				}
+				else
+				{
+					info = getQueryInfo(getQuery(info));
+				}
+			}
+			else
+			{
+				break;
+			}
+
+			// lazy quantifier
+			consume(L'?');
+		}
+		return info;
+	}
+
+	// parses "{n}", "{n,}" and "{n,m}", maxCount is not zero for an unbounded range
+	bool parseRange(size_t& minCount, size_t& maxCount)
+	{
+		const size_t startPos = m_pos;
+		m_pos++;
+
+		if (!parseNumber(minCount))
+		{
+			m_pos = startPos;
+			return false;
+		}
+
+		maxCount = minCount;
+		if (consume(L','))
+		{
+			maxCount = minCount + 1;
+			parseNumber(maxCount);
+		}
+
+		if (!consume(L'}'))
+		{
+			m_pos = startPos;
+			return false;
+		}
+		return true;
+	}
+
+	bool parseNumber(size_t& number)
+	{
+		if (isEnd() || !iswdigit(peek()))
+		{
+			return false;
+		}
+
+		number = 0;
+		while (!isEnd() && iswdigit(peek()))
+		{
+			number = std::min<size_t>(number * 10 + (m_regex[m_pos++] - L'0'), 1000000);
+		}
+		return true;
+	}
+
+	RegexInfo parseAtom()
+	{
+		const wchar_t c = m_regex[m_pos++];
+		switch (c)
+		{
+		case L'.':
+		case L'*':
+		case L'+':
+		case L'?':
+			return getAnyInfo();
+		case L'^':
+		case L'$':
+			return getEmptyInfo();
+		case L'(':
+			return parseGroup();
+		case L'[':
+			return parseClass();
+		case L'\\':
+		{
+			wchar_t escapedChar = 0;
+			switch (parseEscape(escapedChar, false))
+			{
+			case ESCAPE_CHARACTER:
+				return getCharactersInfo({escapedChar});
+			case ESCAPE_ASSERTION:
+				return getEmptyInfo();
+			default:
+				return getAnyInfo();
+			}
+		}
+		default:
+			return getCharactersInfo({c});
+		}
+	}
+
+	RegexInfo parseGroup()
+	{
+		bool isAssertion = false;
+		if (m_regex.compare(m_pos, 2, L"?:") == 0)
+		{
+			m_pos += 2;
+		}
+		else if (m_regex.compare(m_pos, 2, L"?=") == 0 || m_regex.compare(m_pos, 2, L"?!") == 0)
+		{
+			m_pos += 2;
+			isAssertion = true;
+		}
+
+		RegexInfo info = parseAlternation();
+		consume(L')');
+
+		if (isAssertion)
+		{
+			return getEmptyInfo();
+		}
+		return info;
+	}
+
+	RegexInfo parseClass()
+	{
+		const bool negated = consume(L'^');
+		bool matchesAny = negated;
+		std::set<wchar_t> characters;
+
+		while (!isEnd() && peek() != L']')
+		{
+			wchar_t first = 0;
+			if (!parseClassCharacter(first))
+			{
+				matchesAny = true;
+				continue;
+			}
+
+			if (m_pos + 1 < m_regex.size() && peek() == L'-' && m_regex[m_pos + 1] != L']')
+			{
+				m_pos++;
+				wchar_t last = 0;
+				if (!parseClassCharacter(last) || last < first ||
+					static_cast<size_t>(last - first) >= s_maxExactStringCount)
+				{
+					matchesAny = true;
+					continue;
+				}
+				for (wchar_t rangeChar = first; rangeChar <= last; rangeChar++)
+				{
+					characters.insert(rangeChar);
+				}
+			}
+			else
+			{
+				characters.insert(first);
+			}
+		}
+		consume(L']');
+
+		if (matchesAny)
+		{
+			return getAnyInfo();
+		}
+		return getCharactersInfo(characters);
+	}
+
+	// returns false for character classes like "\w" or "[:alpha:]"
+	bool parseClassCharacter(wchar_t& c)
+	{
+		if (m_regex.compare(m_pos, 2, L"[:") == 0 || m_regex.compare(m_pos, 2, L"[=") == 0 ||
+			m_regex.compare(m_pos, 2, L"[.") == 0)
+		{
+			const size_t endPos = m_regex.find(L']', m_pos + 2);
+			m_pos = endPos == std::wstring::npos ? m_regex.size() : endPos + 1;
+			return false;
+		}
+
+		c = m_regex[m_pos++];
+		if (c == L'\\')
+		{
+			return parseEscape(c, true) == ESCAPE_CHARACTER;
+		}
+		return true;
+	}
+
+	enum EscapeType
+	{
+		ESCAPE_CHARACTER,
+		ESCAPE_ASSERTION,
+		ESCAPE_OTHER
+	};
+
+	EscapeType parseEscape(wchar_t& c, bool inClass)
+	{
+		if (isEnd())
+		{
+			return ESCAPE_OTHER;
+		}
+
+		c = m_regex[m_pos++];
+		switch (c)
+		{
+		case L'd':
+		case L'D':
+		case L'w':
+		case L'W':
+		case L's':
+		case L'S':
+			return ESCAPE_OTHER;
+		case L'b':
+			c = L'\b';
+			return inClass ? ESCAPE_CHARACTER : ESCAPE_ASSERTION;
+		case L'B':
+			return ESCAPE_ASSERTION;
+		case L'c':
+			if (!isEnd())
+			{
+				m_pos++;
+			}
+			return ESCAPE_OTHER;
+		case L'0':
+			c = L'\0';
+			return ESCAPE_CHARACTER;
+		case L'n':
+			c = L'\n';
+			return ESCAPE_CHARACTER;
+		case L't':
+			c = L'\t';
+			return ESCAPE_CHARACTER;
+		case L'r':
+			c = L'\r';
+			return ESCAPE_CHARACTER;
+		case L'f':
+			c = L'\f';
+			return ESCAPE_CHARACTER;
+		case L'v':
+			c = L'\v';
+			return ESCAPE_CHARACTER;
+		case L'x':
+			return parseHex(c, 2) ? ESCAPE_CHARACTER : ESCAPE_OTHER;
+		case L'u':
+			return parseHex(c, 4) ? ESCAPE_CHARACTER : ESCAPE_OTHER;
+		default:
+			if (iswdigit(c))
+			{
+				// back reference
+				size_t number = 0;
+				parseNumber(number);
+				return ESCAPE_OTHER;
+			}
+			return ESCAPE_CHARACTER;
+		}
+	}
+
+	bool parseHex(wchar_t& c, size_t digitCount)
+	{
+		if (m_pos + digitCount > m_regex.size())
+		{
+			return false;
+		}
+
+		c = 0;
+		for (size_t i = 0; i < digitCount; i++)
+		{
+			const wchar_t digit = m_regex[m_pos++];
+			if (!iswxdigit(digit))
+			{
+				return false;
+			}
+			c = static_cast<wchar_t>(
+				c * 16 + (iswdigit(digit) ? digit - L'0' : towlower(digit) - L'a' + 10));
+		}
+		return true;
+	}
+
+	const std::wstring& m_regex;
+	size_t m_pos;
+};
+
+void intersect(std::vector<size_t>& result, const std::vector<size_t>& other)
+{
+	std::vector<size_t> intersection;
+	std::set_intersection(
+		result.begin(),
+		result.end(),
+		other.begin(),
+		other.end(),
+		std::back_inserter(intersection));
+	result.swap(intersection);
+}
+
+void unite(std::vector<size_t>& result, const std::vector<size_t>& other)
+{
+	std::vector<size_t> united;
+	std::set_union(
+		result.begin(), result.end(), other.begin(), other.end(), std::back_inserter(united));
+	result.swap(united);
+}
+}	 // namespace
+
+TrigramQuery TrigramQuery::fromRegex(const std::wstring& regex)
+{
+	return getQuery(RegexParser(regex).parse());
+}
+
+TrigramQuery TrigramQuery::fromString(const std::wstring& str)
+{
+	std::wstring lowerStr = str;
+	std::transform(lowerStr.begin(), lowerStr.end(), lowerStr.begin(), ::towlower);
+
+	TrigramQuery query;
+	for (uint64_t trigram: getTrigrams(lowerStr.data(), lowerStr.size()))
+	{
+		query.m_operation = OPERATION_AND;
+		query.m_trigrams.push_back(trigram);
+	}
+	return query;
+}
+
+uint64_t TrigramQuery::getTrigram(wchar_t a, wchar_t b, wchar_t c)
+{
+	// unicode code points fit into 21 bits
+	const uint64_t mask = 0x1FFFFF;
+	return ((static_cast<uint64_t>(a) & mask) << 42) | ((static_cast<uint64_t>(b) & mask) << 21) |
+		(static_cast<uint64_t>(c) & mask);
+}
+
+std::vector<uint64_t> TrigramQuery::getTrigrams(const wchar_t* text, size_t textLength)
+{
+	std::vector<uint64_t> trigrams;
+	for (size_t i = 2; i < textLength; i++)
+	{
+		trigrams.push_back(getTrigram(text[i - 2], text[i - 1], text[i]));
+	}
+	std::sort(trigrams.begin(), trigrams.end());
+	trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+	return trigrams;
+}
+
+TrigramQuery::TrigramQuery(Operation operation): m_operation(operation) {}
+
+TrigramQuery TrigramQuery::andWith(const TrigramQuery& other) const
+{
+	if (m_operation == OPERATION_NONE || other.m_operation == OPERATION_ALL)
+	{
+		return *this;
+	}
+	if (other.m_operation == OPERATION_NONE || m_operation == OPERATION_ALL)
+	{
+		return other;
+	}
+
+	TrigramQuery query(OPERATION_AND);
+	for (const TrigramQuery* part: {this, &other})
+	{
+		if (part->m_operation == OPERATION_AND)
+		{
+			utility::append(query.m_trigrams, part->m_trigrams);
+			utility::append(query.m_subQueries, part->m_subQueries);
+		}
+		else
+		{
+			query.m_subQueries.push_back(*part);
+		}
+	}
+
+	std::sort(query.m_trigrams.begin(), query.m_trigrams.end());
+	query.m_trigrams.erase(
+		std::unique(query.m_trigrams.begin(), query.m_trigrams.end()), query.m_trigrams.end());
+	return query;
+}
+
+TrigramQuery TrigramQuery::orWith(const TrigramQuery& other) const
+{
+	if (m_operation == OPERATION_ALL || other.m_operation == OPERATION_NONE)
+	{
+		return *this;
+	}
+	if (other.m_operation == OPERATION_ALL || m_operation == OPERATION_NONE)
+	{
+		return other;
+	}
+
+	TrigramQuery query(OPERATION_OR);
+	for (const TrigramQuery* part: {this, &other})
+	{
+		if (part->m_operation == OPERATION_OR)
+		{
+			utility::append(query.m_trigrams, part->m_trigrams);
+			utility::append(query.m_subQueries, part->m_subQueries);
+		}
+		else if (part->m_trigrams.size() == 1 && part->m_subQueries.empty())
+		{
+			query.m_trigrams.push_back(part->m_trigrams.front());
+		}
+		else
+		{
+			query.m_subQueries.push_back(*part);
+		}
+	}
+
+	std::sort(query.m_trigrams.begin(), query.m_trigrams.end());
+	query.m_trigrams.erase(
+		std::unique(query.m_trigrams.begin(), query.m_trigrams.end()), query.m_trigrams.end());
+	return query;
+}
+
+TrigramQuery::Operation TrigramQuery::getOperation() const
+{
+	return m_operation;
+}
+
+const std::vector<uint64_t>& TrigramQuery::getTrigrams() const
+{
+	return m_trigrams;
+}
+
+const std::vector<TrigramQuery>& TrigramQuery::getSubQueries() const
+{
+	return m_subQueries;
+}
+
+std::vector<size_t> TrigramQuery::evaluate(
+	size_t fileCount, const std::function<std::vector<size_t>(uint64_t)>& getFiles) const
+{
+	std::vector<size_t> result;
+	switch (m_operation)
+	{
+	case OPERATION_ALL:
+		for (size_t i = 0; i < fileCount; i++)
+		{
+			result.push_back(i);
+		}
+		break;
+
+	case OPERATION_NONE:
+		break;
+
+	case OPERATION_AND:
+	{
+		bool first = true;
+		for (uint64_t trigram: m_trigrams)
+		{
+			if (first)
+			{
+				result = getFiles(trigram);
+				first = false;
+			}
+			else
+			{
+				intersect(result, getFiles(trigram));
+			}
+
+			if (result.empty())
+			{
+				return result;
+			}
+		}
+		for (const TrigramQuery& subQuery: m_subQueries)
+		{
+			if (first)
+			{
+				result = subQuery.evaluate(fileCount, getFiles);
+				first = false;
+			}
+			else
+			{
+				intersect(result, subQuery.evaluate(fileCount, getFiles));
+			}
+
+			if (result.empty())
+			{
+				return result;
+			}
+		}
+		break;
+	}
+
+	case OPERATION_OR:
+		for (uint64_t trigram: m_trigrams)
+		{
+			unite(result, getFiles(trigram));
+		}
+		for (const TrigramQuery& subQuery: m_subQueries)
+		{
+			unite(result, subQuery.evaluate(fileCount, getFiles));
+		}
+		break;
+	}
+	return result;
+}
+
+std::wstring TrigramQuery::toString() const
+{
+	switch (m_operation)
+	{
+	case OPERATION_ALL:
+		return L"*";
+	case OPERATION_NONE:
+		return L"-";
+	default:
+		break;
+	}
+
+	std::wstring str;
+	for (uint64_t trigram: m_trigrams)
+	{
+		if (!str.empty())
+		{
+			str += (m_operation == OPERATION_AND ? L" " : L"|");
+		}
+		for (int shift = 42; shift >= 0; shift -= 21)
+		{
+			str.push_back(static_cast<wchar_t>((trigram >> shift) & 0x1FFFFF));
+		}
+	}
+	for (const TrigramQuery& subQuery: m_subQueries)
+	{
+		if (!str.empty())
+		{
+			str += (m_operation == OPERATION_AND ? L" " : L"|");
+		}
+		str += L"(" + subQuery.toString() + L")";
+	}
+	return str;
+}
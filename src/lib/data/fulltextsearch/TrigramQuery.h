@@ -0,0 +1,55 @@
+#ifndef TRIGRAM_QUERY_H
+#define TRIGRAM_QUERY_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Describes which trigrams a text has to contain to possibly match a regular expression. Trigrams
+// are built from lower case characters, so a query is always evaluated case-insensitively and only
+// serves as prefilter before running the actual regular expression.
+class TrigramQuery
+{
+public:
+	enum Operation
+	{
+		OPERATION_ALL,	  // matches every text
+		OPERATION_NONE,	  // matches no text
+		OPERATION_AND,
+		OPERATION_OR
+	};
+
+	static TrigramQuery fromRegex(const std::wstring& regex);
+
+	// requires all trigrams of the string, matches every text if the string is shorter than three
+	static TrigramQuery fromString(const std::wstring& str);
+
+	static uint64_t getTrigram(wchar_t a, wchar_t b, wchar_t c);
+
+	// returns the sorted trigrams of a lower case text
+	static std::vector<uint64_t> getTrigrams(const wchar_t* text, size_t textLength);
+
+	TrigramQuery(Operation operation = OPERATION_ALL);
+
+	TrigramQuery andWith(const TrigramQuery& other) const;
+	TrigramQuery orWith(const TrigramQuery& other) const;
+
+	Operation getOperation() const;
+	const std::vector<uint64_t>& getTrigrams() const;
+	const std::vector<TrigramQuery>& getSubQueries() const;
+
+	// Returns the sorted indices of all files that satisfy the query. getFiles has to return the
+	// sorted indices of the files containing a trigram.
+	std::vector<size_t> evaluate(
+		size_t fileCount, const std::function<std::vector<size_t>(uint64_t)>& getFiles) const;
+
+	std::wstring toString() const;
+
+private:
+	Operation m_operation;
+	std::vector<uint64_t> m_trigrams;
+	std::vector<TrigramQuery> m_subQueries;
+};
+
+#endif	  // TRIGRAM_QUERY_H
@@ -16,7 +16,14 @@ public:
 	Indexer();
 	IndexerCommandType getSupportedIndexerCommandType() const override;
 	std::shared_ptr<IntermediateStorage> index(std::shared_ptr<IndexerCommand> indexerCommand) override;
+	std::vector<std::shared_ptr<IntermediateStorage>> indexBatch(
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands,
+		size_t threadCount) override;
 	void interrupt() override;
+	void setLowMemoryMode(bool lowMemoryMode) override;
+	void setStorageChunkCallback(
+		size_t chunkByteSize,
+		std::function<void(std::shared_ptr<IntermediateStorage>)> callback) override;
 
 private:
 	virtual void doIndex(
@@ -24,14 +31,28 @@ private:
 		std::shared_ptr<ParserClientImpl> parserClient,
 		std::shared_ptr<IndexerStateInfo> m_indexerStateInfo) = 0;
 
+	// indexes the commands one after another by default
+	virtual void doIndexBatch(
+		const std::vector<std::shared_ptr<T>>& indexerCommands,
+		const std::vector<std::shared_ptr<ParserClientImpl>>& parserClients,
+		std::shared_ptr<IndexerStateInfo> m_indexerStateInfo,
+		size_t threadCount);
+
+	void finalizeStorage(std::shared_ptr<IntermediateStorage> storage) const;
+
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo;
+
+	size_t m_storageChunkByteSize;
+	std::function<void(std::shared_ptr<IntermediateStorage>)> m_storageChunkCallback;
 };
 
 
 template <typename T>
-Indexer<T>::Indexer(): m_indexerStateInfo(std::make_shared<IndexerStateInfo>())
+Indexer<T>::Indexer()
+	: m_indexerStateInfo(std::make_shared<IndexerStateInfo>()), m_storageChunkByteSize(0)
 {
 	m_indexerStateInfo->indexingInterrupted = false;
+	m_indexerStateInfo->lowMemoryMode = false;
 }
 
 template <typename T>
@@ -46,6 +67,20 @@ void Indexer<T>::interrupt()
 	m_indexerStateInfo->indexingInterrupted = true;
 }
 
+template <typename T>
+void Indexer<T>::setLowMemoryMode(bool lowMemoryMode)
+{
+	m_indexerStateInfo->lowMemoryMode = lowMemoryMode;
+}
+
+template <typename T>
+void Indexer<T>::setStorageChunkCallback(
+	size_t chunkByteSize, std::function<void(std::shared_ptr<IntermediateStorage>)> callback)
+{
+	m_storageChunkByteSize = chunkByteSize;
+	m_storageChunkCallback = callback;
+}
+
 template <typename T>
 std::shared_ptr<IntermediateStorage> Indexer<T>::index(std::shared_ptr<IndexerCommand> indexerCommand)
 {
@@ -61,26 +96,114 @@ std::shared_ptr<IntermediateStorage> Indexer<T>::index(std::shared_ptr<IndexerCo
 		return nullptr;
 	}
 
+	const FilePath sourceFilePath = indexerCommand->getSourceFilePath();
+
 	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
 	std::shared_ptr<ParserClientImpl> parserClient = std::make_shared<ParserClientImpl>(storage.get());
+	if (m_storageChunkCallback)
+	{
+		parserClient->setChunkCallback(
+			m_storageChunkByteSize,
+			[sourceFilePath, callback = m_storageChunkCallback](
+				std::shared_ptr<IntermediateStorage> chunk) {
+				chunk->addSourceFileChunkCount(sourceFilePath, 1);
+				callback(chunk);
+			});
+	}
 
 	doIndex(castCommand, parserClient, m_indexerStateInfo);
 
-	if (storage->hasFatalErrors())
+	LOG_INFO(
+		"symbol cache hits: " + std::to_string(parserClient->getSymbolCacheHitCount()) +
+		", misses: " + std::to_string(parserClient->getSymbolCacheMissCount()));
+
+	finalizeStorage(storage);
+
+	if (m_indexerStateInfo->indexingInterrupted)
 	{
-		storage->setAllFilesIncomplete();
+		return nullptr;
 	}
-	else
+
+	const int chunkCount = static_cast<int>(parserClient->getChunkCount());
+	if (chunkCount)
 	{
-		storage->setFilesWithErrorsIncomplete();
+		LOG_INFO("handed over storage in " + std::to_string(chunkCount + 1) + " chunks");
+		storage = storage->extractChunk(true);
+	}
+
+	storage->addSourceFileChunkCount(sourceFilePath, -chunkCount);
+	return storage;
+}
+
+template <typename T>
+std::vector<std::shared_ptr<IntermediateStorage>> Indexer<T>::indexBatch(
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands, size_t threadCount)
+{
+	std::vector<std::shared_ptr<T>> castCommands;
+	std::vector<std::shared_ptr<IntermediateStorage>> storages;
+	std::vector<std::shared_ptr<ParserClientImpl>> parserClients;
+
+	for (const std::shared_ptr<IndexerCommand>& indexerCommand: indexerCommands)
+	{
+		std::shared_ptr<T> castCommand = std::dynamic_pointer_cast<T>(indexerCommand);
+		if (!castCommand)
+		{
+			LOG_ERROR(
+				"Trying to process " +
+				indexerCommandTypeToString(indexerCommand->getIndexerCommandType()) +
+				" indexer command with indexer that supports \"" +
+				indexerCommandTypeToString(getSupportedIndexerCommandType()) + "\".");
+			continue;
+		}
+
+		castCommands.push_back(castCommand);
+		storages.push_back(std::make_shared<IntermediateStorage>());
+		parserClients.push_back(std::make_shared<ParserClientImpl>(storages.back().get()));
+	}
+
+	if (!castCommands.empty())
+	{
+		doIndexBatch(castCommands, parserClients, m_indexerStateInfo, threadCount);
 	}
 
 	if (m_indexerStateInfo->indexingInterrupted)
 	{
-		return nullptr;
+		return {};
 	}
 
-	return storage;
+	for (size_t i = 0; i < storages.size(); i++)
+	{
+		finalizeStorage(storages[i]);
+		storages[i]->addSourceFileChunkCount(castCommands[i]->getSourceFilePath(), 0);
+	}
+
+	return storages;
+}
+
+template <typename T>
+void Indexer<T>::doIndexBatch(
+	const std::vector<std::shared_ptr<T>>& indexerCommands,
+	const std::vector<std::shared_ptr<ParserClientImpl>>& parserClients,
+	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo,
+	size_t threadCount)
+{
+	for (size_t i = 0; i < indexerCommands.size() && !m_indexerStateInfo->indexingInterrupted; i++)
+	{
+		doIndex(indexerCommands[i], parserClients[i], m_indexerStateInfo);
+	}
+}
+
+template <typename T>
+void Indexer<T>::finalizeStorage(std::shared_ptr<IntermediateStorage> storage) const
+{
+	if (storage->hasFatalErrors())
+	{
+		storage->setAllFilesIncomplete();
+	}
+	else
+	{
+		storage->setFilesWithErrorsIncomplete();
+	}
 }
 
 #endif	  // INDEXER_H
@@ -1,3 +1,17 @@
 #include "IndexerBase.h"
 
 IndexerBase::IndexerBase() {}
+
+std::vector<std::shared_ptr<IntermediateStorage>> IndexerBase::indexBatch(
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands, size_t threadCount)
+{
+	std::vector<std::shared_ptr<IntermediateStorage>> storages;
+	for (const std::shared_ptr<IndexerCommand>& indexerCommand: indexerCommands)
+	{
+		if (std::shared_ptr<IntermediateStorage> storage = index(indexerCommand))
+		{
+			storages.push_back(storage);
+		}
+	}
+	return storages;
+}
@@ -1,8 +1,10 @@
 #ifndef INDEXER_BASE_H
 #define INDEXER_BASE_H
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "IndexerCommandType.h"
 
@@ -19,7 +21,22 @@ public:
 	virtual IndexerCommandType getSupportedIndexerCommandType() const = 0;
 	virtual std::shared_ptr<IntermediateStorage> index(
 		std::shared_ptr<IndexerCommand> indexerCommand) = 0;
+
+	// indexes several commands at once and returns one storage per indexed command. Indexers that
+	// can share work between files override this to spread the batch over threadCount threads.
+	virtual std::vector<std::shared_ptr<IntermediateStorage>> indexBatch(
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands, size_t threadCount);
+
 	virtual void interrupt() = 0;
+
+	// reduces the detail of the following indexing runs to keep the memory consumption low
+	virtual void setLowMemoryMode(bool lowMemoryMode) = 0;
+
+	// hands the storage of a large translation unit over in chunks of about chunkByteSize bytes
+	// while it is indexed, index() then only returns the last chunk. 0 disables chunking.
+	virtual void setStorageChunkCallback(
+		size_t chunkByteSize,
+		std::function<void(std::shared_ptr<IntermediateStorage>)> callback) = 0;
 };
 
 #endif	  // INDEXER_BASE_H
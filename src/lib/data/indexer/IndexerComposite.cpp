@@ -30,6 +30,27 @@ std::shared_ptr<IntermediateStorage> IndexerComposite::index(std::shared_ptr<Ind
 	return std::shared_ptr<IntermediateStorage>();
 }
 
+std::vector<std::shared_ptr<IntermediateStorage>> IndexerComposite::indexBatch(
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands, size_t threadCount)
+{
+	if (indexerCommands.empty())
+	{
+		return {};
+	}
+
+	// batches only contain commands of a single type
+	auto it = m_indexers.find(indexerCommands.front()->getIndexerCommandType());
+	if (it != m_indexers.end())
+	{
+		return it->second->indexBatch(indexerCommands, threadCount);
+	}
+
+	LOG_ERROR(
+		"No indexer found that supports \"" +
+		indexerCommandTypeToString(indexerCommands.front()->getIndexerCommandType()) + "\".");
+	return {};
+}
+
 void IndexerComposite::interrupt()
 {
 	for (auto& it: m_indexers)
@@ -37,3 +58,20 @@ void IndexerComposite::interrupt()
 		it.second->interrupt();
 	}
 }
+
+void IndexerComposite::setLowMemoryMode(bool lowMemoryMode)
+{
+	for (auto& it: m_indexers)
+	{
+		it.second->setLowMemoryMode(lowMemoryMode);
+	}
+}
+
+void IndexerComposite::setStorageChunkCallback(
+	size_t chunkByteSize, std::function<void(std::shared_ptr<IntermediateStorage>)> callback)
+{
+	for (auto& it: m_indexers)
+	{
+		it.second->setStorageChunkCallback(chunkByteSize, callback);
+	}
+}
@@ -16,8 +16,15 @@ public:
 	void addIndexer(std::shared_ptr<IndexerBase> indexer);
 
 	std::shared_ptr<IntermediateStorage> index(std::shared_ptr<IndexerCommand> indexerCommand) override;
+	std::vector<std::shared_ptr<IntermediateStorage>> indexBatch(
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands,
+		size_t threadCount) override;
 
 	void interrupt() override;
+	void setLowMemoryMode(bool lowMemoryMode) override;
+	void setStorageChunkCallback(
+		size_t chunkByteSize,
+		std::function<void(std::shared_ptr<IntermediateStorage>)> callback) override;
 
 private:
 	std::map<IndexerCommandType, std::shared_ptr<IndexerBase>> m_indexers;
@@ -5,6 +5,9 @@ struct IndexerStateInfo
 {
 public:
 	bool indexingInterrupted;
+
+	// set when retrying a translation unit that exceeded the memory limit of the indexer
+	bool lowMemoryMode;
 };
 
 #endif	  // INDEXER_STATE_INFO_H
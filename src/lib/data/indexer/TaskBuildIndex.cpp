@@ -4,6 +4,7 @@
 #include "Blackboard.h"
 #include "DialogView.h"
 #include "FileLogger.h"
+#include "IndexerCommand.h"
 #include "InterprocessIndexer.h"
 #include "MessageIndexingStatus.h"
 #include "MessageStatus.h"
@@ -18,16 +19,24 @@ TaskBuildIndex::TaskBuildIndex(
 	std::shared_ptr<StorageProvider> storageProvider,
 	std::shared_ptr<DialogView> dialogView,
 	const std::string& appUUID,
-	bool multiProcessIndexing)
+	bool multiProcessIndexing,
+	size_t indexerMemoryLimitMb,
+	IndexerCommandType batchIndexerCommandType)
 	: m_storageProvider(storageProvider)
 	, m_dialogView(dialogView)
 	, m_appUUID(appUUID)
 	, m_multiProcessIndexing(multiProcessIndexing)
+	, m_indexerMemoryLimitMb(indexerMemoryLimitMb)
+	, m_batchIndexerCommandType(batchIndexerCommandType)
+	, m_interprocessIndexerCommandManager(appUUID, 0, false)
 	, m_interprocessIndexingStatusManager(appUUID, 0, true)
 	, m_indexerCommandQueueStopped(false)
 	, m_processCount(processCount)
 	, m_interrupted(false)
 	, m_indexingFileCount(0)
+	, m_memoryLimitRetryCount(0)
+	, m_maximumQueuedStorageCount(0)
+	, m_storageQueueWaitTimeMs(0)
 	, m_runningThreadCount(0)
 {
 }
@@ -37,13 +46,15 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard)
 	m_interprocessIndexingStatusManager.setIndexingInterrupted(false);
 
 	m_indexingFileCount = 0;
+	m_memoryLimitRetryCount = 0;
+	m_maximumQueuedStorageCount = 0;
+	m_storageQueueWaitTimeMs = 0;
 	updateIndexingDialog(blackboard, std::vector<FilePath>());
 
-	std::wstring logFilePath;
 	Logger* logger = LogManager::getInstance()->getLoggerByType("FileLogger");
 	if (logger)
 	{
-		logFilePath = dynamic_cast<FileLogger*>(logger)->getLogFilePath().wstr();
+		m_logFilePath = dynamic_cast<FileLogger*>(logger)->getLogFilePath().wstr();
 	}
 
 	// start indexer processes
@@ -61,8 +72,15 @@ void TaskBuildIndex::doEnter(std::shared_ptr<Blackboard> blackboard)
 
 		if (m_multiProcessIndexing)
 		{
-			m_processThreads.push_back(
-				new std::thread(&TaskBuildIndex::runIndexerProcess, this, processId, logFilePath));
+			// the memory limit is meant for a single translation unit, not for a batch indexer that
+			// runs all threads of a shared JVM
+			const size_t memoryLimitMb =
+				(m_batchIndexerCommandType != INDEXER_COMMAND_UNKNOWN && processId == 1)
+				? 0
+				: m_indexerMemoryLimitMb;
+
+			m_processThreads.push_back(new std::thread(
+				&TaskBuildIndex::runIndexerProcess, this, processId, memoryLimitMb, false));
 		}
 		else
 		{
@@ -91,7 +109,12 @@ Task::TaskState TaskBuildIndex::doUpdate(std::shared_ptr<Blackboard> blackboard)
 		updateIndexingDialog(blackboard, indexingFiles);
 	}
 
-	if (m_indexerCommandQueueStopped && runningThreadCount == 0)
+	if (m_indexerCommandQueueStopped && runningThreadCount == 0 && !m_interrupted &&
+		retryIndexerCommandsExceedingMemoryLimit())
+	{
+		return STATE_RUNNING;
+	}
+	else if (m_indexerCommandQueueStopped && runningThreadCount == 0)
 	{
 		LOG_INFO_STREAM(<< "command queue stopped and no running threads. done.");
 		return STATE_SUCCESS;
@@ -130,7 +153,19 @@ void TaskBuildIndex::doExit(std::shared_ptr<Blackboard> blackboard)
 
 	std::vector<FilePath> crashedFiles =
 		m_interprocessIndexingStatusManager.getCrashedSourceFilePaths();
-	if (!crashedFiles.empty())
+
+	std::vector<FilePath> memoryLimitExceedingFiles;
+	for (const std::shared_ptr<IndexerCommand>& indexerCommand:
+		 m_interprocessIndexerCommandManager.popRetryIndexerCommands())
+	{
+		memoryLimitExceedingFiles.push_back(indexerCommand->getSourceFilePath());
+	}
+	if (m_interrupted)
+	{
+		memoryLimitExceedingFiles.clear();
+	}
+
+	if (!crashedFiles.empty() || !memoryLimitExceedingFiles.empty())
 	{
 		std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
 		std::shared_ptr<ParserClientImpl> parserClient = std::make_shared<ParserClientImpl>(
@@ -149,11 +184,32 @@ void TaskBuildIndex::doExit(std::shared_ptr<Blackboard> blackboard)
 				true,
 				path,
 				ParseLocation(fileId, 1, 1));
+			storage->addSourceFileChunkCount(path, 0);
 			LOG_INFO(L"crashed translation unit: " + path.wstr());
 		}
+
+		for (const FilePath& path: memoryLimitExceedingFiles)
+		{
+			Id fileId = parserClient->recordFile(path.getCanonical(), false);
+			parserClient->recordError(
+				L"The translation unit exceeded the memory limit of the indexer, even when indexed "
+				L"on its own and without template instantiations. Please increase the indexer memory "
+				L"limit in the preferences to index this file.",
+				true,
+				true,
+				path,
+				ParseLocation(fileId, 1, 1));
+			storage->addSourceFileChunkCount(path, 0);
+			LOG_INFO(L"translation unit exceeding memory limit: " + path.wstr());
+		}
 		m_storageProvider->insert(storage);
 	}
 
+	LOG_INFO_STREAM(
+		<< "at most " << m_maximumQueuedStorageCount
+		<< " storages waited for injection, fetching storages from the indexers waited "
+		<< m_storageQueueWaitTimeMs / 1000.0 << "s for merging and injection");
+
 	blackboard->set<bool>("indexer_threads_stopped", true);
 }
 
@@ -176,7 +232,7 @@ void TaskBuildIndex::handleMessage(MessageIndexingInterrupted* message)
 		L"Interrupting Indexing", L"Waiting for indexer\nthreads to finish");
 }
 
-void TaskBuildIndex::runIndexerProcess(int processId, const std::wstring& logFilePath)
+void TaskBuildIndex::runIndexerProcess(int processId, size_t memoryLimitMb, bool lowMemoryMode)
 {
 	const FilePath indexerProcessPath = AppPath::getCxxIndexerPath();
 	if (!indexerProcessPath.exists())
@@ -194,10 +250,15 @@ void TaskBuildIndex::runIndexerProcess(int processId, const std::wstring& logFil
 	commandArguments.push_back(utility::decodeFromUtf8(m_appUUID));
 	commandArguments.push_back(L"\"" + AppPath::getSharedDataPath().getAbsolute().wstr() + L"\"");
 	commandArguments.push_back(L"\"" + UserPaths::getUserDataPath().getAbsolute().wstr() + L"\"");
+	commandArguments.push_back(std::to_wstring(memoryLimitMb));
+	commandArguments.push_back(lowMemoryMode ? L"1" : L"0");
+	commandArguments.push_back(
+		utility::decodeFromUtf8(indexerCommandTypeToString(m_batchIndexerCommandType)));
+	commandArguments.push_back(std::to_wstring(m_processCount));
 
-	if (!logFilePath.empty())
+	if (!m_logFilePath.empty())
 	{
-		commandArguments.push_back(L"\"" + logFilePath + L"\"");
+		commandArguments.push_back(L"\"" + m_logFilePath + L"\"");
 	}
 
 	int result = 1;
@@ -206,6 +267,21 @@ void TaskBuildIndex::runIndexerProcess(int processId, const std::wstring& logFil
 		result = utility::executeProcessAndGetExitCode(commandPath, commandArguments, FilePath(), -1);
 
 		LOG_INFO_STREAM(<< "Indexer process " << processId << " returned with " + std::to_string(result));
+		if (result == InterprocessIndexer::s_memoryLimitExceededExitCode)
+		{
+			LOG_WARNING_STREAM(
+				<< "Indexer process " << processId << " exceeded memory limit of " << memoryLimitMb
+				<< " MB and gets restarted");
+		}
+
+		if (result != 0 && !m_interrupted)
+		{
+			// hand back the commands the process fetched, but did not get to index
+			const FilePath lastStartedSourceFilePath =
+				m_interprocessIndexingStatusManager.getLastStartedSourceFilePath(processId);
+			m_interprocessIndexerCommandManager.requeueFetchedIndexerCommands(
+				processId, lastStartedSourceFilePath);
+		}
 	}
 
 	{
@@ -218,7 +294,8 @@ void TaskBuildIndex::runIndexerThread(int processId)
 {
 	do
 	{
-		InterprocessIndexer indexer(m_appUUID, processId);
+		InterprocessIndexer indexer(
+			m_appUUID, processId, 0, false, m_batchIndexerCommandType, m_processCount);
 		indexer.work();	   // this will only return if there are no indexer commands left in the queue
 		if (!m_interrupted)
 		{
@@ -234,16 +311,64 @@ void TaskBuildIndex::runIndexerThread(int processId)
 	}
 }
 
+bool TaskBuildIndex::retryIndexerCommandsExceedingMemoryLimit()
+{
+	// Translation units that made an indexer process exceed the memory limit are retried after
+	// all other files are done. The first retry runs a single indexer process that may use the
+	// memory of all indexer processes, the second retry additionally skips template instantiations.
+	const size_t maximumRetryCount = 2;
+	if (!m_multiProcessIndexing || !m_indexerMemoryLimitMb ||
+		m_memoryLimitRetryCount >= maximumRetryCount)
+	{
+		return false;
+	}
+
+	std::vector<std::shared_ptr<IndexerCommand>> indexerCommands =
+		m_interprocessIndexerCommandManager.popRetryIndexerCommands();
+	if (indexerCommands.empty())
+	{
+		return false;
+	}
+
+	m_memoryLimitRetryCount++;
+	const bool lowMemoryMode = (m_memoryLimitRetryCount == maximumRetryCount);
+
+	LOG_INFO_STREAM(
+		<< "retrying " << indexerCommands.size()
+		<< " translation units that exceeded the memory limit"
+		<< (lowMemoryMode ? " in low memory mode" : ""));
+
+	m_interprocessIndexerCommandManager.pushIndexerCommands(indexerCommands);
+
+	{
+		std::lock_guard<std::mutex> lock(m_runningThreadCountMutex);
+		m_runningThreadCount++;
+	}
+
+	m_processThreads.push_back(new std::thread(
+		&TaskBuildIndex::runIndexerProcess,
+		this,
+		1,
+		m_indexerMemoryLimitMb * m_processCount,
+		lowMemoryMode));
+
+	return true;
+}
+
 bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> blackboard)
 {
 	int poppedStorageCount = 0;
+	int indexedSourceFileCount = 0;
 
 	int providerStorageCount = m_storageProvider->getStorageCount();
+	m_maximumQueuedStorageCount = std::max<size_t>(
+		m_maximumQueuedStorageCount, providerStorageCount);
 	if (providerStorageCount > 10)
 	{
 		LOG_INFO_STREAM(<< "waiting, too many storages queued: " << providerStorageCount);
 
 		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		m_storageQueueWaitTimeMs += 100;
 
 		return true;
 	}
@@ -268,7 +393,12 @@ bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> black
 		}
 
 		LOG_INFO_STREAM(<< storageManager->getProcessId() << " - storage count: " << storageCount);
-		m_storageProvider->insert(storageManager->popIntermediateStorage());
+		std::shared_ptr<IntermediateStorage> storage = storageManager->popIntermediateStorage();
+		if (storage && !storage->isChunk())
+		{
+			indexedSourceFileCount++;
+		}
+		m_storageProvider->insert(storage);
 		poppedStorageCount++;
 	} while (TimeStamp::now().deltaMS(t) <
 			 500);	  // don't process all storages at once to allow for status updates in-between
@@ -276,7 +406,7 @@ bool TaskBuildIndex::fetchIntermediateStorages(std::shared_ptr<Blackboard> black
 	if (poppedStorageCount > 0)
 	{
 		blackboard->update<int>(
-			"indexed_source_file_count", [=](int count) { return count + poppedStorageCount; });
+			"indexed_source_file_count", [=](int count) { return count + indexedSourceFileCount; });
 		return true;
 	}
 
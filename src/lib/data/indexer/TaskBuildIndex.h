@@ -25,7 +25,9 @@ public:
 		std::shared_ptr<StorageProvider> storageProvider,
 		std::shared_ptr<DialogView> dialogView,
 		const std::string& appUUID,
-		bool multiProcessIndexing);
+		bool multiProcessIndexing,
+		size_t indexerMemoryLimitMb = 0,
+		IndexerCommandType batchIndexerCommandType = INDEXER_COMMAND_UNKNOWN);
 
 protected:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -36,8 +38,9 @@ protected:
 
 	void handleMessage(MessageIndexingInterrupted* message) override;
 
-	void runIndexerProcess(int processId, const std::wstring& logFilePath);
+	void runIndexerProcess(int processId, size_t memoryLimitMb, bool lowMemoryMode);
 	void runIndexerThread(int processId);
+	bool retryIndexerCommandsExceedingMemoryLimit();
 	bool fetchIntermediateStorages(std::shared_ptr<Blackboard> blackboard);
 	void updateIndexingDialog(
 		std::shared_ptr<Blackboard> blackboard, const std::vector<FilePath>& sourcePaths);
@@ -49,12 +52,23 @@ protected:
 	std::shared_ptr<DialogView> m_dialogView;
 	const std::string m_appUUID;
 	bool m_multiProcessIndexing;
+	const size_t m_indexerMemoryLimitMb;
 
+	// commands of this type are all indexed by the first indexer, using one thread per indexer
+	const IndexerCommandType m_batchIndexerCommandType;
+	std::wstring m_logFilePath;
+
+	InterprocessIndexerCommandManager m_interprocessIndexerCommandManager;
 	InterprocessIndexingStatusManager m_interprocessIndexingStatusManager;
 	bool m_indexerCommandQueueStopped;
 	size_t m_processCount;
 	bool m_interrupted;
 	size_t m_indexingFileCount;
+	size_t m_memoryLimitRetryCount;
+
+	// reported when indexing ends, to tell whether merging and injection keep up with the indexers
+	size_t m_maximumQueuedStorageCount;
+	size_t m_storageQueueWaitTimeMs;
 
 	// store as plain pointers to avoid deallocation issues when closing app during indexing
 	std::vector<std::thread*> m_processThreads;
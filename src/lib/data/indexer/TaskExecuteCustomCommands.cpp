@@ -1,5 +1,8 @@
 #include "TaskExecuteCustomCommands.h"
 
+#include <cctype>
+#include <unordered_map>
+
 #include "ApplicationSettings.h"
 #include "Blackboard.h"
 #include "DialogView.h"
@@ -14,11 +17,146 @@
 #include "SourceLocationCollection.h"
 #include "SourceLocationFile.h"
 #include "TextAccess.h"
+#include "ThreadPool.h"
 #include "utility.h"
 #include "utilityApp.h"
 #include "utilityFile.h"
 #include "utilityString.h"
 
+namespace
+{
+// Index over the names of all stored nodes that is built once before the unsolved locations are
+// resolved. Nodes can be looked up by their own name or by their own name together with the name
+// of their parent, which replaces scanning all nodes of a name for every location.
+class PythonPostProcessingNodeIndex
+{
+public:
+	struct Node
+	{
+		Id id;
+		int type;
+		std::wstring name;
+		bool hasParent;
+		std::wstring parentName;
+	};
+
+	void addNodes(const std::vector<StorageNode>& storageNodes)
+	{
+		m_nodes.reserve(m_nodes.size() + storageNodes.size());
+		for (const StorageNode& storageNode: storageNodes)
+		{
+			const NameHierarchy nameHierarchy = NameHierarchy::deserialize(
+				storageNode.serializedName);
+			if (nameHierarchy.size() == 0)
+			{
+				continue;
+			}
+
+			Node node;
+			node.id = storageNode.id;
+			node.type = storageNode.type;
+			node.name = nameHierarchy.back().getName();
+			node.hasParent = nameHierarchy.size() > 1;
+			if (node.hasParent)
+			{
+				node.parentName = nameHierarchy[nameHierarchy.size() - 2].getName();
+			}
+
+			const size_t nodeIndex = m_nodes.size();
+			m_nodes.push_back(node);
+
+			m_nodeIndicesById.emplace(node.id, nodeIndex);
+			m_nodeIndicesByName[node.name].push_back(nodeIndex);
+			if (node.hasParent)
+			{
+				m_nodeIndicesByNameAndParentName[node.name][node.parentName].push_back(nodeIndex);
+			}
+		}
+	}
+
+	const Node* getNodeById(Id nodeId) const
+	{
+		auto it = m_nodeIndicesById.find(nodeId);
+		return it != m_nodeIndicesById.end() ? &m_nodes[it->second] : nullptr;
+	}
+
+	std::vector<const Node*> getNodesByName(const std::wstring& name) const
+	{
+		auto it = m_nodeIndicesByName.find(name);
+		return it != m_nodeIndicesByName.end() ? getNodes(it->second) : std::vector<const Node*>();
+	}
+
+	std::vector<const Node*> getNodesByNameAndParentName(
+		const std::wstring& name, const std::wstring& parentName) const
+	{
+		auto it = m_nodeIndicesByNameAndParentName.find(name);
+		if (it != m_nodeIndicesByNameAndParentName.end())
+		{
+			auto parentIt = it->second.find(parentName);
+			if (parentIt != it->second.end())
+			{
+				return getNodes(parentIt->second);
+			}
+		}
+		return {};
+	}
+
+private:
+	std::vector<const Node*> getNodes(const std::vector<size_t>& nodeIndices) const
+	{
+		std::vector<const Node*> nodes;
+		nodes.reserve(nodeIndices.size());
+		for (size_t nodeIndex: nodeIndices)
+		{
+			nodes.push_back(&m_nodes[nodeIndex]);
+		}
+		return nodes;
+	}
+
+	std::vector<Node> m_nodes;
+	std::unordered_map<Id, size_t> m_nodeIndicesById;
+	std::unordered_map<std::wstring, std::vector<size_t>> m_nodeIndicesByName;
+	std::unordered_map<std::wstring, std::unordered_map<std::wstring, std::vector<size_t>>>
+		m_nodeIndicesByNameAndParentName;
+};
+
+bool isWhitespace(char c)
+{
+	return std::isspace(static_cast<unsigned char>(c)) != 0;
+}
+
+// returns "name" if the prefix ends with " name." and name contains no '.', '(', ')' or spaces
+std::string getCallContextName(const std::string& prefix)
+{
+	if (prefix.size() < 3 || prefix.back() != '.')
+	{
+		return "";
+	}
+
+	size_t begin = prefix.size() - 1;
+	while (begin > 0 && prefix[begin - 1] != '.' && prefix[begin - 1] != '(' &&
+		   prefix[begin - 1] != ')' && !isWhitespace(prefix[begin - 1]))
+	{
+		begin--;
+	}
+
+	if (begin == 0 || begin == prefix.size() - 1 || !isWhitespace(prefix[begin - 1]))
+	{
+		return "";
+	}
+	return prefix.substr(begin, prefix.size() - 1 - begin);
+}
+
+// returns true if the prefix ends with " super()."
+bool isSuperCallContext(const std::string& prefix)
+{
+	const std::string superCall = "super().";
+	return prefix.size() > superCall.size() &&
+		prefix.compare(prefix.size() - superCall.size(), superCall.size(), superCall) == 0 &&
+		isWhitespace(prefix[prefix.size() - superCall.size() - 1]);
+}
+}	 // namespace
+
 void TaskExecuteCustomCommands::runPythonPostProcessing(PersistentStorage& storage)
 {
 	std::vector<Id> unsolvedLocationIds;
@@ -35,13 +173,25 @@ void TaskExecuteCustomCommands::runPythonPostProcessing(PersistentStorage& stora
 	std::shared_ptr<SourceLocationCollection> locationCollection =
 		storage.getSourceLocationsForLocationIds(unsolvedLocationIds);
 
-	std::map<std::wstring, std::vector<StorageNode>> nodeNameToStorageNodes;
+	// the nodes and the edges of the unsolved locations are fetched up front, so resolving does not
+	// access the storage and can run for all files in parallel
+	PythonPostProcessingNodeIndex nodeIndex;
+	std::unordered_map<Id, StorageEdge> unsolvedEdges;
 	if (locationCollection->getSourceLocationCount() > 0)
 	{
-		for (const StorageNode& node: storage.getStorageNodes())
+		nodeIndex.addNodes(storage.getStorageNodes());
+
+		std::set<Id> tokenIds;
+		locationCollection->forEachSourceLocation([&tokenIds](SourceLocation* location) {
+			tokenIds.insert(location->getTokenIds().begin(), location->getTokenIds().end());
+		});
+
+		for (const StorageEdge& edge: storage.getStorageEdges())
 		{
-			nodeNameToStorageNodes[NameHierarchy::deserialize(node.serializedName).back().getName()]
-				.push_back(node);
+			if (tokenIds.find(edge.id) != tokenIds.end())
+			{
+				unsolvedEdges.emplace(edge.id, edge);
+			}
 		}
 	}
 
@@ -51,16 +201,23 @@ void TaskExecuteCustomCommands::runPythonPostProcessing(PersistentStorage& stora
 		Id sourceLocationId;
 	};
 
+	struct FileResult
+	{
+		std::vector<DataToInsert> dataToInsert;
+		std::vector<StorageOccurrence> occurrencesToDelete;
+	};
+
 	storage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
 
-	std::vector<DataToInsert> dataToInsert;
-	std::vector<StorageOccurrence> occurrencesToDelete;
-	locationCollection->forEachSourceLocationFile([&nodeNameToStorageNodes,
-												   &storage,
-												   &dataToInsert,
-												   &occurrencesToDelete](
-													  std::shared_ptr<SourceLocationFile> locationFile) {
-		const FilePath filePath = locationFile->getFilePath();
+	std::vector<std::shared_ptr<SourceLocationFile>> locationFiles;
+	locationCollection->forEachSourceLocationFile(
+		[&locationFiles](std::shared_ptr<SourceLocationFile> locationFile) {
+			locationFiles.push_back(locationFile);
+		});
+
+	std::vector<FileResult> fileResults(locationFiles.size());
+	ThreadPool::getInstance()->parallelFor(locationFiles.size(), [&](size_t fileIndex) {
+		const FilePath filePath = locationFiles[fileIndex]->getFilePath();
 		if (filePath.empty())
 		{
 			return;
@@ -72,132 +229,114 @@ void TaskExecuteCustomCommands::runPythonPostProcessing(PersistentStorage& stora
 		}
 
 		std::shared_ptr<TextAccess> textAccess = TextAccess::createFromFile(filePath);
-		if (textAccess)
+		if (!textAccess)
 		{
-			std::map<std::wstring, std::vector<std::wstring>> childToParentNodesMap;
-
-			locationFile->forEachStartSourceLocation([textAccess,
-													  &childToParentNodesMap,
-													  &nodeNameToStorageNodes,
-													  &storage,
-													  &dataToInsert,
-													  &occurrencesToDelete](
-														 const SourceLocation* startLoc) {
-				if (!startLoc)
-				{
-					return;
-				}
-				const SourceLocation* endLoc = startLoc->getOtherLocation();
-				if (!endLoc)
-				{
-					return;
-				}
+			return;
+		}
 
-				const std::string tokenLine = textAccess->getLine(
-					static_cast<unsigned int>(startLoc->getLineNumber()));
-				const std::wstring token = utility::decodeFromUtf8(tokenLine.substr(
-					startLoc->getColumnNumber() - 1,
-					endLoc->getColumnNumber() - startLoc->getColumnNumber() + 1));
+		std::vector<DataToInsert>& dataToInsert = fileResults[fileIndex].dataToInsert;
+		std::vector<StorageOccurrence>& occurrencesToDelete =
+			fileResults[fileIndex].occurrencesToDelete;
+		std::map<std::wstring, std::vector<std::wstring>> childToParentNodesMap;
 
-				std::string prefixString = tokenLine.substr(0, startLoc->getColumnNumber() - 1);
+		auto getUnsolvedEdge = [&unsolvedEdges](Id elementId) -> const StorageEdge* {
+			auto it = unsolvedEdges.find(elementId);
+			return it != unsolvedEdges.end() ? &it->second : nullptr;
+		};
 
-				std::wstring definitionContextName = L"";
-				{
-					std::regex regex("\\s([^\\.()\\s]+)\\.$");
-					std::smatch matches;
-					std::regex_search(prefixString, matches, regex);
-					if (!matches.empty())
-					{
-						definitionContextName = utility::decodeFromUtf8(matches.str(1));
-					}
-				}
+		locationFiles[fileIndex]->forEachStartSourceLocation([&](const SourceLocation* startLoc) {
+			if (!startLoc)
+			{
+				return;
+			}
+			const SourceLocation* endLoc = startLoc->getOtherLocation();
+			if (!endLoc)
+			{
+				return;
+			}
+
+			const std::string tokenLine = textAccess->getLine(
+				static_cast<unsigned int>(startLoc->getLineNumber()));
+			const std::wstring token = utility::decodeFromUtf8(tokenLine.substr(
+				startLoc->getColumnNumber() - 1,
+				endLoc->getColumnNumber() - startLoc->getColumnNumber() + 1));
+
+			const std::string prefixString = tokenLine.substr(0, startLoc->getColumnNumber() - 1);
+
+			std::wstring definitionContextName = utility::decodeFromUtf8(
+				getCallContextName(prefixString));
+			if (isSuperCallContext(prefixString))
+			{
+				for (const Id elementId: startLoc->getTokenIds())
 				{
-					std::regex regex("\\s(super\\(\\))\\.$");
-					std::smatch matches;
-					std::regex_search(prefixString, matches, regex);
-					if (!matches.empty())
+					if (const StorageEdge* edge = getUnsolvedEdge(elementId))
 					{
-						for (const Id elementId: startLoc->getTokenIds())
+						const PythonPostProcessingNodeIndex::Node* sourceNode =
+							nodeIndex.getNodeById(edge->sourceNodeId);
+						if (sourceNode && sourceNode->hasParent &&
+							!childToParentNodesMap[sourceNode->parentName].empty())
 						{
-							const StorageEdge edge = storage.getEdgeById(elementId);
-							if (edge.id != 0)
-							{
-								NameHierarchy nameHierarchy = storage.getNameHierarchyForNodeId(
-									edge.sourceNodeId);
-								if (nameHierarchy.size() > 1)
-								{
-									std::wstring name = nameHierarchy
-															.getRange(0, nameHierarchy.size() - 1)
-															.back()
-															.getName();
-
-									if (!childToParentNodesMap[name].empty())
-									{
-										definitionContextName = childToParentNodesMap[name].front();
-									}
-								}
-							}
+							definitionContextName =
+								childToParentNodesMap[sourceNode->parentName].front();
 						}
 					}
 				}
+			}
+
+			std::vector<const PythonPostProcessingNodeIndex::Node*> targetNodes;
+			if (!definitionContextName.empty())
+			{
+				targetNodes = nodeIndex.getNodesByNameAndParentName(token, definitionContextName);
+			}
+			if (targetNodes.empty())
+			{
+				targetNodes = nodeIndex.getNodesByName(token);
+			}
+
+			for (const PythonPostProcessingNodeIndex::Node* targetNode: targetNodes)
+			{
+				for (const Id elementId: startLoc->getTokenIds())
 				{
-					std::vector<StorageNode> targetNodes;
-					if (!definitionContextName.empty())
+					// for node elements there is no edge
+					const StorageEdge* edge = getUnsolvedEdge(elementId);
+					if (!edge)
 					{
-						for (const StorageNode& node: nodeNameToStorageNodes[token])
-						{
-							NameHierarchy nameHierarchy = NameHierarchy::deserialize(
-								node.serializedName);
-							if (nameHierarchy.size() > 1 &&
-								nameHierarchy.getRange(0, nameHierarchy.size() - 1).back().getName() ==
-									definitionContextName)
-							{
-								targetNodes.push_back(node);
-							}
-						}
-					}
-					if (targetNodes.empty())
-					{
-						targetNodes = nodeNameToStorageNodes[token];
+						continue;
 					}
 
-					for (const StorageNode& targetNode: targetNodes)
+					if (Edge::intToType(edge->type) == Edge::EDGE_INHERITANCE)
 					{
-						for (const Id elementId: startLoc->getTokenIds())
+						if (intToNodeKind(targetNode->type) != NODE_CLASS)
+						{
+							continue;
+						}
+
+						const PythonPostProcessingNodeIndex::Node* childNode =
+							nodeIndex.getNodeById(edge->sourceNodeId);
+						if (childNode)
 						{
-							const StorageEdge edge = storage.getEdgeById(elementId);
-							if (edge.id != 0)	 // for node elements this condition will fail
-							{
-								if (Edge::intToType(edge.type) == Edge::EDGE_INHERITANCE)
-								{
-									if (intToNodeKind(targetNode.type) == NODE_CLASS)
-									{
-										const NameHierarchy chileName =
-											storage.getNameHierarchyForNodeId(edge.sourceNodeId);
-										const NameHierarchy parentName = NameHierarchy::deserialize(
-											targetNode.serializedName);
-										childToParentNodesMap[chileName.back().getName()].push_back(
-											parentName.back().getName());
-									}
-									else
-									{
-										continue;
-									}
-								}
-
-								dataToInsert.push_back(
-									{StorageEdgeData(edge.type, edge.sourceNodeId, targetNode.id),
-									 startLoc->getLocationId()});
-								occurrencesToDelete.push_back(
-									StorageOccurrence(edge.id, startLoc->getLocationId()));
-							}
+							childToParentNodesMap[childNode->name].push_back(targetNode->name);
 						}
 					}
+
+					dataToInsert.push_back(
+						{StorageEdgeData(edge->type, edge->sourceNodeId, targetNode->id),
+						 startLoc->getLocationId()});
+					occurrencesToDelete.push_back(
+						StorageOccurrence(edge->id, startLoc->getLocationId()));
 				}
-			});
-		}
+			}
+		});
 	});
 
+	std::vector<DataToInsert> dataToInsert;
+	std::vector<StorageOccurrence> occurrencesToDelete;
+	for (FileResult& fileResult: fileResults)
+	{
+		utility::append(dataToInsert, fileResult.dataToInsert);
+		utility::append(occurrencesToDelete, fileResult.occurrencesToDelete);
+	}
+
 	storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
 
 	storage.startInjection();
@@ -240,6 +379,48 @@ void TaskExecuteCustomCommands::runPythonPostProcessing(PersistentStorage& stora
 	}
 }
 
+void TaskExecuteCustomCommands::mergeDatabases(
+	const FilePath& targetDatabaseFilePath, const std::vector<FilePath>& sourceDatabaseFilePaths)
+{
+	// the target stays at the front, so it is the destination of the last merge
+	std::vector<FilePath> databaseFilePaths = {targetDatabaseFilePath};
+	utility::append(databaseFilePaths, sourceDatabaseFilePaths);
+
+	while (databaseFilePaths.size() > 1)
+	{
+		ThreadPool::getInstance()->parallelFor(databaseFilePaths.size() / 2, [&](size_t index) {
+			injectDatabase(databaseFilePaths[2 * index], databaseFilePaths[2 * index + 1]);
+		});
+
+		std::vector<FilePath> mergedDatabaseFilePaths;
+		for (size_t i = 0; i < databaseFilePaths.size(); i += 2)
+		{
+			mergedDatabaseFilePaths.push_back(databaseFilePaths[i]);
+		}
+		databaseFilePaths = mergedDatabaseFilePaths;
+	}
+}
+
+void TaskExecuteCustomCommands::injectDatabase(
+	const FilePath& targetDatabaseFilePath, const FilePath& sourceDatabaseFilePath)
+{
+	LOG_INFO(
+		L"Injecting \"" + sourceDatabaseFilePath.wstr() + L"\" into \"" +
+		targetDatabaseFilePath.wstr() + L"\"");
+	{
+		PersistentStorage targetStorage(targetDatabaseFilePath, FilePath());
+		targetStorage.setup();
+		targetStorage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		targetStorage.buildCaches();
+
+		PersistentStorage sourceStorage(sourceDatabaseFilePath, FilePath());
+		sourceStorage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
+		sourceStorage.buildCaches();
+		targetStorage.inject(&sourceStorage);
+	}
+	FileSystem::remove(sourceDatabaseFilePath);
+}
+
 TaskExecuteCustomCommands::TaskExecuteCustomCommands(
 	std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
 	std::shared_ptr<PersistentStorage> storage,
@@ -331,33 +512,25 @@ Task::TaskState TaskExecuteCustomCommands::doUpdate(std::shared_ptr<Blackboard>
 	}
 	indexerThreads.clear();
 
+	if (!m_sourceDatabaseFilePaths.empty())
 	{
+		const TimeStamp mergeStart = TimeStamp::now();
+		mergeDatabases(m_targetDatabaseFilePath, utility::toVector(m_sourceDatabaseFilePaths));
+		LOG_INFO(
+			"Merged " + std::to_string(m_sourceDatabaseFilePaths.size()) + " databases in " +
+			std::to_string(TimeStamp::durationSeconds(mergeStart)) + " s");
+	}
+
+	if (m_hasPythonCommands && ApplicationSettings::getInstance()->getPythonPostProcessingEnabled())
+	{
+		LOG_INFO("Starting Python post processing.");
+		m_dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Run Python Post Processing");
+
 		PersistentStorage targetStorage(m_targetDatabaseFilePath, FilePath());
 		targetStorage.setup();
 		targetStorage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
 		targetStorage.buildCaches();
-		for (const FilePath& sourceDatabaseFilePath: m_sourceDatabaseFilePaths)
-		{
-			{
-				PersistentStorage sourceStorage(sourceDatabaseFilePath, FilePath());
-				sourceStorage.setMode(SqliteIndexStorage::STORAGE_MODE_READ);
-				sourceStorage.buildCaches();
-				targetStorage.inject(&sourceStorage);
-			}
-			FileSystem::remove(sourceDatabaseFilePath);
-		}
-
-		if (m_hasPythonCommands &&
-			ApplicationSettings::getInstance()->getPythonPostProcessingEnabled())
-		{
-			LOG_INFO("Starting Python post processing.");
-			m_dialogView->showUnknownProgressDialog(
-				L"Finish Indexing", L"Run Python Post Processing");
-
-			targetStorage.clearCaches();
-			targetStorage.buildCaches();
-			runPythonPostProcessing(targetStorage);
-		}
+		runPythonPostProcessing(targetStorage);
 	}
 
 	return STATE_SUCCESS;
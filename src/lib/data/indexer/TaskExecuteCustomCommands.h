@@ -22,6 +22,12 @@ class TaskExecuteCustomCommands
 public:
 	static void runPythonPostProcessing(PersistentStorage& storage);
 
+	// Injects all source databases into the target database and removes them afterwards. The
+	// databases are merged pairwise in parallel, so only log2(n) inject steps run one after another.
+	static void mergeDatabases(
+		const FilePath& targetDatabaseFilePath,
+		const std::vector<FilePath>& sourceDatabaseFilePaths);
+
 	TaskExecuteCustomCommands(
 		std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
 		std::shared_ptr<PersistentStorage> storage,
@@ -37,6 +43,9 @@ private:
 
 	void handleMessage(MessageIndexingInterrupted* message) override;
 
+	static void injectDatabase(
+		const FilePath& targetDatabaseFilePath, const FilePath& sourceDatabaseFilePath);
+
 	void executeParallelIndexerCommands(int threadId, std::shared_ptr<Blackboard> blackboard);
 	void runIndexerCommand(
 		std::shared_ptr<IndexerCommandCustom> indexerCommand, std::shared_ptr<Blackboard> blackboard);
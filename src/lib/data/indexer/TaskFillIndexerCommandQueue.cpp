@@ -1,5 +1,7 @@
 #include "TaskFillIndexerCommandQueue.h"
 
+#include <algorithm>
+
 #include "Blackboard.h"
 #include "FileSystem.h"
 #include "IndexerCommandProvider.h"
@@ -9,10 +11,12 @@
 TaskFillIndexerCommandsQueue::TaskFillIndexerCommandsQueue(
 	const std::string& appUUID,
 	std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
-	size_t maximumQueueSize)
+	size_t indexerThreadCount)
 	: m_indexerCommandProvider(std::move(indexerCommandProvider))
 	, m_indexerCommandManager(appUUID, 0, true)
-	, m_maximumQueueSize(maximumQueueSize)
+	, m_maximumQueueSize(std::max<size_t>(
+		  20,
+		  2 * indexerThreadCount * InterprocessIndexerCommandManager::s_maximumFetchedCommandCount))
 {
 }
 
@@ -49,7 +53,9 @@ Task::TaskState TaskFillIndexerCommandsQueue::doUpdate(std::shared_ptr<Blackboar
 		}
 	}
 
-	std::this_thread::sleep_for(std::chrono::milliseconds(200));
+	// refill sooner while the indexers drain the queue quickly
+	std::this_thread::sleep_for(
+		std::chrono::milliseconds(m_lastRefillAmount > m_maximumQueueSize / 2 ? 50 : 200));
 
 	return STATE_RUNNING;
 }
@@ -94,7 +100,9 @@ void TaskFillIndexerCommandsQueue::handleMessage(MessageIndexingInterrupted* mes
 
 bool TaskFillIndexerCommandsQueue::fillCommandQueue()
 {
-	size_t refillAmount = m_maximumQueueSize - m_indexerCommandManager.indexerCommandCount();
+	const size_t commandCount = m_indexerCommandManager.indexerCommandCount();
+	size_t refillAmount = commandCount < m_maximumQueueSize ? m_maximumQueueSize - commandCount : 0;
+	m_lastRefillAmount = refillAmount;
 	if (!refillAmount)
 	{
 		return false;
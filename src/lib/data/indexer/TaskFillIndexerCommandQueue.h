@@ -16,10 +16,11 @@ class TaskFillIndexerCommandsQueue
 	, public MessageListener<MessageIndexingInterrupted>
 {
 public:
+	// the queue holds enough commands for every indexer to fetch a few batches
 	TaskFillIndexerCommandsQueue(
 		const std::string& appUUID,
 		std::unique_ptr<IndexerCommandProvider> indexerCommandProvider,
-		size_t maximumQueueSize);
+		size_t indexerThreadCount);
 
 protected:
 	void doEnter(std::shared_ptr<Blackboard> blackboard) override;
@@ -37,6 +38,7 @@ private:
 	InterprocessIndexerCommandManager m_indexerCommandManager;
 
 	const size_t m_maximumQueueSize;
+	size_t m_lastRefillAmount = 0;
 
 	std::queue<FilePath> m_filePathQueue;
 	std::mutex m_commandsMutex;
@@ -1,18 +1,39 @@
 #include "InterprocessIndexer.h"
 
+#include <algorithm>
+#include <cstdlib>
+
 #include "FileRegister.h"
 #include "IndexerCommand.h"
 #include "IndexerComposite.h"
 #include "LanguagePackageManager.h"
 #include "ScopedFunctor.h"
 #include "logging.h"
+#include "utilityMemory.h"
+
+const int InterprocessIndexer::s_memoryLimitExceededExitCode = 2;
+const size_t InterprocessIndexer::s_maximumIntermediateStorageByteSize = 33554432 /* 32 MB */;
 
-InterprocessIndexer::InterprocessIndexer(const std::string& uuid, Id processId)
+InterprocessIndexer::InterprocessIndexer(
+	const std::string& uuid,
+	Id processId,
+	size_t memoryLimit,
+	bool lowMemoryMode,
+	IndexerCommandType batchIndexerCommandType,
+	size_t batchThreadCount,
+	size_t storageChunkByteSize)
 	: m_interprocessIndexerCommandManager(uuid, processId, false)
 	, m_interprocessIndexingStatusManager(uuid, processId, false)
 	, m_interprocessIntermediateStorageManager(uuid, processId, false)
 	, m_uuid(uuid)
 	, m_processId(processId)
+	, m_memoryLimit(memoryLimit)
+	, m_lowMemoryMode(lowMemoryMode)
+	, m_batchIndexerCommandType(batchIndexerCommandType)
+	, m_batchThreadCount(std::max<size_t>(batchThreadCount, 1))
+	, m_storageChunkByteSize(memoryLimit ? 0 : storageChunkByteSize)
+	, m_memoryLimitExceeded(false)
+	, m_idleTimeMs(0)
 {
 }
 
@@ -22,17 +43,48 @@ void InterprocessIndexer::work()
 	std::shared_ptr<std::thread> updaterThread;
 	std::shared_ptr<IndexerBase> indexer;
 
+	// commands are fetched in small batches to reduce the time spent on the shared queue, commands
+	// that are left when the process stops are handed back by the main process
+	std::deque<std::shared_ptr<IndexerCommand>> fetchedIndexerCommands;
+
 	try
 	{
 		LOG_INFO_STREAM(<< m_processId << " starting up indexer");
 		indexer = LanguagePackageManager::getInstance()->instantiateSupportedIndexers();
+		indexer->setLowMemoryMode(m_lowMemoryMode);
+		indexer->setStorageChunkCallback(
+			m_storageChunkByteSize, [&](std::shared_ptr<IntermediateStorage> storage) {
+				// waiting for the app to take earlier chunks bounds the memory of both processes
+				if (waitForIntermediateStorages(updaterThreadRunning))
+				{
+					LOG_INFO_STREAM(<< m_processId << " pushing chunk of index to shared memory");
+					std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+					m_interprocessIntermediateStorageManager.pushIntermediateStorage(storage);
+					m_interprocessIndexingStatusManager.finishIndexingChunk();
+				}
+			});
 
 		updaterThread = std::make_shared<std::thread>([&]() {
+			size_t updateCount = 0;
 			while (updaterThreadRunning)
 			{
-				std::this_thread::sleep_for(std::chrono::milliseconds(1000));
+				std::this_thread::sleep_for(std::chrono::milliseconds(250));
+
+				if (isMemoryLimitExceeded())
+				{
+					// the indexer cannot be stopped in the middle of a translation unit without
+					// leaking its memory, so the whole process quits and gets restarted. The lock
+					// keeps the indexing thread from holding the shared memory mutexes meanwhile.
+					std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+					if (m_currentIndexerCommand)
+					{
+						retryCurrentIndexerCommand();
+						std::_Exit(s_memoryLimitExceededExitCode);
+					}
+				}
 
-				if (m_interprocessIndexingStatusManager.getIndexingInterrupted())
+				if (++updateCount % 4 == 0 &&
+					m_interprocessIndexingStatusManager.getIndexingInterrupted())
 				{
 					LOG_INFO_STREAM(<< m_processId << " received indexer interrupt command.");
 					if (indexer)
@@ -53,54 +105,120 @@ void InterprocessIndexer::work()
 			}
 		});
 
-		while (std::shared_ptr<IndexerCommand> indexerCommand =
-				   m_interprocessIndexerCommandManager.popIndexerCommand())
+		while (updaterThreadRunning)
 		{
-			LOG_INFO_STREAM(
-				<< m_processId << " fetched indexer command for \""
-				<< indexerCommand->getSourceFilePath().str() << "\"");
-			LOG_INFO_STREAM(
-				<< m_processId << " indexer commands left: "
-				<< m_interprocessIndexerCommandManager.indexerCommandCount());
+			if (isBatchIndexer())
+			{
+				// fetch more commands than threads, so no thread idles while others finish
+				std::vector<std::shared_ptr<IndexerCommand>> indexerCommands;
+				{
+					std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+					indexerCommands = m_interprocessIndexerCommandManager.popIndexerCommands(
+						m_batchIndexerCommandType, 2 * m_batchThreadCount);
+				}
+				if (!indexerCommands.empty())
+				{
+					if (!waitForIntermediateStorages(updaterThreadRunning))
+					{
+						break;
+					}
 
-			while (updaterThreadRunning)
+					indexBatch(indexer, indexerCommands);
+					continue;
+				}
+			}
+
+			if (fetchedIndexerCommands.empty())
 			{
-				const size_t storageCount =
-					m_interprocessIntermediateStorageManager.getIntermediateStorageCount();
-				if (storageCount < 2)
+				std::vector<std::shared_ptr<IndexerCommand>> indexerCommands;
 				{
-					break;
+					std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+					indexerCommands = m_interprocessIndexerCommandManager.fetchIndexerCommands(
+						m_batchIndexerCommandType);
 				}
+				fetchedIndexerCommands.insert(
+					fetchedIndexerCommands.end(), indexerCommands.begin(), indexerCommands.end());
 
-				LOG_INFO_STREAM(<< m_processId << " waits, too many intermediate storages: " << storageCount);
+				LOG_INFO_STREAM(
+					<< m_processId << " fetched " << indexerCommands.size() << " indexer commands");
+			}
 
-				std::this_thread::sleep_for(std::chrono::milliseconds(200));
+			if (fetchedIndexerCommands.empty())
+			{
+				if (m_batchIndexerCommandType != INDEXER_COMMAND_UNKNOWN && !isBatchIndexer() &&
+					getIndexerCommandCount())
+				{
+					// only commands for the batch indexer are left, wait for further commands
+					std::this_thread::sleep_for(std::chrono::milliseconds(200));
+					continue;
+				}
+				break;
 			}
 
-			if (!updaterThreadRunning)
+			std::shared_ptr<IndexerCommand> indexerCommand = fetchedIndexerCommands.front();
+			fetchedIndexerCommands.pop_front();
+
+			LOG_INFO_STREAM(
+				<< m_processId << " fetched indexer command for \""
+				<< indexerCommand->getSourceFilePath().str() << "\"");
+
+			if (!waitForIntermediateStorages(updaterThreadRunning))
 			{
 				break;
 			}
 
 			LOG_INFO_STREAM(<< m_processId << " updating indexer status with currently indexed filepath");
-			m_interprocessIndexingStatusManager.startIndexingSourceFile(
-				indexerCommand->getSourceFilePath());
+			{
+				std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+				m_interprocessIndexingStatusManager.startIndexingSourceFile(
+					indexerCommand->getSourceFilePath());
+				m_currentIndexerCommand = indexerCommand;
+			}
 
 			LOG_INFO_STREAM(<< m_processId << " starting to index current file");
 			std::shared_ptr<IntermediateStorage> result = indexer->index(indexerCommand);
 
-			if (result)
 			{
-				LOG_INFO_STREAM(<< m_processId << " pushing index to shared memory");
-				m_interprocessIntermediateStorageManager.pushIntermediateStorage(result);
-			}
+				std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+				m_currentIndexerCommand.reset();
+
+				if (result)
+				{
+					LOG_INFO_STREAM(<< m_processId << " pushing index to shared memory");
+					m_interprocessIntermediateStorageManager.pushIntermediateStorage(result);
+				}
 
-			LOG_INFO_STREAM(<< m_processId << " finalizing indexer status for current file");
-			m_interprocessIndexingStatusManager.finishIndexingSourceFile();
+				LOG_INFO_STREAM(<< m_processId << " finalizing indexer status for current file");
+				m_interprocessIndexingStatusManager.finishIndexingSourceFile();
+			}
 
 			LOG_INFO_STREAM(<< m_processId << " all done");
+
+			if (isMemoryLimitExceeded())
+			{
+				// memory freed by the indexer is not necessarily returned to the system, restart
+				// the process before blaming the next translation unit for it
+				LOG_INFO_STREAM(<< m_processId << " exceeds memory limit, restarting indexer");
+				m_memoryLimitExceeded = true;
+				break;
+			}
 		}
 	}
+	catch (std::bad_alloc& e)
+	{
+		LOG_ERROR_STREAM(<< m_processId << " error: " << e.what());
+		if (!m_memoryLimit)
+		{
+			throw e;
+		}
+
+		std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+		if (m_currentIndexerCommand)
+		{
+			retryCurrentIndexerCommand();
+		}
+		m_memoryLimitExceeded = true;
+	}
 	catch (boost::interprocess::interprocess_exception& e)
 	{
 		LOG_ERROR_STREAM(<< m_processId << " error: " << e.what());
@@ -116,5 +234,109 @@ void InterprocessIndexer::work()
 		LOG_ERROR_STREAM(<< m_processId << " something went wrong while running the indexer");
 	}
 
+	LOG_INFO_STREAM(
+		<< m_processId << " shared memory remaps: "
+		<< m_interprocessIntermediateStorageManager.getRemapCount()
+		<< " copy retries: " << m_interprocessIntermediateStorageManager.getRetryCount()
+		<< " idle time: " << m_idleTimeMs / 1000.0 << "s");
 	LOG_INFO_STREAM(<< m_processId << " shutting down indexer");
 }
+
+bool InterprocessIndexer::hasExceededMemoryLimit() const
+{
+	return m_memoryLimitExceeded;
+}
+
+bool InterprocessIndexer::isBatchIndexer() const
+{
+	return m_batchIndexerCommandType != INDEXER_COMMAND_UNKNOWN && m_processId == 1;
+}
+
+bool InterprocessIndexer::waitForIntermediateStorages(const bool& updaterThreadRunning)
+{
+	while (updaterThreadRunning)
+	{
+		// many small storages may be queued at once, but only little data from large files
+		size_t storageByteSize = 0;
+		{
+			std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+			storageByteSize =
+				m_interprocessIntermediateStorageManager.getIntermediateStorageByteSize();
+		}
+		if (storageByteSize < s_maximumIntermediateStorageByteSize)
+		{
+			return true;
+		}
+
+		LOG_INFO_STREAM(
+			<< m_processId << " waits, too much data in intermediate storages: "
+			<< storageByteSize);
+
+		std::this_thread::sleep_for(std::chrono::milliseconds(200));
+		m_idleTimeMs += 200;
+	}
+	return false;
+}
+
+void InterprocessIndexer::indexBatch(
+	std::shared_ptr<IndexerBase> indexer,
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands)
+{
+	std::vector<FilePath> sourceFilePaths;
+	for (const std::shared_ptr<IndexerCommand>& indexerCommand: indexerCommands)
+	{
+		sourceFilePaths.push_back(indexerCommand->getSourceFilePath());
+	}
+
+	LOG_INFO_STREAM(
+		<< m_processId << " starting to index batch of " << indexerCommands.size() << " files on "
+		<< m_batchThreadCount << " threads");
+	{
+		std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+		m_interprocessIndexingStatusManager.startIndexingSourceFiles(sourceFilePaths);
+	}
+
+	// the memory limit retry only hands back single commands, so it does not apply to batches
+	const std::vector<std::shared_ptr<IntermediateStorage>> results = indexer->indexBatch(
+		indexerCommands, m_batchThreadCount);
+
+	std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+	if (results.empty())
+	{
+		m_interprocessIndexingStatusManager.cancelIndexingSourceFile();
+		return;
+	}
+
+	LOG_INFO_STREAM(<< m_processId << " pushing " << results.size() << " indexes to shared memory");
+	// the current files of the batch are only cleared after its last index is pushed, so a crash in
+	// between still reports the files that did not reach the shared memory
+	for (size_t i = 0; i + 1 < results.size(); i++)
+	{
+		m_interprocessIntermediateStorageManager.pushIntermediateStorage(results[i]);
+		m_interprocessIndexingStatusManager.finishIndexingChunk();
+	}
+	m_interprocessIntermediateStorageManager.pushIntermediateStorage(results.back());
+	m_interprocessIndexingStatusManager.finishIndexingSourceFile();
+}
+
+size_t InterprocessIndexer::getIndexerCommandCount()
+{
+	std::lock_guard<std::mutex> lock(m_currentIndexerCommandMutex);
+	return m_interprocessIndexerCommandManager.indexerCommandCount();
+}
+
+bool InterprocessIndexer::isMemoryLimitExceeded() const
+{
+	return m_memoryLimit && utility::getProcessMemoryUsage() > m_memoryLimit;
+}
+
+void InterprocessIndexer::retryCurrentIndexerCommand()
+{
+	LOG_WARNING_STREAM(
+		<< m_processId << " exceeded memory limit of " << (m_memoryLimit >> 20)
+		<< " MB while indexing \"" << m_currentIndexerCommand->getSourceFilePath().str()
+		<< "\", handing back command for retry");
+
+	m_interprocessIndexerCommandManager.pushRetryIndexerCommand(m_currentIndexerCommand);
+	m_interprocessIndexingStatusManager.cancelIndexingSourceFile();
+}
@@ -1,24 +1,74 @@
 #ifndef INTERPROCESS_INDEXER_H
 #define INTERPROCESS_INDEXER_H
 
+#include <deque>
+#include <mutex>
+
 #include "InterprocessIndexerCommandManager.h"
 #include "InterprocessIndexingStatusManager.h"
 #include "InterprocessIntermediateStorageManager.h"
 
+class IndexerBase;
+
 class InterprocessIndexer
 {
 public:
-	InterprocessIndexer(const std::string& uuid, Id processId);
+	static const int s_memoryLimitExceededExitCode;
+
+	// A memory limit of 0 disables memory monitoring. Otherwise the indexer hands back the command
+	// of a translation unit that makes the process exceed the limit for a later retry and quits.
+	// Commands of the batch type are all indexed by the indexer with process id 1, which passes
+	// them on in batches to an indexer running batchThreadCount threads. The other indexers skip
+	// them. INDEXER_COMMAND_UNKNOWN indexes all commands one by one. Storages growing beyond
+	// storageChunkByteSize are handed over in chunks while indexing, 0 disables chunking. Chunking
+	// is also disabled by a memory limit, because a translation unit handed back for a retry is
+	// indexed again from the start and its earlier chunks would be injected twice.
+	InterprocessIndexer(
+		const std::string& uuid,
+		Id processId,
+		size_t memoryLimit = 0,
+		bool lowMemoryMode = false,
+		IndexerCommandType batchIndexerCommandType = INDEXER_COMMAND_UNKNOWN,
+		size_t batchThreadCount = 0,
+		size_t storageChunkByteSize = 0);
 
 	void work();
 
+	bool hasExceededMemoryLimit() const;
+
 private:
+	bool isBatchIndexer() const;
+	bool waitForIntermediateStorages(const bool& updaterThreadRunning);
+	void indexBatch(
+		std::shared_ptr<IndexerBase> indexer,
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands);
+	size_t getIndexerCommandCount();
+
+	bool isMemoryLimitExceeded() const;
+	void retryCurrentIndexerCommand();
+
+	static const size_t s_maximumIntermediateStorageByteSize;
+
 	InterprocessIndexerCommandManager m_interprocessIndexerCommandManager;
 	InterprocessIndexingStatusManager m_interprocessIndexingStatusManager;
 	InterprocessIntermediateStorageManager m_interprocessIntermediateStorageManager;
 
 	const std::string m_uuid;
 	const Id m_processId;
+	const size_t m_memoryLimit;
+	const bool m_lowMemoryMode;
+	const IndexerCommandType m_batchIndexerCommandType;
+	const size_t m_batchThreadCount;
+	const size_t m_storageChunkByteSize;
+	bool m_memoryLimitExceeded;
+
+	// time spent waiting for the app to take the storages of earlier files
+	size_t m_idleTimeMs;
+
+	// the mutex is also held during each access of the shared memory by the indexing threads, so
+	// the memory monitoring never quits the process while it holds a shared memory mutex
+	std::shared_ptr<IndexerCommand> m_currentIndexerCommand;
+	std::mutex m_currentIndexerCommandMutex;
 };
 
 #endif	  // INTERPROCESS_INDEXER_H
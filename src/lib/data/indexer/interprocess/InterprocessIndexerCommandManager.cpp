@@ -1,11 +1,20 @@
 #include "InterprocessIndexerCommandManager.h"
 
+#include "FileSystem.h"
 #include "IndexerCommand.h"
 #include "logging.h"
 
+const size_t InterprocessIndexerCommandManager::s_maximumFetchedCommandCount = 8;
+const size_t InterprocessIndexerCommandManager::s_maximumFetchedSourceFileByteSize =
+	65536 /* 64 KB */;
+
 const char* InterprocessIndexerCommandManager::s_sharedMemoryNamePrefix = "icmd_";
 
 const char* InterprocessIndexerCommandManager::s_indexerCommandsKeyName = "indexer_commands";
+const char* InterprocessIndexerCommandManager::s_retryIndexerCommandsKeyName =
+	"retry_indexer_commands";
+const char* InterprocessIndexerCommandManager::s_fetchedIndexerCommandsKeyNamePrefix =
+	"fetched_indexer_commands_";
 
 InterprocessIndexerCommandManager::InterprocessIndexerCommandManager(
 	const std::string& instanceUuid, Id processId, bool isOwner)
@@ -19,64 +28,164 @@ InterprocessIndexerCommandManager::~InterprocessIndexerCommandManager() {}
 void InterprocessIndexerCommandManager::pushIndexerCommands(
 	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands)
 {
-	size_t size = 0;
+	pushIndexerCommands(indexerCommands, s_indexerCommandsKeyName);
+}
+
+std::shared_ptr<IndexerCommand> InterprocessIndexerCommandManager::popIndexerCommand(
+	IndexerCommandType excludedType)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Queue<SharedIndexerCommand>* queue =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
+			s_indexerCommandsKeyName);
+	if (!queue || !queue->size())
 	{
-		const size_t overestimationMultiplier = 2;
-		for (auto& command: indexerCommands)
+		return nullptr;
+	}
+
+	if (excludedType == INDEXER_COMMAND_UNKNOWN)
+	{
+		std::shared_ptr<IndexerCommand> command = SharedIndexerCommand::fromShared(queue->front());
+
+		queue->pop_front();
+
+		return command;
+	}
+
+	for (auto it = queue->begin(); it != queue->end(); it++)
+	{
+		if (it->getIndexerCommandType() != excludedType)
 		{
-			size += command->getByteSize(sizeof(SharedMemory::String)) + sizeof(SharedIndexerCommand);
+			std::shared_ptr<IndexerCommand> command = SharedIndexerCommand::fromShared(*it);
+
+			queue->erase(it);
+
+			return command;
 		}
-		size *= overestimationMultiplier;
 	}
 
+	return nullptr;
+}
+
+std::vector<std::shared_ptr<IndexerCommand>> InterprocessIndexerCommandManager::popIndexerCommands(
+	IndexerCommandType type, size_t maximumCount)
+{
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
-	while (access.getFreeMemorySize() < size)
-	{
-		size_t currentSize = access.getMemorySize();
-		LOG_INFO_STREAM(
-			<< "grow memory - est: " << size << " size: " << currentSize
-			<< " free: " << access.getFreeMemorySize() << " alloc: " << (currentSize));
 
-		access.growMemory(currentSize);
+	std::vector<std::shared_ptr<IndexerCommand>> commands;
 
-		LOG_INFO("growing memory succeeded");
+	SharedMemory::Queue<SharedIndexerCommand>* queue =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
+			s_indexerCommandsKeyName);
+	if (queue)
+	{
+		for (auto it = queue->begin(); it != queue->end() && commands.size() < maximumCount;)
+		{
+			if (it->getIndexerCommandType() == type)
+			{
+				if (std::shared_ptr<IndexerCommand> command = SharedIndexerCommand::fromShared(*it))
+				{
+					commands.push_back(command);
+				}
+				it = queue->erase(it);
+			}
+			else
+			{
+				it++;
+			}
+		}
 	}
 
+	return commands;
+}
+
+std::vector<std::shared_ptr<IndexerCommand>> InterprocessIndexerCommandManager::fetchIndexerCommands(
+	IndexerCommandType excludedType)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	std::vector<std::shared_ptr<IndexerCommand>> commands;
+
 	SharedMemory::Queue<SharedIndexerCommand>* queue =
 		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
 			s_indexerCommandsKeyName);
-	if (!queue)
+	SharedMemory::Queue<SharedIndexerCommand>* fetchedQueue =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
+			s_fetchedIndexerCommandsKeyNamePrefix + std::to_string(getProcessId()));
+	if (!queue || !fetchedQueue)
 	{
-		return;
+		return commands;
 	}
 
-	for (auto& command: indexerCommands)
+	// all commands of the previous fetch have been started by now
+	fetchedQueue->clear();
+
+	size_t sourceFileByteSize = 0;
+	for (auto it = queue->begin();
+		 it != queue->end() && commands.size() < s_maximumFetchedCommandCount;)
 	{
-		queue->push_back(SharedIndexerCommand(access.getAllocator()));
-		SharedIndexerCommand& sharedCommand = queue->back();
-		sharedCommand.fromLocal(command.get());
+		if (excludedType != INDEXER_COMMAND_UNKNOWN && it->getIndexerCommandType() == excludedType)
+		{
+			it++;
+			continue;
+		}
+
+		// the first command is fetched even if it exceeds the limit on its own
+		sourceFileByteSize += it->getSourceFileByteSize();
+		if (!commands.empty() && sourceFileByteSize > s_maximumFetchedSourceFileByteSize)
+		{
+			break;
+		}
+
+		if (std::shared_ptr<IndexerCommand> command = SharedIndexerCommand::fromShared(*it))
+		{
+			commands.push_back(command);
+			fetchedQueue->push_back(*it);
+		}
+		it = queue->erase(it);
 	}
 
-	LOG_INFO(access.logString());
+	return commands;
 }
 
-std::shared_ptr<IndexerCommand> InterprocessIndexerCommandManager::popIndexerCommand()
+void InterprocessIndexerCommandManager::requeueFetchedIndexerCommands(
+	Id processId, const FilePath& lastStartedSourceFilePath)
 {
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
 	SharedMemory::Queue<SharedIndexerCommand>* queue =
 		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
 			s_indexerCommandsKeyName);
-	if (!queue || !queue->size())
+	SharedMemory::Queue<SharedIndexerCommand>* fetchedQueue =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
+			s_fetchedIndexerCommandsKeyNamePrefix + std::to_string(processId));
+	if (!queue || !fetchedQueue)
 	{
-		return nullptr;
+		return;
 	}
 
-	std::shared_ptr<IndexerCommand> command = SharedIndexerCommand::fromShared(queue->front());
+	// commands are indexed in the order they were fetched, so all commands after the last started
+	// one have not been indexed
+	auto requeueBegin = fetchedQueue->begin();
+	for (auto it = fetchedQueue->begin(); it != fetchedQueue->end(); it++)
+	{
+		if (it->getSourceFilePath() == lastStartedSourceFilePath)
+		{
+			requeueBegin = it + 1;
+			break;
+		}
+	}
 
-	queue->pop_front();
+	if (requeueBegin != fetchedQueue->end())
+	{
+		LOG_INFO_STREAM(
+			<< "requeueing " << (fetchedQueue->end() - requeueBegin)
+			<< " indexer commands fetched by process " << processId);
+		queue->insert(queue->begin(), requeueBegin, fetchedQueue->end());
+	}
 
-	return command;
+	fetchedQueue->clear();
 }
 
 void InterprocessIndexerCommandManager::clearIndexerCommands()
@@ -108,3 +217,85 @@ size_t InterprocessIndexerCommandManager::indexerCommandCount()
 
 	return queue->size();
 }
+
+void InterprocessIndexerCommandManager::pushRetryIndexerCommand(
+	std::shared_ptr<IndexerCommand> indexerCommand)
+{
+	pushIndexerCommands({indexerCommand}, s_retryIndexerCommandsKeyName);
+}
+
+std::vector<std::shared_ptr<IndexerCommand>> InterprocessIndexerCommandManager::popRetryIndexerCommands()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	std::vector<std::shared_ptr<IndexerCommand>> commands;
+
+	SharedMemory::Queue<SharedIndexerCommand>* queue =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(
+			s_retryIndexerCommandsKeyName);
+	if (queue)
+	{
+		while (queue->size())
+		{
+			if (std::shared_ptr<IndexerCommand> command = SharedIndexerCommand::fromShared(
+					queue->front()))
+			{
+				commands.push_back(command);
+			}
+			queue->pop_front();
+		}
+	}
+
+	return commands;
+}
+
+void InterprocessIndexerCommandManager::pushIndexerCommands(
+	const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands, const char* keyName)
+{
+	size_t size = 0;
+	std::vector<size_t> sourceFileByteSizes;
+	{
+		const size_t overestimationMultiplier = 2;
+		for (auto& command: indexerCommands)
+		{
+			size += command->getByteSize(sizeof(SharedMemory::String)) + sizeof(SharedIndexerCommand);
+
+			const FilePath& sourceFilePath = command->getSourceFilePath();
+			sourceFileByteSizes.push_back(
+				sourceFilePath.exists()
+					? static_cast<size_t>(FileSystem::getFileByteSize(sourceFilePath))
+					: 0);
+		}
+		size *= overestimationMultiplier;
+	}
+
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+	while (access.getFreeMemorySize() < size)
+	{
+		size_t currentSize = access.getMemorySize();
+		LOG_INFO_STREAM(
+			<< "grow memory - est: " << size << " size: " << currentSize
+			<< " free: " << access.getFreeMemorySize() << " alloc: " << (currentSize));
+
+		access.growMemory(currentSize);
+
+		LOG_INFO("growing memory succeeded");
+	}
+
+	SharedMemory::Queue<SharedIndexerCommand>* queue =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIndexerCommand>>(keyName);
+	if (!queue)
+	{
+		return;
+	}
+
+	for (size_t i = 0; i < indexerCommands.size(); i++)
+	{
+		queue->push_back(SharedIndexerCommand(access.getAllocator()));
+		SharedIndexerCommand& sharedCommand = queue->back();
+		sharedCommand.fromLocal(indexerCommands[i].get());
+		sharedCommand.setSourceFileByteSize(sourceFileByteSizes[i]);
+	}
+
+	LOG_INFO(access.logString());
+}
@@ -2,6 +2,7 @@
 #define INTERPROCESS_INDEXER_COMMAND_MANAGER_H
 
 #include "BaseInterprocessDataManager.h"
+#include "IndexerCommandType.h"
 #include "SharedIndexerCommand.h"
 
 class IndexerCommand;
@@ -9,18 +10,48 @@ class IndexerCommand;
 class InterprocessIndexerCommandManager: public BaseInterprocessDataManager
 {
 public:
+	// limits of the commands an indexer fetches at once, many small source files are fetched
+	// together while large ones are fetched one by one
+	static const size_t s_maximumFetchedCommandCount;
+	static const size_t s_maximumFetchedSourceFileByteSize;
+
 	InterprocessIndexerCommandManager(const std::string& instanceUuid, Id processId, bool isOwner);
 	virtual ~InterprocessIndexerCommandManager();
 
 	void pushIndexerCommands(const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands);
-	std::shared_ptr<IndexerCommand> popIndexerCommand();
+	// pops the first command that is not of the excluded type
+	std::shared_ptr<IndexerCommand> popIndexerCommand(
+		IndexerCommandType excludedType = INDEXER_COMMAND_UNKNOWN);
+
+	// pops up to maximumCount commands of the given type, wherever they are in the queue
+	std::vector<std::shared_ptr<IndexerCommand>> popIndexerCommands(
+		IndexerCommandType type, size_t maximumCount);
+
+	// pops the first commands that are not of the excluded type, until the fetch limits are
+	// reached. The commands are remembered as fetched by this process until its next fetch, so
+	// they can be handed back if the process stops before indexing all of them.
+	std::vector<std::shared_ptr<IndexerCommand>> fetchIndexerCommands(
+		IndexerCommandType excludedType = INDEXER_COMMAND_UNKNOWN);
+
+	// pushes the commands fetched by the given process that come after the last started source
+	// file back to the front of the queue, or all of them if that file was not fetched
+	void requeueFetchedIndexerCommands(Id processId, const FilePath& lastStartedSourceFilePath);
 
 	void clearIndexerCommands();
 	size_t indexerCommandCount();
 
+	// commands of translation units that exceeded the memory limit of the indexer process
+	void pushRetryIndexerCommand(std::shared_ptr<IndexerCommand> indexerCommand);
+	std::vector<std::shared_ptr<IndexerCommand>> popRetryIndexerCommands();
+
 private:
+	void pushIndexerCommands(
+		const std::vector<std::shared_ptr<IndexerCommand>>& indexerCommands, const char* keyName);
+
 	static const char* s_sharedMemoryNamePrefix;
 	static const char* s_indexerCommandsKeyName;
+	static const char* s_retryIndexerCommandsKeyName;
+	static const char* s_fetchedIndexerCommandsKeyNamePrefix;
 };
 
 #endif	  // INTERPROCESS_INDEXER_COMMAND_MANAGER_H
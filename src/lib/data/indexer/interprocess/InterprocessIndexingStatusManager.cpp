@@ -1,6 +1,7 @@
 #include "InterprocessIndexingStatusManager.h"
 
 #include "logging.h"
+#include "utility.h"
 #include "utilityString.h"
 
 const char* InterprocessIndexingStatusManager::s_sharedMemoryNamePrefix = "ists_";
@@ -8,6 +9,7 @@ const char* InterprocessIndexingStatusManager::s_sharedMemoryNamePrefix = "ists_
 const char* InterprocessIndexingStatusManager::s_indexingFilesKeyName = "indexing_files";
 const char* InterprocessIndexingStatusManager::s_currentFilesKeyName = "current_files";
 const char* InterprocessIndexingStatusManager::s_crashedFilesKeyName = "crashed_files";
+const char* InterprocessIndexingStatusManager::s_lastStartedFilesKeyName = "last_started_files";
 const char* InterprocessIndexingStatusManager::s_finishedProcessIdsKeyName = "finished_process_ids";
 const char* InterprocessIndexingStatusManager::s_indexingInterruptedKeyName =
 	"indexing_interrupted_flag";
@@ -22,17 +24,32 @@ InterprocessIndexingStatusManager::InterprocessIndexingStatusManager(
 InterprocessIndexingStatusManager::~InterprocessIndexingStatusManager() {}
 
 void InterprocessIndexingStatusManager::startIndexingSourceFile(const FilePath& filePath)
+{
+	startIndexingSourceFiles({filePath});
+}
+
+void InterprocessIndexingStatusManager::startIndexingSourceFiles(
+	const std::vector<FilePath>& filePaths)
 {
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
+	// the current files of a process are stored as a single newline separated string
+	std::string currentFilesString;
+
 	SharedMemory::Queue<SharedMemory::String>* indexingFilesPtr =
 		access.accessValueWithAllocator<SharedMemory::Queue<SharedMemory::String>>(
 			s_indexingFilesKeyName);
-	if (indexingFilesPtr)
+	for (const FilePath& filePath: filePaths)
 	{
-		SharedMemory::String fileStr(access.getAllocator());
-		fileStr = utility::encodeToUtf8(filePath.wstr()).c_str();
-		indexingFilesPtr->push_back(fileStr);
+		const std::string filePathString = utility::encodeToUtf8(filePath.wstr());
+		if (indexingFilesPtr)
+		{
+			SharedMemory::String fileStr(access.getAllocator());
+			fileStr = filePathString.c_str();
+			indexingFilesPtr->push_back(fileStr);
+		}
+
+		currentFilesString += (currentFilesString.empty() ? "" : "\n") + filePathString;
 	}
 
 	SharedMemory::Map<Id, SharedMemory::String>* currentFilesPtr =
@@ -80,11 +97,25 @@ void InterprocessIndexingStatusManager::startIndexingSourceFile(const FilePath&
 		}
 
 		SharedMemory::String str(access.getAllocator());
-		str = utility::encodeToUtf8(filePath.wstr()).c_str();
+		str = currentFilesString.c_str();
 
 		it = currentFilesPtr->insert(std::pair<Id, SharedMemory::String>(getProcessId(), str)).first;
 		it->second = str;
 	}
+
+	SharedMemory::Map<Id, SharedMemory::String>* lastStartedFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Map<Id, SharedMemory::String>>(
+			s_lastStartedFilesKeyName);
+	if (lastStartedFilesPtr && !filePaths.empty())
+	{
+		SharedMemory::String str(access.getAllocator());
+		str = utility::encodeToUtf8(filePaths.back().wstr()).c_str();
+
+		SharedMemory::Map<Id, SharedMemory::String>::iterator it =
+			lastStartedFilesPtr->insert(std::pair<Id, SharedMemory::String>(getProcessId(), str))
+				.first;
+		it->second = str;
+	}
 }
 
 void InterprocessIndexingStatusManager::finishIndexingSourceFile()
@@ -107,6 +138,31 @@ void InterprocessIndexingStatusManager::finishIndexingSourceFile()
 	}
 }
 
+void InterprocessIndexingStatusManager::finishIndexingChunk()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Queue<Id>* finishedProcessIdsPtr =
+		access.accessValueWithAllocator<SharedMemory::Queue<Id>>(s_finishedProcessIdsKeyName);
+	if (finishedProcessIdsPtr)
+	{
+		finishedProcessIdsPtr->push_back(m_processId);
+	}
+}
+
+void InterprocessIndexingStatusManager::cancelIndexingSourceFile()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Map<Id, SharedMemory::String>* currentFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Map<Id, SharedMemory::String>>(
+			s_currentFilesKeyName);
+	if (currentFilesPtr)
+	{
+		currentFilesPtr->erase(getProcessId());
+	}
+}
+
 void InterprocessIndexingStatusManager::setIndexingInterrupted(bool interrupted)
 {
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
@@ -183,7 +239,7 @@ std::vector<FilePath> InterprocessIndexingStatusManager::getCrashedSourceFilePat
 	{
 		for (size_t i = 0; i < crashedFilesPtr->size(); i++)
 		{
-			crashedFiles.push_back(FilePath(utility::decodeFromUtf8(crashedFilesPtr->at(i).c_str())));
+			utility::append(crashedFiles, getSourceFilePaths(crashedFilesPtr->at(i).c_str()));
 		}
 	}
 
@@ -196,9 +252,43 @@ std::vector<FilePath> InterprocessIndexingStatusManager::getCrashedSourceFilePat
 			 it != currentFilesPtr->end();
 			 it++)
 		{
-			crashedFiles.push_back(FilePath(utility::decodeFromUtf8(it->second.c_str())));
+			utility::append(crashedFiles, getSourceFilePaths(it->second.c_str()));
 		}
 	}
 
 	return crashedFiles;
 }
+
+FilePath InterprocessIndexingStatusManager::getLastStartedSourceFilePath(Id processId)
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Map<Id, SharedMemory::String>* lastStartedFilesPtr =
+		access.accessValueWithAllocator<SharedMemory::Map<Id, SharedMemory::String>>(
+			s_lastStartedFilesKeyName);
+	if (lastStartedFilesPtr)
+	{
+		SharedMemory::Map<Id, SharedMemory::String>::iterator it = lastStartedFilesPtr->find(
+			processId);
+		if (it != lastStartedFilesPtr->end())
+		{
+			return FilePath(utility::decodeFromUtf8(it->second.c_str()));
+		}
+	}
+
+	return FilePath();
+}
+
+std::vector<FilePath> InterprocessIndexingStatusManager::getSourceFilePaths(
+	const std::string& currentFilesString)
+{
+	std::vector<FilePath> filePaths;
+	for (const std::string& filePathString: utility::splitToVector(currentFilesString, '\n'))
+	{
+		if (!filePathString.empty())
+		{
+			filePaths.push_back(FilePath(utility::decodeFromUtf8(filePathString)));
+		}
+	}
+	return filePaths;
+}
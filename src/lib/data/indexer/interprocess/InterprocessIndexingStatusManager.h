@@ -13,8 +13,19 @@ public:
 	virtual ~InterprocessIndexingStatusManager();
 
 	void startIndexingSourceFile(const FilePath& filePath);
+
+	// starts indexing several source files at once, all of them are reported as crashed if the
+	// process does not finish them
+	void startIndexingSourceFiles(const std::vector<FilePath>& filePaths);
 	void finishIndexingSourceFile();
 
+	// announces a chunk of the intermediate storage of the current source file, or one index of the
+	// current batch, which stays in progress until it is finished
+	void finishIndexingChunk();
+
+	// stops indexing the current source file without reporting it as finished or crashed
+	void cancelIndexingSourceFile();
+
 	void setIndexingInterrupted(bool interrupted);
 	bool getIndexingInterrupted();
 
@@ -23,12 +34,18 @@ public:
 	std::vector<FilePath> getCurrentlyIndexedSourceFilePaths();
 	std::vector<FilePath> getCrashedSourceFilePaths();
 
+	// the source file the given process started to index last, kept after it finished
+	FilePath getLastStartedSourceFilePath(Id processId);
+
 private:
+	static std::vector<FilePath> getSourceFilePaths(const std::string& currentFilesString);
+
 	static const char* s_sharedMemoryNamePrefix;
 
 	static const char* s_indexingFilesKeyName;
 	static const char* s_currentFilesKeyName;
 	static const char* s_crashedFilesKeyName;
+	static const char* s_lastStartedFilesKeyName;
 	static const char* s_finishedProcessIdsKeyName;
 	static const char* s_indexingInterruptedKeyName;
 };
@@ -1,5 +1,7 @@
 #include "InterprocessIntermediateStorageManager.h"
 
+#include <algorithm>
+
 #include "IntermediateStorage.h"
 #include "SharedIntermediateStorage.h"
 #include "logging.h"
@@ -9,6 +11,13 @@ const char* InterprocessIntermediateStorageManager::s_sharedMemoryNamePrefix = "
 const char* InterprocessIntermediateStorageManager::s_intermediatStoragesKeyName =
 	"intermediate_storages";
 
+// room for the queue itself and the named object index of the segment
+const size_t InterprocessIntermediateStorageManager::s_queueByteSize = 65536 /* 64 kB */;
+
+const size_t InterprocessIntermediateStorageManager::s_maximumRetryCount = 3;
+
+const size_t InterprocessIntermediateStorageManager::s_shrinkFreeMemoryFactor = 4;
+
 InterprocessIntermediateStorageManager::InterprocessIntermediateStorageManager(
 	const std::string& instanceUuid, Id processId, bool isOwner)
 	: BaseInterprocessDataManager(
@@ -17,78 +26,86 @@ InterprocessIntermediateStorageManager::InterprocessIntermediateStorageManager(
 		  instanceUuid,
 		  processId,
 		  isOwner)
-	, m_insertsWithoutGrowth(0)
+	, m_largestRequiredSize(0)
+	, m_remapCount(0)
+	, m_retryCount(0)
 {
 }
 
 void InterprocessIntermediateStorageManager::pushIntermediateStorage(
 	const std::shared_ptr<IntermediateStorage>& intermediateStorage)
 {
-	const size_t requiredInsertsToShrink = 10;
+	const size_t requiredSize = SharedIntermediateStorage::getByteSize(*intermediateStorage) +
+		SharedMemory::getAllocationByteSize(sizeof(SharedIntermediateStorage)) + s_queueByteSize;
 
-	const size_t overestimationMultiplier = 2;
-	const size_t requiredSize = (intermediateStorage->getByteSize(sizeof(SharedMemory::String)) +
-								 sizeof(SharedIntermediateStorage)) *
-			overestimationMultiplier +
-		1048576 /* 1 MB */;
+	// slowly forget large storages, so the segment can shrink after indexing a large file
+	m_largestRequiredSize = std::max(
+		requiredSize, m_largestRequiredSize - m_largestRequiredSize / 8);
 
 	SharedMemory::ScopedAccess access(&m_sharedMemory);
 
-	const size_t freeMemory = access.getFreeMemorySize();
-	if (freeMemory < requiredSize)
-	{
-		const size_t requiredGrowth = requiredSize - freeMemory;
-
-		LOG_INFO_STREAM(
-			<< "grow memory - est: " << requiredSize << " size: " << access.getMemorySize()
-			<< " free: " << access.getFreeMemorySize() << " alloc: " << requiredGrowth);
-
-		access.growMemory(requiredGrowth);
-
-		LOG_INFO("growing memory succeeded");
-
-		m_insertsWithoutGrowth = 0;
-	}
-	else
-	{
-		m_insertsWithoutGrowth++;
-	}
-
-	SharedMemory::Queue<SharedIntermediateStorage>* queue =
-		access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(
-			s_intermediatStoragesKeyName);
-	if (!queue)
+	for (size_t retry = 0;; retry++)
 	{
-		return;
+		// the free memory may be fragmented, so each retry asks for room of another copy
+		reserveMemory(access, requiredSize * (retry + 1));
+
+		SharedMemory::Queue<SharedIntermediateStorage>* queue =
+			access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(
+				s_intermediatStoragesKeyName);
+		if (!queue)
+		{
+			return;
+		}
+
+		const size_t queueSize = queue->size();
+
+		try
+		{
+			queue->push_back(SharedIntermediateStorage(access.getAllocator()));
+			SharedIntermediateStorage& storage = queue->back();
+
+			storage.setStorageNodes(intermediateStorage->getStorageNodes());
+			storage.setStorageFiles(intermediateStorage->getStorageFiles());
+			storage.setStorageSymbols(intermediateStorage->getStorageSymbols());
+			storage.setStorageEdges(intermediateStorage->getStorageEdges());
+			storage.setStorageLocalSymbols(intermediateStorage->getStorageLocalSymbols());
+			storage.setStorageSourceLocations(intermediateStorage->getStorageSourceLocations());
+			storage.setStorageOccurrences(intermediateStorage->getStorageOccurrences());
+			storage.setStorageComponentAccesses(intermediateStorage->getComponentAccesses());
+			storage.setStorageErrors(intermediateStorage->getErrors());
+
+			storage.setNextId(intermediateStorage->getNextId());
+			storage.setIsChunk(intermediateStorage->isChunk());
+			storage.setSourceFileChunkCounts(intermediateStorage->getSourceFileChunkCounts());
+			break;
+		}
+		catch (boost::interprocess::bad_alloc&)
+		{
+			if (queue->size() > queueSize)
+			{
+				queue->pop_back();
+			}
+
+			if (retry >= s_maximumRetryCount)
+			{
+				LOG_ERROR_STREAM(
+					<< "copying intermediate storage failed - est: " << requiredSize << " "
+					<< access.logString());
+				throw;
+			}
+
+			m_retryCount++;
+
+			LOG_WARNING_STREAM(
+				<< "copying intermediate storage failed, retrying - est: " << requiredSize << " "
+				<< access.logString());
+		}
 	}
 
-	queue->push_back(SharedIntermediateStorage(access.getAllocator()));
-	SharedIntermediateStorage& storage = queue->back();
-
-	storage.setStorageNodes(intermediateStorage->getStorageNodes());
-	storage.setStorageFiles(intermediateStorage->getStorageFiles());
-	storage.setStorageSymbols(intermediateStorage->getStorageSymbols());
-	storage.setStorageEdges(intermediateStorage->getStorageEdges());
-	storage.setStorageLocalSymbols(intermediateStorage->getStorageLocalSymbols());
-	storage.setStorageSourceLocations(intermediateStorage->getStorageSourceLocations());
-	storage.setStorageOccurrences(intermediateStorage->getStorageOccurrences());
-	storage.setStorageComponentAccesses(intermediateStorage->getComponentAccesses());
-	storage.setStorageErrors(intermediateStorage->getErrors());
+	shrinkMemory(access);
 
-	storage.setNextId(intermediateStorage->getNextId());
-
-	if (m_insertsWithoutGrowth >= requiredInsertsToShrink)
-	{
-		m_insertsWithoutGrowth = 0;
-
-		LOG_INFO("shrinking shared memory");
-		access.shrinkToFitMemory();
-		LOG_INFO_STREAM(
-			<< "shrunk memory - size: " << access.getMemorySize()
-			<< " free: " << access.getFreeMemorySize());
-	}
-
-	LOG_INFO(access.logString());
+	LOG_INFO_STREAM(
+		<< access.logString() << " remaps: " << m_remapCount << " retries: " << m_retryCount);
 }
 
 std::shared_ptr<IntermediateStorage> InterprocessIntermediateStorageManager::popIntermediateStorage()
@@ -118,6 +135,8 @@ std::shared_ptr<IntermediateStorage> InterprocessIntermediateStorageManager::pop
 	storage->setErrors(sharedIntermediateStorage.getStorageErrors());
 
 	storage->setNextId(sharedIntermediateStorage.getNextId());
+	storage->setIsChunk(sharedIntermediateStorage.isChunk());
+	storage->addSourceFileChunkCounts(sharedIntermediateStorage.getSourceFileChunkCounts());
 
 	queue->pop_front();
 	LOG_INFO(access.logString());
@@ -139,3 +158,71 @@ size_t InterprocessIntermediateStorageManager::getIntermediateStorageCount()
 
 	return queue->size();
 }
+
+size_t InterprocessIntermediateStorageManager::getIntermediateStorageByteSize()
+{
+	SharedMemory::ScopedAccess access(&m_sharedMemory);
+
+	SharedMemory::Queue<SharedIntermediateStorage>* queue =
+		access.accessValueWithAllocator<SharedMemory::Queue<SharedIntermediateStorage>>(
+			s_intermediatStoragesKeyName);
+	if (!queue || !queue->size())
+	{
+		return 0;
+	}
+
+	return access.getUsedMemorySize();
+}
+
+size_t InterprocessIntermediateStorageManager::getRemapCount() const
+{
+	return m_remapCount;
+}
+
+size_t InterprocessIntermediateStorageManager::getRetryCount() const
+{
+	return m_retryCount;
+}
+
+void InterprocessIntermediateStorageManager::reserveMemory(
+	SharedMemory::ScopedAccess& access, size_t requiredSize)
+{
+	const size_t freeMemory = access.getFreeMemorySize();
+	if (freeMemory >= requiredSize)
+	{
+		return;
+	}
+
+	// grow by at least half of the current size, so a run of growing storages remaps rarely
+	const size_t requiredGrowth = std::max(requiredSize - freeMemory, access.getMemorySize() / 2);
+
+	LOG_INFO_STREAM(
+		<< "grow memory - est: " << requiredSize << " size: " << access.getMemorySize()
+		<< " free: " << freeMemory << " alloc: " << requiredGrowth);
+
+	access.growMemory(requiredGrowth);
+	m_remapCount++;
+}
+
+void InterprocessIntermediateStorageManager::shrinkMemory(SharedMemory::ScopedAccess& access)
+{
+	if (access.getFreeMemorySize() < s_shrinkFreeMemoryFactor * m_largestRequiredSize)
+	{
+		return;
+	}
+
+	const size_t memorySize = access.getMemorySize();
+	access.shrinkToFitMemory();
+	if (access.getMemorySize() == memorySize)
+	{
+		return;
+	}
+	m_remapCount++;
+
+	// keep room for the largest recent storage, so the next push does not need to grow
+	reserveMemory(access, m_largestRequiredSize);
+
+	LOG_INFO_STREAM(
+		<< "shrunk memory - size: " << access.getMemorySize()
+		<< " free: " << access.getFreeMemorySize());
+}
@@ -16,11 +16,28 @@ public:
 
 	size_t getIntermediateStorageCount();
 
+	// bytes of shared memory used by the queued intermediate storages, 0 if none are queued
+	size_t getIntermediateStorageByteSize();
+
+	// number of times the shared memory segment was remapped to grow or shrink it
+	size_t getRemapCount() const;
+	// number of copies into shared memory that failed and were started again
+	size_t getRetryCount() const;
+
 private:
 	static const char* s_sharedMemoryNamePrefix;
 	static const char* s_intermediatStoragesKeyName;
 
-	size_t m_insertsWithoutGrowth;
+	static const size_t s_queueByteSize;
+	static const size_t s_maximumRetryCount;
+	static const size_t s_shrinkFreeMemoryFactor;
+
+	void reserveMemory(SharedMemory::ScopedAccess& access, size_t requiredSize);
+	void shrinkMemory(SharedMemory::ScopedAccess& access);
+
+	size_t m_largestRequiredSize;
+	size_t m_remapCount;
+	size_t m_retryCount;
 };
 
 #endif	  // INTERPROCESS_INTERMEDIATE_STORAGE_MANAGER_H
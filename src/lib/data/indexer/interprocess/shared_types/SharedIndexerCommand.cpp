@@ -85,6 +85,7 @@ std::shared_ptr<IndexerCommand> SharedIndexerCommand::fromShared(const SharedInd
 SharedIndexerCommand::SharedIndexerCommand(SharedMemory::Allocator* allocator)
 	: m_type(Type::UNKNOWN)
 	, m_sourceFilePath("", allocator)
+	, m_sourceFileByteSize(0)
 #if BUILD_CXX_LANGUAGE_PACKAGE
 	, m_indexedPaths(allocator)
 	, m_excludeFilters(allocator)
@@ -101,6 +102,29 @@ SharedIndexerCommand::SharedIndexerCommand(SharedMemory::Allocator* allocator)
 
 SharedIndexerCommand::~SharedIndexerCommand() {}
 
+IndexerCommandType SharedIndexerCommand::getIndexerCommandType() const
+{
+	switch (getType())
+	{
+#if BUILD_CXX_LANGUAGE_PACKAGE
+	case CXX:
+		return INDEXER_COMMAND_CXX;
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+#if BUILD_JAVA_LANGUAGE_PACKAGE
+	case JAVA:
+		return INDEXER_COMMAND_JAVA;
+#endif	  // BUILD_JAVA_LANGUAGE_PACKAGE
+#if BUILD_PYTHON_LANGUAGE_PACKAGE
+	case PYTHON:
+		return INDEXER_COMMAND_PYTHON;
+#endif	  // BUILD_PYTHON_LANGUAGE_PACKAGE
+	case UNKNOWN:
+	default:
+		break;
+	}
+	return INDEXER_COMMAND_UNKNOWN;
+}
+
 FilePath SharedIndexerCommand::getSourceFilePath() const
 {
 	return FilePath(utility::decodeFromUtf8(m_sourceFilePath.c_str()));
@@ -111,6 +135,16 @@ void SharedIndexerCommand::setSourceFilePath(const FilePath& filePath)
 	m_sourceFilePath = utility::encodeToUtf8(filePath.wstr()).c_str();
 }
 
+size_t SharedIndexerCommand::getSourceFileByteSize() const
+{
+	return m_sourceFileByteSize;
+}
+
+void SharedIndexerCommand::setSourceFileByteSize(size_t sourceFileByteSize)
+{
+	m_sourceFileByteSize = sourceFileByteSize;
+}
+
 #if BUILD_CXX_LANGUAGE_PACKAGE
 
 std::set<FilePath> SharedIndexerCommand::getIndexedPaths() const
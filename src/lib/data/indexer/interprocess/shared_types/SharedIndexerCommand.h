@@ -7,6 +7,7 @@
 
 #include "FilePath.h"
 #include "FilePathFilter.h"
+#include "IndexerCommandType.h"
 #include "SharedMemory.h"
 
 class IndexerCommand;
@@ -20,9 +21,15 @@ public:
 	SharedIndexerCommand(SharedMemory::Allocator* allocator);
 	~SharedIndexerCommand();
 
+	IndexerCommandType getIndexerCommandType() const;
+
 	FilePath getSourceFilePath() const;
 	void setSourceFilePath(const FilePath& filePath);
 
+	// used as the expected cost of indexing the command
+	size_t getSourceFileByteSize() const;
+	void setSourceFileByteSize(size_t sourceFileByteSize);
+
 #if BUILD_CXX_LANGUAGE_PACKAGE
 
 	std::set<FilePath> getIndexedPaths() const;
@@ -73,6 +80,7 @@ private:
 
 	// indexer command
 	SharedMemory::String m_sourceFilePath;
+	size_t m_sourceFileByteSize;
 
 #if BUILD_CXX_LANGUAGE_PACKAGE
 	SharedMemory::Vector<SharedMemory::String> m_indexedPaths;
@@ -1,5 +1,49 @@
 #include "SharedIntermediateStorage.h"
 
+#include "IntermediateStorage.h"
+#include "utilityString.h"
+
+namespace
+{
+template <typename SharedType, typename ContainerType>
+size_t getSharedContainerByteSize(const ContainerType& container)
+{
+	size_t byteSize = SharedMemory::getVectorByteSize<SharedType>(container.size());
+	for (const auto& element: container)
+	{
+		byteSize += getSharedByteSize(element);
+	}
+	return byteSize;
+}
+
+// one line per source file, holding the chunk count and the path
+std::string encodeSourceFileChunkCounts(const std::map<FilePath, int>& chunkCounts)
+{
+	std::string encoded;
+	for (const std::pair<const FilePath, int>& p: chunkCounts)
+	{
+		encoded += std::to_string(p.second) + ':' + utility::encodeToUtf8(p.first.wstr()) + '\n';
+	}
+	return encoded;
+}
+}	 // namespace
+
+size_t SharedIntermediateStorage::getByteSize(const IntermediateStorage& storage)
+{
+	return getSharedContainerByteSize<SharedStorageNode>(storage.getStorageNodes()) +
+		getSharedContainerByteSize<SharedStorageFile>(storage.getStorageFiles()) +
+		getSharedContainerByteSize<SharedStorageSymbol>(storage.getStorageSymbols()) +
+		getSharedContainerByteSize<SharedStorageEdge>(storage.getStorageEdges()) +
+		getSharedContainerByteSize<SharedStorageLocalSymbol>(storage.getStorageLocalSymbols()) +
+		getSharedContainerByteSize<SharedStorageSourceLocation>(
+			storage.getStorageSourceLocations()) +
+		getSharedContainerByteSize<SharedStorageOccurrence>(storage.getStorageOccurrences()) +
+		getSharedContainerByteSize<SharedStorageComponentAccess>(storage.getComponentAccesses()) +
+		getSharedContainerByteSize<SharedStorageError>(storage.getErrors()) +
+		SharedMemory::getStringByteSize(
+			encodeSourceFileChunkCounts(storage.getSourceFileChunkCounts()).size());
+}
+
 SharedIntermediateStorage::SharedIntermediateStorage(SharedMemory::Allocator* allocator)
 	: m_storageFiles(allocator)
 	, m_storageSymbols(allocator)
@@ -10,8 +54,10 @@ SharedIntermediateStorage::SharedIntermediateStorage(SharedMemory::Allocator* al
 	, m_storageLocalSymbols(allocator)
 	, m_storageSourceLocations(allocator)
 	, m_storageErrors(allocator)
+	, m_sourceFileChunkCounts(allocator)
 	, m_allocator(allocator)
 	, m_nextId(1)
+	, m_isChunk(false)
 {
 }
 
@@ -33,6 +79,7 @@ std::vector<StorageFile> SharedIntermediateStorage::getStorageFiles() const
 void SharedIntermediateStorage::setStorageFiles(const std::vector<StorageFile>& storageFiles)
 {
 	m_storageFiles.clear();
+	m_storageFiles.reserve(storageFiles.size());
 
 	for (unsigned int i = 0; i < storageFiles.size(); i++)
 	{
@@ -56,6 +103,7 @@ std::vector<StorageNode> SharedIntermediateStorage::getStorageNodes() const
 void SharedIntermediateStorage::setStorageNodes(const std::vector<StorageNode>& storageNodes)
 {
 	m_storageNodes.clear();
+	m_storageNodes.reserve(storageNodes.size());
 
 	for (unsigned int i = 0; i < storageNodes.size(); i++)
 	{
@@ -79,6 +127,7 @@ std::vector<StorageSymbol> SharedIntermediateStorage::getStorageSymbols() const
 void SharedIntermediateStorage::setStorageSymbols(const std::vector<StorageSymbol>& storageSymbols)
 {
 	m_storageSymbols.clear();
+	m_storageSymbols.reserve(storageSymbols.size());
 
 	for (unsigned int i = 0; i < storageSymbols.size(); i++)
 	{
@@ -102,6 +151,7 @@ std::vector<StorageEdge> SharedIntermediateStorage::getStorageEdges() const
 void SharedIntermediateStorage::setStorageEdges(const std::vector<StorageEdge>& storageEdges)
 {
 	m_storageEdges.clear();
+	m_storageEdges.reserve(storageEdges.size());
 
 	for (unsigned int i = 0; i < storageEdges.size(); i++)
 	{
@@ -125,6 +175,7 @@ void SharedIntermediateStorage::setStorageLocalSymbols(
 	const std::set<StorageLocalSymbol>& storageLocalSymbols)
 {
 	m_storageLocalSymbols.clear();
+	m_storageLocalSymbols.reserve(storageLocalSymbols.size());
 
 	for (const StorageLocalSymbol& localSymbol: storageLocalSymbols)
 	{
@@ -148,6 +199,7 @@ void SharedIntermediateStorage::setStorageSourceLocations(
 	const std::set<StorageSourceLocation>& storageSourceLocations)
 {
 	m_storageSourceLocations.clear();
+	m_storageSourceLocations.reserve(storageSourceLocations.size());
 
 	for (const StorageSourceLocation& sourceLocation: storageSourceLocations)
 	{
@@ -170,6 +222,7 @@ std::set<StorageOccurrence> SharedIntermediateStorage::getStorageOccurrences() c
 void SharedIntermediateStorage::setStorageOccurrences(const std::set<StorageOccurrence>& storageOccurences)
 {
 	m_storageOccurrences.clear();
+	m_storageOccurrences.reserve(storageOccurences.size());
 
 	for (const StorageOccurrence& occurrence: storageOccurences)
 	{
@@ -193,6 +246,7 @@ void SharedIntermediateStorage::setStorageComponentAccesses(
 	const std::set<StorageComponentAccess>& storageComponentAccesses)
 {
 	m_storageComponentAccesses.clear();
+	m_storageComponentAccesses.reserve(storageComponentAccesses.size());
 
 	for (const StorageComponentAccess& componentAccess: storageComponentAccesses)
 	{
@@ -216,6 +270,7 @@ std::vector<StorageError> SharedIntermediateStorage::getStorageErrors() const
 void SharedIntermediateStorage::setStorageErrors(const std::vector<StorageError>& errors)
 {
 	m_storageErrors.clear();
+	m_storageErrors.reserve(errors.size());
 
 	for (unsigned int i = 0; i < errors.size(); i++)
 	{
@@ -232,3 +287,35 @@ void SharedIntermediateStorage::setNextId(const Id nextId)
 {
 	m_nextId = static_cast<int>(nextId);
 }
+
+bool SharedIntermediateStorage::isChunk() const
+{
+	return m_isChunk;
+}
+
+void SharedIntermediateStorage::setIsChunk(bool isChunk)
+{
+	m_isChunk = isChunk;
+}
+
+std::map<FilePath, int> SharedIntermediateStorage::getSourceFileChunkCounts() const
+{
+	std::map<FilePath, int> chunkCounts;
+	for (const std::string& line:
+		 utility::splitToVector(std::string(m_sourceFileChunkCounts.c_str()), '\n'))
+	{
+		const size_t pos = line.find(':');
+		if (pos != std::string::npos)
+		{
+			chunkCounts.emplace(
+				FilePath(utility::decodeFromUtf8(line.substr(pos + 1))),
+				std::stoi(line.substr(0, pos)));
+		}
+	}
+	return chunkCounts;
+}
+
+void SharedIntermediateStorage::setSourceFileChunkCounts(const std::map<FilePath, int>& chunkCounts)
+{
+	m_sourceFileChunkCounts = encodeSourceFileChunkCounts(chunkCounts).c_str();
+}
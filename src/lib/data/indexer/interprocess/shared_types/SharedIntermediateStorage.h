@@ -1,15 +1,22 @@
 #ifndef SHARED_INTERMEDIATE_STORAGE_H
 #define SHARED_INTERMEDIATE_STORAGE_H
 
+#include <map>
 #include <set>
 #include <vector>
 
+#include "FilePath.h"
 #include "SharedMemory.h"
 #include "SharedStorageTypes.h"
 
+class IntermediateStorage;
+
 class SharedIntermediateStorage
 {
 public:
+	// bytes of shared memory allocated when copying the storage, excluding the instance itself
+	static size_t getByteSize(const IntermediateStorage& storage);
+
 	SharedIntermediateStorage(SharedMemory::Allocator* allocator);
 	~SharedIntermediateStorage();
 
@@ -43,6 +50,12 @@ public:
 	Id getNextId() const;
 	void setNextId(const Id nextId);
 
+	bool isChunk() const;
+	void setIsChunk(bool isChunk);
+
+	std::map<FilePath, int> getSourceFileChunkCounts() const;
+	void setSourceFileChunkCounts(const std::map<FilePath, int>& chunkCounts);
+
 private:
 	SharedMemory::Vector<SharedStorageFile> m_storageFiles;
 	SharedMemory::Vector<SharedStorageSymbol> m_storageSymbols;
@@ -53,10 +66,12 @@ private:
 	SharedMemory::Vector<SharedStorageLocalSymbol> m_storageLocalSymbols;
 	SharedMemory::Vector<SharedStorageSourceLocation> m_storageSourceLocations;
 	SharedMemory::Vector<SharedStorageError> m_storageErrors;
+	SharedMemory::String m_sourceFileChunkCounts;
 
 	SharedMemory::Allocator* m_allocator;
 
 	int m_nextId;
+	bool m_isChunk;
 };
 
 #endif	  // SHARED_INTERMEDIATE_STORAGE_H
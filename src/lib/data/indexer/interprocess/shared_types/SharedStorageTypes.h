@@ -17,6 +17,7 @@
 // macro creating SharedStorageType from StorageType
 // - arguments: StorageType & SharedStorageType
 // - defines: conversion functions toShared() & fromShared()
+//   and getSharedByteSize() returning the bytes allocated by the shared type besides its own size
 
 #define CONVERT_STORAGE_TYPE_TO_SHARED_TYPE(__type__, __shared_type__)                             \
 	typedef __type__ __shared_type__;                                                              \
@@ -30,6 +31,11 @@
 	inline const __type__& fromShared(const __shared_type__& instance)                             \
 	{                                                                                              \
 		return instance;                                                                           \
+	}                                                                                              \
+                                                                                                   \
+	inline size_t getSharedByteSize(const __type__& instance)                                      \
+	{                                                                                              \
+		return 0;                                                                                  \
 	}
 
 CONVERT_STORAGE_TYPE_TO_SHARED_TYPE(StorageEdge, SharedStorageEdge)
@@ -63,6 +69,11 @@ inline StorageNode fromShared(const SharedStorageNode& node)
 	return StorageNode(node.id, node.type, utility::decodeFromUtf8(node.serializedName.c_str()));
 }
 
+inline size_t getSharedByteSize(const StorageNode& node)
+{
+	return SharedMemory::getStringByteSize(utility::getUtf8ByteSize(node.serializedName));
+}
+
 
 struct SharedStorageFile
 {
@@ -110,6 +121,12 @@ inline StorageFile fromShared(const SharedStorageFile& file)
 		file.complete);
 }
 
+inline size_t getSharedByteSize(const StorageFile& file)
+{
+	return SharedMemory::getStringByteSize(utility::getUtf8ByteSize(file.filePath)) +
+		SharedMemory::getStringByteSize(utility::getUtf8ByteSize(file.languageIdentifier));
+}
+
 
 struct SharedStorageLocalSymbol
 {
@@ -133,6 +150,11 @@ inline StorageLocalSymbol fromShared(const SharedStorageLocalSymbol& symbol)
 	return StorageLocalSymbol(symbol.id, utility::decodeFromUtf8(symbol.name.c_str()));
 }
 
+inline size_t getSharedByteSize(const StorageLocalSymbol& symbol)
+{
+	return SharedMemory::getStringByteSize(utility::getUtf8ByteSize(symbol.name));
+}
+
 
 struct SharedStorageError
 {
@@ -179,4 +201,10 @@ inline StorageError fromShared(const SharedStorageError& error)
 		error.indexed);
 }
 
+inline size_t getSharedByteSize(const StorageError& error)
+{
+	return SharedMemory::getStringByteSize(utility::getUtf8ByteSize(error.message)) +
+		SharedMemory::getStringByteSize(utility::getUtf8ByteSize(error.translationUnit));
+}
+
 #endif	  // SHARED_STORAGE_TYPES_H
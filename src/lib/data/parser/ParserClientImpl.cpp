@@ -4,7 +4,14 @@
 #include "Node.h"
 #include "ParseLocation.h"
 
-ParserClientImpl::ParserClientImpl(IntermediateStorage* const storage): m_storage(storage) {}
+ParserClientImpl::ParserClientImpl(IntermediateStorage* const storage)
+	: m_storage(storage)
+	, m_symbolCacheHitCount(0)
+	, m_symbolCacheMissCount(0)
+	, m_chunkByteSize(0)
+	, m_chunkCount(0)
+{
+}
 
 Id ParserClientImpl::recordFile(const FilePath& filePath, bool indexed)
 {
@@ -20,7 +27,21 @@ void ParserClientImpl::recordFileLanguage(Id fileId, const std::wstring& languag
 
 Id ParserClientImpl::recordSymbol(const NameHierarchy& symbolName)
 {
-	return addNodeHierarchy(symbolName);
+	std::wstring serializedName = NameHierarchy::serialize(symbolName);
+
+	auto it = m_symbolIdMap.find(serializedName);
+	if (it != m_symbolIdMap.end())
+	{
+		m_symbolCacheHitCount++;
+		return it->second;
+	}
+
+	m_symbolCacheMissCount++;
+	const Id symbolId = addNodeHierarchy(symbolName);
+	m_symbolIdMap.emplace(std::move(serializedName), symbolId);
+
+	extractChunkIfNeeded();
+	return symbolId;
 }
 
 void ParserClientImpl::recordSymbolKind(Id symbolId, SymbolKind symbolKind)
@@ -52,6 +73,8 @@ Id ParserClientImpl::recordReference(
 	{
 		addSourceLocation(edgeId, location, LOCATION_TOKEN);
 	}
+
+	extractChunkIfNeeded();
 	return edgeId;
 }
 
@@ -59,11 +82,15 @@ void ParserClientImpl::recordLocalSymbol(const std::wstring& name, const ParseLo
 {
 	const Id localSymbolId = m_storage->addLocalSymbol(name);
 	addSourceLocation(localSymbolId, location, LOCATION_LOCAL_SYMBOL);
+
+	extractChunkIfNeeded();
 }
 
 void ParserClientImpl::recordLocation(Id elementId, const ParseLocation& location, ParseLocationType type)
 {
 	addSourceLocation(elementId, location, parseLocationTypeToLocationType(type));
+
+	extractChunkIfNeeded();
 }
 
 void ParserClientImpl::recordComment(const ParseLocation& location)
@@ -80,6 +107,8 @@ void ParserClientImpl::recordComment(const ParseLocation& location)
 		location.endLineNumber,
 		location.endColumnNumber,
 		locationTypeToInt(LOCATION_COMMENT)));
+
+	extractChunkIfNeeded();
 }
 
 void ParserClientImpl::recordError(
@@ -96,6 +125,8 @@ void ParserClientImpl::recordError(
 
 		addSourceLocation(errorId, location, LOCATION_ERROR);
 	}
+
+	extractChunkIfNeeded();
 }
 
 bool ParserClientImpl::hasContent() const
@@ -103,6 +134,28 @@ bool ParserClientImpl::hasContent() const
 	return m_storage->getByteSize(1) > 0;
 }
 
+size_t ParserClientImpl::getSymbolCacheHitCount() const
+{
+	return m_symbolCacheHitCount;
+}
+
+size_t ParserClientImpl::getSymbolCacheMissCount() const
+{
+	return m_symbolCacheMissCount;
+}
+
+void ParserClientImpl::setChunkCallback(
+	size_t chunkByteSize, std::function<void(std::shared_ptr<IntermediateStorage>)> callback)
+{
+	m_chunkByteSize = chunkByteSize;
+	m_chunkCallback = callback;
+}
+
+size_t ParserClientImpl::getChunkCount() const
+{
+	return m_chunkCount;
+}
+
 NodeKind ParserClientImpl::symbolKindToNodeKind(SymbolKind symbolKind) const
 {
 	switch (symbolKind)
@@ -271,3 +324,14 @@ void ParserClientImpl::addSourceLocation(Id elementId, const ParseLocation& loca
 
 	m_storage->addOccurrence(StorageOccurrence(elementId, sourceLocationId));
 }
+
+void ParserClientImpl::extractChunkIfNeeded()
+{
+	if (!m_chunkCallback || !m_chunkByteSize || m_storage->getChunkByteSize() < m_chunkByteSize)
+	{
+		return;
+	}
+
+	m_chunkCount++;
+	m_chunkCallback(m_storage->extractChunk(false));
+}
@@ -1,7 +1,10 @@
 #ifndef PARSER_CLIENT_IMPL_H
 #define PARSER_CLIENT_IMPL_H
 
+#include <functional>
+#include <memory>
 #include <set>
+#include <unordered_map>
 
 #include "DefinitionKind.h"
 #include "IntermediateStorage.h"
@@ -41,6 +44,15 @@ public:
 
 	bool hasContent() const override;
 
+	size_t getSymbolCacheHitCount() const;
+	size_t getSymbolCacheMissCount() const;
+
+	// hands the recorded data over in chunks once it grows beyond chunkByteSize bytes, the storage
+	// keeps the rest. Ids returned by this client stay valid across chunks.
+	void setChunkCallback(
+		size_t chunkByteSize, std::function<void(std::shared_ptr<IntermediateStorage>)> callback);
+	size_t getChunkCount() const;
+
 private:
 	NodeKind symbolKindToNodeKind(SymbolKind symbolType) const;
 	Edge::EdgeType referenceKindToEdgeType(ReferenceKind referenceKind) const;
@@ -54,8 +66,20 @@ private:
 
 	void addSourceLocation(Id elementId, const ParseLocation& location, LocationType type);
 
+	void extractChunkIfNeeded();
+
 	IntermediateStorage* const m_storage;
 	std::map<std::wstring, Id> m_fileIdMap;
+
+	// maps serialized symbol names to their node ids, so repeatedly recorded symbols skip adding
+	// every level of their name hierarchy again.
+	std::unordered_map<std::wstring, Id> m_symbolIdMap;
+	size_t m_symbolCacheHitCount;
+	size_t m_symbolCacheMissCount;
+
+	size_t m_chunkByteSize;
+	std::function<void(std::shared_ptr<IntermediateStorage>)> m_chunkCallback;
+	size_t m_chunkCount;
 };
 
 #endif	  // PARSER_CLIENT_IMPL_H
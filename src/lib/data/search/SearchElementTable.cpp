@@ -0,0 +1,461 @@
+#include "SearchElementTable.h"
+
+#include <algorithm>
+
+#include <boost/filesystem.hpp>
+
+#include "logging.h"
+
+namespace
+{
+void writeVarint(uint64_t value, std::vector<uint8_t>* bytes)
+{
+	while (value >= 0x80)
+	{
+		bytes->push_back(static_cast<uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	bytes->push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t readVarint(const uint8_t** bytes)
+{
+	uint64_t value = 0;
+	for (int shift = 0;; shift += 7)
+	{
+		const uint8_t byte = *(*bytes)++;
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if (!(byte & 0x80))
+		{
+			return value;
+		}
+	}
+}
+
+// node kinds are single bits, so their bit position fits into one byte
+uint8_t getKindBit(NodeKind kind)
+{
+	uint8_t bit = 0;
+	while (bit < 31 && !(static_cast<NodeKindMask>(kind) & (1 << bit)))
+	{
+		bit++;
+	}
+	return bit;
+}
+}	 // namespace
+
+const size_t SearchElementTable::s_pageByteSize = 64 * 1024;
+
+bool SearchElementTable::Element::operator==(const Element& other) const
+{
+	return id == other.id && kind == other.kind && flags == other.flags;
+}
+
+SearchElementTable::SearchElementTable(size_t memoryBudget): m_memoryBudget(memoryBudget) {}
+
+SearchElementTable::~SearchElementTable()
+{
+	if (m_file.is_open())
+	{
+		m_file.close();
+	}
+
+	if (!m_filePath.empty())
+	{
+		boost::system::error_code ec;
+		boost::filesystem::remove(m_filePath, ec);
+	}
+}
+
+void SearchElementTable::setMemoryBudget(size_t memoryBudget)
+{
+	m_memoryBudget = memoryBudget;
+
+	if (m_memoryBudget)
+	{
+		fitIntoMemoryBudget();
+	}
+	else
+	{
+		// without a budget all lists are read from memory again
+		for (uint32_t i = 0; i < m_pages.size(); i++)
+		{
+			getPageData(i);
+		}
+	}
+}
+
+size_t SearchElementTable::getMemoryBudget() const
+{
+	return m_memoryBudget;
+}
+
+SearchElementTable::ListId SearchElementTable::addList(const std::vector<Element>& elements)
+{
+	if (!m_unusedLists.empty())
+	{
+		const ListId listId = m_unusedLists.back();
+		m_unusedLists.pop_back();
+		m_lists[listId] = appendList(elements);
+		return listId;
+	}
+
+	m_lists.push_back(appendList(elements));
+	return static_cast<ListId>(m_lists.size() - 1);
+}
+
+void SearchElementTable::replaceList(ListId listId, const std::vector<Element>& elements)
+{
+	m_unusedListByteSize += m_lists[listId].byteSize;
+	m_lists[listId] = appendList(elements);
+
+	compact();
+}
+
+void SearchElementTable::removeList(ListId listId)
+{
+	m_unusedListByteSize += m_lists[listId].byteSize;
+	m_lists[listId] = ListLocation();
+	m_unusedLists.push_back(listId);
+
+	compact();
+}
+
+bool SearchElementTable::getList(ListId listId, std::vector<Element>* elements) const
+{
+	elements->clear();
+
+	const ListLocation& location = m_lists[listId];
+	if (!location.byteSize)
+	{
+		return true;
+	}
+
+	if (location.page == m_pages.size())
+	{
+		*elements = decodeList(m_openPage.data() + location.offset, location.byteSize);
+		return true;
+	}
+
+	// the page stays alive while it is decoded, even if another thread evicts it meanwhile
+	const std::shared_ptr<const std::vector<uint8_t>> data = getPageData(location.page);
+	if (!data)
+	{
+		// the page was evicted and can't be read again, all other pages stay in memory now
+		return false;
+	}
+
+	*elements = decodeList(data->data() + location.offset, location.byteSize);
+	return true;
+}
+
+bool SearchElementTable::hasReadError() const
+{
+	std::lock_guard<std::mutex> lock(m_pageMutex);
+	return m_hasReadError;
+}
+
+size_t SearchElementTable::getListCount() const
+{
+	return m_lists.size() - m_unusedLists.size();
+}
+
+size_t SearchElementTable::getResidentByteSize() const
+{
+	std::lock_guard<std::mutex> lock(m_pageMutex);
+	return m_residentByteSize + m_openPage.size();
+}
+
+size_t SearchElementTable::getTotalByteSize() const
+{
+	return m_listByteSize;
+}
+
+size_t SearchElementTable::getFileByteSize() const
+{
+	return static_cast<size_t>(m_fileByteSize);
+}
+
+const std::string& SearchElementTable::getFilePath() const
+{
+	return m_filePath;
+}
+
+void SearchElementTable::encodeList(
+	const std::vector<Element>& elements, std::vector<uint8_t>* bytes)
+{
+	Id lastId = 0;
+	for (const Element& element: elements)
+	{
+		writeVarint(element.id - lastId, bytes);
+		bytes->push_back(getKindBit(element.kind));
+		writeVarint(static_cast<uint32_t>(element.flags), bytes);
+		lastId = element.id;
+	}
+}
+
+std::vector<SearchElementTable::Element> SearchElementTable::decodeList(
+	const uint8_t* bytes, uint32_t byteSize)
+{
+	std::vector<Element> elements;
+
+	const uint8_t* end = bytes + byteSize;
+	Id lastId = 0;
+	while (bytes < end)
+	{
+		const Id id = lastId + static_cast<Id>(readVarint(&bytes));
+		const NodeKind kind = static_cast<NodeKind>(1 << *bytes++);
+		const int flags = static_cast<int>(readVarint(&bytes));
+
+		elements.emplace_back(id, kind, flags);
+		lastId = id;
+	}
+
+	return elements;
+}
+
+SearchElementTable::ListLocation SearchElementTable::appendList(
+	const std::vector<Element>& elements)
+{
+	std::vector<uint8_t> bytes;
+	encodeList(elements, &bytes);
+
+	if (!m_openPage.empty() && m_openPage.size() + bytes.size() > s_pageByteSize)
+	{
+		sealOpenPage();
+	}
+
+	ListLocation location;
+	location.page = static_cast<uint32_t>(m_pages.size());
+	location.offset = static_cast<uint32_t>(m_openPage.size());
+	location.byteSize = static_cast<uint32_t>(bytes.size());
+
+	m_openPage.insert(m_openPage.end(), bytes.begin(), bytes.end());
+	m_listByteSize += bytes.size();
+
+	return location;
+}
+
+void SearchElementTable::sealOpenPage()
+{
+	Page page;
+	page.byteSize = static_cast<uint32_t>(m_openPage.size());
+	page.data = std::make_shared<const std::vector<uint8_t>>(std::move(m_openPage));
+	m_openPage = std::vector<uint8_t>();
+
+	{
+		std::lock_guard<std::mutex> lock(m_pageMutex);
+		page.lastUse = ++m_useCount;
+		m_residentByteSize += page.byteSize;
+		m_pages.push_back(std::move(page));
+	}
+
+	fitIntoMemoryBudget();
+}
+
+void SearchElementTable::compact()
+{
+	// rewrite all lists once most of the stored bytes belong to replaced or removed lists. After a
+	// read error the unreadable lists would be lost for good, so the lists stay where they are.
+	if (m_unusedListByteSize < 16 * s_pageByteSize || m_unusedListByteSize * 2 < m_listByteSize ||
+		hasReadError())
+	{
+		return;
+	}
+
+	SearchElementTable table(m_memoryBudget);
+	table.m_lists.resize(m_lists.size());
+	table.m_unusedLists = m_unusedLists;
+	std::vector<Element> elements;
+	for (ListId listId = 0; listId < m_lists.size(); listId++)
+	{
+		if (m_lists[listId].byteSize)
+		{
+			if (!getList(listId, &elements))
+			{
+				return;
+			}
+			table.m_lists[listId] = table.appendList(elements);
+		}
+	}
+
+	// the old pages and file are released by the destructor of the swapped table
+	std::swap(m_lists, table.m_lists);
+	std::swap(m_unusedLists, table.m_unusedLists);
+	std::swap(m_listByteSize, table.m_listByteSize);
+	std::swap(m_unusedListByteSize, table.m_unusedListByteSize);
+	std::swap(m_openPage, table.m_openPage);
+	std::swap(m_pages, table.m_pages);
+	std::swap(m_residentByteSize, table.m_residentByteSize);
+	std::swap(m_useCount, table.m_useCount);
+	std::swap(m_filePath, table.m_filePath);
+	std::swap(m_file, table.m_file);
+	std::swap(m_fileByteSize, table.m_fileByteSize);
+	std::swap(m_hasFileError, table.m_hasFileError);
+	std::swap(m_hasReadError, table.m_hasReadError);
+}
+
+void SearchElementTable::fitIntoMemoryBudget()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_pageMutex);
+		if (!exceedsMemoryBudget())
+		{
+			// pages are only written to the file once they don't fit into memory anymore
+			return;
+		}
+	}
+
+	writePages();
+
+	std::lock_guard<std::mutex> lock(m_pageMutex);
+	evictPages(static_cast<uint32_t>(m_pages.size()));
+}
+
+bool SearchElementTable::exceedsMemoryBudget() const
+{
+	// the open page may grow to a full page until it is sealed
+	return m_memoryBudget && !m_hasFileError &&
+		m_residentByteSize + s_pageByteSize > m_memoryBudget;
+}
+
+bool SearchElementTable::writePages()
+{
+	if (m_hasFileError)
+	{
+		// all pages stay in memory once the file failed
+		return false;
+	}
+
+	if (!m_file.is_open())
+	{
+		try
+		{
+			m_filePath = (boost::filesystem::temp_directory_path() /
+						  boost::filesystem::unique_path("sourcetrail_search_%%%%-%%%%-%%%%-%%%%"))
+							 .string();
+		}
+		catch (boost::filesystem::filesystem_error& e)
+		{
+			LOG_ERROR("Unable to create search index page file: " + std::string(e.what()));
+			m_hasFileError = true;
+			return false;
+		}
+
+		m_file.open(
+			m_filePath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!m_file.is_open())
+		{
+			LOG_ERROR("Unable to open search index page file: " + m_filePath);
+			m_hasFileError = true;
+			return false;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(m_pageMutex);
+	for (Page& page: m_pages)
+	{
+		if (page.isWritten || !page.data)
+		{
+			continue;
+		}
+
+		m_file.seekp(static_cast<std::streamoff>(m_fileByteSize));
+		m_file.write(reinterpret_cast<const char*>(page.data->data()), page.byteSize);
+		if (!m_file.good())
+		{
+			LOG_ERROR("Unable to write search index page file: " + m_filePath);
+			m_hasFileError = true;
+			return false;
+		}
+
+		page.fileOffset = m_fileByteSize;
+		page.isWritten = true;
+		m_fileByteSize += page.byteSize;
+	}
+	return true;
+}
+
+std::shared_ptr<const std::vector<uint8_t>> SearchElementTable::getPageData(
+	uint32_t pageIndex) const
+{
+	std::lock_guard<std::mutex> lock(m_pageMutex);
+
+	Page& page = m_pages[pageIndex];
+	page.lastUse = ++m_useCount;
+
+	if (!page.data)
+	{
+		std::vector<uint8_t> data(page.byteSize);
+		if (!readPage(page, &data))
+		{
+			// the resident pages stay in memory from now on, so no further list gets lost
+			LOG_ERROR("Unable to read search index page file: " + m_filePath);
+			m_hasFileError = true;
+			m_hasReadError = true;
+			return nullptr;
+		}
+
+		page.data = std::make_shared<const std::vector<uint8_t>>(std::move(data));
+		m_residentByteSize += page.byteSize;
+
+		evictPages(pageIndex);
+	}
+
+	return page.data;
+}
+
+bool SearchElementTable::readPage(const Page& page, std::vector<uint8_t>* data) const
+{
+	for (int attempt = 0; attempt < 2; attempt++)
+	{
+		if (attempt)
+		{
+			// a failed read may leave the stream unusable, so the file is opened again
+			m_file.close();
+			m_file.open(m_filePath, std::ios::in | std::ios::out | std::ios::binary);
+		}
+
+		m_file.clear();
+		m_file.seekg(static_cast<std::streamoff>(page.fileOffset));
+		m_file.read(reinterpret_cast<char*>(data->data()), page.byteSize);
+		if (m_file.good())
+		{
+			return true;
+		}
+	}
+
+	m_file.clear();
+	return false;
+}
+
+void SearchElementTable::evictPages(uint32_t keptPageIndex) const
+{
+	if (!exceedsMemoryBudget())
+	{
+		return;
+	}
+
+	// drop the least recently used pages until the resident pages fit into the budget again
+	std::vector<std::pair<uint64_t, uint32_t>> residentPages;
+	for (uint32_t i = 0; i < m_pages.size(); i++)
+	{
+		if (m_pages[i].data && m_pages[i].isWritten && i != keptPageIndex)
+		{
+			residentPages.emplace_back(m_pages[i].lastUse, i);
+		}
+	}
+	std::sort(residentPages.begin(), residentPages.end());
+
+	for (const std::pair<uint64_t, uint32_t>& p: residentPages)
+	{
+		if (!exceedsMemoryBudget())
+		{
+			break;
+		}
+
+		Page& page = m_pages[p.second];
+		page.data.reset();
+		m_residentByteSize -= page.byteSize;
+	}
+}
@@ -0,0 +1,113 @@
+#ifndef SEARCH_ELEMENT_TABLE_H
+#define SEARCH_ELEMENT_TABLE_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "NodeKind.h"
+#include "types.h"
+
+// Stores the element lists of the SearchIndex nodes apart from the trie. Lists are delta encoded
+// into pages. Once the pages exceed the memory budget, they are written to a temporary file and the
+// least recently used pages are dropped from memory and read again when a search needs them.
+class SearchElementTable
+{
+public:
+	struct Element
+	{
+		Element(Id id, NodeKind kind, int flags): id(id), kind(kind), flags(flags) {}
+
+		bool operator==(const Element& other) const;
+
+		Id id;
+		NodeKind kind;
+		int flags;
+	};
+
+	typedef uint32_t ListId;
+
+	static const size_t s_pageByteSize;
+
+	// memoryBudget == 0 keeps all pages in memory without writing them to a file
+	SearchElementTable(size_t memoryBudget = 0);
+	~SearchElementTable();
+
+	void setMemoryBudget(size_t memoryBudget);
+	size_t getMemoryBudget() const;
+
+	// elements have to be ordered by id
+	ListId addList(const std::vector<Element>& elements);
+	void replaceList(ListId listId, const std::vector<Element>& elements);
+	void removeList(ListId listId);
+
+	// may be called from several threads at once, as long as no list is changed meanwhile. Returns
+	// false if the list was evicted to the file and can't be read again.
+	bool getList(ListId listId, std::vector<Element>* elements) const;
+
+	// true once a list couldn't be read, its elements are lost until the table is filled again
+	bool hasReadError() const;
+
+	size_t getListCount() const;
+	size_t getResidentByteSize() const;
+	size_t getTotalByteSize() const;
+	size_t getFileByteSize() const;
+	const std::string& getFilePath() const;
+
+private:
+	struct ListLocation
+	{
+		uint32_t page = 0;
+		uint32_t offset = 0;
+		uint32_t byteSize = 0;
+	};
+
+	struct Page
+	{
+		// null while the page is only stored in the file
+		std::shared_ptr<const std::vector<uint8_t>> data;
+		uint64_t fileOffset = 0;
+		uint32_t byteSize = 0;
+		bool isWritten = false;
+		uint64_t lastUse = 0;
+	};
+
+	static void encodeList(const std::vector<Element>& elements, std::vector<uint8_t>* bytes);
+	static std::vector<Element> decodeList(const uint8_t* bytes, uint32_t byteSize);
+
+	ListLocation appendList(const std::vector<Element>& elements);
+	void sealOpenPage();
+	void compact();
+
+	void fitIntoMemoryBudget();
+	bool exceedsMemoryBudget() const;
+	bool writePages();
+	std::shared_ptr<const std::vector<uint8_t>> getPageData(uint32_t pageIndex) const;
+	bool readPage(const Page& page, std::vector<uint8_t>* data) const;
+	void evictPages(uint32_t keptPageIndex) const;
+
+	std::vector<ListLocation> m_lists;
+	std::vector<ListId> m_unusedLists;
+	size_t m_listByteSize = 0;
+	size_t m_unusedListByteSize = 0;
+
+	// the open page takes new lists and is always resident, it gets the index m_pages.size()
+	std::vector<uint8_t> m_openPage;
+	mutable std::vector<Page> m_pages;
+	mutable size_t m_residentByteSize = 0;
+	mutable uint64_t m_useCount = 0;
+
+	size_t m_memoryBudget;
+	std::string m_filePath;
+	mutable std::fstream m_file;
+	uint64_t m_fileByteSize = 0;
+	mutable bool m_hasFileError = false;
+	mutable bool m_hasReadError = false;
+
+	mutable std::mutex m_pageMutex;
+};
+
+#endif	  // SEARCH_ELEMENT_TABLE_H
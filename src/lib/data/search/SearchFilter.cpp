@@ -0,0 +1,90 @@
+#include "SearchFilter.h"
+
+std::wstring SearchFilter::getDefinitionFilterName(DefinitionFilter definition)
+{
+	switch (definition)
+	{
+	case DEFINITION_INDEXED:
+		return L"indexed";
+	case DEFINITION_NON_INDEXED:
+		return L"non-indexed";
+	case DEFINITION_ALL:
+		break;
+	}
+
+	return L"";
+}
+
+std::wstring SearchFilter::getLanguageFilterName(LanguageFilter language)
+{
+	switch (language)
+	{
+	case LANGUAGE_CXX:
+		return L"c/c++";
+	case LANGUAGE_JAVA:
+		return L"java/python";
+	case LANGUAGE_ALL:
+		break;
+	}
+
+	return L"";
+}
+
+std::vector<std::wstring> SearchFilter::getFilterNames()
+{
+	return {
+		getDefinitionFilterName(DEFINITION_INDEXED),
+		getDefinitionFilterName(DEFINITION_NON_INDEXED),
+		getLanguageFilterName(LANGUAGE_CXX),
+		getLanguageFilterName(LANGUAGE_JAVA)};
+}
+
+bool SearchFilter::isDefinitionFilterName(const std::wstring& name)
+{
+	return name == getDefinitionFilterName(DEFINITION_INDEXED) ||
+		name == getDefinitionFilterName(DEFINITION_NON_INDEXED);
+}
+
+bool SearchFilter::isLanguageFilterName(const std::wstring& name)
+{
+	return name == getLanguageFilterName(LANGUAGE_CXX) ||
+		name == getLanguageFilterName(LANGUAGE_JAVA);
+}
+
+bool SearchFilter::operator==(const SearchFilter& other) const
+{
+	return definition == other.definition && language == other.language;
+}
+
+bool SearchFilter::operator!=(const SearchFilter& other) const
+{
+	return !(*this == other);
+}
+
+bool SearchFilter::acceptsAll() const
+{
+	return definition == DEFINITION_ALL && language == LANGUAGE_ALL;
+}
+
+bool SearchFilter::addFilter(const std::wstring& name)
+{
+	for (DefinitionFilter d: {DEFINITION_INDEXED, DEFINITION_NON_INDEXED})
+	{
+		if (name == getDefinitionFilterName(d))
+		{
+			definition = d;
+			return true;
+		}
+	}
+
+	for (LanguageFilter l: {LANGUAGE_CXX, LANGUAGE_JAVA})
+	{
+		if (name == getLanguageFilterName(l))
+		{
+			language = l;
+			return true;
+		}
+	}
+
+	return false;
+}
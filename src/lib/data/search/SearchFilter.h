@@ -0,0 +1,45 @@
+#ifndef SEARCH_FILTER_H
+#define SEARCH_FILTER_H
+
+#include <string>
+#include <vector>
+
+// Restricts the symbols of the autocompletion to a definition state and a language, next to the
+// accepted node types. The filters are picked like node type filters in the search box.
+struct SearchFilter
+{
+	enum DefinitionFilter
+	{
+		DEFINITION_ALL,
+		DEFINITION_INDEXED,	   // defined in the indexed source files
+		DEFINITION_NON_INDEXED	  // only referenced, e.g. declared in a library
+	};
+
+	enum LanguageFilter
+	{
+		LANGUAGE_ALL,
+		LANGUAGE_CXX,
+		LANGUAGE_JAVA	 // symbols with Java delimiter, also used for Python
+	};
+
+	static std::wstring getDefinitionFilterName(DefinitionFilter definition);
+	static std::wstring getLanguageFilterName(LanguageFilter language);
+	// names of all filters except the ones accepting everything, used as search commands
+	static std::vector<std::wstring> getFilterNames();
+
+	static bool isDefinitionFilterName(const std::wstring& name);
+	static bool isLanguageFilterName(const std::wstring& name);
+
+	bool operator==(const SearchFilter& other) const;
+	bool operator!=(const SearchFilter& other) const;
+
+	bool acceptsAll() const;
+
+	// returns false if the name is neither a definition nor a language filter
+	bool addFilter(const std::wstring& name);
+
+	DefinitionFilter definition = DEFINITION_ALL;
+	LanguageFilter language = LANGUAGE_ALL;
+};
+
+#endif	  // SEARCH_FILTER_H
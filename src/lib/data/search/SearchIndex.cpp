@@ -3,24 +3,113 @@
 #include <algorithm>
 #include <ctype.h>
 #include <iterator>
+#include <tuple>
 
+#include "ThreadPool.h"
 #include "utility.h"
+#include "utilityApp.h"
 #include "utilityString.h"
 
-SearchIndex::SearchIndex()
+SearchIndex::Filter::Filter(NodeTypeSet acceptedNodeTypes, ElementFlags requiredFlags)
+	: acceptedNodeTypes(acceptedNodeTypes), requiredFlags(requiredFlags)
+{
+}
+
+bool SearchIndex::Filter::operator==(const Filter& other) const
+{
+	return acceptedNodeTypes == other.acceptedNodeTypes && requiredFlags == other.requiredFlags;
+}
+
+bool SearchIndex::Filter::accepts(const NodeType& type, ElementFlags flags) const
+{
+	return acceptedNodeTypes.contains(type) && (flags & requiredFlags) == requiredFlags;
+}
+
+bool SearchIndex::Filter::acceptsAnyOf(const NodeTypeSet& types, ElementFlags flags) const
+{
+	return acceptedNodeTypes.intersectsWith(types) && (flags & requiredFlags) == requiredFlags;
+}
+
+void SearchIndex::SearchGate::add(wchar_t c)
+{
+	if (static_cast<uint32_t>(c) < 128)
+	{
+		asciiMask[c / 64] |= uint64_t(1) << (c % 64);
+		return;
+	}
+
+	auto it = std::lower_bound(otherChars.begin(), otherChars.end(), c);
+	if (it == otherChars.end() || *it != c)
+	{
+		otherChars.insert(it, c);
+	}
+}
+
+void SearchIndex::SearchGate::add(const SearchGate& other)
+{
+	asciiMask[0] |= other.asciiMask[0];
+	asciiMask[1] |= other.asciiMask[1];
+
+	for (wchar_t c: other.otherChars)
+	{
+		add(c);
+	}
+}
+
+bool SearchIndex::SearchGate::contains(wchar_t c) const
+{
+	if (static_cast<uint32_t>(c) < 128)
+	{
+		return asciiMask[c / 64] & (uint64_t(1) << (c % 64));
+	}
+	return std::binary_search(otherChars.begin(), otherChars.end(), c);
+}
+
+SearchIndex::SearchIndex(size_t threadCount)
+	: m_threadCount(
+		  threadCount ? threadCount
+					  : static_cast<size_t>(std::max(1, utility::getIdealThreadCount())))
 {
 	clear();
 }
 
 SearchIndex::~SearchIndex() {}
 
-void SearchIndex::addNode(Id id, std::wstring name, NodeType type)
+void SearchIndex::setElementMemoryBudget(size_t byteSize)
+{
+	m_elementMemoryBudget = byteSize;
+	m_elementTable->setMemoryBudget(byteSize);
+}
+
+const SearchElementTable& SearchIndex::getElementTable() const
+{
+	return *m_elementTable;
+}
+
+bool SearchIndex::hasLostElements() const
 {
+	return m_elementTable->hasReadError();
+}
+
+void SearchIndex::SearchCursor::clear()
+{
+	m_index = nullptr;
+	m_lowerQuery.clear();
+	m_paths.clear();
+}
+
+void SearchIndex::addNode(Id id, std::wstring name, NodeType type, ElementFlags flags)
+{
+	m_revision++;
+
+	std::vector<SearchNode*> visitedNodes;
 	SearchNode* currentNode = m_root;
 
 	while (name.size() > 0)
 	{
 		currentNode->containedTypes.add(type);
+		currentNode->containedFlags |= flags;
+		visitedNodes.push_back(currentNode);
 
 		auto it = currentNode->edges.find(name[0]);
 		if (it != currentNode->edges.end())
@@ -40,30 +129,44 @@ void SearchIndex::addNode(Id id, std::wstring name, NodeType type)
 
 			if (matchCount < edgeString.size())
 			{
-				// split current edge
-				m_nodes.push_back(std::make_unique<SearchNode>(currentNode->containedTypes));
-				SearchNode* n = m_nodes.back().get();
-
-				m_edges.push_back(std::make_unique<SearchEdge>(
-					currentEdge->target, edgeString.substr(matchCount)));
-				SearchEdge* e = m_edges.back().get();
+				// split current edge, the new node contains the elements below the edge
+				SearchNode* n = createNode();
+				SearchEdge* e = createEdge(currentEdge->target, edgeString.substr(matchCount));
 
 				n->edges.emplace(e->s[0], e);
+				n->parent = currentNode;
+				n->incomingEdge = currentEdge;
+				n->containedTypes = e->target->containedTypes;
+				n->containedFlags = e->target->containedFlags;
+				n->subtreeElementCount = e->target->subtreeElementCount;
+				e->target->parent = n;
+				e->target->incomingEdge = e;
+				e->gate = currentEdge->gate;
 
 				currentEdge->s = edgeString.substr(0, matchCount);
 				currentEdge->target = n;
 			}
 
+			if (m_isSetUp)
+			{
+				addToGate(currentEdge, name);
+			}
+
 			name = name.substr(matchCount);
 			currentNode = currentEdge->target;
 		}
 		else
 		{
-			m_nodes.push_back(std::make_unique<SearchNode>(currentNode->containedTypes));
-			SearchNode* n = m_nodes.back().get();
+			SearchNode* n = createNode();
+			SearchEdge* e = createEdge(n, std::move(name));
 
-			m_edges.push_back(std::make_unique<SearchEdge>(n, std::move(name)));
-			SearchEdge* e = m_edges.back().get();
+			n->parent = currentNode;
+			n->incomingEdge = e;
+
+			if (m_isSetUp)
+			{
+				addToGate(e, e->s);
+			}
 
 			currentNode->edges.emplace(e->s[0], e);
 			currentNode = n;
@@ -72,41 +175,207 @@ void SearchIndex::addNode(Id id, std::wstring name, NodeType type)
 		}
 	}
 
-	currentNode->elementIds.emplace(id, type);
+	currentNode->containedTypes.add(type);
+	currentNode->containedFlags |= flags;
+	visitedNodes.push_back(currentNode);
+
+	if (addElement(currentNode, SearchElementTable::Element(id, type.getKind(), flags)))
+	{
+		if (m_isSetUp)
+		{
+			m_addedNodesForIds.emplace(id, currentNode);
+
+			for (SearchNode* node: visitedNodes)
+			{
+				node->subtreeElementCount++;
+			}
+		}
+		else
+		{
+			m_nodesForIds.emplace_back(id, currentNode);
+		}
+	}
+}
+
+void SearchIndex::removeNode(Id id)
+{
+	m_revision++;
+
+	// the ids are only sorted once the index is set up
+	auto first = m_nodesForIds.begin();
+	auto last = m_nodesForIds.end();
+	if (m_isSetUp)
+	{
+		std::tie(first, last) = std::equal_range(
+			first, last, std::make_pair(id, nullptr), [](const auto& a, const auto& b) {
+				return a.first < b.first;
+			});
+	}
+
+	for (auto it = first; it != last; it++)
+	{
+		if (it->first == id && it->second)
+		{
+			// an id added twice to the same node before finishSetup() is listed twice
+			SearchNode* node = it->second;
+			for (auto duplicate = it; duplicate != last; duplicate++)
+			{
+				if (duplicate->first == id && duplicate->second == node)
+				{
+					duplicate->second = nullptr;
+				}
+			}
+
+			removeElement(node, id);
+		}
+	}
+
+	auto range = m_addedNodesForIds.equal_range(id);
+	for (auto it = range.first; it != range.second; it++)
+	{
+		removeElement(it->second, id);
+	}
+	m_addedNodesForIds.erase(range.first, range.second);
 }
 
 void SearchIndex::finishSetup()
 {
+	// the pending elements are stored in the order of the trie, so the elements of a subtree are
+	// kept on few pages of the element table. Sorting them by node and id drops ids that were
+	// added to a node twice, the first one is kept.
+	std::stable_sort(
+		m_pendingElements.begin(),
+		m_pendingElements.end(),
+		[](const std::pair<const SearchNode*, SearchElementTable::Element>& a,
+		   const std::pair<const SearchNode*, SearchElementTable::Element>& b) {
+			return std::tie(a.first, a.second.id) < std::tie(b.first, b.second.id);
+		});
+	m_pendingElements.erase(
+		std::unique(
+			m_pendingElements.begin(),
+			m_pendingElements.end(),
+			[](const std::pair<const SearchNode*, SearchElementTable::Element>& a,
+			   const std::pair<const SearchNode*, SearchElementTable::Element>& b) {
+				return a.first == b.first && a.second.id == b.second.id;
+			}),
+		m_pendingElements.end());
+
+	storePendingElements(m_root);
+	m_root->subtreeElementCount = m_root->elementCount;
+
 	for (auto& p: m_root->edges)
 	{
 		populateEdgeGate(p.second);
+		m_root->subtreeElementCount += p.second->target->subtreeElementCount;
 	}
+
+	std::vector<std::pair<const SearchNode*, SearchElementTable::Element>>().swap(
+		m_pendingElements);
+
+	m_nodesForIds.insert(
+		m_nodesForIds.end(), m_addedNodesForIds.begin(), m_addedNodesForIds.end());
+	m_addedNodesForIds.clear();
+	m_nodesForIds.erase(
+		std::remove_if(
+			m_nodesForIds.begin(),
+			m_nodesForIds.end(),
+			[](const std::pair<Id, SearchNode*>& p) { return !p.second; }),
+		m_nodesForIds.end());
+	std::sort(m_nodesForIds.begin(), m_nodesForIds.end());
+	m_nodesForIds.erase(
+		std::unique(m_nodesForIds.begin(), m_nodesForIds.end()), m_nodesForIds.end());
+	m_nodesForIds.shrink_to_fit();
+
+	m_isSetUp = true;
 }
 
 void SearchIndex::clear()
 {
+	m_revision++;
+
 	m_nodes.clear();
 	m_edges.clear();
+	m_elementTable = std::make_unique<SearchElementTable>(m_elementMemoryBudget);
+	m_pendingElements.clear();
+	m_nodesForIds.clear();
+	m_addedNodesForIds.clear();
+	m_unusedNodes.clear();
+	m_unusedEdges.clear();
+	m_isSetUp = false;
 
-	m_nodes.push_back(std::make_unique<SearchNode>(NodeTypeSet()));
+	m_nodes.push_back(std::make_unique<SearchNode>());
 
 	m_root = m_nodes.back().get();
 }
 
 std::vector<SearchResult> SearchIndex::search(
 	const std::wstring& query,
-	NodeTypeSet acceptedNodeTypes,
+	const Filter& filter,
 	size_t maxResultCount,
-	size_t maxBestScoredResultsLength) const
+	size_t maxBestScoredResultsLength,
+	SearchCursor* cursor) const
 {
-	// find paths containing query
+	const std::wstring lowerQuery = utility::toLowerCase(query);
+
+	// find paths containing query, the shards are merged in order to keep the order of the paths
 	std::vector<SearchPath> paths;
-	searchRecursive(
-		SearchPath(L"", {}, m_root), utility::toLowerCase(query), acceptedNodeTypes, &paths);
+	if (cursor && cursor->m_index == this && cursor->m_revision == m_revision &&
+		cursor->m_filter == filter &&
+		utility::isPrefix(cursor->m_lowerQuery, lowerQuery))
+	{
+		// an extended query can only match behind the paths matching the last query
+		const std::wstring remainingQuery = lowerQuery.substr(cursor->m_lowerQuery.size());
+		const std::vector<SearchPath>& cursorPaths = cursor->m_paths;
+
+		const size_t shardCount = std::min(m_threadCount * 4, cursorPaths.size());
+		std::vector<std::vector<SearchPath>> shardPaths(shardCount);
+		forEachIndexConcurrently(shardCount, [&](size_t shard) {
+			for (size_t i = cursorPaths.size() * shard / shardCount;
+				 i < cursorPaths.size() * (shard + 1) / shardCount;
+				 i++)
+			{
+				continuePath(cursorPaths[i], remainingQuery, filter, &shardPaths[shard]);
+			}
+		});
+
+		for (std::vector<SearchPath>& shard: shardPaths)
+		{
+			std::move(shard.begin(), shard.end(), std::back_inserter(paths));
+		}
+	}
+	else
+	{
+		// each edge of the root is a shard
+		const SearchPath rootPath(L"", {}, m_root);
+		std::vector<const SearchEdge*> rootEdges;
+		for (const auto& p: m_root->edges)
+		{
+			rootEdges.push_back(p.second);
+		}
+
+		std::vector<std::vector<SearchPath>> shardPaths(rootEdges.size());
+		forEachIndexConcurrently(rootEdges.size(), [&](size_t shard) {
+			searchEdge(rootPath, rootEdges[shard], lowerQuery, filter, &shardPaths[shard]);
+		});
+
+		for (std::vector<SearchPath>& shard: shardPaths)
+		{
+			std::move(shard.begin(), shard.end(), std::back_inserter(paths));
+		}
+	}
 
 	// create scored search results
 	std::multiset<SearchResult> searchResults = createScoredResults(
-		paths, acceptedNodeTypes, maxResultCount * 3);
+		paths, filter, maxResultCount * 3);
+
+	if (cursor)
+	{
+		cursor->m_index = this;
+		cursor->m_revision = m_revision;
+		cursor->m_lowerQuery = lowerQuery;
+		cursor->m_filter = filter;
+		cursor->m_paths = std::move(paths);
+	}
 
 	// find maximum length for best scores
 	std::multiset<size_t> resultLengths;
@@ -144,141 +413,462 @@ std::vector<SearchResult> SearchIndex::search(
 	return std::vector<SearchResult>(bestResults.begin(), it);
 }
 
+SearchIndex::SearchNode* SearchIndex::createNode()
+{
+	if (m_unusedNodes.empty())
+	{
+		m_nodes.push_back(std::make_unique<SearchNode>());
+		return m_nodes.back().get();
+	}
+
+	SearchNode* node = m_unusedNodes.back();
+	m_unusedNodes.pop_back();
+	*node = SearchNode();
+	return node;
+}
+
+SearchIndex::SearchEdge* SearchIndex::createEdge(SearchNode* target, std::wstring s)
+{
+	if (m_unusedEdges.empty())
+	{
+		m_edges.push_back(std::make_unique<SearchEdge>(target, std::move(s)));
+		return m_edges.back().get();
+	}
+
+	SearchEdge* edge = m_unusedEdges.back();
+	m_unusedEdges.pop_back();
+	*edge = SearchEdge(target, std::move(s));
+	return edge;
+}
+
+void SearchIndex::addToGate(SearchEdge* e, const std::wstring& s) const
+{
+	for (const wchar_t& c: s)
+	{
+		e->gate.add(towlower(c));
+	}
+}
+
+bool SearchIndex::addElement(SearchNode* node, const SearchElementTable::Element& element)
+{
+	if (!m_isSetUp)
+	{
+		// ids added twice are dropped by finishSetup()
+		m_pendingElements.emplace_back(node, element);
+		node->elementCount++;
+		return true;
+	}
+
+	const auto isLess = [](const SearchElementTable::Element& a,
+						   const SearchElementTable::Element& b) { return a.id < b.id; };
+
+	// an unreadable list is not replaced, otherwise the lost elements would never come back
+	std::vector<SearchElementTable::Element> elements;
+	if (!getElements(node, &elements))
+	{
+		return false;
+	}
+
+	auto it = std::lower_bound(elements.begin(), elements.end(), element, isLess);
+	if (it != elements.end() && it->id == element.id)
+	{
+		return false;
+	}
+
+	elements.insert(it, element);
+	setElements(node, elements);
+	return true;
+}
+
+void SearchIndex::removeElement(SearchNode* node, Id id)
+{
+	if (m_isSetUp)
+	{
+		std::vector<SearchElementTable::Element> elements;
+		if (!getElements(node, &elements))
+		{
+			return;
+		}
+
+		elements.erase(
+			std::remove_if(
+				elements.begin(),
+				elements.end(),
+				[id](const SearchElementTable::Element& element) { return element.id == id; }),
+			elements.end());
+		setElements(node, elements);
+
+		for (SearchNode* n = node; n; n = n->parent)
+		{
+			n->subtreeElementCount--;
+		}
+	}
+	else
+	{
+		const size_t pendingElementCount = m_pendingElements.size();
+		m_pendingElements.erase(
+			std::remove_if(
+				m_pendingElements.begin(),
+				m_pendingElements.end(),
+				[node, id](const std::pair<const SearchNode*, SearchElementTable::Element>& p) {
+					return p.first == node && p.second.id == id;
+				}),
+			m_pendingElements.end());
+		node->elementCount -= static_cast<uint32_t>(
+			pendingElementCount - m_pendingElements.size());
+	}
+
+	// remove or merge nodes that are not needed anymore, so the trie looks as if the element was
+	// never added. Gates, contained types and flags may still include characters, types and flags
+	// of the element, but they only serve as filters.
+	while (node != m_root && !node->elementCount && node->edges.size() < 2)
+	{
+		SearchNode* parent = node->parent;
+		SearchEdge* incomingEdge = node->incomingEdge;
+
+		if (node->edges.empty())
+		{
+			parent->edges.erase(incomingEdge->s[0]);
+
+			m_unusedNodes.push_back(node);
+			m_unusedEdges.push_back(incomingEdge);
+
+			node = parent;
+		}
+		else
+		{
+			SearchEdge* edge = node->edges.begin()->second;
+
+			incomingEdge->s += edge->s;
+			incomingEdge->target = edge->target;
+			edge->target->parent = parent;
+			edge->target->incomingEdge = incomingEdge;
+
+			m_unusedNodes.push_back(node);
+			m_unusedEdges.push_back(edge);
+			break;
+		}
+	}
+}
+
+bool SearchIndex::getElements(
+	const SearchNode* node, std::vector<SearchElementTable::Element>* elements) const
+{
+	elements->clear();
+
+	if (!node->elementCount)
+	{
+		return true;
+	}
+
+	if (!m_isSetUp)
+	{
+		for (const std::pair<const SearchNode*, SearchElementTable::Element>& p: m_pendingElements)
+		{
+			if (p.first == node)
+			{
+				elements->push_back(p.second);
+			}
+		}
+		return true;
+	}
+
+	return m_elementTable->getList(node->elementListId, elements);
+}
+
+void SearchIndex::setElements(
+	SearchNode* node, const std::vector<SearchElementTable::Element>& elements)
+{
+	if (elements.empty())
+	{
+		if (node->elementCount)
+		{
+			m_elementTable->removeList(node->elementListId);
+		}
+	}
+	else if (node->elementCount)
+	{
+		m_elementTable->replaceList(node->elementListId, elements);
+	}
+	else
+	{
+		node->elementListId = m_elementTable->addList(elements);
+	}
+
+	node->elementCount = static_cast<uint32_t>(elements.size());
+}
+
+void SearchIndex::storePendingElements(SearchNode* node)
+{
+	// the pending elements are sorted by node and id
+	const std::pair<const SearchNode*, SearchElementTable::Element> key(node, {0, NODE_SYMBOL, 0});
+	auto range = std::equal_range(
+		m_pendingElements.begin(),
+		m_pendingElements.end(),
+		key,
+		[](const std::pair<const SearchNode*, SearchElementTable::Element>& a,
+		   const std::pair<const SearchNode*, SearchElementTable::Element>& b) {
+			return a.first < b.first;
+		});
+
+	if (range.first == range.second)
+	{
+		return;
+	}
+
+	std::vector<SearchElementTable::Element> elements;
+	for (auto it = range.first; it != range.second; it++)
+	{
+		elements.push_back(it->second);
+	}
+
+	node->elementListId = m_elementTable->addList(elements);
+	node->elementCount = static_cast<uint32_t>(elements.size());
+}
+
 void SearchIndex::populateEdgeGate(SearchEdge* e)
 {
+	storePendingElements(e->target);
+	e->target->subtreeElementCount = e->target->elementCount;
+
 	for (auto& p: e->target->edges)
 	{
 		SearchEdge* targetEdge = p.second;
 		populateEdgeGate(targetEdge);
-		utility::append(e->gate, targetEdge->gate);
+		e->gate.add(targetEdge->gate);
+		e->target->subtreeElementCount += targetEdge->target->subtreeElementCount;
 	}
 
 	for (const wchar_t& c: e->s)
 	{
-		e->gate.insert(towlower(c));
+		e->gate.add(towlower(c));
+	}
+}
+
+void SearchIndex::continuePath(
+	const SearchPath& path,
+	const std::wstring& remainingQuery,
+	const Filter& filter,
+	std::vector<SearchIndex::SearchPath>* results) const
+{
+	// consume characters for the rest of the last edge behind the last match
+	SearchPath currentPath = path;
+
+	size_t j = 0;
+	for (size_t i = path.indices.empty() ? 0 : path.indices.back() + 1;
+		 i < path.text.size() && j < remainingQuery.size();
+		 i++)
+	{
+		if (towlower(path.text[i]) == remainingQuery[j])
+		{
+			currentPath.indices.push_back(i);
+			j++;
+		}
+	}
+
+	if (j == remainingQuery.size())
+	{
+		results->push_back(std::move(currentPath));
+	}
+	else
+	{
+		searchRecursive(currentPath, remainingQuery.substr(j), filter, results);
 	}
 }
 
 void SearchIndex::searchRecursive(
 	const SearchPath& path,
 	const std::wstring& remainingQuery,
-	NodeTypeSet acceptedNodeTypes,
+	const Filter& filter,
 	std::vector<SearchIndex::SearchPath>* results) const
 {
 	for (const auto& p: path.node->edges)
 	{
-		const SearchEdge* currentEdge = p.second;
+		searchEdge(path, p.second, remainingQuery, filter, results);
+	}
+}
+
+void SearchIndex::searchEdge(
+	const SearchPath& path,
+	const SearchEdge* edge,
+	const std::wstring& remainingQuery,
+	const Filter& filter,
+	std::vector<SearchIndex::SearchPath>* results) const
+{
+	if (!filter.acceptsAnyOf(edge->target->containedTypes, edge->target->containedFlags))
+	{
+		return;
+	}
 
-		if (!acceptedNodeTypes.intersectsWith(currentEdge->target->containedTypes))
+	// test if s passes the edge's gate.
+	for (const wchar_t& c: remainingQuery)
+	{
+		if (!edge->gate.contains(c))
 		{
-			continue;
+			return;
 		}
+	}
+
+	// consume characters for edge
+	const std::wstring& edgeString = edge->s;
+	SearchPath currentPath {path.text + edgeString, path.indices, edge->target};
 
-		// test if s passes the edge's gate.
-		bool passesGate = true;
-		for (const wchar_t& c: remainingQuery)
+	size_t j = 0;
+	for (size_t i = 0; i < edgeString.size() && j < remainingQuery.size(); i++)
+	{
+		if (towlower(edgeString[i]) == remainingQuery[j])
 		{
-			if (currentEdge->gate.find(c) == currentEdge->gate.end())
-			{
-				passesGate = false;
-				break;
-			}
+			currentPath.indices.push_back(path.text.size() + i);
+			j++;
 		}
+	}
+
+	if (j == remainingQuery.size())
+	{
+		results->push_back(std::move(currentPath));
+	}
+	else
+	{
+		searchRecursive(currentPath, remainingQuery.substr(j), filter, results);
+	}
+}
+
+std::multiset<SearchResult> SearchIndex::createScoredResults(
+	const std::vector<SearchPath>& paths, const Filter& filter, size_t maxResultCount) const
+{
+	// score and order initial paths
+	std::vector<int> scores(paths.size());
+	forEachIndexConcurrently(paths.size(), [&](size_t i) {
+		scores[i] = scoreText(paths[i].text, paths[i].indices);
+	});
 
-		if (!passesGate)
+	std::multimap<int, const SearchPath*, std::greater<int>> scoredPaths;
+	for (size_t i = 0; i < paths.size(); i++)
+	{
+		scoredPaths.emplace(scores[i], &paths[i]);
+	}
+
+	std::vector<const SearchPath*> orderedPaths;
+	for (const auto& p: scoredPaths)
+	{
+		orderedPaths.push_back(p.second);
+	}
+
+	// score paths and subpaths in batches, results are added in order of the paths until there are
+	// enough of them
+	std::multiset<SearchResult> searchResults;
+	const size_t maxBatchSize = m_threadCount * 4;
+	size_t batchEnd = 0;
+	for (size_t batchStart = 0; batchStart < orderedPaths.size(); batchStart = batchEnd)
+	{
+		// don't take more paths than needed, if the subtrees of the first ones are large enough
+		size_t batchElementCount = 0;
+		while (batchEnd < orderedPaths.size() && batchEnd - batchStart < maxBatchSize &&
+			   (!maxResultCount || batchElementCount < maxResultCount - searchResults.size()))
 		{
-			continue;
+			batchElementCount += orderedPaths[batchEnd]->node->subtreeElementCount;
+			batchEnd++;
 		}
 
-		// consume characters for edge
-		const std::wstring& edgeString = currentEdge->s;
-		SearchPath currentPath {path.text + edgeString, path.indices, currentEdge->target};
+		std::vector<std::vector<SearchResult>> batchResults(batchEnd - batchStart);
+		forEachIndexConcurrently(batchEnd - batchStart, [&](size_t i) {
+			batchResults[i] = createSubpathResults(
+				*orderedPaths[batchStart + i], filter, maxResultCount);
+		});
 
-		size_t j = 0;
-		for (size_t i = 0; i < edgeString.size() && j < remainingQuery.size(); i++)
+		for (std::vector<SearchResult>& results: batchResults)
 		{
-			if (towlower(edgeString[i]) == remainingQuery[j])
+			for (SearchResult& result: results)
 			{
-				currentPath.indices.push_back(path.text.size() + i);
-				j++;
-			}
-		}
+				searchResults.insert(std::move(result));
 
-		if (j == remainingQuery.size())
-		{
-			results->push_back(std::move(currentPath));
-		}
-		else
-		{
-			searchRecursive(currentPath, remainingQuery.substr(j), acceptedNodeTypes, results);
+				if (maxResultCount && searchResults.size() >= maxResultCount)
+				{
+					return searchResults;
+				}
+			}
 		}
 	}
+
+	return searchResults;
 }
 
-std::multiset<SearchResult> SearchIndex::createScoredResults(
-	const std::vector<SearchPath>& paths, NodeTypeSet acceptedNodeTypes, size_t maxResultCount) const
+std::vector<SearchResult> SearchIndex::createSubpathResults(
+	const SearchPath& startPath, const Filter& filter, size_t maxResultCount) const
 {
-	// score and order initial paths
-	std::multimap<int, SearchPath, std::greater<int>> scoredPaths;
-	for (const SearchPath& path: paths)
+	std::vector<SearchResult> searchResults;
+
+	std::vector<SearchPath> currentPaths;
+	if (filter.acceptsAnyOf(startPath.node->containedTypes, startPath.node->containedFlags))
 	{
-		scoredPaths.emplace(scoreText(path.text, path.indices), path);
+		currentPaths.push_back(startPath);
 	}
 
-	// score paths and subpaths
-	std::multiset<SearchResult> searchResults;
-	for (const std::pair<int, SearchPath>& p: scoredPaths)
+	while (!currentPaths.empty())
 	{
-		std::vector<SearchPath> currentPaths;
-		currentPaths.push_back(p.second);
+		std::vector<SearchPath> nextPaths;
 
-		while (!currentPaths.empty())
+		for (const SearchPath& path: currentPaths)
 		{
-			std::vector<SearchPath> nextPaths;
-
-			for (const SearchPath& path: currentPaths)
+			std::vector<SearchElementTable::Element> elements;
+			if (path.node->elementCount && getElements(path.node, &elements))
 			{
-				if (!path.node->elementIds.empty() &&
-					(acceptedNodeTypes.intersectsWith(path.node->containedTypes)))
+				std::vector<Id> elementIds;
+				for (const SearchElementTable::Element& element: elements)
 				{
-					std::vector<Id> elementIds;
-					for (const auto& p: path.node->elementIds)
+					if (filter.accepts(NodeType(element.kind), element.flags))
 					{
-						if (acceptedNodeTypes.contains(p.second))
-						{
-							elementIds.push_back(p.first);
-						}
+						elementIds.push_back(element.id);
 					}
+				}
+
+				if (!elementIds.empty())
+				{
+					searchResults.emplace_back(
+						path.text,
+						std::move(elementIds),
+						path.indices,
+						scoreText(path.text, path.indices));
 
-					if (!elementIds.empty())
+					if (maxResultCount && searchResults.size() >= maxResultCount)
 					{
-						searchResults.emplace(
-							path.text,
-							std::move(elementIds),
-							path.indices,
-							scoreText(path.text, path.indices));
-
-						if (maxResultCount && searchResults.size() >= maxResultCount)
-						{
-							return searchResults;
-						}
+						return searchResults;
 					}
 				}
+			}
 
-				for (auto p: path.node->edges)
+			// only descend into subtrees containing accepted elements
+			for (auto p: path.node->edges)
+			{
+				const SearchEdge* edge = p.second;
+				if (filter.acceptsAnyOf(edge->target->containedTypes, edge->target->containedFlags))
 				{
-					const SearchEdge* edge = p.second;
 					nextPaths.emplace_back(path.text + edge->s, path.indices, edge->target);
 				}
 			}
-
-			currentPaths = std::move(nextPaths);
 		}
+
+		currentPaths = std::move(nextPaths);
 	}
 
 	return searchResults;
 }
 
+void SearchIndex::forEachIndexConcurrently(
+	size_t count, const std::function<void(size_t)>& func) const
+{
+	if (m_threadCount <= 1)
+	{
+		for (size_t index = 0; index < count; index++)
+		{
+			func(index);
+		}
+		return;
+	}
+
+	ThreadPool::getInstance()->parallelFor(count, func);
+}
+
 SearchResult SearchIndex::bestScoredResult(
 	SearchResult result,
 	std::map<std::wstring, SearchResult>* scoresCache,
@@ -1,6 +1,7 @@
 #ifndef SEARCH_INDEX_H
 #define SEARCH_INDEX_H
 
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -9,6 +10,7 @@
 
 #include "Node.h"
 #include "NodeTypeSet.h"
+#include "SearchElementTable.h"
 #include "types.h"
 
 // SearchResult is only used as an internal type in the SearchIndex and the PersistentStorage
@@ -36,30 +38,98 @@ struct SearchResult
 class SearchIndex
 {
 public:
-	SearchIndex();
+	class SearchCursor;
+
+	// Properties of an element that a search can require in addition to its node type.
+	enum ElementFlag
+	{
+		ELEMENT_DEFINED = 1 << 0,		   // defined in the indexed source files
+		ELEMENT_NON_INDEXED = 1 << 1,	   // only referenced, e.g. declared in a library
+		ELEMENT_LANGUAGE_CXX = 1 << 2,	   // name with C/C++ delimiter
+		ELEMENT_LANGUAGE_JAVA = 1 << 3,	   // name with Java delimiter, also used for Python
+		ELEMENT_FILE = 1 << 4,			   // element of a file index
+		ELEMENT_SYMBOL = 1 << 5			   // element of a symbol index
+	};
+	typedef int ElementFlags;
+
+	// Accepts the elements of the accepted node types that have all required flags. Each node of
+	// the trie keeps the node types and flags of all elements below it, so subtrees without any
+	// accepted element are skipped before their paths are scored.
+	struct Filter
+	{
+		Filter(NodeTypeSet acceptedNodeTypes = NodeTypeSet(), ElementFlags requiredFlags = 0);
+
+		bool operator==(const Filter& other) const;
+
+		bool accepts(const NodeType& type, ElementFlags flags) const;
+		bool acceptsAnyOf(const NodeTypeSet& types, ElementFlags flags) const;
+
+		NodeTypeSet acceptedNodeTypes;
+		ElementFlags requiredFlags;
+	};
+
+	// The searches are split into work for threadCount threads, which runs on the shared
+	// ThreadPool. threadCount == 0 uses the ideal thread count of the machine.
+	SearchIndex(size_t threadCount = 0);
+	SearchIndex(SearchIndex&& other) = default;
 	virtual ~SearchIndex();
 
-	void addNode(Id id, std::wstring name, NodeType type = NodeType(NODE_SYMBOL));
+	SearchIndex& operator=(SearchIndex&& other) = default;
+
+	// The elements of the nodes are kept apart from the trie in a SearchElementTable. With a
+	// memory budget above 0 its pages are moved to a temporary file and only the recently
+	// searched ones stay in memory.
+	void setElementMemoryBudget(size_t byteSize);
+	const SearchElementTable& getElementTable() const;
+
+	// true once element lists couldn't be read from the page file. Searches miss these elements
+	// and nodes can't be updated reliably, so the index has to be set up again.
+	bool hasLostElements() const;
+
+	// Nodes added after finishSetup() are searchable right away, so single nodes can be updated
+	// without setting up the whole index again.
+	void addNode(
+		Id id, std::wstring name, NodeType type = NodeType(NODE_SYMBOL), ElementFlags flags = 0);
+	void removeNode(Id id);
 	void finishSetup();
 	void clear();
 
-	// maxResultCount == 0 means "no restriction".
+	// maxResultCount == 0 means "no restriction". If a cursor is passed, a query extending the
+	// cursor's last query continues from its matches instead of searching the whole index.
 	std::vector<SearchResult> search(
 		const std::wstring& query,
-		NodeTypeSet acceptedNodeTypes,
+		const Filter& filter,
 		size_t maxResultCount,
-		size_t maxBestScoredResultsLength = 0) const;
+		size_t maxBestScoredResultsLength = 0,
+		SearchCursor* cursor = nullptr) const;
 
 private:
 	struct SearchEdge;
 
-	struct SearchNode
+	// The lower case characters of the names below an edge. Most names are ASCII, so these fit
+	// into a bit mask instead of a set node per character.
+	struct SearchGate
 	{
-		SearchNode(NodeTypeSet containedTypes): containedTypes(containedTypes) {}
+		void add(wchar_t c);
+		void add(const SearchGate& other);
+		bool contains(wchar_t c) const;
+
+		uint64_t asciiMask[2] = {0, 0};
+		std::vector<wchar_t> otherChars;	// sorted
+	};
 
-		std::map<Id, NodeType> elementIds;
+	struct SearchNode
+	{
+		// the elements are kept in the element table, or as pending elements until finishSetup()
+		SearchElementTable::ListId elementListId = 0;
+		uint32_t elementCount = 0;
 		NodeTypeSet containedTypes;
+		ElementFlags containedFlags = 0;
 		std::map<wchar_t, SearchEdge*> edges;
+		size_t subtreeElementCount = 0;	   // set by finishSetup()
+
+		SearchNode* parent = nullptr;
+		SearchEdge* incomingEdge = nullptr;
 	};
 
 	struct SearchEdge
@@ -68,7 +138,7 @@ private:
 
 		SearchNode* target;
 		std::wstring s;
-		std::set<wchar_t> gate;
+		SearchGate gate;
 	};
 
 	struct SearchPath
@@ -83,17 +153,59 @@ private:
 		SearchNode* node;
 	};
 
+public:
+	// Keeps the paths matching the last query of a search session, e.g. while a query is typed.
+	class SearchCursor
+	{
+	public:
+		void clear();
+
+	private:
+		friend class SearchIndex;
+
+		const SearchIndex* m_index = nullptr;
+		size_t m_revision = 0;
+		std::wstring m_lowerQuery;
+		Filter m_filter;
+		std::vector<SearchPath> m_paths;
+	};
+
+private:
+	SearchNode* createNode();
+	SearchEdge* createEdge(SearchNode* target, std::wstring s);
+	void addToGate(SearchEdge* e, const std::wstring& s) const;
+	bool addElement(SearchNode* node, const SearchElementTable::Element& element);
+	void removeElement(SearchNode* node, Id id);
+	bool getElements(
+		const SearchNode* node, std::vector<SearchElementTable::Element>* elements) const;
+	void setElements(SearchNode* node, const std::vector<SearchElementTable::Element>& elements);
+	void storePendingElements(SearchNode* node);
+
 	void populateEdgeGate(SearchEdge* e);
+	void continuePath(
+		const SearchPath& path,
+		const std::wstring& remainingQuery,
+		const Filter& filter,
+		std::vector<SearchIndex::SearchPath>* results) const;
 	void searchRecursive(
 		const SearchPath& path,
 		const std::wstring& remainingQuery,
-		NodeTypeSet acceptedNodeTypes,
+		const Filter& filter,
+		std::vector<SearchIndex::SearchPath>* results) const;
+	void searchEdge(
+		const SearchPath& path,
+		const SearchEdge* edge,
+		const std::wstring& remainingQuery,
+		const Filter& filter,
 		std::vector<SearchIndex::SearchPath>* results) const;
 
 	std::multiset<SearchResult> createScoredResults(
-		const std::vector<SearchPath>& paths,
-		NodeTypeSet acceptedNodeTypes,
-		size_t maxResultCount) const;
+		const std::vector<SearchPath>& paths, const Filter& filter, size_t maxResultCount) const;
+	std::vector<SearchResult> createSubpathResults(
+		const SearchPath& startPath, const Filter& filter, size_t maxResultCount) const;
+
+	// calls func for all indices below count on the threads of the shared ThreadPool
+	void forEachIndexConcurrently(size_t count, const std::function<void(size_t)>& func) const;
 
 	static SearchResult bestScoredResult(
 		SearchResult result,
@@ -122,6 +234,27 @@ private:
 	std::vector<std::unique_ptr<SearchNode>> m_nodes;
 	std::vector<std::unique_ptr<SearchEdge>> m_edges;
 	SearchNode* m_root;
+	size_t m_threadCount;
+
+	std::unique_ptr<SearchElementTable> m_elementTable;
+	// the elements added before finishSetup(). A single vector instead of one per node keeps the
+	// heap from being riddled with small blocks once they are moved to the element table.
+	std::vector<std::pair<const SearchNode*, SearchElementTable::Element>> m_pendingElements;
+	size_t m_elementMemoryBudget = 0;
+
+	// sorted by id by finishSetup(), the nodes of removed ids are null
+	std::vector<std::pair<Id, SearchNode*>> m_nodesForIds;
+	// the nodes of ids added after finishSetup()
+	std::multimap<Id, SearchNode*> m_addedNodesForIds;
+
+	std::vector<SearchNode*> m_unusedNodes;
+	std::vector<SearchEdge*> m_unusedEdges;
+
+	// gates and subtree element counts are updated on each change once the index is set up
+	bool m_isSetUp = false;
+
+	// changes whenever the trie changes, so cursors of older revisions are not used
+	size_t m_revision = 0;
 };
 
 #endif	  // SEARCH_INDEX_H
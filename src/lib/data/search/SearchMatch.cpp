@@ -3,6 +3,7 @@
 #include <sstream>
 
 #include "NodeTypeSet.h"
+#include "SearchFilter.h"
 #include "logging.h"
 
 void SearchMatch::log(const std::vector<SearchMatch>& matches, const std::wstring& query)
@@ -88,6 +89,10 @@ std::wstring SearchMatch::getCommandName(CommandType type)
 		return L"error";
 	case COMMAND_NODE_FILTER:
 		return L"node_filter";
+	case COMMAND_DEFINITION_FILTER:
+		return L"definition_filter";
+	case COMMAND_LANGUAGE_FILTER:
+		return L"language_filter";
 	case COMMAND_LEGEND:
 		return L"legend";
 	}
@@ -201,7 +206,14 @@ bool SearchMatch::isValid() const
 
 bool SearchMatch::isFilterCommand() const
 {
-	return searchType == SEARCH_COMMAND && getCommandType() == COMMAND_NODE_FILTER;
+	if (searchType != SEARCH_COMMAND)
+	{
+		return false;
+	}
+
+	const CommandType type = getCommandType();
+	return type == COMMAND_NODE_FILTER || type == COMMAND_DEFINITION_FILTER ||
+		type == COMMAND_LANGUAGE_FILTER;
 }
 
 void SearchMatch::print(std::wostream& ostream) const
@@ -250,6 +262,14 @@ SearchMatch::CommandType SearchMatch::getCommandType() const
 	{
 		return COMMAND_LEGEND;
 	}
+	else if (SearchFilter::isDefinitionFilterName(name))
+	{
+		return COMMAND_DEFINITION_FILTER;
+	}
+	else if (SearchFilter::isLanguageFilterName(name))
+	{
+		return COMMAND_LANGUAGE_FILTER;
+	}
 
 	return COMMAND_NODE_FILTER;
 }
@@ -28,6 +28,8 @@ struct SearchMatch
 		COMMAND_ALL,
 		COMMAND_ERROR,
 		COMMAND_NODE_FILTER,
+		COMMAND_DEFINITION_FILTER,
+		COMMAND_LANGUAGE_FILTER,
 		COMMAND_LEGEND
 	};
 
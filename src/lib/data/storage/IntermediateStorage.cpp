@@ -3,7 +3,10 @@
 #include "LocationType.h"
 #include "utility.h"
 
-IntermediateStorage::IntermediateStorage(): m_nextId(1) {}
+IntermediateStorage::IntermediateStorage()
+	: m_nextId(1), m_chunkFirstId(1), m_chunkByteSize(0), m_isChunk(false)
+{
+}
 
 void IntermediateStorage::clear()
 {
@@ -29,6 +32,14 @@ void IntermediateStorage::clear()
 	m_errors.clear();
 
 	m_nextId = 1;
+
+	m_chunkFirstId = 1;
+	m_chunkByteSize = 0;
+	m_chunkUpdatedNodeIds.clear();
+	m_chunkErrorFileIds.clear();
+	m_isChunk = false;
+
+	m_sourceFileChunkCounts.clear();
 }
 
 size_t IntermediateStorage::getByteSize(size_t stringSize) const
@@ -98,7 +109,7 @@ void IntermediateStorage::setAllFilesIncomplete()
 
 void IntermediateStorage::setFilesWithErrorsIncomplete()
 {
-	std::set<Id> errorFileIds;
+	std::set<Id> errorFileIds = m_chunkErrorFileIds;
 	for (const StorageSourceLocation& location: m_sourceLocations)
 	{
 		if (location.type == locationTypeToInt(LOCATION_ERROR))
@@ -116,6 +127,152 @@ void IntermediateStorage::setFilesWithErrorsIncomplete()
 	}
 }
 
+size_t IntermediateStorage::getChunkByteSize() const
+{
+	return m_chunkByteSize;
+}
+
+std::shared_ptr<IntermediateStorage> IntermediateStorage::extractChunk(bool lastChunk)
+{
+	std::set<Id> referencedIds = m_chunkUpdatedNodeIds;
+	auto addReferencedId = [&referencedIds, this](Id id) {
+		if (id < m_chunkFirstId)
+		{
+			referencedIds.insert(id);
+		}
+	};
+
+	for (const StorageSymbol& symbol: m_symbols)
+	{
+		addReferencedId(symbol.id);
+	}
+	for (const StorageOccurrence& occurrence: m_occurrences)
+	{
+		addReferencedId(occurrence.elementId);
+	}
+	for (const StorageComponentAccess& componentAccess: m_componentAccesses)
+	{
+		addReferencedId(componentAccess.nodeId);
+	}
+	for (const StorageElementComponent& component: m_elementComponents)
+	{
+		addReferencedId(component.elementId);
+	}
+	for (const StorageSourceLocation& location: m_sourceLocations)
+	{
+		if (location.type == locationTypeToInt(LOCATION_ERROR))
+		{
+			m_chunkErrorFileIds.insert(location.fileNodeId);
+		}
+	}
+
+	std::vector<StorageEdge> edges;
+	for (const StorageEdge& edge: m_edges)
+	{
+		if (edge.id >= m_chunkFirstId || referencedIds.find(edge.id) != referencedIds.end())
+		{
+			edges.push_back(edge);
+		}
+	}
+	for (const StorageEdge& edge: edges)
+	{
+		addReferencedId(edge.sourceNodeId);
+		addReferencedId(edge.targetNodeId);
+	}
+
+	std::vector<StorageFile> files = m_files;
+	for (StorageFile& file: files)
+	{
+		referencedIds.insert(file.id);
+		if (!lastChunk)
+		{
+			file.complete = false;
+		}
+	}
+
+	std::vector<StorageNode> nodes;
+	for (const StorageNode& node: m_nodes)
+	{
+		if (node.id >= m_chunkFirstId || referencedIds.find(node.id) != referencedIds.end())
+		{
+			nodes.push_back(node);
+		}
+	}
+
+	std::set<StorageLocalSymbol> localSymbols;
+	for (const StorageLocalSymbol& localSymbol: m_localSymbols)
+	{
+		if (localSymbol.id >= m_chunkFirstId ||
+			referencedIds.find(localSymbol.id) != referencedIds.end())
+		{
+			localSymbols.insert(localSymbol);
+		}
+	}
+
+	std::vector<StorageError> errors;
+	for (const StorageError& error: m_errors)
+	{
+		if (error.id >= m_chunkFirstId || referencedIds.find(error.id) != referencedIds.end())
+		{
+			errors.push_back(error);
+		}
+	}
+
+	std::shared_ptr<IntermediateStorage> chunk = std::make_shared<IntermediateStorage>();
+	chunk->setStorageNodes(std::move(nodes));
+	chunk->setStorageFiles(std::move(files));
+	chunk->setStorageEdges(std::move(edges));
+	chunk->setStorageLocalSymbols(std::move(localSymbols));
+	chunk->setErrors(std::move(errors));
+	chunk->setStorageSymbols(std::move(m_symbols));
+	chunk->setStorageSourceLocations(std::move(m_sourceLocations));
+	chunk->setStorageOccurrences(std::move(m_occurrences));
+	chunk->setComponentAccesses(std::move(m_componentAccesses));
+	chunk->setElementComponents(std::move(m_elementComponents));
+	chunk->setNextId(m_nextId);
+	chunk->setIsChunk(!lastChunk);
+
+	m_symbols.clear();
+	m_sourceLocations.clear();
+	m_occurrences.clear();
+	m_componentAccesses.clear();
+	m_elementComponents.clear();
+
+	m_chunkFirstId = m_nextId;
+	m_chunkByteSize = 0;
+	m_chunkUpdatedNodeIds.clear();
+
+	return chunk;
+}
+
+bool IntermediateStorage::isChunk() const
+{
+	return m_isChunk;
+}
+
+void IntermediateStorage::setIsChunk(bool isChunk)
+{
+	m_isChunk = isChunk;
+}
+
+const std::map<FilePath, int>& IntermediateStorage::getSourceFileChunkCounts() const
+{
+	return m_sourceFileChunkCounts;
+}
+
+void IntermediateStorage::addSourceFileChunkCount(const FilePath& sourceFilePath, int chunkCount)
+{
+	m_sourceFileChunkCounts[sourceFilePath] += chunkCount;
+}
+
+void IntermediateStorage::addSourceFileChunkCounts(const std::map<FilePath, int>& chunkCounts)
+{
+	for (const std::pair<const FilePath, int>& p: chunkCounts)
+	{
+		addSourceFileChunkCount(p.first, p.second);
+	}
+}
+
 std::pair<Id, bool> IntermediateStorage::addNode(const StorageNodeData& nodeData)
 {
 	auto it = m_nodesIndex.find(nodeData);
@@ -125,10 +282,16 @@ std::pair<Id, bool> IntermediateStorage::addNode(const StorageNodeData& nodeData
 		if (storedNode.type < nodeData.type)
 		{
 			storedNode.type = nodeData.type;
+			if (storedNode.id < m_chunkFirstId)
+			{
+				m_chunkUpdatedNodeIds.insert(storedNode.id);
+			}
 		}
 		return std::make_pair(storedNode.id, false);
 	}
 
+	m_chunkByteSize += sizeof(StorageNode) + nodeData.serializedName.size() * sizeof(wchar_t);
+
 	Id nodeId = m_nextId++;
 	m_nodes.emplace_back(nodeId, nodeData);
 	m_nodesIndex.emplace(nodeData, m_nodes.size() - 1);
@@ -153,17 +316,23 @@ void IntermediateStorage::setNodeType(Id nodeId, int nodeType)
 	if (it != m_nodeIdIndex.end() && m_nodes[it->second].type < nodeType)
 	{
 		m_nodes[it->second].type = nodeType;
+		if (nodeId < m_chunkFirstId)
+		{
+			m_chunkUpdatedNodeIds.insert(nodeId);
+		}
 	}
 }
 
 void IntermediateStorage::addSymbol(const StorageSymbol& symbol)
 {
 	m_symbols.push_back(symbol);
+	m_chunkByteSize += sizeof(StorageSymbol);
 }
 
 void IntermediateStorage::addSymbols(const std::vector<StorageSymbol>& symbols)
 {
 	m_symbols.insert(m_symbols.end(), symbols.begin(), symbols.end());
+	m_chunkByteSize += sizeof(StorageSymbol) * symbols.size();
 }
 
 void IntermediateStorage::addFile(const StorageFile& file)
@@ -190,6 +359,8 @@ void IntermediateStorage::addFile(const StorageFile& file)
 	}
 	else
 	{
+		m_chunkByteSize += sizeof(StorageFile) + file.filePath.size() * sizeof(wchar_t);
+
 		m_filesIndex.emplace(file, m_files.size());
 		m_filesIdIndex.emplace(file.id, m_files.size());
 		m_files.emplace_back(file);
@@ -213,6 +384,8 @@ Id IntermediateStorage::addEdge(const StorageEdgeData& edgeData)
 		return m_edges[it->second].id;
 	}
 
+	m_chunkByteSize += sizeof(StorageEdge);
+
 	Id edgeId = m_nextId++;
 	m_edges.emplace_back(edgeId, edgeData);
 	m_edgesIndex.emplace(edgeData, m_edges.size() - 1);
@@ -238,6 +411,8 @@ Id IntermediateStorage::addLocalSymbol(const StorageLocalSymbolData& localSymbol
 		return it->id;
 	}
 
+	m_chunkByteSize += sizeof(StorageLocalSymbol) + localSymbolData.name.size() * sizeof(wchar_t);
+
 	Id localSymbolId = m_nextId++;
 	m_localSymbols.emplace(localSymbolId, localSymbolData);
 	return localSymbolId;
@@ -262,6 +437,8 @@ Id IntermediateStorage::addSourceLocation(const StorageSourceLocationData& sourc
 		return it->id;
 	}
 
+	m_chunkByteSize += sizeof(StorageSourceLocation);
+
 	Id sourceLocationId = m_nextId++;
 	m_sourceLocations.emplace(sourceLocationId, sourceLocationData);
 	return sourceLocationId;
@@ -281,31 +458,37 @@ std::vector<Id> IntermediateStorage::addSourceLocations(const std::vector<Storag
 void IntermediateStorage::addOccurrence(const StorageOccurrence& occurrence)
 {
 	m_occurrences.emplace(occurrence);
+	m_chunkByteSize += sizeof(StorageOccurrence);
 }
 
 void IntermediateStorage::addOccurrences(const std::vector<StorageOccurrence>& occurrences)
 {
 	m_occurrences.insert(occurrences.begin(), occurrences.end());
+	m_chunkByteSize += sizeof(StorageOccurrence) * occurrences.size();
 }
 
 void IntermediateStorage::addComponentAccess(const StorageComponentAccess& componentAccess)
 {
 	m_componentAccesses.emplace(componentAccess);
+	m_chunkByteSize += sizeof(StorageComponentAccess);
 }
 
 void IntermediateStorage::addComponentAccesses(const std::vector<StorageComponentAccess>& componentAccesses)
 {
 	m_componentAccesses.insert(componentAccesses.begin(), componentAccesses.end());
+	m_chunkByteSize += sizeof(StorageComponentAccess) * componentAccesses.size();
 }
 
 void IntermediateStorage::addElementComponent(const StorageElementComponent& component)
 {
 	m_elementComponents.emplace(component);
+	m_chunkByteSize += sizeof(StorageElementComponent);
 }
 
 void IntermediateStorage::addElementComponents(const std::vector<StorageElementComponent>& components)
 {
 	m_elementComponents.insert(components.begin(), components.end());
+	m_chunkByteSize += sizeof(StorageElementComponent) * components.size();
 }
 
 Id IntermediateStorage::addError(const StorageErrorData& errorData)
@@ -316,6 +499,9 @@ Id IntermediateStorage::addError(const StorageErrorData& errorData)
 		return m_errors[it->second].id;
 	}
 
+	m_chunkByteSize += sizeof(StorageError) +
+		(errorData.message.size() + errorData.translationUnit.size()) * sizeof(wchar_t);
+
 	Id errorId = m_nextId++;
 	m_errors.emplace_back(errorId, errorData);
 	m_errorsIndex.emplace(errorData, m_errors.size() - 1);
@@ -5,6 +5,7 @@
 #include <memory>
 #include <set>
 
+#include "FilePath.h"
 #include "Storage.h"
 
 class IntermediateStorage: public Storage
@@ -21,6 +22,25 @@ public:
 	void setAllFilesIncomplete();
 	void setFilesWithErrorsIncomplete();
 
+	// Rough byte size of the data added since the last extracted chunk, cheap to call.
+	size_t getChunkByteSize() const;
+
+	// Moves the data added since the last extracted chunk to a new storage that can be injected on
+	// its own. Besides the new data the chunk contains all files and the earlier elements that the
+	// new data refers to, so ids stay valid across chunks. This storage keeps its elements to
+	// resolve later references. Files of chunks that are not the last one are incomplete.
+	std::shared_ptr<IntermediateStorage> extractChunk(bool lastChunk);
+
+	// true for storages extracted as an early chunk of a translation unit
+	bool isChunk() const;
+	void setIsChunk(bool isChunk);
+
+	// Source files indexed into this storage. An early chunk of a source file counts 1, the last
+	// part counts the negative number of early chunks, so the counts of all parts add up to 0.
+	const std::map<FilePath, int>& getSourceFileChunkCounts() const;
+	void addSourceFileChunkCount(const FilePath& sourceFilePath, int chunkCount);
+	void addSourceFileChunkCounts(const std::map<FilePath, int>& chunkCounts);
+
 	std::pair<Id, bool> addNode(const StorageNodeData& nodeData) override;
 	std::vector<Id> addNodes(const std::vector<StorageNode>& nodes) override;
 	void setNodeType(Id nodeId, int nodeType);
@@ -94,6 +114,14 @@ private:
 	std::vector<StorageError> m_errors;
 
 	Id m_nextId;
+
+	Id m_chunkFirstId;
+	size_t m_chunkByteSize;
+	std::set<Id> m_chunkUpdatedNodeIds;
+	std::set<Id> m_chunkErrorFileIds;
+	bool m_isChunk;
+
+	std::map<FilePath, int> m_sourceFileChunkCounts;
 };
 
 #endif	  // INTERMEDIATE_STORAGE_H
@@ -1,6 +1,7 @@
 #include "PersistentStorage.h"
 
 #include <queue>
+#include <regex>
 #include <sstream>
 
 #include "AccessKind.h"
@@ -8,6 +9,7 @@
 #include "ElementComponentKind.h"
 #include "FileInfo.h"
 #include "FilePath.h"
+#include "FullTextSearchCursor.h"
 #include "Graph.h"
 #include "MessageErrorCountUpdate.h"
 #include "MessageStatus.h"
@@ -17,18 +19,156 @@
 #include "SourceLocationFile.h"
 #include "TextAccess.h"
 #include "TextCodec.h"
+#include "ThreadPool.h"
 #include "TimeStamp.h"
 #include "TokenComponentAccess.h"
 #include "TokenComponentAggregation.h"
 #include "TokenComponentFilePath.h"
 #include "TokenComponentInheritanceChain.h"
 #include "TokenComponentIsAmbiguous.h"
+#include "TrigramQuery.h"
 #include "UnorderedCache.h"
 #include "logging.h"
 #include "tracing.h"
 #include "utility.h"
 #include "utilityApp.h"
 
+namespace
+{
+// returns the locations of the search term at the positions found by the fulltext search index
+std::vector<ParseLocation> getTermLocations(
+	const TextAccess* fileContent,
+	const std::vector<int>& positions,
+	const std::wstring& searchTerm,
+	bool caseSensitive,
+	const TextCodec& codec)
+{
+	std::vector<ParseLocation> locations;
+
+	const int termLength = static_cast<int>(searchTerm.length());
+	int charsTotal = 0;
+	unsigned int lineNumber = 1;
+	std::wstring line = codec.decode(fileContent->getLine(lineNumber));
+
+	for (int pos: positions)
+	{
+		while (charsTotal + (int)line.length() <= pos)
+		{
+			charsTotal += static_cast<int>(line.length());
+			lineNumber++;
+			line = codec.decode(fileContent->getLine(lineNumber));
+		}
+
+		ParseLocation location;
+		location.startLineNumber = lineNumber;
+		location.startColumnNumber = pos - charsTotal + 1;
+
+		if (caseSensitive && line.substr(location.startColumnNumber - 1, termLength) != searchTerm)
+		{
+			continue;
+		}
+		while ((charsTotal + (int)line.length()) < pos + termLength)
+		{
+			charsTotal += static_cast<int>(line.length());
+			lineNumber++;
+			line = codec.decode(fileContent->getLine(lineNumber));
+		}
+		location.endLineNumber = lineNumber;
+		location.endColumnNumber = pos + termLength - charsTotal;
+
+		locations.push_back(location);
+	}
+
+	return locations;
+}
+
+// returns the matches of the regular expression, which are searched line by line
+std::vector<ParseLocation> getRegexLocations(
+	const TextAccess* fileContent, const std::wregex& regex, const TextCodec& codec)
+{
+	std::vector<ParseLocation> locations;
+
+	const unsigned int lineCount = fileContent->getLineCount();
+	for (unsigned int lineNumber = 1; lineNumber <= lineCount; lineNumber++)
+	{
+		std::wstring line = codec.decode(fileContent->getLine(lineNumber));
+		while (!line.empty() && (line.back() == L'\n' || line.back() == L'\r'))
+		{
+			line.pop_back();
+		}
+
+		for (auto it = std::wsregex_iterator(line.begin(), line.end(), regex);
+			 it != std::wsregex_iterator();
+			 it++)
+		{
+			if (it->length() > 0)
+			{
+				locations.emplace_back(
+					0,
+					lineNumber,
+					static_cast<size_t>(it->position() + 1),
+					lineNumber,
+					static_cast<size_t>(it->position() + it->length()));
+			}
+		}
+	}
+
+	return locations;
+}
+
+// search terms enclosed in slashes are regular expressions, e.g. "/get\w*Id\(/"
+bool isRegexSearchTerm(const std::wstring& searchTerm)
+{
+	return searchTerm.size() > 2 && searchTerm.front() == L'/' && searchTerm.back() == L'/';
+}
+
+// throws std::regex_error for an invalid regular expression
+std::wregex createSearchTermRegex(const std::wstring& searchTerm, bool caseSensitive)
+{
+	return std::wregex(
+		searchTerm.substr(1, searchTerm.size() - 2),
+		caseSensitive ? std::regex::ECMAScript : std::regex::ECMAScript | std::regex::icase);
+}
+
+size_t getSearchIndexMemoryBudget()
+{
+	return static_cast<size_t>(
+			   std::max(0, ApplicationSettings::getInstance()->getSearchIndexMemoryBudgetMb())) *
+		1024 * 1024;
+}
+
+SearchIndex::ElementFlags getRequiredElementFlags(const SearchFilter& filter)
+{
+	SearchIndex::ElementFlags flags = 0;
+
+	switch (filter.definition)
+	{
+	case SearchFilter::DEFINITION_INDEXED:
+		flags |= SearchIndex::ELEMENT_DEFINED;
+		break;
+	case SearchFilter::DEFINITION_NON_INDEXED:
+		flags |= SearchIndex::ELEMENT_NON_INDEXED;
+		break;
+	case SearchFilter::DEFINITION_ALL:
+		break;
+	}
+
+	switch (filter.language)
+	{
+	case SearchFilter::LANGUAGE_CXX:
+		flags |= SearchIndex::ELEMENT_LANGUAGE_CXX;
+		break;
+	case SearchFilter::LANGUAGE_JAVA:
+		flags |= SearchIndex::ELEMENT_LANGUAGE_JAVA;
+		break;
+	case SearchFilter::LANGUAGE_ALL:
+		break;
+	}
+
+	return flags;
+}
+}	 // namespace
+
 PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& bookmarkPath)
 	: m_sqliteIndexStorage(dbPath), m_sqliteBookmarkStorage(bookmarkPath)
 {
@@ -36,6 +176,11 @@ PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& boo
 	m_commandIndex.addNode(0, SearchMatch::getCommandName(SearchMatch::COMMAND_ERROR));
 	m_commandIndex.addNode(0, SearchMatch::getCommandName(SearchMatch::COMMAND_LEGEND));
 
+	for (const std::wstring& filterName: SearchFilter::getFilterNames())
+	{
+		m_commandIndex.addNode(0, filterName);
+	}
+
 	for (const NodeType& nodeType: NodeTypeSet::all().getNodeTypes())
 	{
 		if (nodeType.hasSearchFilter())
@@ -49,26 +194,40 @@ PersistentStorage::PersistentStorage(const FilePath& dbPath, const FilePath& boo
 
 std::pair<Id, bool> PersistentStorage::addNode(const StorageNodeData& data)
 {
-	return std::make_pair(m_sqliteIndexStorage.addNode(data), true);
+	const Id id = m_sqliteIndexStorage.addNode(data);
+	addChangedNodeIds({id});
+	return std::make_pair(id, true);
 }
 
 std::vector<Id> PersistentStorage::addNodes(const std::vector<StorageNode>& nodes)
 {
-	return m_sqliteIndexStorage.addNodes(nodes);
+	const std::vector<Id> ids = m_sqliteIndexStorage.addNodes(nodes);
+	addChangedNodeIds(ids);
+	return ids;
 }
 
 void PersistentStorage::addSymbol(const StorageSymbol& data)
 {
 	m_sqliteIndexStorage.addSymbol(data);
+	addChangedNodeIds({data.id});
 }
 
 void PersistentStorage::addSymbols(const std::vector<StorageSymbol>& symbols)
 {
 	m_sqliteIndexStorage.addSymbols(symbols);
+
+	std::vector<Id> ids;
+	for (const StorageSymbol& symbol: symbols)
+	{
+		ids.push_back(symbol.id);
+	}
+	addChangedNodeIds(ids);
 }
 
 void PersistentStorage::addFile(const StorageFile& data)
 {
+	addChangedNodeIds({data.id});
+
 	const StorageFile storedFile = m_sqliteIndexStorage.getFirstById<StorageFile>(data.id);
 
 	if (storedFile.id == 0)
@@ -158,11 +317,13 @@ Id PersistentStorage::addError(const StorageErrorData& data)
 void PersistentStorage::removeElement(const Id id)
 {
 	m_sqliteIndexStorage.removeElement(id);
+	addChangedNodeIds({id});
 }
 
 void PersistentStorage::removeElements(const std::vector<Id>& ids)
 {
 	m_sqliteIndexStorage.removeElements(ids);
+	addChangedNodeIds(ids);
 }
 
 void PersistentStorage::removeOccurrence(const StorageOccurrence& occurrence)
@@ -178,6 +339,7 @@ void PersistentStorage::removeOccurrences(const std::vector<StorageOccurrence>&
 void PersistentStorage::removeElementsWithoutOccurrences(const std::vector<Id>& elementIds)
 {
 	m_sqliteIndexStorage.removeElementsWithoutOccurrences(elementIds);
+	addChangedNodeIds(elementIds);
 }
 
 const std::vector<StorageNode>& PersistentStorage::getStorageNodes() const
@@ -403,6 +565,9 @@ void PersistentStorage::clearFileElements(
 
 	if (!fileNodeIds.empty())
 	{
+		addChangedNodeIds(fileNodeIds);
+		addChangedNodeIds(m_sqliteIndexStorage.getElementIdsWithLocationInFiles(fileNodeIds));
+
 		m_sqliteIndexStorage.beginTransaction();
 		m_sqliteIndexStorage.removeElementsWithLocationInFiles(fileNodeIds, updateStatusCallback);
 		m_sqliteIndexStorage.removeElements(fileNodeIds);
@@ -457,6 +622,81 @@ bool PersistentStorage::getFilePathIndexed(const FilePath& path) const
 	return false;
 }
 
+void PersistentStorage::setPendingSourceFiles(const std::set<FilePath>& filePaths)
+{
+	m_injectedSourceFileChunkCounts.clear();
+
+	m_sqliteIndexStorage.beginTransaction();
+	m_sqliteIndexStorage.setPendingSourceFiles(filePaths);
+	m_sqliteIndexStorage.commitTransaction();
+}
+
+std::set<FilePath> PersistentStorage::getPendingSourceFiles() const
+{
+	return m_sqliteIndexStorage.getPendingSourceFiles();
+}
+
+void PersistentStorage::addInjectedSourceFileChunkCounts(const std::map<FilePath, int>& chunkCounts)
+{
+	for (const std::pair<const FilePath, int>& p: chunkCounts)
+	{
+		m_injectedSourceFileChunkCounts[p.first] += p.second;
+	}
+}
+
+void PersistentStorage::checkpointInjectedSourceFiles()
+{
+	// the counts of all parts of a source file add up to 0, earlier parts may still be on their way
+	std::set<FilePath> injectedFilePaths;
+	for (auto it = m_injectedSourceFileChunkCounts.begin();
+		 it != m_injectedSourceFileChunkCounts.end();)
+	{
+		if (it->second == 0)
+		{
+			injectedFilePaths.insert(it->first);
+			it = m_injectedSourceFileChunkCounts.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+
+	if (!injectedFilePaths.empty())
+	{
+		m_sqliteIndexStorage.beginTransaction();
+		m_sqliteIndexStorage.removePendingSourceFiles(injectedFilePaths);
+		m_sqliteIndexStorage.commitTransaction();
+
+		LOG_INFO(
+			"indexing checkpoint for " + std::to_string(injectedFilePaths.size()) +
+			" injected source files");
+	}
+}
+
+std::set<Id> PersistentStorage::getChangedNodeIds() const
+{
+	std::lock_guard<std::mutex> lock(m_changedNodeIdsMutex);
+	return m_changedNodeIds;
+}
+
+PersistentStorage::SearchIndices PersistentStorage::releaseSearchIndices()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_symbolSearchCursorMutex);
+		m_symbolSearchCursor.clear();
+	}
+
+	SearchIndices searchIndices;
+	searchIndices.symbolIndex = std::move(m_symbolIndex);
+	searchIndices.fileIndex = std::move(m_fileIndex);
+
+	m_symbolIndex.clear();
+	m_fileIndex.clear();
+
+	return searchIndices;
+}
+
 void PersistentStorage::buildCaches()
 {
 	TRACE();
@@ -469,6 +709,19 @@ void PersistentStorage::buildCaches()
 	buildHierarchyCache();
 }
 
+void PersistentStorage::buildCaches(
+	SearchIndices previousSearchIndices, const std::set<Id>& changedNodeIds)
+{
+	TRACE();
+
+	clearCaches();
+
+	buildFilePathMaps();
+	updateSearchIndex(std::move(previousSearchIndices), changedNodeIds);
+	buildMemberEdgeIdOrderMap();
+	buildHierarchyCache();
+}
+
 void PersistentStorage::optimizeMemory()
 {
 	TRACE();
@@ -479,6 +732,17 @@ void PersistentStorage::optimizeMemory()
 	m_sqliteBookmarkStorage.optimizeMemory();
 }
 
+FilePath PersistentStorage::getFullTextSearchIndexFilePath(const FilePath& indexDbFilePath)
+{
+	return FilePath(indexDbFilePath.wstr() + L"_fulltext");
+}
+
+void PersistentStorage::updateFullTextSearchIndex()
+{
+	std::lock_guard<std::mutex> lock(m_fullTextSearchMutex);
+	buildFullTextSearchIndex();
+}
+
 Id PersistentStorage::getNodeIdForFileNode(const FilePath& filePath) const
 {
 	return getFileNodeId(filePath);
@@ -581,16 +845,25 @@ StorageEdge PersistentStorage::getEdgeById(Id edgeId) const
 	return m_sqliteIndexStorage.getEdgeById(edgeId);
 }
 
-std::shared_ptr<SourceLocationCollection> PersistentStorage::getFullTextSearchLocations(
-	const std::wstring& searchTerm, bool caseSensitive) const
+bool PersistentStorage::getFullTextSearchLocations(
+	const std::wstring& searchTerm,
+	bool caseSensitive,
+	size_t maxLocationCount,
+	std::function<bool(std::shared_ptr<SourceLocationCollection>)> onLocations,
+	FullTextSearchCursor* cursor) const
 {
 	TRACE();
 
-	std::shared_ptr<SourceLocationCollection> collection =
-		std::make_shared<SourceLocationCollection>();
+	FullTextSearchCursor searchCursor;
+	if (!cursor)
+	{
+		cursor = &searchCursor;
+	}
+	cursor->clear();
+
 	if (searchTerm.empty())
 	{
-		return collection;
+		return false;
 	}
 
 	const TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
@@ -599,11 +872,68 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getFullTextSearchLo
 
 		if (m_fullTextSearchCodec != codec.getName())
 		{
-			MessageStatus(L"Building fulltext search index", false, true).dispatch();
+			MessageStatus(L"Loading fulltext search index", false, true).dispatch();
 			buildFullTextSearchIndex();
 		}
 	}
 
+	if (isRegexSearchTerm(searchTerm))
+	{
+		const std::wstring pattern = searchTerm.substr(1, searchTerm.size() - 2);
+		try
+		{
+			createSearchTermRegex(searchTerm, caseSensitive);
+		}
+		catch (const std::regex_error& e)
+		{
+			MessageStatus(
+				L"Invalid regular expression for fulltext search: " + pattern + L" (" +
+					utility::decodeFromUtf8(e.what()) + L")",
+				true,
+				false)
+				.dispatch();
+			return false;
+		}
+
+		// only files containing the trigrams required by the regular expression can have a match
+		for (Id fileId:
+			 m_fullTextSearchIndex.getFilesForTrigramQuery(TrigramQuery::fromRegex(pattern)))
+		{
+			FullTextSearchResult fileResult;
+			fileResult.fileId = fileId;
+			cursor->fileResults.push_back(fileResult);
+		}
+	}
+	else
+	{
+		cursor->fileResults = m_fullTextSearchIndex.searchForTerm(searchTerm);
+		std::stable_sort(
+			cursor->fileResults.begin(),
+			cursor->fileResults.end(),
+			[](const FullTextSearchResult& a, const FullTextSearchResult& b) {
+				return a.positions.size() > b.positions.size();
+			});
+	}
+
+	cursor->searchTerm = searchTerm;
+	cursor->caseSensitive = caseSensitive;
+	return continueFullTextSearch(cursor, maxLocationCount, onLocations);
+}
+
+bool PersistentStorage::continueFullTextSearch(
+	FullTextSearchCursor* cursor,
+	size_t maxLocationCount,
+	std::function<bool(std::shared_ptr<SourceLocationCollection>)> onLocations) const
+{
+	TRACE();
+
+	const std::wstring searchTerm = cursor->searchTerm;
+	const bool caseSensitive = cursor->caseSensitive;
+	if (searchTerm.empty())
+	{
+		return false;
+	}
+
 	MessageStatus(
 		std::wstring(L"Searching fulltext (case-") +
 			(caseSensitive ? L"sensitive" : L"insensitive") + L"): " + searchTerm,
@@ -611,100 +941,139 @@ std::shared_ptr<SourceLocationCollection> PersistentStorage::getFullTextSearchLo
 		true)
 		.dispatch();
 
-	{
-		std::vector<std::shared_ptr<std::thread>> threads;
-		std::mutex collectionMutex;
-		for (std::vector<FullTextSearchResult> fileResults: utility::splitToEqualySizedParts(
-				 m_fullTextSearchIndex.searchForTerm(searchTerm), utility::getIdealThreadCount()))
-		{
-			std::shared_ptr<std::thread> thread = std::make_shared<std::thread>(
-				[this,
-				 &searchTerm,
-				 &caseSensitive,
-				 &codec,
-				 /*no ref here!*/ fileResults,
-				 &collection,
-				 &collectionMutex]() {
-					const int termLength = static_cast<int>(searchTerm.length());
-					for (const FullTextSearchResult& fileResult: fileResults)
-					{
-						const FilePath filePath = getFileNodePath(fileResult.fileId);
-						std::shared_ptr<TextAccess> fileContent = getFileContent(filePath, false);
+	const TextCodec codec(ApplicationSettings::getInstance()->getTextEncoding());
+	const bool isRegex = isRegexSearchTerm(searchTerm);
+	const std::wregex regex = isRegex ? createSearchTermRegex(searchTerm, caseSensitive)
+									  : std::wregex();
+
+	// The files are searched in batches and the locations of each batch are passed on right away,
+	// so the first results can be shown and the search can be stopped before all files are done.
+	std::shared_ptr<ThreadPool> threadPool = ThreadPool::getInstance();
+	const size_t batchSize = (threadPool->getThreadCount() + 1) * 4;
+	const size_t maxTotalLocationCount = cursor->locationCount + maxLocationCount;
+
+	bool hasMoreLocations = false;
+	while (!hasMoreLocations &&
+		   (!cursor->pendingFileLocations.empty() ||
+			cursor->nextFileIndex < cursor->fileResults.size()))
+	{
+		if (cursor->pendingFileLocations.empty())
+		{
+			const size_t batchStart = cursor->nextFileIndex;
+			const size_t batchEnd = std::min(batchStart + batchSize, cursor->fileResults.size());
+			cursor->nextFileIndex = batchEnd;
+
+			std::vector<std::vector<ParseLocation>> batchLocations(batchEnd - batchStart);
+			threadPool->parallelFor(batchEnd - batchStart, [&](size_t i) {
+				const FullTextSearchResult& fileResult = cursor->fileResults[batchStart + i];
+				std::shared_ptr<TextAccess> fileContent = getFileContent(
+					getFileNodePath(fileResult.fileId), false);
+
+				batchLocations[i] = isRegex
+					? getRegexLocations(fileContent.get(), regex, codec)
+					: getTermLocations(
+						  fileContent.get(),
+						  fileResult.positions,
+						  searchTerm,
+						  caseSensitive,
+						  codec);
+			});
 
-						int charsTotal = 0;
-						int lineNumber = 1;
-						std::wstring line = codec.decode(fileContent->getLine(lineNumber));
+			// files with more matches come first within each chunk
+			std::vector<size_t> batchOrder;
+			for (size_t i = 0; i < batchLocations.size(); i++)
+			{
+				batchOrder.push_back(i);
+			}
+			std::stable_sort(
+				batchOrder.begin(), batchOrder.end(), [&batchLocations](size_t a, size_t b) {
+					return batchLocations[a].size() > batchLocations[b].size();
+				});
 
-						for (int pos: fileResult.positions)
-						{
-							while (charsTotal + (int)line.length() <= pos)
-							{
-								charsTotal += static_cast<int>(line.length());
-								lineNumber++;
-								line = codec.decode(fileContent->getLine(lineNumber));
-							}
+			for (size_t i: batchOrder)
+			{
+				if (!batchLocations[i].empty())
+				{
+					cursor->pendingFileLocations.push_back(
+						{cursor->fileResults[batchStart + i].fileId,
+						 std::move(batchLocations[i]),
+						 0});
+				}
+			}
+		}
+
+		std::shared_ptr<SourceLocationCollection> collection =
+			std::make_shared<SourceLocationCollection>();
+		while (!cursor->pendingFileLocations.empty() && !hasMoreLocations)
+		{
+			FullTextSearchCursor::FileLocations& fileLocations =
+				cursor->pendingFileLocations.front();
+			const FilePath filePath = getFileNodePath(fileLocations.fileId);
+			while (fileLocations.passedLocationCount < fileLocations.locations.size())
+			{
+				if (cursor->locationCount == maxTotalLocationCount)
+				{
+					hasMoreLocations = true;
+					break;
+				}
 
-							ParseLocation location;
-							location.startLineNumber = lineNumber;
-							location.startColumnNumber = pos - charsTotal + 1;
+				if (!fileLocations.passedLocationCount)
+				{
+					cursor->fileCount++;
+				}
 
-							if (caseSensitive &&
-								line.substr(location.startColumnNumber - 1, termLength) != searchTerm)
-							{
-								continue;
-							}
-							while ((charsTotal + (int)line.length()) < pos + termLength)
-							{
-								charsTotal += static_cast<int>(line.length());
-								lineNumber++;
-								line = codec.decode(fileContent->getLine(lineNumber));
-							}
-							location.endLineNumber = lineNumber;
-							location.endColumnNumber = pos + termLength - charsTotal;
+				const ParseLocation& location =
+					fileLocations.locations[fileLocations.passedLocationCount++];
+				cursor->locationCount++;
+				collection->addSourceLocation(
+					LOCATION_FULLTEXT_SEARCH,
+					// Set first bit to 1 to avoid collisions
+					~(~Id(0) >> 1) + cursor->locationCount,
+					std::vector<Id>(),
+					filePath,
+					location.startLineNumber,
+					location.startColumnNumber,
+					location.endLineNumber,
+					location.endColumnNumber);
+			}
 
-							{
-								std::lock_guard<std::mutex> lock(collectionMutex);
-								// Set first bit to 1 to avoid collisions
-								const Id locationId = ~(~Id(0) >> 1) +
-									collection->getSourceLocationCount() + 1;
-								collection->addSourceLocation(
-									LOCATION_FULLTEXT_SEARCH,
-									locationId,
-									std::vector<Id>(),
-									filePath,
-									location.startLineNumber,
-									location.startColumnNumber,
-									location.endLineNumber,
-									location.endColumnNumber);
-							}
-						}
-					}
-				});
-			threads.push_back(thread);
+			if (!hasMoreLocations)
+			{
+				cursor->pendingFileLocations.pop_front();
+			}
 		}
 
-		for (std::shared_ptr<std::thread> thread: threads)
+		addCompleteFlagsToSourceLocationCollection(collection.get());
+
+		if (!onLocations(collection))
 		{
-			thread->join();
+			MessageStatus(L"Fulltext search interrupted: " + searchTerm, false, false).dispatch();
+			cursor->clear();
+			return false;
 		}
 	}
 
-	addCompleteFlagsToSourceLocationCollection(collection.get());
-
 	MessageStatus(
-		std::to_wstring(collection->getSourceLocationCount()) + L" results in " +
-			std::to_wstring(collection->getSourceLocationFileCount()) +
+		std::to_wstring(cursor->locationCount) + (hasMoreLocations ? L"+" : L"") +
+			L" results in " + std::to_wstring(cursor->fileCount) +
 			L" files for fulltext search (case-" + (caseSensitive ? L"sensitive" : L"insensitive") +
 			L"): " + searchTerm,
 		false,
 		false)
 		.dispatch();
 
-	return collection;
+	if (!hasMoreLocations)
+	{
+		cursor->clear();
+	}
+	return hasMoreLocations;
 }
 
 std::vector<SearchMatch> PersistentStorage::getAutocompletionMatches(
-	const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const
+	const std::wstring& query,
+	NodeTypeSet acceptedNodeTypes,
+	SearchFilter filter,
+	bool acceptCommands) const
 {
 	TRACE();
 
@@ -721,17 +1090,29 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionMatches(
 			 .isEmpty())
 	{
 		matches = getAutocompletionSymbolMatches(
-			query, acceptedNodeTypes, maxResultsCount, maxBestScoredResultsLength);
+			query,
+			acceptedNodeTypes,
+			maxResultsCount,
+			maxBestScoredResultsLength,
+			SearchIndex::ELEMENT_SYMBOL | getRequiredElementFlags(filter));
 	}
 
-	if (acceptedNodeTypes.containsMatching([](const NodeType& type) { return type.isFile(); }))
+	// files have no language
+	if (acceptedNodeTypes.containsMatching([](const NodeType& type) { return type.isFile(); }) &&
+		filter.language == SearchFilter::LANGUAGE_ALL)
 	{
-		utility::append(matches, getAutocompletionFileMatches(query, maxResultsCount));
+		utility::append(
+			matches,
+			getAutocompletionFileMatches(
+				query,
+				maxResultsCount,
+				SearchIndex::ELEMENT_FILE | getRequiredElementFlags(filter)));
 	}
 
 	if (acceptCommands)
 	{
-		utility::append(matches, getAutocompletionCommandMatches(query, acceptedNodeTypes));
+		utility::append(
+			matches, getAutocompletionCommandMatches(query, acceptedNodeTypes, filter));
 	}
 
 	// Rescore search matches to check if better score is achieved with higher indices
@@ -802,11 +1183,39 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(
 	const std::wstring& query,
 	const NodeTypeSet& acceptedNodeTypes,
 	size_t maxResultsCount,
-	size_t maxBestScoredResultsLength) const
+	size_t maxBestScoredResultsLength,
+	SearchIndex::ElementFlags requiredElementFlags) const
 {
+	// continue from the matches of the last query while the query is typed
+	SearchIndex::SearchCursor cursor;
+	{
+		std::lock_guard<std::mutex> lock(m_symbolSearchCursorMutex);
+		cursor = std::move(m_symbolSearchCursor);
+		m_symbolSearchCursor.clear();
+	}
+
 	// search in indices
 	const std::vector<SearchResult> results = m_symbolIndex.search(
-		query, acceptedNodeTypes, maxResultsCount, maxBestScoredResultsLength);
+		query,
+		SearchIndex::Filter(acceptedNodeTypes, requiredElementFlags),
+		maxResultsCount,
+		maxBestScoredResultsLength,
+		&cursor);
+
+	{
+		std::lock_guard<std::mutex> lock(m_symbolSearchCursorMutex);
+		m_symbolSearchCursor = std::move(cursor);
+	}
+
+	if (m_symbolIndex.hasLostElements())
+	{
+		MessageStatus(
+			L"Symbols of the search index could not be read from its temporary file. Refresh the "
+			L"project to find all symbols again.",
+			true,
+			false)
+			.dispatch();
+	}
 
 	// fetch StorageNodes for node ids
 	std::map<Id, StorageNode> storageNodeMap;
@@ -891,11 +1300,16 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionSymbolMatches(
 }
 
 std::vector<SearchMatch> PersistentStorage::getAutocompletionFileMatches(
-	const std::wstring& query, size_t maxResultsCount) const
+	const std::wstring& query,
+	size_t maxResultsCount,
+	SearchIndex::ElementFlags requiredElementFlags) const
 {
 	const std::vector<SearchResult> results = m_fileIndex.search(
 		query,
-		NodeTypeSet::all().getWithMatchingKept([](const NodeType& type) { return type.isFile(); }),
+		SearchIndex::Filter(
+			NodeTypeSet::all().getWithMatchingKept(
+				[](const NodeType& type) { return type.isFile(); }),
+			requiredElementFlags),
 		maxResultsCount,
 		100);
 
@@ -937,7 +1351,7 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionFileMatches(
 }
 
 std::vector<SearchMatch> PersistentStorage::getAutocompletionCommandMatches(
-	const std::wstring& query, NodeTypeSet acceptedNodeTypes) const
+	const std::wstring& query, NodeTypeSet acceptedNodeTypes, SearchFilter filter) const
 {
 	// search in indices
 	const std::vector<SearchResult> results = m_commandIndex.search(query, NodeTypeSet::all(), 0);
@@ -957,15 +1371,37 @@ std::vector<SearchMatch> PersistentStorage::getAutocompletionCommandMatches(
 		match.searchType = SearchMatch::SEARCH_COMMAND;
 		match.typeName = L"command";
 
-		if (match.getCommandType() == SearchMatch::COMMAND_NODE_FILTER)
+		const SearchMatch::CommandType commandType = match.getCommandType();
+		if (commandType == SearchMatch::COMMAND_NODE_FILTER)
 		{
 			match.nodeType = NodeType(getNodeKindForReadableNodeKindString(match.name));
 			match.typeName = L"filter";
 		}
+		else if (match.isFilterCommand())
+		{
+			match.typeName = L"filter";
+		}
 
-		if (acceptedNodeTypes == NodeTypeSet::all() ||
-			(match.getCommandType() == SearchMatch::COMMAND_NODE_FILTER &&
-			 !(acceptedNodeTypes.contains(match.nodeType))))
+		// other commands are only offered while nothing is filtered
+		bool accepted = false;
+		switch (commandType)
+		{
+		case SearchMatch::COMMAND_NODE_FILTER:
+			accepted = acceptedNodeTypes == NodeTypeSet::all() ||
+				!acceptedNodeTypes.contains(match.nodeType);
+			break;
+		case SearchMatch::COMMAND_DEFINITION_FILTER:
+			accepted = filter.definition == SearchFilter::DEFINITION_ALL;
+			break;
+		case SearchMatch::COMMAND_LANGUAGE_FILTER:
+			accepted = filter.language == SearchFilter::LANGUAGE_ALL;
+			break;
+		default:
+			accepted = acceptedNodeTypes == NodeTypeSet::all() && filter.acceptsAll();
+			break;
+		}
+
+		if (accepted)
 		{
 			matches.push_back(match);
 		}
@@ -3266,59 +3702,135 @@ void PersistentStorage::buildSearchIndex()
 {
 	TRACE();
 
+	{
+		std::lock_guard<std::mutex> lock(m_symbolSearchCursorMutex);
+		m_symbolSearchCursor.clear();
+	}
+
+	m_symbolIndex.setElementMemoryBudget(getSearchIndexMemoryBudget());
+
 	const FilePath dbPath = getIndexDbFilePath();
 
-	m_sqliteIndexStorage.forEach<StorageNode>([&](StorageNode&& node) {
-		const NodeType type(intToNodeKind(node.type));
-		if (type.isFile())
-		{
-			bool indexed = getFileNodeIndexed(node.id);
-			if (!indexed)
-			{
-				return;
-			}
+	m_sqliteIndexStorage.forEach<StorageNode>(
+		[&](StorageNode&& node) { addNodeToSearchIndex(node, dbPath); });
 
-			auto it = m_fileNodePaths.find(node.id);
-			if (it != m_fileNodePaths.end())
-			{
-				FilePath filePath(it->second);
+	m_symbolIndex.finishSetup();
+	m_fileIndex.finishSetup();
+}
 
-				if (filePath.exists())
-				{
-					filePath.makeRelativeTo(dbPath);
-				}
+void PersistentStorage::updateSearchIndex(
+	SearchIndices previousSearchIndices, const std::set<Id>& changedNodeIds)
+{
+	TRACE();
 
-				m_fileIndex.addNode(node.id, filePath.wstr(), type);
-			}
+	{
+		std::lock_guard<std::mutex> lock(m_symbolSearchCursorMutex);
+		m_symbolSearchCursor.clear();
+	}
+
+	m_symbolIndex = std::move(previousSearchIndices.symbolIndex);
+	m_fileIndex = std::move(previousSearchIndices.fileIndex);
+
+	m_symbolIndex.setElementMemoryBudget(getSearchIndexMemoryBudget());
+
+	for (Id id: changedNodeIds)
+	{
+		m_symbolIndex.removeNode(id);
+		m_fileIndex.removeNode(id);
+	}
+
+	const FilePath dbPath = getIndexDbFilePath();
+
+	for (const StorageNode& node:
+		 m_sqliteIndexStorage.getAllByIds<StorageNode>(utility::toVector(changedNodeIds)))
+	{
+		addNodeToSearchIndex(node, dbPath);
+	}
+
+	if (m_symbolIndex.hasLostElements() || m_fileIndex.hasLostElements())
+	{
+		// the lost elements can't be updated, so the search index is built from scratch
+		LOG_WARNING("search index lost elements, building it again");
+		m_symbolIndex.clear();
+		m_fileIndex.clear();
+		buildSearchIndex();
+		return;
+	}
+
+	LOG_INFO(
+		"updated search index with " + std::to_string(changedNodeIds.size()) + " changed nodes");
+}
+
+void PersistentStorage::addNodeToSearchIndex(const StorageNode& node, const FilePath& dbPath)
+{
+	const NodeType type(intToNodeKind(node.type));
+	if (type.isFile())
+	{
+		bool indexed = getFileNodeIndexed(node.id);
+		if (!indexed)
+		{
+			return;
 		}
-		else
+
+		auto it = m_fileNodePaths.find(node.id);
+		if (it != m_fileNodePaths.end())
 		{
-			auto it = m_symbolDefinitionKinds.find(node.id);
-			const DefinitionKind defKind =
-				(it != m_symbolDefinitionKinds.end() ? it->second : DEFINITION_NONE);
-			if (defKind != DEFINITION_IMPLICIT)
+			FilePath filePath(it->second);
+
+			if (filePath.exists())
 			{
-				const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
+				filePath.makeRelativeTo(dbPath);
+			}
 
-				// we don't use the signature here, so elements with the same signature share the
-				// same node.
-				std::wstring name = nameHierarchy.getQualifiedName();
+			m_fileIndex.addNode(
+				node.id,
+				filePath.wstr(),
+				type,
+				SearchIndex::ELEMENT_FILE | SearchIndex::ELEMENT_DEFINED);
+		}
+	}
+	else
+	{
+		auto it = m_symbolDefinitionKinds.find(node.id);
+		const DefinitionKind defKind =
+			(it != m_symbolDefinitionKinds.end() ? it->second : DEFINITION_NONE);
+		if (defKind != DEFINITION_IMPLICIT)
+		{
+			const NameHierarchy nameHierarchy = NameHierarchy::deserialize(node.serializedName);
 
-				// replace template arguments with .. to avoid clutter in search results and have
-				// different template specializations share the same node.
-				if (defKind == DEFINITION_NONE &&
-					nameHierarchy.getDelimiter() == nameDelimiterTypeToString(NAME_DELIMITER_CXX))
-				{
-					name = utility::replaceBetween(name, L'<', L'>', L"..");
-				}
+			// we don't use the signature here, so elements with the same signature share the
+			// same node.
+			std::wstring name = nameHierarchy.getQualifiedName();
 
-				m_symbolIndex.addNode(node.id, std::move(name), type);
+			// replace template arguments with .. to avoid clutter in search results and have
+			// different template specializations share the same node.
+			if (defKind == DEFINITION_NONE &&
+				nameHierarchy.getDelimiter() == nameDelimiterTypeToString(NAME_DELIMITER_CXX))
+			{
+				name = utility::replaceBetween(name, L'<', L'>', L"..");
 			}
+
+			SearchIndex::ElementFlags flags = SearchIndex::ELEMENT_SYMBOL |
+				(defKind == DEFINITION_NONE ? SearchIndex::ELEMENT_NON_INDEXED
+											: SearchIndex::ELEMENT_DEFINED);
+			if (nameHierarchy.getDelimiter() == nameDelimiterTypeToString(NAME_DELIMITER_CXX))
+			{
+				flags |= SearchIndex::ELEMENT_LANGUAGE_CXX;
+			}
+			else if (nameHierarchy.getDelimiter() == nameDelimiterTypeToString(NAME_DELIMITER_JAVA))
+			{
+				flags |= SearchIndex::ELEMENT_LANGUAGE_JAVA;
+			}
+
+			m_symbolIndex.addNode(node.id, std::move(name), type, flags);
 		}
-	});
+	}
+}
 
-	m_symbolIndex.finishSetup();
-	m_fileIndex.finishSetup();
+void PersistentStorage::addChangedNodeIds(const std::vector<Id>& nodeIds)
+{
+	std::lock_guard<std::mutex> lock(m_changedNodeIdsMutex);
+	m_changedNodeIds.insert(nodeIds.begin(), nodeIds.end());
 }
 
 void PersistentStorage::buildFullTextSearchIndex() const
@@ -3329,18 +3841,38 @@ void PersistentStorage::buildFullTextSearchIndex() const
 
 	m_fullTextSearchCodec = codec.getName();
 
+	std::vector<StorageFile> indexedFiles;
+	std::vector<FullTextSearchFileInfo> indexedFileInfos;
+	for (const StorageFile& file: m_sqliteIndexStorage.getAll<StorageFile>())
+	{
+		if (file.indexed)
+		{
+			indexedFiles.push_back(file);
+			indexedFileInfos.emplace_back(file.id, file.modificationTime);
+		}
+	}
+
+	// the index file stays valid as long as the indexed files did not change
+	const FilePath indexFilePath = getFullTextSearchIndexFilePath(getIndexDbFilePath());
+	if (m_fullTextSearchIndex.loadFile(indexFilePath, m_fullTextSearchCodec) &&
+		m_fullTextSearchIndex.isUpToDate(indexedFileInfos))
+	{
+		return;
+	}
+
+	if (m_fullTextSearchIndex.updateFile(
+			indexFilePath, m_fullTextSearchCodec, indexedFileInfos, [this, &codec](Id fileId) {
+				return codec.decode(m_sqliteIndexStorage.getFileContentById(fileId)->getText());
+			}))
+	{
+		return;
+	}
+
+	// keep the index in memory if the index file cannot be written
 	m_fullTextSearchIndex.clear();
 
 	std::vector<std::shared_ptr<std::thread>> threads;
 	{
-		std::vector<StorageFile> indexedFiles;
-		for (const StorageFile& file: m_sqliteIndexStorage.getAll<StorageFile>())
-		{
-			if (file.indexed)
-			{
-				indexedFiles.push_back(file);
-			}
-		}
 		for (std::vector<StorageFile> part:
 			 utility::splitToEqualySizedParts(indexedFiles, utility::getIdealThreadCount()))
 		{
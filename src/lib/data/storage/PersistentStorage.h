@@ -2,6 +2,7 @@
 #define PERSISTENT_STORAGE_H
 
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "FullTextSearchIndex.h"
@@ -88,10 +89,39 @@ public:
 	std::set<FilePath> getIncompleteFiles() const;
 	bool getFilePathIndexed(const FilePath& path) const;
 
+	// Indexing checkpoints keep the source files of an indexing run that are not fully injected
+	// yet, so a later run can resume an interrupted one with just these files.
+	void setPendingSourceFiles(const std::set<FilePath>& filePaths);
+	std::set<FilePath> getPendingSourceFiles() const;
+
+	// counts the parts of source files that got injected, see IntermediateStorage
+	void addInjectedSourceFileChunkCounts(const std::map<FilePath, int>& chunkCounts);
+	// removes the source files that got injected with all their parts from the pending ones
+	void checkpointInjectedSourceFiles();
+
+	// Search indices that can be reused by a storage of a later state of the same database.
+	struct SearchIndices
+	{
+		SearchIndex symbolIndex;
+		SearchIndex fileIndex;
+	};
+
+	// ids of the nodes added, changed or removed through this storage, may contain other elements
+	std::set<Id> getChangedNodeIds() const;
+	SearchIndices releaseSearchIndices();
+
 	void buildCaches();
+	// Like buildCaches(), but instead of adding all nodes to the search indices, only the changed
+	// nodes are updated in the search indices of the previous state of the database.
+	void buildCaches(SearchIndices previousSearchIndices, const std::set<Id>& changedNodeIds);
 
 	void optimizeMemory();
 
+	// The fulltext search index is kept in a file next to the database and is memory mapped for
+	// searching. Updating it at the end of indexing only indexes files that changed.
+	static FilePath getFullTextSearchIndexFilePath(const FilePath& indexDbFilePath);
+	void updateFullTextSearchIndex();
+
 	// StorageAccess implementation
 	Id getNodeIdForFileNode(const FilePath& filePath) const override;
 	Id getNodeIdForNameHierarchy(const NameHierarchy& nameHierarchy) const override;
@@ -107,20 +137,35 @@ public:
 
 	StorageEdge getEdgeById(Id edgeId) const override;
 
-	std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const override;
+	bool getFullTextSearchLocations(
+		const std::wstring& searchTerm,
+		bool caseSensitive,
+		size_t maxLocationCount,
+		std::function<bool(std::shared_ptr<SourceLocationCollection>)> onLocations,
+		FullTextSearchCursor* cursor) const override;
+	bool continueFullTextSearch(
+		FullTextSearchCursor* cursor,
+		size_t maxLocationCount,
+		std::function<bool(std::shared_ptr<SourceLocationCollection>)> onLocations) const override;
 
 	std::vector<SearchMatch> getAutocompletionMatches(
-		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const override;
+		const std::wstring& query,
+		NodeTypeSet acceptedNodeTypes,
+		SearchFilter filter,
+		bool acceptCommands) const override;
+	// requiredElementFlags restricts the matches like the accepted node types, see SearchIndex
 	std::vector<SearchMatch> getAutocompletionSymbolMatches(
 		const std::wstring& query,
 		const NodeTypeSet& acceptedNodeTypes,
 		size_t maxResultsCount,
-		size_t maxBestScoredResultsLength) const;
+		size_t maxBestScoredResultsLength,
+		SearchIndex::ElementFlags requiredElementFlags = 0) const;
 	std::vector<SearchMatch> getAutocompletionFileMatches(
-		const std::wstring& query, size_t maxResultsCount) const;
+		const std::wstring& query,
+		size_t maxResultsCount,
+		SearchIndex::ElementFlags requiredElementFlags = SearchIndex::ELEMENT_FILE) const;
 	std::vector<SearchMatch> getAutocompletionCommandMatches(
-		const std::wstring& query, NodeTypeSet acceptedNodeTypes) const;
+		const std::wstring& query, NodeTypeSet acceptedNodeTypes, SearchFilter filter) const;
 	std::vector<SearchMatch> getSearchMatchesForTokenIds(const std::vector<Id>& elementIds) const override;
 
 	std::shared_ptr<Graph> getGraphForAll() const override;
@@ -255,10 +300,15 @@ private:
 
 	void buildFilePathMaps();
 	void buildSearchIndex();
+	void updateSearchIndex(SearchIndices previousSearchIndices, const std::set<Id>& changedNodeIds);
+	void addNodeToSearchIndex(const StorageNode& node, const FilePath& dbPath);
+	void addChangedNodeIds(const std::vector<Id>& nodeIds);
 	void buildFullTextSearchIndex() const;
 	void buildMemberEdgeIdOrderMap();
 	void buildHierarchyCache();
 
+	std::map<FilePath, int> m_injectedSourceFileChunkCounts;
+
 	bool m_preIndexingErrorCountSet = false;
 	size_t m_preIndexingErrorCount = 0;
 	size_t m_preInjectionErrorCount = 0;
@@ -267,6 +317,12 @@ private:
 	SearchIndex m_symbolIndex;
 	SearchIndex m_fileIndex;
 
+	mutable SearchIndex::SearchCursor m_symbolSearchCursor;
+	mutable std::mutex m_symbolSearchCursorMutex;
+
+	std::set<Id> m_changedNodeIds;
+	mutable std::mutex m_changedNodeIdsMutex;
+
 	mutable FullTextSearchIndex m_fullTextSearchIndex;
 	mutable std::string m_fullTextSearchCodec;
 	mutable std::mutex m_fullTextSearchMutex;
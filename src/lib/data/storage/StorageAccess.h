@@ -1,6 +1,7 @@
 #ifndef STORAGE_ACCESS_H
 #define STORAGE_ACCESS_H
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -15,6 +16,7 @@
 #include "LocationType.h"
 #include "Node.h"
 #include "NodeBookmark.h"
+#include "SearchFilter.h"
 #include "SearchMatch.h"
 #include "StorageEdge.h"
 #include "StorageStats.h"
@@ -29,6 +31,7 @@ class SourceLocationFile;
 class TextAccess;
 
 struct FileInfo;
+struct FullTextSearchCursor;
 
 class StorageAccess
 {
@@ -50,10 +53,26 @@ public:
 
 	virtual StorageEdge getEdgeById(Id edgeId) const = 0;
 
-	virtual std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const = 0;
+	// Passes the locations of the search term to onLocations in chunks while searching, files with
+	// more matches first. The search stops after maxLocationCount locations or when onLocations
+	// returns false. Returns whether there are more locations than the ones passed on, which are
+	// found by continuing with the cursor.
+	virtual bool getFullTextSearchLocations(
+		const std::wstring& searchTerm,
+		bool caseSensitive,
+		size_t maxLocationCount,
+		std::function<bool(std::shared_ptr<SourceLocationCollection>)> onLocations,
+		FullTextSearchCursor* cursor) const = 0;
+	// Passes up to maxLocationCount further locations of the search of the cursor to onLocations.
+	virtual bool continueFullTextSearch(
+		FullTextSearchCursor* cursor,
+		size_t maxLocationCount,
+		std::function<bool(std::shared_ptr<SourceLocationCollection>)> onLocations) const = 0;
 	virtual std::vector<SearchMatch> getAutocompletionMatches(
-		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const = 0;
+		const std::wstring& query,
+		NodeTypeSet acceptedNodeTypes,
+		SearchFilter filter,
+		bool acceptCommands) const = 0;
 	virtual std::vector<SearchMatch> getSearchMatchesForTokenIds(
 		const std::vector<Id>& tokenIds) const = 0;
 
@@ -164,16 +164,27 @@ DEF_GETTER_1(getNodeIdToParentFileMap, const std::vector<Id>&, NodeIdToParentFil
 
 DEF_GETTER_1(getNodeTypeForNodeWithId, Id, NodeType, NodeType(NODE_SYMBOL))
 DEF_GETTER_1(getEdgeById, Id, StorageEdge, StorageEdge())
-DEF_GETTER_2(
+DEF_GETTER_5(
 	getFullTextSearchLocations,
 	const std::wstring&,
 	bool,
-	std::shared_ptr<SourceLocationCollection>,
-	std::make_shared<SourceLocationCollection>())
+	size_t,
+	std::function<bool(std::shared_ptr<SourceLocationCollection>)>,
+	FullTextSearchCursor*,
+	bool,
+	false)
 DEF_GETTER_3(
+	continueFullTextSearch,
+	FullTextSearchCursor*,
+	size_t,
+	std::function<bool(std::shared_ptr<SourceLocationCollection>)>,
+	bool,
+	false)
+DEF_GETTER_4(
 	getAutocompletionMatches,
 	const std::wstring&,
 	NodeTypeSet,
+	SearchFilter,
 	bool,
 	std::vector<SearchMatch>,
 	std::vector<SearchMatch>())
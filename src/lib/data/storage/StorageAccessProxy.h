@@ -27,10 +27,21 @@ public:
 
 	StorageEdge getEdgeById(Id edgeId) const override;
 
-	std::shared_ptr<SourceLocationCollection> getFullTextSearchLocations(
-		const std::wstring& searchTerm, bool caseSensitive) const override;
+	bool getFullTextSearchLocations(
+		const std::wstring& searchTerm,
+		bool caseSensitive,
+		size_t maxLocationCount,
+		std::function<bool(std::shared_ptr<SourceLocationCollection>)> onLocations,
+		FullTextSearchCursor* cursor) const override;
+	bool continueFullTextSearch(
+		FullTextSearchCursor* cursor,
+		size_t maxLocationCount,
+		std::function<bool(std::shared_ptr<SourceLocationCollection>)> onLocations) const override;
 	std::vector<SearchMatch> getAutocompletionMatches(
-		const std::wstring& query, NodeTypeSet acceptedNodeTypes, bool acceptCommands) const override;
+		const std::wstring& query,
+		NodeTypeSet acceptedNodeTypes,
+		SearchFilter filter,
+		bool acceptCommands) const override;
 	std::vector<SearchMatch> getSearchMatchesForTokenIds(const std::vector<Id>& tokenIds) const override;
 
 	std::shared_ptr<Graph> getGraphForAll() const override;
@@ -30,17 +30,18 @@ void StorageProvider::insert(std::shared_ptr<IntermediateStorage> storage)
 	m_storages.insert(it, storage);
 }
 
-std::shared_ptr<IntermediateStorage> StorageProvider::consumeSecondLargestStorage()
+std::pair<std::shared_ptr<IntermediateStorage>, std::shared_ptr<IntermediateStorage>>
+	StorageProvider::consumeStoragesToMerge()
 {
-	std::shared_ptr<IntermediateStorage> ret;
+	std::pair<std::shared_ptr<IntermediateStorage>, std::shared_ptr<IntermediateStorage>> ret;
 	{
 		std::lock_guard<std::mutex> lock(m_storagesMutex);
-		if (m_storages.size() > 1)
+		if (m_storages.size() > 2)	  // largest storage won't be touched here
 		{
-			std::list<std::shared_ptr<IntermediateStorage>>::iterator it = m_storages.begin();
-			it++;
-			ret = *it;
-			m_storages.erase(it);
+			ret.second = m_storages.back();
+			m_storages.pop_back();
+			ret.first = m_storages.back();
+			m_storages.pop_back();
 		}
 	}
 	return ret;
@@ -5,6 +5,7 @@
 #include <list>
 #include <memory>
 #include <mutex>
+#include <utility>
 
 class StorageProvider
 {
@@ -15,8 +16,11 @@ public:
 
 	void insert(std::shared_ptr<IntermediateStorage> storage);
 
-	// returns empty shared_ptr if no storages available
-	std::shared_ptr<IntermediateStorage> consumeSecondLargestStorage();
+	// returns the two smallest storages or empty shared_ptrs if there are less than three storages.
+	// Merging these repeatedly pairs storages of similar size and forms a balanced merge tree,
+	// while the largest storage is left for injection.
+	std::pair<std::shared_ptr<IntermediateStorage>, std::shared_ptr<IntermediateStorage>>
+		consumeStoragesToMerge();
 
 	// returns empty shared_ptr if no storages available
 	std::shared_ptr<IntermediateStorage> consumeLargestStorage();
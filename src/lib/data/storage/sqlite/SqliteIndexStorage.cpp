@@ -842,6 +842,28 @@ StorageFile SqliteIndexStorage::getFileByPath(const std::wstring& filePath) cons
 	return doGetFirst<StorageFile>("WHERE file.path == '" + utility::encodeToUtf8(filePath) + "'");
 }
 
+std::vector<Id> SqliteIndexStorage::getElementIdsWithLocationInFiles(
+	const std::vector<Id>& fileIds) const
+{
+	CppSQLite3Query q = executeQuery(
+		"SELECT DISTINCT occurrence.element_id "
+		"FROM occurrence "
+		"INNER JOIN source_location ON ("
+		"	occurrence.source_location_id = source_location.id"
+		") "
+		"WHERE source_location.file_node_id IN (" +
+		utility::join(utility::toStrings(fileIds), ',') + ");");
+
+	std::vector<Id> elementIds;
+	while (!q.eof())
+	{
+		elementIds.push_back(q.getIntField(0, 0));
+		q.nextRow();
+	}
+
+	return elementIds;
+}
+
 std::vector<StorageFile> SqliteIndexStorage::getFilesByPaths(const std::vector<FilePath>& filePaths) const
 {
 	return doGetAll<StorageFile>(
@@ -912,6 +934,41 @@ void SqliteIndexStorage::setNodeType(int type, Id nodeId)
 		" WHERE id == " + std::to_string(nodeId) + ";");
 }
 
+void SqliteIndexStorage::setPendingSourceFiles(const std::set<FilePath>& filePaths)
+{
+	executeStatement("DELETE FROM pending_source_file;");
+
+	for (const FilePath& filePath: filePaths)
+	{
+		m_insertPendingSourceFileStmt.bind(1, utility::encodeToUtf8(filePath.wstr()).c_str());
+		executeStatement(m_insertPendingSourceFileStmt);
+	}
+}
+
+void SqliteIndexStorage::removePendingSourceFiles(const std::set<FilePath>& filePaths)
+{
+	for (const FilePath& filePath: filePaths)
+	{
+		m_removePendingSourceFileStmt.bind(1, utility::encodeToUtf8(filePath.wstr()).c_str());
+		executeStatement(m_removePendingSourceFileStmt);
+	}
+}
+
+std::set<FilePath> SqliteIndexStorage::getPendingSourceFiles() const
+{
+	CppSQLite3Query q = executeQuery("SELECT path FROM pending_source_file;");
+
+	std::set<FilePath> filePaths;
+
+	while (!q.eof())
+	{
+		filePaths.insert(FilePath(utility::decodeFromUtf8(q.getStringField(0, ""))));
+		q.nextRow();
+	}
+
+	return filePaths;
+}
+
 std::shared_ptr<SourceLocationFile> SqliteIndexStorage::getSourceLocationsForFile(
 	const FilePath& filePath, const std::string& query) const
 {
@@ -1214,6 +1271,7 @@ void SqliteIndexStorage::clearTables()
 {
 	try
 	{
+		m_database.execDML("DROP TABLE IF EXISTS main.pending_source_file;");
 		m_database.execDML("DROP TABLE IF EXISTS main.error;");
 		m_database.execDML("DROP TABLE IF EXISTS main.component_access;");
 		m_database.execDML("DROP TABLE IF EXISTS main.occurrence;");
@@ -1343,6 +1401,11 @@ void SqliteIndexStorage::setupTables()
 			"translation_unit TEXT, "
 			"PRIMARY KEY(id), "
 			"FOREIGN KEY(id) REFERENCES element(id) ON DELETE CASCADE);");
+
+		m_database.execDML(
+			"CREATE TABLE IF NOT EXISTS pending_source_file("
+			"path TEXT NOT NULL, "
+			"PRIMARY KEY(path));");
 	}
 	catch (CppSQLite3Exception& e)
 	{
@@ -1437,6 +1500,10 @@ void SqliteIndexStorage::setupPrecompiledStatements()
 		m_insertErrorStmt = m_database.compileStatement(
 			"INSERT INTO error(id, message, fatal, indexed, translation_unit) "
 			"VALUES(?, ?, ?, ?, ?);");
+		m_insertPendingSourceFileStmt = m_database.compileStatement(
+			"INSERT OR IGNORE INTO pending_source_file(path) VALUES(?);");
+		m_removePendingSourceFileStmt = m_database.compileStatement(
+			"DELETE FROM pending_source_file WHERE path == ?;");
 	}
 	catch (CppSQLite3Exception& e)
 	{
@@ -2,6 +2,7 @@
 #define SQLITE_INDEX_STORAGE_H
 
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -76,6 +77,7 @@ public:
 	void removeElementsWithoutOccurrences(const std::vector<Id>& elementIds);
 	void removeElementsWithLocationInFiles(
 		const std::vector<Id>& fileIds, std::function<void(int)> updateStatusCallback);
+	std::vector<Id> getElementIdsWithLocationInFiles(const std::vector<Id>& fileIds) const;
 
 	void removeAllErrors();
 
@@ -114,6 +116,11 @@ public:
 	void setFileCompleteIfNoError(Id fileId, const std::wstring& filePath, bool complete);
 	void setNodeType(int type, Id nodeId);
 
+	// source files of the current indexing run that are not fully injected yet
+	void setPendingSourceFiles(const std::set<FilePath>& filePaths);
+	void removePendingSourceFiles(const std::set<FilePath>& filePaths);
+	std::set<FilePath> getPendingSourceFiles() const;
+
 	std::shared_ptr<SourceLocationFile> getSourceLocationsForFile(
 		const FilePath& filePath, const std::string& query = "") const;
 	std::shared_ptr<SourceLocationFile> getSourceLocationsForLinesInFile(
@@ -366,6 +373,8 @@ private:
 	CppSQLite3Statement m_insertFileContentStmt;
 	CppSQLite3Statement m_checkErrorExistsStmt;
 	CppSQLite3Statement m_insertErrorStmt;
+	CppSQLite3Statement m_insertPendingSourceFileStmt;
+	CppSQLite3Statement m_removePendingSourceFileStmt;
 };
 
 template <>
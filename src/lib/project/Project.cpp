@@ -154,6 +154,8 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 				{
 					LOG_INFO("Discarding temporary indexing data on user's decision");
 					FileSystem::remove(tempDbPath);
+					FileSystem::remove(
+						PersistentStorage::getFullTextSearchIndexFilePath(tempDbPath));
 				}
 			}
 			else
@@ -162,6 +164,10 @@ void Project::load(std::shared_ptr<DialogView> dialogView)
 					"Switching to temporary indexing data because no other persistent data was "
 					"found");
 				FileSystem::rename(tempDbPath, dbPath);
+				FileSystem::remove(PersistentStorage::getFullTextSearchIndexFilePath(dbPath));
+				FileSystem::rename(
+					PersistentStorage::getFullTextSearchIndexFilePath(tempDbPath),
+					PersistentStorage::getFullTextSearchIndexFilePath(dbPath));
 			}
 		}
 	}
@@ -548,6 +554,14 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		// store the indexed data into the temp db but keep the current state to allow browsing
 		// while indexing
 		FileSystem::copyFile(indexDbFilePath, tempIndexDbFilePath);
+
+		// the fulltext search index of the files that do not change is kept as well
+		const FilePath tempFullTextSearchIndexFilePath =
+			PersistentStorage::getFullTextSearchIndexFilePath(tempIndexDbFilePath);
+		FileSystem::remove(tempFullTextSearchIndexFilePath);
+		FileSystem::copyFile(
+			PersistentStorage::getFullTextSearchIndexFilePath(indexDbFilePath),
+			tempFullTextSearchIndexFilePath);
 	}
 
 	std::shared_ptr<PersistentStorage> tempStorage = std::make_shared<PersistentStorage>(
@@ -566,6 +580,16 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 			info.mode == REFRESH_UPDATED_AND_INCOMPLETE_FILES));
 	}
 
+	// source files stay pending until they are injected, so an interrupted run can be resumed
+	std::weak_ptr<PersistentStorage> weakTempStorage = tempStorage;
+	taskSequential->addTask(std::make_shared<TaskLambda>(
+		[weakTempStorage, filesToIndex = info.filesToIndex]() {
+			if (std::shared_ptr<PersistentStorage> tempStorage = weakTempStorage.lock())
+			{
+				tempStorage->setPendingSourceFiles(filesToIndex);
+			}
+		}));
+
 	tempStorage->setProjectSettingsText(
 		TextAccess::createFromFile(getProjectSettingsFilePath())->getText());
 	tempStorage->updateVersion();
@@ -652,11 +676,20 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 
 		// add task for refilling the indexer command queue
 		taskParallelIndexing->addTask(std::make_shared<TaskFillIndexerCommandsQueue>(
-			m_appUUID, std::move(indexerCommandProvider), 20));
+			m_appUUID, std::move(indexerCommandProvider), adjustedIndexerThreadCount));
 
 		// add task for indexing
 		bool multiProcess = ApplicationSettings::getInstance()->getMultiProcessIndexingEnabled() &&
 			hasCxxSourceGroup();
+
+		// let a single indexer run all java indexing threads within one jvm
+		IndexerCommandType batchIndexerCommandType = INDEXER_COMMAND_UNKNOWN;
+#if BUILD_JAVA_LANGUAGE_PACKAGE
+		if (ApplicationSettings::getInstance()->getSharedJavaIndexerEnabled())
+		{
+			batchIndexerCommandType = INDEXER_COMMAND_JAVA;
+		}
+#endif	  // BUILD_JAVA_LANGUAGE_PACKAGE
 		taskParallelIndexing->addChildTasks(std::make_shared<TaskGroupSequence>()->addChildTasks(
 			// block until there are indexer commands to process
 			std::make_shared<TaskDecoratorRepeat>(
@@ -664,24 +697,43 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 				->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
 					"indexer_command_queue_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
 			std::make_shared<TaskBuildIndex>(
-				adjustedIndexerThreadCount, storageProvider, dialogView, m_appUUID, multiProcess)));
+				adjustedIndexerThreadCount,
+				storageProvider,
+				dialogView,
+				m_appUUID,
+				multiProcess,
+				std::max(0, ApplicationSettings::getInstance()->getIndexerMemoryLimitMb()),
+				batchIndexerCommandType)));
+
+		// add tasks for merging the intermediate storages, merging is a lot faster than indexing,
+		// so by default a quarter of the indexer threads keeps up with the indexers
+		int storageMergeThreadCount =
+			ApplicationSettings::getInstance()->getStorageMergeThreadCount();
+		if (storageMergeThreadCount <= 0)
+		{
+			storageMergeThreadCount = std::max(1, adjustedIndexerThreadCount / 4);
+		}
 
-		// add task for merging the intermediate storages
-		taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
-			// block until there are indexers running
-			std::make_shared<TaskDecoratorRepeat>(
-				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
-				->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
-					"indexer_threads_started", TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false)),
-			// merge until all indexers stopped and nothing left to merge
-			std::make_shared<TaskDecoratorRepeat>(
-				TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
-				->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
-					std::make_shared<TaskMergeStorages>(storageProvider),
-					std::make_shared<TaskReturnSuccessIf<bool>>(
-						"indexer_threads_stopped",
+		for (int i = 0; i < storageMergeThreadCount; i++)
+		{
+			taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
+				// block until there are indexers running
+				std::make_shared<TaskDecoratorRepeat>(
+					TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+					->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
+						"indexer_threads_started",
 						TaskReturnSuccessIf<bool>::CONDITION_EQUALS,
-						false)))));
+						false)),
+				// merge until all indexers stopped and nothing left to merge
+				std::make_shared<TaskDecoratorRepeat>(
+					TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 250)
+					->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
+						std::make_shared<TaskMergeStorages>(storageProvider),
+						std::make_shared<TaskReturnSuccessIf<bool>>(
+							"indexer_threads_stopped",
+							TaskReturnSuccessIf<bool>::CONDITION_EQUALS,
+							false)))));
+		}
 
 		// add task for injecting the intermediate storages into the persistent storage
 		taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
@@ -718,6 +770,11 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 		dialogView->hideUnknownProgressDialog();
 	}
 
+	// custom commands write to the database through storages of their own, so the changed nodes
+	// are not known to the temp storage
+	const bool updateSearchIndex = info.mode != REFRESH_ALL_FILES &&
+		customIndexerCommandProvider->empty();
+
 	if (!customIndexerCommandProvider->empty())
 	{
 		const int adjustedIndexerThreadCount = std::min<int>(
@@ -736,10 +793,20 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 	taskSequential->addTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
 		std::make_shared<TaskGroupSequence>()->addChildTasks(
 			std::make_shared<TaskFindKeyOnBlackboard>("keep_database"),
-			std::make_shared<TaskLambda>([dialogView, this]() {
-				Task::dispatch(TabId::app(), std::make_shared<TaskLambda>([dialogView, this]() {
-								   swapToTempStorage(dialogView);
-							   }));
+			std::make_shared<TaskLambda>([dialogView, weakTempStorage, updateSearchIndex, this]() {
+				std::shared_ptr<const std::set<Id>> changedNodeIds;
+				std::shared_ptr<PersistentStorage> tempStorage = weakTempStorage.lock();
+				if (updateSearchIndex && tempStorage)
+				{
+					changedNodeIds = std::make_shared<std::set<Id>>(
+						tempStorage->getChangedNodeIds());
+				}
+
+				Task::dispatch(
+					TabId::app(),
+					std::make_shared<TaskLambda>([dialogView, changedNodeIds, this]() {
+						swapToTempStorage(dialogView, changedNodeIds);
+					}));
 			})),
 		std::make_shared<TaskGroupSequence>()->addChildTasks(
 			std::make_shared<TaskFindKeyOnBlackboard>("discard_database"),
@@ -776,7 +843,8 @@ void Project::buildIndex(RefreshInfo info, std::shared_ptr<DialogView> dialogVie
 	MessageIndexingStarted().dispatch();
 }
 
-void Project::swapToTempStorage(std::shared_ptr<DialogView> dialogView)
+void Project::swapToTempStorage(
+	std::shared_ptr<DialogView> dialogView, std::shared_ptr<const std::set<Id>> changedNodeIds)
 {
 	LOG_INFO("Switching to temporary indexing data");
 
@@ -784,6 +852,14 @@ void Project::swapToTempStorage(std::shared_ptr<DialogView> dialogView)
 	const FilePath tempIndexDbFilePath = m_settings->getTempDBFilePath();
 	const FilePath bookmarkDbFilePath = m_settings->getBookmarkDBFilePath();
 
+	// the temp storage started as a copy of the current one, so its search indices can be updated
+	const bool updateSearchIndex = changedNodeIds && m_storage;
+	PersistentStorage::SearchIndices previousSearchIndices;
+	if (updateSearchIndex)
+	{
+		previousSearchIndices = m_storage->releaseSearchIndices();
+	}
+
 	m_storage.reset();
 
 	if (!swapToTempStorageFile(indexDbFilePath, tempIndexDbFilePath, dialogView))
@@ -798,7 +874,14 @@ void Project::swapToTempStorage(std::shared_ptr<DialogView> dialogView)
 	// std::shared_ptr<DialogView> dialogView =
 	// Application::getInstance()->getDialogView(DialogView::UseCase::INDEXING);
 	// dialogView->showUnknownProgressDialog(L"Finish Indexing", L"Building caches");
-	m_storage->buildCaches();
+	if (updateSearchIndex)
+	{
+		m_storage->buildCaches(std::move(previousSearchIndices), *changedNodeIds);
+	}
+	else
+	{
+		m_storage->buildCaches();
+	}
 	// dialogView->hideUnknownProgressDialog();
 
 	m_storageCache->setSubject(m_storage);
@@ -814,6 +897,11 @@ bool Project::swapToTempStorageFile(
 	{
 		FileSystem::remove(indexDbFilePath);
 		FileSystem::rename(tempIndexDbFilePath, indexDbFilePath);
+
+		FileSystem::remove(PersistentStorage::getFullTextSearchIndexFilePath(indexDbFilePath));
+		FileSystem::rename(
+			PersistentStorage::getFullTextSearchIndexFilePath(tempIndexDbFilePath),
+			PersistentStorage::getFullTextSearchIndexFilePath(indexDbFilePath));
 	}
 	catch (std::exception& /*e*/)
 	{
@@ -839,6 +927,7 @@ void Project::discardTempStorage()
 		LOG_INFO("Discarding temporary indexing data");
 		FileSystem::remove(tempIndexDbPath);
 	}
+	FileSystem::remove(PersistentStorage::getFullTextSearchIndexFilePath(tempIndexDbPath));
 }
 
 bool Project::hasCxxSourceGroup() const
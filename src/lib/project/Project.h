@@ -8,6 +8,7 @@
 
 #include "RefreshInfo.h"
 #include "SourceGroup.h"
+#include "types.h"
 
 struct FileInfo;
 class DialogView;
@@ -65,7 +66,11 @@ private:
 
 	Project(const Project&);
 
-	void swapToTempStorage(std::shared_ptr<DialogView> dialogView);
+	// changedNodeIds are the nodes changed in the temp storage, if only they need to be updated in
+	// the search index of the current storage
+	void swapToTempStorage(
+		std::shared_ptr<DialogView> dialogView,
+		std::shared_ptr<const std::set<Id>> changedNodeIds = nullptr);
 	bool swapToTempStorageFile(
 		const FilePath& indexDbFilePath,
 		const FilePath& tempIndexDbFilePath,
@@ -7,6 +7,7 @@
 #include "SourceGroup.h"
 #include "SourceGroupStatusType.h"
 #include "TextAccess.h"
+#include "logging.h"
 #include "utility.h"
 
 RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
@@ -80,6 +81,17 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 	// 2.2) Add files that are reference the changed files
 	utility::append(filesToClear, storage->getReferencing(changedFilePaths));
 
+	// 2.2.1) Add source files that an interrupted indexing run did not finish. Some of their
+	// chunks may already be stored, so they are cleared before they are indexed again.
+	const std::set<FilePath> pendingSourceFilePaths = storage->getPendingSourceFiles();
+	for (const FilePath& path: pendingSourceFilePaths)
+	{
+		if (unchangedIndexedFilePaths.erase(path) || unchangedNonindexedFilePaths.erase(path))
+		{
+			filesToClear.insert(path);
+		}
+	}
+
 	// 2.3) Handle files that are referenced by the files that will be cleared. These will be
 	// re-indexed on the fly. However, we do not
 	//		need to clear files that are also referenced by unchanged source files, because
@@ -127,6 +139,25 @@ RefreshInfo RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
 		}
 	}
 
+	// 3.1) Add source files that an interrupted indexing run did not finish
+	size_t resumedFileCount = 0;
+	for (const FilePath& path: pendingSourceFilePaths)
+	{
+		if (allSourceFilePathsFromSourcegroups.find(path) !=
+				allSourceFilePathsFromSourcegroups.end() &&
+			filesToIndex.insert(path).second)
+		{
+			resumedFileCount++;
+		}
+	}
+
+	if (resumedFileCount)
+	{
+		LOG_INFO(
+			"Resuming interrupted indexing with " + std::to_string(resumedFileCount) +
+			" pending source files");
+	}
+
 	// 4) Store and return this information
 	RefreshInfo info;
 	info.mode = REFRESH_UPDATED_FILES;
@@ -389,6 +389,56 @@ void ApplicationSettings::setMultiProcessIndexingEnabled(bool enabled)
 	setValue<bool>("indexing/multi_process_indexing", enabled);
 }
 
+int ApplicationSettings::getIndexerMemoryLimitMb() const
+{
+	return getValue<int>("indexing/indexer_memory_limit_mb", 0);
+}
+
+void ApplicationSettings::setIndexerMemoryLimitMb(int size)
+{
+	setValue<int>("indexing/indexer_memory_limit_mb", size);
+}
+
+int ApplicationSettings::getIndexerStorageChunkSizeMb() const
+{
+	return getValue<int>("indexing/indexer_storage_chunk_size_mb", 64);
+}
+
+void ApplicationSettings::setIndexerStorageChunkSizeMb(int size)
+{
+	setValue<int>("indexing/indexer_storage_chunk_size_mb", size);
+}
+
+int ApplicationSettings::getStorageMergeThreadCount() const
+{
+	return getValue<int>("indexing/storage_merge_thread_count", 0);
+}
+
+void ApplicationSettings::setStorageMergeThreadCount(int count)
+{
+	setValue<int>("indexing/storage_merge_thread_count", count);
+}
+
+int ApplicationSettings::getSearchIndexMemoryBudgetMb() const
+{
+	return getValue<int>("search/search_index_memory_budget_mb", 64);
+}
+
+void ApplicationSettings::setSearchIndexMemoryBudgetMb(int size)
+{
+	setValue<int>("search/search_index_memory_budget_mb", size);
+}
+
+bool ApplicationSettings::getSharedJavaIndexerEnabled() const
+{
+	return getValue<bool>("indexing/java/shared_java_indexer", false);
+}
+
+void ApplicationSettings::setSharedJavaIndexerEnabled(bool enabled)
+{
+	setValue<bool>("indexing/java/shared_java_indexer", enabled);
+}
+
 FilePath ApplicationSettings::getJavaPath() const
 {
 	return FilePath(getValue<std::wstring>("indexing/java/java_path", L""));
@@ -98,6 +98,21 @@ public:
 	bool getMultiProcessIndexingEnabled() const;
 	void setMultiProcessIndexingEnabled(bool enabled);
 
+	int getIndexerMemoryLimitMb() const;
+	void setIndexerMemoryLimitMb(int size);
+
+	int getIndexerStorageChunkSizeMb() const;
+	void setIndexerStorageChunkSizeMb(int size);
+
+	int getStorageMergeThreadCount() const;
+	void setStorageMergeThreadCount(int count);
+
+	int getSearchIndexMemoryBudgetMb() const;
+	void setSearchIndexMemoryBudgetMb(int size);
+
+	bool getSharedJavaIndexerEnabled() const;
+	void setSharedJavaIndexerEnabled(bool enabled);
+
 	FilePath getJavaPath() const;
 	void setJavaPath(const FilePath& path);
 
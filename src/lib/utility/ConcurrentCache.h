@@ -0,0 +1,71 @@
+#ifndef CONCURRENT_CACHE_H
+#define CONCURRENT_CACHE_H
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
+// Same as UnorderedCache but safe to use from multiple threads. Values are calculated outside of
+// the lock, so concurrent misses on the same key may calculate a value more than once.
+template <typename KeyType, typename ValType, typename Hasher = std::hash<KeyType>>
+class ConcurrentCache
+{
+public:
+	ConcurrentCache(std::function<ValType(const KeyType&)> calculator);
+	ValType getValue(const KeyType& key);
+
+	size_t getHitCount() const;
+	size_t getMissCount() const;
+
+private:
+	std::function<ValType(const KeyType&)> m_calculator;
+	std::unordered_map<KeyType, ValType, Hasher> m_map;
+	mutable std::mutex m_mutex;
+
+	size_t m_hitCount;
+	size_t m_missCount;
+};
+
+template <typename KeyType, typename ValType, typename Hasher>
+ConcurrentCache<KeyType, ValType, Hasher>::ConcurrentCache(
+	std::function<ValType(const KeyType&)> calculator)
+	: m_calculator(calculator), m_hitCount(0), m_missCount(0)
+{
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+ValType ConcurrentCache<KeyType, ValType, Hasher>::getValue(const KeyType& key)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto it = m_map.find(key);
+		if (it != m_map.end())
+		{
+			++m_hitCount;
+			return it->second;
+		}
+		++m_missCount;
+	}
+
+	ValType val = m_calculator(key);
+
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_map.emplace(key, val);
+	return val;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t ConcurrentCache<KeyType, ValType, Hasher>::getHitCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_hitCount;
+}
+
+template <typename KeyType, typename ValType, typename Hasher>
+size_t ConcurrentCache<KeyType, ValType, Hasher>::getMissCount() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_missCount;
+}
+
+#endif	  // CONCURRENT_CACHE_H
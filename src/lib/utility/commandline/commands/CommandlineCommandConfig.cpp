@@ -87,6 +87,19 @@ void CommandlineCommandConfig::setup()
 		"use-processes,p",
 		po::value<bool>(),
 		"Enable C/C++ Indexer threads to run in different processes. <true/false>")(
+		"indexer-memory-limit,M",
+		po::value<int>(),
+		"Set the memory limit of each indexer process in MB (0 disables the limit)")(
+		"indexer-storage-chunk-size",
+		po::value<int>(),
+		"Hand over the index of large files in chunks of this size in MB (0 disables chunks, not "
+		"used with an indexer memory limit)")(
+		"storage-merge-threads",
+		po::value<int>(),
+		"Set the number of threads merging indexed files before saving (0 means automatic)")(
+		"search-index-memory-budget",
+		po::value<int>(),
+		"Keep at most this many MB of symbol search elements in memory (0 keeps all of them)")(
 		"logging-enabled,l", po::value<bool>(), "Enable file/console logging <true/false>")(
 		"verbose-indexer-logging-enabled,L",
 		po::value<bool>(),
@@ -148,6 +161,10 @@ CommandlineCommand::ReturnStatus CommandlineCommandConfig::parse(std::vector<std
 		std::cout << "Sourcetrail Settings:\n"
 				  << "\n  indexer-threads: " << settings->getIndexerThreadCount()
 				  << "\n  use-processes: " << settings->getMultiProcessIndexingEnabled()
+				  << "\n  indexer-memory-limit: " << settings->getIndexerMemoryLimitMb()
+				  << "\n  indexer-storage-chunk-size: " << settings->getIndexerStorageChunkSizeMb()
+				  << "\n  storage-merge-threads: " << settings->getStorageMergeThreadCount()
+				  << "\n  search-index-memory-budget: " << settings->getSearchIndexMemoryBudgetMb()
 				  << "\n  logging-enabled: " << settings->getLoggingEnabled()
 				  << "\n  verbose-indexer-logging-enabled: "
 				  << settings->getVerboseIndexerLoggingEnabled()
@@ -169,6 +186,20 @@ CommandlineCommand::ReturnStatus CommandlineCommandConfig::parse(std::vector<std
 		vm);
 
 	parseAndSetValue(&ApplicationSettings::setIndexerThreadCount, "indexer-threads", settings, vm);
+	parseAndSetValue(
+		&ApplicationSettings::setIndexerMemoryLimitMb, "indexer-memory-limit", settings, vm);
+	parseAndSetValue(
+		&ApplicationSettings::setIndexerStorageChunkSizeMb,
+		"indexer-storage-chunk-size",
+		settings,
+		vm);
+	parseAndSetValue(
+		&ApplicationSettings::setStorageMergeThreadCount, "storage-merge-threads", settings, vm);
+	parseAndSetValue(
+		&ApplicationSettings::setSearchIndexMemoryBudgetMb,
+		"search-index-memory-budget",
+		settings,
+		vm);
 
 	parseAndSetValue(&ApplicationSettings::setMavenPath, "maven-path", settings, vm);
 	parseAndSetValue(&ApplicationSettings::setJavaPath, "jvm-path", settings, vm);
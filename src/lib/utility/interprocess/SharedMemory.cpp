@@ -1,5 +1,7 @@
 #include "SharedMemory.h"
 
+#include <algorithm>
+
 #include "SharedMemoryGarbageCollector.h"
 #include "logging.h"
 
@@ -124,6 +126,28 @@ void SharedMemory::deleteSharedMemory(const std::string& name)
 	boost::interprocess::named_mutex::remove((s_mutexNamePrefix + name).c_str());
 }
 
+size_t SharedMemory::getAllocationByteSize(size_t size)
+{
+	const size_t alignment = Allocator::memory_algorithm::Alignment;
+	const size_t payload = Allocator::memory_algorithm::PayloadPerAllocation;
+	const size_t minimumByteSize = 3 * alignment;
+
+	const size_t byteSize = (size + payload + alignment - 1) / alignment * alignment;
+	return std::max(byteSize, minimumByteSize);
+}
+
+size_t SharedMemory::getStringByteSize(size_t length)
+{
+	static const size_t internalCapacity = String(static_cast<Allocator*>(nullptr)).capacity();
+	if (length <= internalCapacity)
+	{
+		return 0;
+	}
+
+	// the string may allocate up to two alignment units more than needed for its characters
+	return getAllocationByteSize(length + 1 + 2 * Allocator::memory_algorithm::Alignment);
+}
+
 SharedMemory::SharedMemory(const std::string& name, size_t initialMemorySize, AccessMode mode)
 	: m_name(checkName(name)), m_mode(mode), m_initialMemorySize(initialMemorySize)
 {
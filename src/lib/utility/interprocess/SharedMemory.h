@@ -46,6 +46,17 @@ public:
 	static std::string checkSharedMemory(const std::string& name);
 	static void deleteSharedMemory(const std::string& name);
 
+	// Bytes taken from a segment by an allocation, including the allocator's bookkeeping
+	static size_t getAllocationByteSize(size_t size);
+	// Bytes taken from a segment by the buffer of a String, 0 if it fits the internal buffer
+	static size_t getStringByteSize(size_t length);
+
+	template <typename T>
+	static size_t getVectorByteSize(size_t count)
+	{
+		return count ? getAllocationByteSize(count * sizeof(T)) : 0;
+	}
+
 	SharedMemory(const std::string& name, size_t initialMemorySize, AccessMode mode);
 	~SharedMemory();
 
@@ -15,8 +15,14 @@ public:
 		return "MessageActivateFullTextSearch";
 	}
 
-	MessageActivateFullTextSearch(const std::wstring& searchTerm, bool caseSensitive = false)
-		: searchTerm(searchTerm), caseSensitive(caseSensitive)
+	// number of results shown at once, more results are shown on request
+	static const size_t MAX_LOCATION_COUNT_STEP = 1000;
+
+	MessageActivateFullTextSearch(
+		const std::wstring& searchTerm,
+		bool caseSensitive = false,
+		size_t maxLocationCount = MAX_LOCATION_COUNT_STEP)
+		: searchTerm(searchTerm), caseSensitive(caseSensitive), maxLocationCount(maxLocationCount)
 	{
 		setSchedulerId(TabId::currentTab());
 	}
@@ -36,6 +42,7 @@ public:
 
 	const std::wstring searchTerm;
 	bool caseSensitive;
+	size_t maxLocationCount;
 };
 
 #endif	  // MESSAGE_ACTIVATE_FULLTEXT_SEARCH_H
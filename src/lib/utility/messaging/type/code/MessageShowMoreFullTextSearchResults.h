@@ -0,0 +1,21 @@
+#ifndef MESSAGE_SHOW_MORE_FULLTEXT_SEARCH_RESULTS_H
+#define MESSAGE_SHOW_MORE_FULLTEXT_SEARCH_RESULTS_H
+
+#include "Message.h"
+#include "TabId.h"
+
+class MessageShowMoreFullTextSearchResults: public Message<MessageShowMoreFullTextSearchResults>
+{
+public:
+	static const std::string getStaticType()
+	{
+		return "MessageShowMoreFullTextSearchResults";
+	}
+
+	MessageShowMoreFullTextSearchResults()
+	{
+		setSchedulerId(TabId::currentTab());
+	}
+};
+
+#endif	  // MESSAGE_SHOW_MORE_FULLTEXT_SEARCH_RESULTS_H
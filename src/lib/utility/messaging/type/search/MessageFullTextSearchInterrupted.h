@@ -0,0 +1,25 @@
+#ifndef MESSAGE_FULLTEXT_SEARCH_INTERRUPTED_H
+#define MESSAGE_FULLTEXT_SEARCH_INTERRUPTED_H
+
+#include "Message.h"
+#include "TabId.h"
+
+// Stops a running fulltext search as soon as a new search is requested. It is not sent as task, so
+// it doesn't have to wait for the running search to finish.
+class MessageFullTextSearchInterrupted: public Message<MessageFullTextSearchInterrupted>
+{
+public:
+	static const std::string getStaticType()
+	{
+		return "MessageFullTextSearchInterrupted";
+	}
+
+	MessageFullTextSearchInterrupted()
+	{
+		setSchedulerId(TabId::currentTab());
+		setSendAsTask(false);
+		setIsLogged(false);
+	}
+};
+
+#endif	  // MESSAGE_FULLTEXT_SEARCH_INTERRUPTED_H
@@ -4,13 +4,17 @@
 #include "Message.h"
 #include "Node.h"
 #include "NodeTypeSet.h"
+#include "SearchFilter.h"
 #include "TabId.h"
 
 class MessageSearchAutocomplete: public Message<MessageSearchAutocomplete>
 {
 public:
-	MessageSearchAutocomplete(const std::wstring& query, NodeTypeSet acceptedNodeTypes)
-		: query(query), acceptedNodeTypes(acceptedNodeTypes)
+	MessageSearchAutocomplete(
+		const std::wstring& query,
+		NodeTypeSet acceptedNodeTypes,
+		SearchFilter filter = SearchFilter())
+		: query(query), acceptedNodeTypes(acceptedNodeTypes), filter(filter)
 	{
 		setSchedulerId(TabId::currentTab());
 	}
@@ -33,10 +37,21 @@ public:
 			os << std::to_wstring(nodeTypeIds[i]);
 		}
 		os << L"]";
+
+		for (const std::wstring& filterName:
+			 {SearchFilter::getDefinitionFilterName(filter.definition),
+			  SearchFilter::getLanguageFilterName(filter.language)})
+		{
+			if (!filterName.empty())
+			{
+				os << L" " << filterName;
+			}
+		}
 	}
 
 	const std::wstring query;
 	const NodeTypeSet acceptedNodeTypes;
+	const SearchFilter filter;
 };
 
 #endif	  // MESSAGE_SEARCH_AUTOCOMPLETE_H
@@ -0,0 +1,123 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+#include "utilityApp.h"
+
+std::shared_ptr<ThreadPool> ThreadPool::s_instance;
+
+std::shared_ptr<ThreadPool> ThreadPool::getInstance()
+{
+	static std::mutex instanceMutex;
+	std::lock_guard<std::mutex> lock(instanceMutex);
+	if (!s_instance)
+	{
+		s_instance = std::make_shared<ThreadPool>(
+			std::max(1, utility::getIdealThreadCount() - 1));
+	}
+	return s_instance;
+}
+
+ThreadPool::ThreadPool(size_t threadCount): m_stopped(false)
+{
+	for (size_t i = 0; i < threadCount; i++)
+	{
+		m_threads.emplace_back(&ThreadPool::run, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_stopped = true;
+	}
+	m_jobsCondition.notify_all();
+
+	for (std::thread& thread: m_threads)
+	{
+		thread.join();
+	}
+}
+
+size_t ThreadPool::getThreadCount() const
+{
+	return m_threads.size();
+}
+
+void ThreadPool::execute(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_jobsMutex);
+		m_jobs.push_back(job);
+	}
+	m_jobsCondition.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, std::function<void(size_t)> func)
+{
+	if (count == 0)
+	{
+		return;
+	}
+
+	struct State
+	{
+		std::function<void(size_t)> func;
+		size_t count;
+		std::atomic<size_t> nextIndex;
+		std::atomic<size_t> finishedCount;
+		std::mutex finishedMutex;
+		std::condition_variable finishedCondition;
+	};
+
+	std::shared_ptr<State> state = std::make_shared<State>();
+	state->func = func;
+	state->count = count;
+	state->nextIndex = 0;
+	state->finishedCount = 0;
+
+	// the state is kept alive by jobs that only start after all indices have been handed out
+	std::function<void()> work = [state]() {
+		size_t index = 0;
+		while ((index = state->nextIndex++) < state->count)
+		{
+			state->func(index);
+			if (++state->finishedCount == state->count)
+			{
+				std::lock_guard<std::mutex> lock(state->finishedMutex);
+				state->finishedCondition.notify_all();
+			}
+		}
+	};
+
+	for (size_t i = 0; i < std::min(m_threads.size(), count - 1); i++)
+	{
+		execute(work);
+	}
+
+	work();
+
+	std::unique_lock<std::mutex> lock(state->finishedMutex);
+	state->finishedCondition.wait(lock, [state]() { return state->finishedCount == state->count; });
+}
+
+void ThreadPool::run()
+{
+	while (true)
+	{
+		std::function<void()> job;
+		{
+			std::unique_lock<std::mutex> lock(m_jobsMutex);
+			m_jobsCondition.wait(lock, [this]() { return m_stopped || !m_jobs.empty(); });
+			if (m_stopped)
+			{
+				return;
+			}
+			job = m_jobs.front();
+			m_jobs.pop_front();
+		}
+		job();
+	}
+}
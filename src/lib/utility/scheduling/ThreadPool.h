@@ -0,0 +1,42 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool of worker threads that is shared by work that can be split into independent jobs. The
+// calling thread of parallelFor() takes part in processing, so parallelFor() may also be used from
+// within a job without blocking the pool.
+class ThreadPool
+{
+public:
+	static std::shared_ptr<ThreadPool> getInstance();
+
+	ThreadPool(size_t threadCount);
+	~ThreadPool();
+
+	size_t getThreadCount() const;
+
+	void execute(std::function<void()> job);
+
+	// Calls func for every index in [0, count) and returns when all calls have finished.
+	void parallelFor(size_t count, std::function<void(size_t)> func);
+
+private:
+	void run();
+
+	static std::shared_ptr<ThreadPool> s_instance;
+
+	std::vector<std::thread> m_threads;
+	std::deque<std::function<void()>> m_jobs;
+	std::mutex m_jobsMutex;
+	std::condition_variable m_jobsCondition;
+	bool m_stopped;
+};
+
+#endif	  // THREAD_POOL_H
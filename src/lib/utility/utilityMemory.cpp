@@ -0,0 +1,84 @@
+#include "utilityMemory.h"
+
+#ifdef _WIN32
+#	define PSAPI_VERSION 2
+#	include <windows.h>
+#	include <psapi.h>
+#elif defined(__APPLE__)
+#	include <mach/mach.h>
+#	include <sys/resource.h>
+#else
+#	include <algorithm>
+#	include <fstream>
+
+#	include <sys/resource.h>
+#	include <unistd.h>
+#endif
+
+size_t utility::getProcessMemoryUsage()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return counters.WorkingSetSize;
+	}
+	return 0;
+#elif defined(__APPLE__)
+	mach_task_basic_info info;
+	mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+	if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, (task_info_t)&info, &count) ==
+		KERN_SUCCESS)
+	{
+		return info.resident_size;
+	}
+	return 0;
+#else
+	// only anonymous memory is counted, resident pages of mapped files and shared memory, e.g. of
+	// the segments transferring intermediate storages, are shared with other processes
+	size_t totalPageCount = 0;
+	size_t residentPageCount = 0;
+	size_t sharedPageCount = 0;
+	std::ifstream statm("/proc/self/statm");
+	if (statm >> totalPageCount >> residentPageCount >> sharedPageCount)
+	{
+		return (residentPageCount - std::min(sharedPageCount, residentPageCount)) *
+			static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	}
+	return 0;
+#endif
+}
+
+bool utility::setProcessMemoryLimit(size_t byteSize)
+{
+#ifdef _WIN32
+	// a job object is the only way to limit the committed memory of a process on Windows
+	HANDLE job = CreateJobObject(nullptr, nullptr);
+	if (!job)
+	{
+		return false;
+	}
+
+	JOBOBJECT_EXTENDED_LIMIT_INFORMATION limitInfo = {};
+	limitInfo.BasicLimitInformation.LimitFlags = JOB_OBJECT_LIMIT_PROCESS_MEMORY;
+	limitInfo.ProcessMemoryLimit = byteSize;
+	return SetInformationJobObject(
+			   job, JobObjectExtendedLimitInformation, &limitInfo, sizeof(limitInfo)) &&
+		AssignProcessToJobObject(job, GetCurrentProcess());
+#else
+	// RLIMIT_DATA does not count address space that is only reserved, e.g. by the JVM, so it
+	// matches the actually allocated memory more closely than RLIMIT_AS.
+	rlimit limit;
+	if (getrlimit(RLIMIT_DATA, &limit) != 0)
+	{
+		return false;
+	}
+
+	limit.rlim_cur = static_cast<rlim_t>(byteSize);
+	if (limit.rlim_max != RLIM_INFINITY && limit.rlim_cur > limit.rlim_max)
+	{
+		limit.rlim_cur = limit.rlim_max;
+	}
+	return setrlimit(RLIMIT_DATA, &limit) == 0;
+#endif
+}
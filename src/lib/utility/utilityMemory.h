@@ -0,0 +1,17 @@
+#ifndef UTILITY_MEMORY_H
+#define UTILITY_MEMORY_H
+
+#include <cstddef>
+
+namespace utility
+{
+// Returns the number of bytes of physical memory currently used by this process or 0 if the
+// value cannot be determined on this platform. On Linux, resident pages of mapped files and
+// shared memory are not counted.
+size_t getProcessMemoryUsage();
+
+// Limits the memory this process is allowed to allocate. Allocations exceeding the limit fail.
+bool setProcessMemoryLimit(size_t byteSize);
+}	 // namespace utility
+
+#endif	  // UTILITY_MEMORY_H
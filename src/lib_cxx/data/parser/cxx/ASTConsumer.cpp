@@ -2,7 +2,6 @@
 
 #include "ApplicationSettings.h"
 #include "CxxAstVisitor.h"
-#include "CxxVerboseAstVisitor.h"
 
 ASTConsumer::ASTConsumer(
 	clang::ASTContext* context,
@@ -13,16 +12,13 @@ ASTConsumer::ASTConsumer(
 {
 	ApplicationSettings* appSettings = ApplicationSettings::getInstance().get();
 
-	if (appSettings->getLoggingEnabled() && appSettings->getVerboseIndexerLoggingEnabled())
-	{
-		m_visitor = std::make_shared<CxxVerboseAstVisitor>(
-			context, preprocessor, client, canonicalFilePathCache, indexerStateInfo);
-	}
-	else
-	{
-		m_visitor = std::make_shared<CxxAstVisitor>(
-			context, preprocessor, client, canonicalFilePathCache, indexerStateInfo);
-	}
+	m_visitor = std::make_shared<CxxAstVisitor>(
+		context,
+		preprocessor,
+		client,
+		canonicalFilePathCache,
+		indexerStateInfo,
+		appSettings->getLoggingEnabled() && appSettings->getVerboseIndexerLoggingEnabled());
 }
 
 void ASTConsumer::HandleTranslationUnit(clang::ASTContext& context)
@@ -9,6 +9,7 @@
 #include "IndexerStateInfo.h"
 #include "ParseLocation.h"
 #include "ParserClient.h"
+#include "TimeStamp.h"
 #include "logging.h"
 #include "utilityClang.h"
 #include "utilityString.h"
@@ -18,7 +19,8 @@ CxxAstVisitor::CxxAstVisitor(
 	clang::Preprocessor* preprocessor,
 	std::shared_ptr<ParserClient> client,
 	std::shared_ptr<CanonicalFilePathCache> canonicalFilePathCache,
-	std::shared_ptr<IndexerStateInfo> indexerStateInfo)
+	std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+	bool verboseLogging)
 	: m_astContext(astContext)
 	, m_preprocessor(preprocessor)
 	, m_client(client)
@@ -30,6 +32,7 @@ CxxAstVisitor::CxxAstVisitor(
 	, m_implicitCodeComponent(this)
 	, m_indexerComponent(this, astContext, client)
 	, m_braceRecorderComponent(this, astContext, client)
+	, m_verboseLoggerComponent(this, verboseLogging)
 {
 }
 
@@ -62,15 +65,28 @@ CanonicalFilePathCache* CxxAstVisitor::getCanonicalFilePathCache() const
 	return m_canonicalFilePathCache.get();
 }
 
+CxxNameCache* CxxAstVisitor::getNameCache()
+{
+	return &m_nameCache;
+}
+
 void CxxAstVisitor::indexDecl(clang::Decl* d)
 {
 	LOG_INFO("starting AST traversal");
+	const TimeStamp start = TimeStamp::now();
 	this->TraverseDecl(d);
+	LOG_INFO(
+		"finished AST traversal in " +
+		TimeStamp::secondsToString(TimeStamp::durationSeconds(start)));
+	LOG_INFO(
+		"context name cache hits: " + std::to_string(m_nameCache.getHitCount()) +
+		", misses: " + std::to_string(m_nameCache.getMissCount()));
 }
 
 bool CxxAstVisitor::shouldVisitTemplateInstantiations() const
 {
-	return true;
+	// template instantiations can make up most of the AST of heavily templated code
+	return !(m_indexerStateInfo && m_indexerStateInfo->lowMemoryMode);
 }
 
 bool CxxAstVisitor::shouldVisitImplicitCode() const
@@ -102,6 +118,7 @@ bool CxxAstVisitor::checkIgnoresTypeLoc(const clang::TypeLoc& tl) const
 		m_implicitCodeComponent.__METHOD_CALL__;                                                   \
 		m_indexerComponent.__METHOD_CALL__;                                                        \
 		m_braceRecorderComponent.__METHOD_CALL__;                                                  \
+		m_verboseLoggerComponent.__METHOD_CALL__;                                                  \
 	}
 
 #define DEF_TRAVERSE_CUSTOM_TYPE_PTR(__NAME_TYPE__, __PARAM_TYPE__, CODE_BEFORE, CODE_AFTER)       \
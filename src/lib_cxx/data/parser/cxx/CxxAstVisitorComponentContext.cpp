@@ -13,14 +13,14 @@ const clang::NamedDecl* CxxAstVisitorComponentContext::getTopmostContextDecl(con
 
 	for (auto it = m_contextStack.rbegin(); it != m_contextStack.rend(); it++)
 	{
-		if (*it)
+		if (it->isValid())
 		{
 			if (skipped < skip)
 			{
 				skipped++;
 				continue;
 			}
-			const clang::NamedDecl* decl = (*it)->getDecl();
+			const clang::NamedDecl* decl = it->getDecl();
 			if (decl)
 			{
 				return decl;
@@ -36,14 +36,14 @@ const CxxContext* CxxAstVisitorComponentContext::getContext(const size_t skip) c
 
 	for (auto it = m_contextStack.rbegin(); it != m_contextStack.rend(); it++)
 	{
-		if (*it)
+		if (it->isValid())
 		{
 			if (skipped < skip)
 			{
 				skipped++;
 				continue;
 			}
-			return it->get();
+			return &(*it);
 		}
 	}
 	return nullptr;
@@ -51,7 +51,7 @@ const CxxContext* CxxAstVisitorComponentContext::getContext(const size_t skip) c
 
 void CxxAstVisitorComponentContext::beginTraverseDecl(clang::Decl* d)
 {
-	std::shared_ptr<CxxContextDecl> context;
+	CxxContext context;
 
 	if (d && clang::isa<clang::NamedDecl>(d) &&
 		!clang::isa<clang::ParmVarDecl>(d) &&	 // no parameter
@@ -66,7 +66,7 @@ void CxxAstVisitorComponentContext::beginTraverseDecl(clang::Decl* d)
 	)
 	{
 		clang::NamedDecl* nd = clang::dyn_cast<clang::NamedDecl>(d);
-		context = std::make_shared<CxxContextDecl>(nd);
+		context = CxxContext(nd);
 	}
 
 	m_contextStack.push_back(context);
@@ -79,7 +79,7 @@ void CxxAstVisitorComponentContext::endTraverseDecl(clang::Decl* d)
 
 void CxxAstVisitorComponentContext::beginTraverseTypeLoc(const clang::TypeLoc& tl)
 {
-	std::shared_ptr<CxxContextType> context;
+	CxxContext context;
 	clang::TypeLoc::TypeLocClass tlcc = tl.getTypeLocClass();
 	if (!getAstVisitor()->checkIgnoresTypeLoc(tl))
 	{
@@ -96,7 +96,7 @@ void CxxAstVisitorComponentContext::beginTraverseTypeLoc(const clang::TypeLoc& t
 		}
 		if (recordContext)
 		{
-			context = std::make_shared<CxxContextType>(tl.getTypePtr());
+			context = CxxContext(tl.getTypePtr());
 		}
 	}
 
@@ -110,7 +110,7 @@ void CxxAstVisitorComponentContext::endTraverseTypeLoc(const clang::TypeLoc& tl)
 
 void CxxAstVisitorComponentContext::beginTraverseLambdaExpr(clang::LambdaExpr* s)
 {
-	m_contextStack.push_back(std::make_shared<CxxContextDecl>(s->getCallOperator()));
+	m_contextStack.emplace_back(s->getCallOperator());
 }
 
 void CxxAstVisitorComponentContext::endTraverseLambdaExpr(clang::LambdaExpr* s)
@@ -120,7 +120,7 @@ void CxxAstVisitorComponentContext::endTraverseLambdaExpr(clang::LambdaExpr* s)
 
 void CxxAstVisitorComponentContext::beginTraverseFunctionDecl(clang::FunctionDecl* d)
 {
-	m_templateArgumentContext.push_back(std::make_shared<CxxContextDecl>(d));
+	m_templateArgumentContext.emplace_back(d);
 }
 
 void CxxAstVisitorComponentContext::endTraverseFunctionDecl(clang::FunctionDecl* d)
@@ -131,7 +131,7 @@ void CxxAstVisitorComponentContext::endTraverseFunctionDecl(clang::FunctionDecl*
 void CxxAstVisitorComponentContext::beginTraverseClassTemplateSpecializationDecl(
 	clang::ClassTemplateSpecializationDecl* d)
 {
-	m_templateArgumentContext.push_back(std::make_shared<CxxContextDecl>(d));
+	m_templateArgumentContext.emplace_back(d);
 }
 
 void CxxAstVisitorComponentContext::endTraverseClassTemplateSpecializationDecl(
@@ -143,7 +143,7 @@ void CxxAstVisitorComponentContext::endTraverseClassTemplateSpecializationDecl(
 void CxxAstVisitorComponentContext::beginTraverseClassTemplatePartialSpecializationDecl(
 	clang::ClassTemplatePartialSpecializationDecl* d)
 {
-	m_templateArgumentContext.push_back(std::make_shared<CxxContextDecl>(d));
+	m_templateArgumentContext.emplace_back(d);
 }
 
 void CxxAstVisitorComponentContext::endTraverseClassTemplatePartialSpecializationDecl(
@@ -154,8 +154,8 @@ void CxxAstVisitorComponentContext::endTraverseClassTemplatePartialSpecializatio
 
 void CxxAstVisitorComponentContext::beginTraverseDeclRefExpr(clang::DeclRefExpr* s)
 {
-	m_templateArgumentContext.push_back(std::make_shared<CxxContextDecl>(
-		s->getDecl()));	   // e.g. used for recording usage of template arguments within function calls
+	m_templateArgumentContext.emplace_back(
+		s->getDecl());	  // e.g. used for recording usage of template arguments within function calls
 }
 
 void CxxAstVisitorComponentContext::endTraverseDeclRefExpr(clang::DeclRefExpr* s)
@@ -175,11 +175,11 @@ void CxxAstVisitorComponentContext::beginTraverseTemplateSpecializationTypeLoc(
 
 	if (recordContext)
 	{
-		m_templateArgumentContext.push_back(std::make_shared<CxxContextType>(loc.getTypePtr()));
+		m_templateArgumentContext.emplace_back(loc.getTypePtr());
 	}
 	else
 	{
-		m_templateArgumentContext.push_back(std::shared_ptr<CxxContextType>());
+		m_templateArgumentContext.emplace_back();
 	}
 }
 
@@ -192,7 +192,7 @@ void CxxAstVisitorComponentContext::endTraverseTemplateSpecializationTypeLoc(
 void CxxAstVisitorComponentContext::beginTraverseUnresolvedLookupExpr(
 	clang::UnresolvedLookupExpr* e)	   // TODO: do this for unresolved and dependent stuff
 {
-	m_templateArgumentContext.push_back(nullptr);
+	m_templateArgumentContext.emplace_back();
 }
 
 void CxxAstVisitorComponentContext::endTraverseUnresolvedLookupExpr(clang::UnresolvedLookupExpr* e)
@@ -203,7 +203,7 @@ void CxxAstVisitorComponentContext::endTraverseUnresolvedLookupExpr(clang::Unres
 void CxxAstVisitorComponentContext::beginTraverseTemplateArgumentLoc(
 	const clang::TemplateArgumentLoc& loc)
 {
-	std::shared_ptr<CxxContext> context;
+	CxxContext context;
 
 	if (!m_templateArgumentContext.empty())
 	{
@@ -1,6 +1,8 @@
 #ifndef CXX_AST_VISITOR_COMPONENT_CONTEXT_H
 #define CXX_AST_VISITOR_COMPONENT_CONTEXT_H
 
+#include <vector>
+
 #include "CxxAstVisitorComponent.h"
 #include "CxxContext.h"
 
@@ -48,8 +50,8 @@ public:
 	void endTraverseTemplateArgumentLoc(const clang::TemplateArgumentLoc& loc);
 
 private:
-	std::vector<std::shared_ptr<CxxContext>> m_contextStack;
-	std::vector<std::shared_ptr<CxxContext>> m_templateArgumentContext;
+	std::vector<CxxContext> m_contextStack;
+	std::vector<CxxContext> m_templateArgumentContext;
 };
 
 #endif	  // CXX_AST_VISITOR_COMPONENT_CONTEXT_H
@@ -976,17 +976,23 @@ ReferenceKind CxxAstVisitorComponentIndexer::consumeDeclRefContextKind()
 
 Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::NamedDecl* decl)
 {
-	auto it = m_declSymbolIds.find(decl);
+	// the name resolver always uses the first declaration, so all redeclarations share one entry
+	const clang::NamedDecl* firstDecl = utility::getFirstDecl(decl);
+
+	auto it = m_declSymbolIds.find(firstDecl);
 	if (it != m_declSymbolIds.end())
 	{
 		return it->second;
 	}
 
+	bool cacheSymbolId = true;
 	NameHierarchy symbolName(L"global", NAME_DELIMITER_UNKNOWN);
 	if (decl)
 	{
 		std::unique_ptr<CxxDeclName> declName =
-			CxxDeclNameResolver(getAstVisitor()->getCanonicalFilePathCache()).getName(decl);
+			CxxDeclNameResolver(
+				getAstVisitor()->getCanonicalFilePathCache(), getAstVisitor()->getNameCache())
+				.getName(decl);
 		if (declName)
 		{
 			symbolName = declName->toNameHierarchy();
@@ -1002,12 +1008,18 @@ Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::NamedDecl* de
 						getAstVisitor()->getCanonicalFilePathCache()->getDeclarationFilePath(decl).wstr(),
 					sig.getPrefix(),
 					sig.getPostfix()));
+
+				// the name depends on the file of this redeclaration
+				cacheSymbolId = false;
 			}
 		}
 	}
 
 	Id symbolId = m_client->recordSymbol(symbolName);
-	m_declSymbolIds.emplace(decl, symbolId);
+	if (cacheSymbolId)
+	{
+		m_declSymbolIds.emplace(firstDecl, symbolId);
+	}
 	return symbolId;
 }
 
@@ -1023,7 +1035,9 @@ Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(const clang::Type* type)
 	if (type)
 	{
 		std::unique_ptr<CxxTypeName> typeName =
-			CxxTypeNameResolver(getAstVisitor()->getCanonicalFilePathCache()).getName(type);
+			CxxTypeNameResolver(
+				getAstVisitor()->getCanonicalFilePathCache(), getAstVisitor()->getNameCache())
+				.getName(type);
 		if (typeName)
 		{
 			symbolName = typeName->toNameHierarchy();
@@ -1068,5 +1082,5 @@ Id CxxAstVisitorComponentIndexer::getOrCreateSymbolId(
 		}
 	}
 
-	return m_client->recordSymbol(fallback);	// TODO: cache result somehow
+	return m_client->recordSymbol(fallback);
 }
@@ -78,8 +78,8 @@ private:
 	clang::ASTContext* m_astContext;
 	std::shared_ptr<ParserClient> m_client;
 
-	std::map<const clang::NamedDecl*, Id> m_declSymbolIds;
-	std::map<const clang::Type*, Id> m_typeSymbolIds;
+	std::unordered_map<const clang::NamedDecl*, Id> m_declSymbolIds;
+	std::unordered_map<const clang::Type*, Id> m_typeSymbolIds;
 };
 
 #endif	  // CXX_AST_VISITOR_COMPONENT_INDEXER_H
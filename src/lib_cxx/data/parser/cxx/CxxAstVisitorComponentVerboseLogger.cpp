@@ -0,0 +1,94 @@
+#include "CxxAstVisitorComponentVerboseLogger.h"
+
+#include <sstream>
+
+#include <clang/Basic/SourceLocation.h>
+#include <clang/Basic/SourceManager.h>
+
+#include "CanonicalFilePathCache.h"
+#include "CxxAstVisitor.h"
+#include "ParseLocation.h"
+#include "logging.h"
+
+CxxAstVisitorComponentVerboseLogger::CxxAstVisitorComponentVerboseLogger(
+	CxxAstVisitor* astVisitor, bool enabled)
+	: CxxAstVisitorComponent(astVisitor), m_enabled(enabled), m_indentation(0)
+{
+}
+
+void CxxAstVisitorComponentVerboseLogger::logDecl(clang::Decl* d)
+{
+	if (!d)
+	{
+		return;
+	}
+
+	std::stringstream stream;
+	stream << getIndentString() << d->getDeclKindName() << "Decl";
+	if (clang::NamedDecl* namedDecl = clang::dyn_cast_or_null<clang::NamedDecl>(d))
+	{
+		stream << " [" << obfuscateName(namedDecl->getNameAsString()) << "]";
+	}
+
+	ParseLocation loc = getAstVisitor()->getParseLocation(d->getSourceRange());
+	stream << " <" << loc.startLineNumber << ":" << loc.startColumnNumber << ", "
+		   << loc.endLineNumber << ":" << loc.endColumnNumber << ">";
+
+	const clang::SourceManager& sm = d->getASTContext().getSourceManager();
+	FilePath currentFilePath = getAstVisitor()->getCanonicalFilePathCache()->getCanonicalFilePath(
+		sm.getFileID(d->getSourceRange().getBegin()), sm);
+	if (m_currentFilePath != currentFilePath)
+	{
+		m_currentFilePath = currentFilePath;
+		LOG_INFO_BARE(L"Indexer - Traversing \"" + currentFilePath.wstr() + L"\"");
+	}
+
+	LOG_INFO_STREAM_BARE(<< "Indexer - " << stream.str());
+}
+
+void CxxAstVisitorComponentVerboseLogger::logStmt(clang::Stmt* s)
+{
+	if (!s)
+	{
+		return;
+	}
+
+	ParseLocation loc = getAstVisitor()->getParseLocation(s->getSourceRange());
+	LOG_INFO_STREAM_BARE(
+		<< "Indexer - " << getIndentString() << s->getStmtClassName() << " <"
+		<< loc.startLineNumber << ":" << loc.startColumnNumber << ", " << loc.endLineNumber << ":"
+		<< loc.endColumnNumber << ">");
+}
+
+void CxxAstVisitorComponentVerboseLogger::logTypeLoc(const clang::TypeLoc& tl)
+{
+	if (tl.isNull())
+	{
+		return;
+	}
+
+	ParseLocation loc = getAstVisitor()->getParseLocation(tl.getSourceRange());
+	LOG_INFO_STREAM_BARE(
+		<< "Indexer - " << getIndentString() << typeLocClassToString(tl) << "TypeLoc <"
+		<< loc.startLineNumber << ":" << loc.startColumnNumber << ", " << loc.endLineNumber << ":"
+		<< loc.endColumnNumber << ">");
+}
+
+std::string CxxAstVisitorComponentVerboseLogger::getIndentString() const
+{
+	std::string indentString = "";
+	for (unsigned int i = 0; i < m_indentation; i++)
+	{
+		indentString += "| ";
+	}
+	return indentString;
+}
+
+std::string CxxAstVisitorComponentVerboseLogger::obfuscateName(const std::string& name) const
+{
+	if (name.length() <= 2)
+	{
+		return name;
+	}
+	return name.substr(0, 1) + ".." + name.substr(name.length() - 1);
+}
@@ -0,0 +1,99 @@
+#ifndef CXX_AST_VISITOR_COMPONENT_VERBOSE_LOGGER_H
+#define CXX_AST_VISITOR_COMPONENT_VERBOSE_LOGGER_H
+
+#include <string>
+
+#include <clang/AST/TypeLoc.h>
+
+#include "CxxAstVisitorComponent.h"
+#include "FilePath.h"
+
+// This CxxAstVisitorComponent is responsible for logging every traversed decl, stmt and type loc
+// with its location if verbose indexer logging is enabled.
+class CxxAstVisitorComponentVerboseLogger: public CxxAstVisitorComponent
+{
+public:
+	CxxAstVisitorComponentVerboseLogger(CxxAstVisitor* astVisitor, bool enabled);
+
+	void beginTraverseDecl(clang::Decl* d)
+	{
+		if (m_enabled)
+		{
+			logDecl(d);
+			m_indentation++;
+		}
+	}
+
+	void endTraverseDecl(clang::Decl* d)
+	{
+		if (m_enabled)
+		{
+			m_indentation--;
+		}
+	}
+
+	void beginTraverseStmt(clang::Stmt* s)
+	{
+		if (m_enabled)
+		{
+			logStmt(s);
+			m_indentation++;
+		}
+	}
+
+	void endTraverseStmt(clang::Stmt* s)
+	{
+		if (m_enabled)
+		{
+			m_indentation--;
+		}
+	}
+
+	void beginTraverseTypeLoc(const clang::TypeLoc& tl)
+	{
+		if (m_enabled)
+		{
+			logTypeLoc(tl);
+			m_indentation++;
+		}
+	}
+
+	void endTraverseTypeLoc(const clang::TypeLoc& tl)
+	{
+		if (m_enabled)
+		{
+			m_indentation--;
+		}
+	}
+
+private:
+	void logDecl(clang::Decl* d);
+	void logStmt(clang::Stmt* s);
+	void logTypeLoc(const clang::TypeLoc& tl);
+
+	std::string getIndentString() const;
+	std::string obfuscateName(const std::string& name) const;
+
+	std::string typeLocClassToString(clang::TypeLoc tl) const
+	{
+		switch (tl.getTypeLocClass())
+		{
+#define STRINGIFY(X) #X
+#define ABSTRACT_TYPE(Class, Base)
+#define TYPE(Class, Base)                                                                          \
+case clang::TypeLoc::Class:                                                                        \
+	return STRINGIFY(Class);
+#include <clang/AST/TypeLoc.h>
+		case clang::TypeLoc::TypeLocClass::Qualified:
+			return "Qualified";
+		default:
+			return "";
+		}
+	}
+
+	const bool m_enabled;
+	FilePath m_currentFilePath;
+	unsigned int m_indentation;
+};
+
+#endif	  // CXX_AST_VISITOR_COMPONENT_VERBOSE_LOGGER_H
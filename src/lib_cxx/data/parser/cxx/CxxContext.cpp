@@ -1,27 +1,25 @@
 #include "CxxContext.h"
 
-const clang::NamedDecl* CxxContext::getDecl() const
-{
-	return nullptr;
-}
+CxxContext::CxxContext(): m_decl(nullptr), m_type(nullptr), m_isValid(false) {}
 
-const clang::Type* CxxContext::getType() const
+CxxContext::CxxContext(const clang::NamedDecl* decl)
+	: m_decl(decl), m_type(nullptr), m_isValid(true)
 {
-	return nullptr;
 }
 
+CxxContext::CxxContext(const clang::Type* type): m_decl(nullptr), m_type(type), m_isValid(true) {}
 
-CxxContextDecl::CxxContextDecl(const clang::NamedDecl* decl): m_decl(decl) {}
+bool CxxContext::isValid() const
+{
+	return m_isValid;
+}
 
-const clang::NamedDecl* CxxContextDecl::getDecl() const
+const clang::NamedDecl* CxxContext::getDecl() const
 {
 	return m_decl;
 }
 
-
-CxxContextType::CxxContextType(const clang::Type* type): m_type(type) {}
-
-const clang::Type* CxxContextType::getType() const
+const clang::Type* CxxContext::getType() const
 {
 	return m_type;
 }
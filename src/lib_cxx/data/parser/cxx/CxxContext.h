@@ -3,34 +3,25 @@
 
 #include <clang/AST/Decl.h>
 
+// Lightweight value type describing the decl or type that acts as context of a traversed node.
+// Contexts are pushed and popped for nearly every node of the AST, so they are stored by value
+// instead of being allocated on the heap. A default constructed context marks "no context".
 class CxxContext
 {
 public:
-	virtual ~CxxContext() = default;
-	virtual const clang::NamedDecl* getDecl() const;
-	virtual const clang::Type* getType() const;
-};
+	CxxContext();
+	explicit CxxContext(const clang::NamedDecl* decl);
+	explicit CxxContext(const clang::Type* type);
 
+	bool isValid() const;
 
-class CxxContextDecl: public CxxContext
-{
-public:
-	CxxContextDecl(const clang::NamedDecl* decl);
-	const clang::NamedDecl* getDecl() const override;
+	const clang::NamedDecl* getDecl() const;
+	const clang::Type* getType() const;
 
 private:
 	const clang::NamedDecl* m_decl;
-};
-
-
-class CxxContextType: public CxxContext
-{
-public:
-	CxxContextType(const clang::Type* type);
-	const clang::Type* getType() const override;
-
-private:
 	const clang::Type* m_type;
+	bool m_isValid;
 };
 
 #endif	  // CXX_CONTEXT_H
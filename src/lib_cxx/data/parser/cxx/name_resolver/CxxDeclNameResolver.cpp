@@ -4,6 +4,7 @@
 
 #include "CanonicalFilePathCache.h"
 #include "CxxFunctionDeclName.h"
+#include "CxxNameCache.h"
 #include "CxxSpecifierNameResolver.h"
 #include "CxxStaticFunctionDeclName.h"
 #include "CxxTemplateArgumentNameResolver.h"
@@ -14,8 +15,9 @@
 #include "utilityClang.h"
 #include "utilityString.h"
 
-CxxDeclNameResolver::CxxDeclNameResolver(CanonicalFilePathCache* canonicalFilePathCache)
-	: CxxNameResolver(canonicalFilePathCache), m_currentDecl(nullptr)
+CxxDeclNameResolver::CxxDeclNameResolver(
+	CanonicalFilePathCache* canonicalFilePathCache, CxxNameCache* nameCache)
+	: CxxNameResolver(canonicalFilePathCache, nameCache), m_currentDecl(nullptr)
 {
 }
 
@@ -72,12 +74,20 @@ std::unique_ptr<CxxDeclName> CxxDeclNameResolver::getName(const clang::NamedDecl
 	return declName;
 }
 
-std::unique_ptr<CxxName> CxxDeclNameResolver::getContextName(const clang::DeclContext* declContext)
+std::shared_ptr<CxxName> CxxDeclNameResolver::getContextName(const clang::DeclContext* declContext)
 {
-	std::unique_ptr<CxxName> contextDeclName;
+	std::shared_ptr<CxxName> contextDeclName;
 
 	if (declContext && !ignoresContext(declContext))
 	{
+		// context names only depend on the ignored context decls, so they are only shared if there
+		// are none.
+		CxxNameCache* nameCache = getIgnoredContextDecls().empty() ? getNameCache() : nullptr;
+		if (nameCache && nameCache->getContextName(declContext, contextDeclName))
+		{
+			return contextDeclName;
+		}
+
 		if (const clang::NamedDecl* contextNamedDecl = clang::dyn_cast_or_null<clang::NamedDecl>(
 				declContext))
 		{
@@ -91,6 +101,11 @@ std::unique_ptr<CxxName> CxxDeclNameResolver::getContextName(const clang::DeclCo
 				contextDeclName = getContextName(declContext->getParent());
 			}
 		}
+
+		if (nameCache)
+		{
+			nameCache->addContextName(declContext, contextDeclName);
+		}
 	}
 	return contextDeclName;
 }
@@ -0,0 +1,35 @@
+#include "CxxNameCache.h"
+
+#include "CxxName.h"
+
+CxxNameCache::CxxNameCache(): m_hitCount(0), m_missCount(0) {}
+
+bool CxxNameCache::getContextName(
+	const clang::DeclContext* declContext, std::shared_ptr<CxxName>& name)
+{
+	auto it = m_contextNames.find(declContext);
+	if (it != m_contextNames.end())
+	{
+		++m_hitCount;
+		name = it->second;
+		return true;
+	}
+	++m_missCount;
+	return false;
+}
+
+void CxxNameCache::addContextName(
+	const clang::DeclContext* declContext, std::shared_ptr<CxxName> name)
+{
+	m_contextNames.emplace(declContext, std::move(name));
+}
+
+size_t CxxNameCache::getHitCount() const
+{
+	return m_hitCount;
+}
+
+size_t CxxNameCache::getMissCount() const
+{
+	return m_missCount;
+}
@@ -0,0 +1,32 @@
+#ifndef CXX_NAME_CACHE_H
+#define CXX_NAME_CACHE_H
+
+#include <memory>
+#include <unordered_map>
+
+#include <clang/AST/DeclBase.h>
+
+class CxxName;
+
+// Stores the names of decl contexts that have already been resolved while traversing a single
+// translation unit. Name resolution recursively rebuilds the names of all surrounding contexts for
+// every symbol, which is expensive for contexts with many template parameters.
+class CxxNameCache
+{
+public:
+	CxxNameCache();
+
+	bool getContextName(const clang::DeclContext* declContext, std::shared_ptr<CxxName>& name);
+	void addContextName(const clang::DeclContext* declContext, std::shared_ptr<CxxName> name);
+
+	size_t getHitCount() const;
+	size_t getMissCount() const;
+
+private:
+	std::unordered_map<const clang::DeclContext*, std::shared_ptr<CxxName>> m_contextNames;
+
+	size_t m_hitCount;
+	size_t m_missCount;
+};
+
+#endif	  // CXX_NAME_CACHE_H
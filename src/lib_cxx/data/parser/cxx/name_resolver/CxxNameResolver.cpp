@@ -1,12 +1,14 @@
 #include "CxxNameResolver.h"
 
-CxxNameResolver::CxxNameResolver(CanonicalFilePathCache* canonicalFilePathCache)
-	: m_canonicalFilePathCache(canonicalFilePathCache)
+CxxNameResolver::CxxNameResolver(
+	CanonicalFilePathCache* canonicalFilePathCache, CxxNameCache* nameCache)
+	: m_canonicalFilePathCache(canonicalFilePathCache), m_nameCache(nameCache)
 {
 }
 
 CxxNameResolver::CxxNameResolver(const CxxNameResolver* other)
 	: m_canonicalFilePathCache(other->getCanonicalFilePathCache())
+	, m_nameCache(other->getNameCache())
 	, m_ignoredContextDecls(other->getIgnoredContextDecls())
 {
 }
@@ -48,6 +50,11 @@ CanonicalFilePathCache* CxxNameResolver::getCanonicalFilePathCache() const
 	return m_canonicalFilePathCache;
 }
 
+CxxNameCache* CxxNameResolver::getNameCache() const
+{
+	return m_nameCache;
+}
+
 const std::vector<const clang::Decl*>& CxxNameResolver::getIgnoredContextDecls() const
 {
 	return m_ignoredContextDecls;
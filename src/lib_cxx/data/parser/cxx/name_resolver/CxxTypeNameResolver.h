@@ -7,7 +7,8 @@
 class CxxTypeNameResolver: public CxxNameResolver
 {
 public:
-	CxxTypeNameResolver(CanonicalFilePathCache* canonicalFilePathCache);
+	CxxTypeNameResolver(
+		CanonicalFilePathCache* canonicalFilePathCache, CxxNameCache* nameCache = nullptr);
 	CxxTypeNameResolver(const CxxNameResolver* other);
 
 	std::unique_ptr<CxxTypeName> getName(const clang::QualType& qualType);
@@ -1,15 +1,17 @@
 #include "SourceGroupCxxCdb.h"
 
-#include <clang/Tooling/JSONCompilationDatabase.h>
+#include <clang/Tooling/CompilationDatabase.h>
 #include <clang/Tooling/Tooling.h>
 
 #include "Application.h"
 #include "ApplicationSettings.h"
 #include "ClangInvocationInfo.h"
+#include "CompilationDatabaseLoader.h"
 #include "CxxCompilationDatabaseSingle.h"
 #include "CxxIndexerCommandProvider.h"
 #include "IndexerCommandCxx.h"
 #include "MessageStatus.h"
+#include "ProjectSettings.h"
 #include "SourceGroupSettingsCxxCdb.h"
 #include "TaskLambda.h"
 #include "logging.h"
@@ -48,31 +50,12 @@ std::set<FilePath> SourceGroupCxxCdb::filterToContainedFilePaths(const std::set<
 
 std::set<FilePath> SourceGroupCxxCdb::getAllSourceFilePaths() const
 {
-	return getAllSourceFilePaths(
-		utility::loadCDB(m_settings->getCompilationDatabasePathExpandedAndAbsolute()));
-}
-
-std::set<FilePath> SourceGroupCxxCdb::getAllSourceFilePaths(
-	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb) const
-{
-	std::set<FilePath> sourceFilePaths;
-
-	if (cdb)
+	std::shared_ptr<utility::CompilationDatabaseLoader> cdb = loadCompilationDatabase();
+	if (!cdb)
 	{
-		const std::vector<FilePathFilter> excludeFilters =
-			m_settings->getExcludeFiltersExpandedAndAbsolute();
-		for (const FilePath& path: IndexerCommandCxx::getSourceFilesFromCDB(
-				 cdb, m_settings->getCompilationDatabasePathExpandedAndAbsolute()))
-		{
-			bool excluded = FilePathFilter::areMatching(excludeFilters, path);
-			if (!excluded && path.exists())
-			{
-				sourceFilePaths.insert(path);
-			}
-		}
+		return std::set<FilePath>();
 	}
-
-	return sourceFilePaths;
+	return cdb->getSourceFilePaths(m_settings->getExcludeFiltersExpandedAndAbsolute());
 }
 
 std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProvider(
@@ -81,8 +64,7 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
 	std::shared_ptr<CxxIndexerCommandProvider> provider =
 		std::make_shared<CxxIndexerCommandProvider>();
 
-	const FilePath cdbPath = m_settings->getCompilationDatabasePathExpandedAndAbsolute();
-	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath);
+	std::shared_ptr<utility::CompilationDatabaseLoader> cdb = loadCompilationDatabase();
 	if (!cdb)
 	{
 		return provider;
@@ -97,30 +79,23 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
 		m_settings->getIndexedHeaderPathsExpandedAndAbsolute());
 	const std::set<FilePathFilter> excludeFilters = utility::toSet(
 		m_settings->getExcludeFiltersExpandedAndAbsolute());
-	const std::set<FilePath>& sourceFilePaths = getAllSourceFilePaths(cdb);
+	const std::set<FilePath> sourceFilePaths = cdb->getSourceFilePaths(
+		m_settings->getExcludeFiltersExpandedAndAbsolute());
 
-	for (const clang::tooling::CompileCommand& command: cdb->getAllCompileCommands())
+	for (const utility::CompilationDatabaseCommand& command: cdb->getCommands())
 	{
-		FilePath sourcePath = FilePath(utility::decodeFromUtf8(command.Filename)).makeCanonical();
-		if (!sourcePath.isAbsolute())
-		{
-			sourcePath = FilePath(utility::decodeFromUtf8(command.Directory + '/' + command.Filename))
-							 .makeCanonical();
-			if (!sourcePath.isAbsolute())
-			{
-				sourcePath = cdbPath.getParentDirectory().getConcatenated(sourcePath).makeCanonical();
-			}
-		}
+		const FilePath& sourcePath = command.sourceFilePath;
 
 		if (info.filesToIndex.find(sourcePath) != info.filesToIndex.end() &&
 			sourceFilePaths.find(sourcePath) != sourceFilePaths.end())
 		{
 			std::vector<std::wstring> cdbFlags = utility::convert<std::string, std::wstring>(
-				command.CommandLine, [](const std::string& s) { return utility::decodeFromUtf8(s); });
+				*command.commandLine,
+				[](const std::string& s) { return utility::decodeFromUtf8(s); });
 
 			utility::removeIncludePchFlag(cdbFlags);
 
-			if (command.CommandLine.size() != cdbFlags.size())
+			if (command.commandLine->size() != cdbFlags.size())
 			{
 				utility::append(cdbFlags, includePchFlags);
 			}
@@ -130,7 +105,7 @@ std::shared_ptr<IndexerCommandProvider> SourceGroupCxxCdb::getIndexerCommandProv
 				utility::concat(indexedHeaderPaths, {sourcePath}),
 				excludeFilters,
 				std::set<FilePathFilter>(),
-				FilePath(utility::decodeFromUtf8(command.Directory)),
+				FilePath(utility::decodeFromUtf8(command.directory)),
 				utility::concat(cdbFlags, compilerFlags)));
 		}
 	}
@@ -158,31 +133,19 @@ std::shared_ptr<Task> SourceGroupCxxCdb::getPreIndexTask(
 
 	if (m_settings->getUseCompilerFlags())
 	{
-		const FilePath cdbPath = m_settings->getCompilationDatabasePathExpandedAndAbsolute();
-		std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb = utility::loadCDB(cdbPath);
+		std::shared_ptr<utility::CompilationDatabaseLoader> cdb = loadCompilationDatabase();
 		if (cdb)
 		{
-			const std::set<FilePath> sourceFilePaths = getAllSourceFilePaths(cdb);
-			for (const clang::tooling::CompileCommand& command: cdb->getAllCompileCommands())
+			const std::set<FilePath> sourceFilePaths = cdb->getSourceFilePaths(
+				m_settings->getExcludeFiltersExpandedAndAbsolute());
+			for (const utility::CompilationDatabaseCommand& command: cdb->getCommands())
 			{
-				FilePath sourcePath =
-					FilePath(utility::decodeFromUtf8(command.Filename)).makeCanonical();
-				if (!sourcePath.isAbsolute())
-				{
-					sourcePath = FilePath(utility::decodeFromUtf8(
-											  command.Directory + '/' + command.Filename))
-									 .makeCanonical();
-					if (!sourcePath.isAbsolute())
-					{
-						sourcePath =
-							cdbPath.getParentDirectory().getConcatenated(sourcePath).makeCanonical();
-					}
-				}
+				const FilePath& sourcePath = command.sourceFilePath;
 
 				if (sourceFilePaths.find(sourcePath) != sourceFilePaths.end() &&
-					utility::containsIncludePchFlag(command.CommandLine))
+					utility::containsIncludePchFlag(*command.commandLine))
 				{
-					for (const std::string& arg: command.CommandLine)
+					for (const std::string& arg: *command.commandLine)
 					{
 						if ((!compilerFlags.empty() || utility::isPrefix<std::string>("-", arg)) &&
 							FilePath(arg).fileName() != sourcePath.fileName())
@@ -191,7 +154,8 @@ std::shared_ptr<Task> SourceGroupCxxCdb::getPreIndexTask(
 						}
 					}
 
-					CxxCompilationDatabaseSingle compilationDatabase(command);
+					CxxCompilationDatabaseSingle compilationDatabase(clang::tooling::CompileCommand(
+						command.directory, command.filename, *command.commandLine, ""));
 					ClangInvocationInfo info = ClangInvocationInfo::getClangInvocationString(
 						&compilationDatabase);
 
@@ -248,3 +212,27 @@ std::vector<std::wstring> SourceGroupCxxCdb::getBaseCompilerFlags() const
 
 	return compilerFlags;
 }
+
+std::shared_ptr<utility::CompilationDatabaseLoader> SourceGroupCxxCdb::loadCompilationDatabase() const
+{
+	std::shared_ptr<utility::CompilationDatabaseLoader> cdb =
+		std::make_shared<utility::CompilationDatabaseLoader>(
+			m_settings->getCompilationDatabasePathExpandedAndAbsolute(),
+			getCompilationDatabaseCacheFilePath());
+	if (!cdb->load())
+	{
+		return std::shared_ptr<utility::CompilationDatabaseLoader>();
+	}
+	return cdb;
+}
+
+FilePath SourceGroupCxxCdb::getCompilationDatabaseCacheFilePath() const
+{
+	// only cache for projects that have been saved, the cache is stored with their dependencies
+	if (!m_settings->getProjectSettings()->getProjectFilePath().exists())
+	{
+		return FilePath();
+	}
+	return m_settings->getSourceGroupDependenciesDirectoryPath().concatenate(
+		L"compile_commands.cache");
+}
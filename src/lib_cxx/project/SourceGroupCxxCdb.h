@@ -8,15 +8,12 @@
 #include "SourceGroup.h"
 
 class FilePath;
-namespace clang
-{
-namespace tooling
+class SourceGroupSettingsCxxCdb;
+
+namespace utility
 {
-class JSONCompilationDatabase;
+class CompilationDatabaseLoader;
 }
-}	 // namespace clang
-
-class SourceGroupSettingsCxxCdb;
 
 class SourceGroupCxxCdb: public SourceGroup
 {
@@ -26,8 +23,6 @@ public:
 	bool prepareIndexing() override;
 	std::set<FilePath> filterToContainedFilePaths(const std::set<FilePath>& filePaths) const override;
 	std::set<FilePath> getAllSourceFilePaths() const override;
-	std::set<FilePath> getAllSourceFilePaths(
-		std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb) const;
 	std::shared_ptr<IndexerCommandProvider> getIndexerCommandProvider(
 		const RefreshInfo& info) const override;
 	std::vector<std::shared_ptr<IndexerCommand>> getIndexerCommands(const RefreshInfo& info) const override;
@@ -39,6 +34,8 @@ private:
 	std::shared_ptr<SourceGroupSettings> getSourceGroupSettings() override;
 	std::shared_ptr<const SourceGroupSettings> getSourceGroupSettings() const override;
 	std::vector<std::wstring> getBaseCompilerFlags() const;
+	std::shared_ptr<utility::CompilationDatabaseLoader> loadCompilationDatabase() const;
+	FilePath getCompilationDatabaseCacheFilePath() const;
 
 	std::shared_ptr<SourceGroupSettingsCxxCdb> m_settings;
 };
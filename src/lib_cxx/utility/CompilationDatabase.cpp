@@ -2,9 +2,7 @@
 
 #include <set>
 
-#include <clang/Tooling/CompilationDatabase.h>
-#include <clang/Tooling/JSONCompilationDatabase.h>
-
+#include "CompilationDatabaseLoader.h"
 #include "FilePath.h"
 #include "logging.h"
 #include "utility.h"
@@ -39,22 +37,12 @@ std::vector<FilePath> utility::CompilationDatabase::getFrameworkHeaderPaths() co
 
 void utility::CompilationDatabase::init()
 {
-	std::string error;
-	std::shared_ptr<clang::tooling::JSONCompilationDatabase> cdb(
-		clang::tooling::JSONCompilationDatabase::loadFromFile(
-			utility::encodeToUtf8(m_filePath.wstr()),
-			error,
-			clang::tooling::JSONCommandLineSyntax::AutoDetect));
-
-	if (!cdb)
+	CompilationDatabaseLoader cdb(m_filePath);
+	if (!cdb.load())
 	{
-		LOG_ERROR(
-			L"Loading compilation database from file \"" + m_filePath.wstr() +
-			L"\" failed with error: " + utility::decodeFromUtf8(error));
 		return;
 	}
 
-	std::vector<clang::tooling::CompileCommand> commands = cdb->getAllCompileCommands();
 	std::set<FilePath> frameworkHeaders;
 	std::set<FilePath> systemHeaders;
 	std::set<FilePath> headers;
@@ -64,16 +52,24 @@ void utility::CompilationDatabase::init()
 		const std::wstring systemIncludeFlag = L"-isystem";
 		const std::wstring quoteFlag = L"-iquote";
 		const std::wstring includeFlag = L"-I";
-		for (clang::tooling::CompileCommand& command: commands)
+		std::set<std::pair<const std::vector<std::string>*, std::string>> processedCommands;
+		for (const CompilationDatabaseCommand& command: cdb.getCommands())
 		{
-			const std::wstring commandDirectory = utility::decodeFromUtf8(command.Directory);
-			for (size_t i = 0; i < command.CommandLine.size(); i++)
+			// commands with identical command lines provide identical include paths
+			if (!processedCommands.emplace(command.commandLine.get(), command.directory).second)
+			{
+				continue;
+			}
+
+			const std::vector<std::string>& commandLine = *command.commandLine;
+			const std::wstring commandDirectory = utility::decodeFromUtf8(command.directory);
+			for (size_t i = 0; i < commandLine.size(); i++)
 			{
-				std::wstring argument = utility::decodeFromUtf8(command.CommandLine[i]);
-				if (i + 1 < command.CommandLine.size() &&
-					!utility::isPrefix<std::string>("-", command.CommandLine[i + 1]))
+				std::wstring argument = utility::decodeFromUtf8(commandLine[i]);
+				if (i + 1 < commandLine.size() &&
+					!utility::isPrefix<std::string>("-", commandLine[i + 1]))
 				{
-					argument += utility::decodeFromUtf8(command.CommandLine[++i]);
+					argument += utility::decodeFromUtf8(commandLine[++i]);
 				}
 
 				if (utility::isPrefix(frameworkIncludeFlag, argument))
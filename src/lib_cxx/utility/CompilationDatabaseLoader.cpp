@@ -0,0 +1,933 @@
+#include "CompilationDatabaseLoader.h"
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/Triple.h>
+#include <llvm/Support/Allocator.h>
+#include <llvm/Support/CommandLine.h>
+#include <llvm/Support/Host.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/StringSaver.h>
+
+#include "FileSystem.h"
+#include "OrderedCache.h"
+#include "ThreadPool.h"
+#include "TimeStamp.h"
+#include "logging.h"
+#include "utility.h"
+#include "utilityApp.h"
+#include "utilityString.h"
+
+namespace
+{
+const char* const s_cacheFileMagic = "SRCTRLCDB";
+const unsigned int s_cacheFileVersion = 1;
+
+unsigned long long getContentHash(const std::string& content)
+{
+	unsigned long long hash = 14695981039346656037ull;
+	for (const char c: content)
+	{
+		hash ^= static_cast<unsigned char>(c);
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
+
+size_t getParallelPartCount(size_t count)
+{
+	return std::max<size_t>(1, std::min<size_t>(utility::getIdealThreadCount(), count / 64));
+}
+
+// Splits the range [0, count) into getParallelPartCount(count) consecutive parts and processes them
+// on the shared ThreadPool.
+void runInParallel(size_t count, std::function<void(size_t, size_t, size_t)> func)
+{
+	const size_t partCount = getParallelPartCount(count);
+	if (partCount == 1)
+	{
+		func(0, 0, count);
+		return;
+	}
+
+	const size_t partSize = (count + partCount - 1) / partCount;
+	ThreadPool::getInstance()->parallelFor(partCount, [&](size_t part) {
+		const size_t begin = std::min(part * partSize, count);
+		func(part, begin, std::min(begin + partSize, count));
+	});
+}
+
+void appendUtf8(unsigned int codePoint, std::string& out)
+{
+	if (codePoint < 0x80)
+	{
+		out += static_cast<char>(codePoint);
+	}
+	else if (codePoint < 0x800)
+	{
+		out += static_cast<char>(0xC0 | (codePoint >> 6));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else if (codePoint < 0x10000)
+	{
+		out += static_cast<char>(0xE0 | (codePoint >> 12));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+	else
+	{
+		out += static_cast<char>(0xF0 | (codePoint >> 18));
+		out += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+		out += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+		out += static_cast<char>(0x80 | (codePoint & 0x3F));
+	}
+}
+
+// Minimal reader for the subset of JSON used by compilation databases.
+class JsonObjectReader
+{
+public:
+	JsonObjectReader(const std::string& text, size_t begin, size_t end)
+		: m_text(text), m_pos(begin), m_end(end)
+	{
+	}
+
+	bool consume(char c)
+	{
+		skipWhitespace();
+		if (m_pos < m_end && m_text[m_pos] == c)
+		{
+			m_pos++;
+			return true;
+		}
+		return false;
+	}
+
+	bool peek(char c)
+	{
+		skipWhitespace();
+		return m_pos < m_end && m_text[m_pos] == c;
+	}
+
+	bool readString(std::string& out)
+	{
+		out.clear();
+		if (!consume('"'))
+		{
+			return false;
+		}
+
+		while (m_pos < m_end)
+		{
+			const char c = m_text[m_pos++];
+			if (c == '"')
+			{
+				return true;
+			}
+			if (c != '\\')
+			{
+				out += c;
+				continue;
+			}
+			if (m_pos >= m_end)
+			{
+				return false;
+			}
+
+			const char escaped = m_text[m_pos++];
+			switch (escaped)
+			{
+			case '"':
+			case '\\':
+			case '/':
+				out += escaped;
+				break;
+			case 'b':
+				out += '\b';
+				break;
+			case 'f':
+				out += '\f';
+				break;
+			case 'n':
+				out += '\n';
+				break;
+			case 'r':
+				out += '\r';
+				break;
+			case 't':
+				out += '\t';
+				break;
+			case 'u':
+			{
+				unsigned int codePoint = 0;
+				if (!readHex(codePoint))
+				{
+					return false;
+				}
+				if (codePoint >= 0xD800 && codePoint < 0xDC00 && m_pos + 1 < m_end &&
+					m_text[m_pos] == '\\' && m_text[m_pos + 1] == 'u')
+				{
+					m_pos += 2;
+					unsigned int lowSurrogate = 0;
+					if (!readHex(lowSurrogate))
+					{
+						return false;
+					}
+					codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+				}
+				appendUtf8(codePoint, out);
+				break;
+			}
+			default:
+				return false;
+			}
+		}
+		return false;
+	}
+
+	bool readStringArray(std::vector<std::string>& out)
+	{
+		out.clear();
+		if (!consume('['))
+		{
+			return false;
+		}
+		if (consume(']'))
+		{
+			return true;
+		}
+
+		do
+		{
+			std::string value;
+			if (!readString(value))
+			{
+				return false;
+			}
+			out.push_back(std::move(value));
+		} while (consume(','));
+
+		return consume(']');
+	}
+
+	bool skipValue()
+	{
+		skipWhitespace();
+		if (peek('"'))
+		{
+			std::string ignored;
+			return readString(ignored);
+		}
+
+		int depth = 0;
+		bool inString = false;
+		while (m_pos < m_end)
+		{
+			const char c = m_text[m_pos];
+			if (inString)
+			{
+				if (c == '\\')
+				{
+					m_pos++;
+				}
+				else if (c == '"')
+				{
+					inString = false;
+				}
+			}
+			else if (c == '"')
+			{
+				inString = true;
+			}
+			else if (c == '{' || c == '[')
+			{
+				depth++;
+			}
+			else if (c == '}' || c == ']')
+			{
+				if (depth == 0)
+				{
+					return true;
+				}
+				depth--;
+			}
+			else if (c == ',' && depth == 0)
+			{
+				return true;
+			}
+			m_pos++;
+		}
+		return depth == 0;
+	}
+
+private:
+	void skipWhitespace()
+	{
+		while (m_pos < m_end &&
+			   (m_text[m_pos] == ' ' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r' ||
+				m_text[m_pos] == '\t'))
+		{
+			m_pos++;
+		}
+	}
+
+	bool readHex(unsigned int& value)
+	{
+		if (m_pos + 4 > m_end)
+		{
+			return false;
+		}
+		for (size_t i = 0; i < 4; i++)
+		{
+			const char c = m_text[m_pos++];
+			value <<= 4;
+			if (c >= '0' && c <= '9')
+			{
+				value |= c - '0';
+			}
+			else if (c >= 'a' && c <= 'f')
+			{
+				value |= c - 'a' + 10;
+			}
+			else if (c >= 'A' && c <= 'F')
+			{
+				value |= c - 'A' + 10;
+			}
+			else
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	const std::string& m_text;
+	size_t m_pos;
+	const size_t m_end;
+};
+
+// Finds the byte ranges of all objects within the top level array in a single pass.
+bool findObjectRanges(
+	const std::string& content, std::vector<std::pair<size_t, size_t>>& ranges, std::string& error)
+{
+	size_t pos = content.find_first_not_of(" \t\r\n");
+	if (pos == std::string::npos || content[pos] != '[')
+	{
+		error = "Expected array at top level of compilation database.";
+		return false;
+	}
+
+	int depth = 0;
+	bool inString = false;
+	size_t objectBegin = 0;
+	for (; pos < content.size(); pos++)
+	{
+		const char c = content[pos];
+		if (inString)
+		{
+			if (c == '\\')
+			{
+				pos++;
+			}
+			else if (c == '"')
+			{
+				inString = false;
+			}
+			continue;
+		}
+
+		switch (c)
+		{
+		case '"':
+			inString = true;
+			break;
+		case '{':
+			if (depth == 1)
+			{
+				objectBegin = pos;
+			}
+			depth++;
+			break;
+		case '[':
+			depth++;
+			break;
+		case '}':
+			depth--;
+			if (depth == 1)
+			{
+				ranges.emplace_back(objectBegin, pos + 1);
+			}
+			break;
+		case ']':
+			depth--;
+			if (depth == 0)
+			{
+				return true;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	error = "Unexpected end of compilation database.";
+	return false;
+}
+
+bool useWindowsCommandLineSyntax()
+{
+	// same as clang::tooling::JSONCommandLineSyntax::AutoDetect
+	return llvm::Triple(llvm::sys::getProcessTriple()).getEnvironment() ==
+		llvm::Triple::EnvironmentType::MSVC;
+}
+
+std::vector<std::string> tokenizeCommand(const std::string& command, bool windowsSyntax)
+{
+	llvm::BumpPtrAllocator allocator;
+	llvm::StringSaver saver(allocator);
+	llvm::SmallVector<const char*, 64> tokens;
+
+	if (windowsSyntax)
+	{
+		llvm::cl::TokenizeWindowsCommandLine(command, saver, tokens);
+	}
+	else
+	{
+		llvm::cl::TokenizeGNUCommandLine(command, saver, tokens);
+	}
+
+	return std::vector<std::string>(tokens.begin(), tokens.end());
+}
+
+// Strips wrappers like ccache or distcc from the front of the command line, just like the JSON
+// compilation database of clang does.
+void unwrapCommand(std::vector<std::string>& commandLine)
+{
+	while (commandLine.size() >= 2)
+	{
+		const std::string wrapper = llvm::sys::path::stem(commandLine.front()).str();
+		if (wrapper != "distcc" && wrapper != "gomacc" && wrapper != "ccache" &&
+			wrapper != "sccache")
+		{
+			return;
+		}
+
+		const std::string& compiler = commandLine[1];
+		if (compiler.empty() || compiler[0] == '-' || llvm::sys::path::has_extension(compiler))
+		{
+			return;
+		}
+		commandLine.erase(commandLine.begin());
+	}
+}
+
+void writeSize(std::ostream& stream, size_t value)
+{
+	const unsigned long long v = value;
+	stream.write(reinterpret_cast<const char*>(&v), sizeof(v));
+}
+
+bool readSize(std::istream& stream, size_t& value)
+{
+	unsigned long long v = 0;
+	if (!stream.read(reinterpret_cast<char*>(&v), sizeof(v)))
+	{
+		return false;
+	}
+	value = static_cast<size_t>(v);
+	return true;
+}
+
+void writeString(std::ostream& stream, const std::string& value)
+{
+	writeSize(stream, value.size());
+	stream.write(value.data(), value.size());
+}
+
+// Reads a count of items that take at least minItemByteSize bytes each. Counts that don't fit into
+// the rest of the file are rejected, so a damaged cache doesn't allocate huge vectors or strings.
+bool readCount(
+	std::istream& stream, unsigned long long fileByteSize, size_t minItemByteSize, size_t& count)
+{
+	if (!readSize(stream, count))
+	{
+		return false;
+	}
+
+	const std::streamoff position = stream.tellg();
+	if (position < 0 || static_cast<unsigned long long>(position) > fileByteSize)
+	{
+		return false;
+	}
+	return count <= (fileByteSize - static_cast<unsigned long long>(position)) / minItemByteSize;
+}
+
+bool readString(std::istream& stream, unsigned long long fileByteSize, std::string& value)
+{
+	size_t size = 0;
+	if (!readCount(stream, fileByteSize, 1, size))
+	{
+		return false;
+	}
+	value.resize(size);
+	return size == 0 || static_cast<bool>(stream.read(&value[0], size));
+}
+}	 // namespace
+
+namespace utility
+{
+CompilationDatabaseLoader::CompilationDatabaseLoader(
+	const FilePath& cdbPath, const FilePath& cacheFilePath)
+	: m_cdbPath(cdbPath)
+	, m_cacheFilePath(cacheFilePath)
+	, m_loadedFromCache(false)
+	, m_droppedDuplicateCount(0)
+{
+}
+
+bool CompilationDatabaseLoader::load()
+{
+	m_commands.clear();
+	m_error.clear();
+	m_loadedFromCache = false;
+	m_droppedDuplicateCount = 0;
+
+	if (m_cdbPath.empty() || !m_cdbPath.exists())
+	{
+		m_error = "Compilation database \"" + m_cdbPath.str() + "\" does not exist.";
+		return false;
+	}
+
+	const TimeStamp start = TimeStamp::now();
+
+	std::string content;
+	{
+		std::ifstream stream(m_cdbPath.str(), std::ios::in | std::ios::binary);
+		if (!stream)
+		{
+			m_error = "Unable to open compilation database \"" + m_cdbPath.str() + "\".";
+			return false;
+		}
+		std::stringstream buffer;
+		buffer << stream.rdbuf();
+		content = buffer.str();
+	}
+
+	const unsigned long long contentHash = getContentHash(content);
+
+	if (!m_cacheFilePath.empty() && readCache(contentHash))
+	{
+		m_loadedFromCache = true;
+	}
+	else if (parse(content))
+	{
+		if (!m_cacheFilePath.empty())
+		{
+			writeCache(contentHash);
+		}
+	}
+	else
+	{
+		LOG_ERROR(
+			L"Loading compilation database from file \"" + m_cdbPath.wstr() +
+			L"\" failed with error: " + utility::decodeFromUtf8(m_error));
+		m_commands.clear();
+		return false;
+	}
+
+	resolveSourceFilePaths();
+
+	LOG_INFO(
+		"Loaded " + std::to_string(m_commands.size()) + " compile commands" +
+		(m_loadedFromCache ? " from cache" : "") + " in " +
+		TimeStamp::secondsToString(TimeStamp::durationSeconds(start)) + ", dropped " +
+		std::to_string(m_droppedDuplicateCount) + " duplicates");
+
+	return true;
+}
+
+const std::vector<CompilationDatabaseCommand>& CompilationDatabaseLoader::getCommands() const
+{
+	return m_commands;
+}
+
+std::set<FilePath> CompilationDatabaseLoader::getSourceFilePaths(
+	const std::vector<FilePathFilter>& excludeFilters) const
+{
+	std::set<FilePath> sourceFilePaths;
+	std::mutex sourceFilePathsMutex;
+
+	runInParallel(m_commands.size(), [&](size_t part, size_t begin, size_t end) {
+		OrderedCache<FilePath, FilePath> canonicalDirectoryPathCache(
+			[](const FilePath& path) { return path.getCanonical(); });
+
+		std::vector<FilePath> paths;
+		for (size_t i = begin; i < end; i++)
+		{
+			const FilePath& sourceFilePath = m_commands[i].sourceFilePath;
+			FilePath path =
+				canonicalDirectoryPathCache.getValue(sourceFilePath.getParentDirectory())
+					.concatenate(sourceFilePath.fileName());
+			if (!FilePathFilter::areMatching(excludeFilters, path) && path.exists())
+			{
+				paths.push_back(path);
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(sourceFilePathsMutex);
+		sourceFilePaths.insert(paths.begin(), paths.end());
+	});
+
+	return sourceFilePaths;
+}
+
+const std::string& CompilationDatabaseLoader::getError() const
+{
+	return m_error;
+}
+
+bool CompilationDatabaseLoader::isLoadedFromCache() const
+{
+	return m_loadedFromCache;
+}
+
+size_t CompilationDatabaseLoader::getDroppedDuplicateCount() const
+{
+	return m_droppedDuplicateCount;
+}
+
+bool CompilationDatabaseLoader::parse(const std::string& content)
+{
+	std::vector<std::pair<size_t, size_t>> objectRanges;
+	if (!findObjectRanges(content, objectRanges, m_error))
+	{
+		return false;
+	}
+
+	const size_t partCount = getParallelPartCount(objectRanges.size());
+	std::vector<std::vector<ParsedCommand>> parsedParts(partCount);
+	std::vector<std::string> errors(partCount);
+
+	runInParallel(objectRanges.size(), [&](size_t part, size_t begin, size_t end) {
+		parseCommands(
+			content,
+			std::vector<std::pair<size_t, size_t>>(
+				objectRanges.begin() + begin, objectRanges.begin() + end),
+			parsedParts[part],
+			errors[part]);
+	});
+
+	for (const std::string& error: errors)
+	{
+		if (!error.empty())
+		{
+			m_error = error;
+			return false;
+		}
+	}
+
+	addCommands(parsedParts);
+	return true;
+}
+
+bool CompilationDatabaseLoader::parseCommands(
+	const std::string& content,
+	const std::vector<std::pair<size_t, size_t>>& objectRanges,
+	std::vector<ParsedCommand>& commands,
+	std::string& error) const
+{
+	const bool windowsSyntax = useWindowsCommandLineSyntax();
+
+	commands.reserve(objectRanges.size());
+	for (const std::pair<size_t, size_t>& range: objectRanges)
+	{
+		JsonObjectReader reader(content, range.first, range.second);
+
+		ParsedCommand command;
+		std::string commandString;
+		bool hasDirectory = false;
+		bool hasFile = false;
+		bool hasCommand = false;
+		bool hasArguments = false;
+
+		bool valid = reader.consume('{');
+		if (valid && !reader.consume('}'))
+		{
+			do
+			{
+				std::string key;
+				valid = reader.readString(key) && reader.consume(':');
+				if (!valid)
+				{
+					break;
+				}
+
+				if (key == "directory")
+				{
+					valid = hasDirectory = reader.readString(command.directory);
+				}
+				else if (key == "file")
+				{
+					valid = hasFile = reader.readString(command.filename);
+				}
+				else if (key == "arguments")
+				{
+					valid = hasArguments = reader.readStringArray(command.commandLine);
+				}
+				else if (key == "command")
+				{
+					valid = hasCommand = reader.readString(commandString);
+				}
+				else
+				{
+					valid = reader.skipValue();
+				}
+			} while (valid && reader.consume(','));
+
+			valid = valid && reader.consume('}');
+		}
+
+		if (!valid)
+		{
+			error = "Invalid compile command at offset " + std::to_string(range.first) + ".";
+			return false;
+		}
+		if (!hasDirectory)
+		{
+			error = "Missing key: \"directory\".";
+			return false;
+		}
+		if (!hasFile)
+		{
+			error = "Missing key: \"file\".";
+			return false;
+		}
+		if (!hasArguments && !hasCommand)
+		{
+			error = "Either \"command\" or \"arguments\" is required.";
+			return false;
+		}
+
+		if (!hasArguments)
+		{
+			command.commandLine = tokenizeCommand(commandString, windowsSyntax);
+		}
+		unwrapCommand(command.commandLine);
+
+		commands.push_back(std::move(command));
+	}
+	return true;
+}
+
+void CompilationDatabaseLoader::addCommands(std::vector<std::vector<ParsedCommand>>& parsedParts)
+{
+	std::unordered_map<std::string, std::shared_ptr<const std::vector<std::string>>> commandLines;
+	std::unordered_set<std::string> commandKeys;
+
+	for (std::vector<ParsedCommand>& parsedCommands: parsedParts)
+	{
+		m_commands.reserve(m_commands.size() + parsedCommands.size());
+		for (ParsedCommand& parsedCommand: parsedCommands)
+		{
+			std::string commandLineKey;
+			for (const std::string& arg: parsedCommand.commandLine)
+			{
+				commandLineKey += arg;
+				commandLineKey += '\0';
+			}
+
+			if (!commandKeys
+					 .insert(
+						 parsedCommand.directory + '\0' + parsedCommand.filename + '\0' +
+						 commandLineKey)
+					 .second)
+			{
+				m_droppedDuplicateCount++;
+				continue;
+			}
+
+			std::shared_ptr<const std::vector<std::string>>& commandLine =
+				commandLines[commandLineKey];
+			if (!commandLine)
+			{
+				commandLine = std::make_shared<const std::vector<std::string>>(
+					std::move(parsedCommand.commandLine));
+			}
+
+			CompilationDatabaseCommand command;
+			command.directory = std::move(parsedCommand.directory);
+			command.filename = std::move(parsedCommand.filename);
+			command.commandLine = commandLine;
+			m_commands.push_back(std::move(command));
+		}
+	}
+}
+
+void CompilationDatabaseLoader::resolveSourceFilePaths()
+{
+	const FilePath cdbDirectoryPath = m_cdbPath.getParentDirectory();
+
+	runInParallel(m_commands.size(), [&](size_t part, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++)
+		{
+			CompilationDatabaseCommand& command = m_commands[i];
+
+			FilePath sourceFilePath = FilePath(utility::decodeFromUtf8(command.filename))
+										  .makeCanonical();
+			if (!sourceFilePath.isAbsolute())
+			{
+				sourceFilePath = FilePath(utility::decodeFromUtf8(
+											  command.directory + '/' + command.filename))
+									 .makeCanonical();
+				if (!sourceFilePath.isAbsolute())
+				{
+					sourceFilePath =
+						cdbDirectoryPath.getConcatenated(sourceFilePath).makeCanonical();
+				}
+			}
+			command.sourceFilePath = sourceFilePath;
+		}
+	});
+}
+
+bool CompilationDatabaseLoader::readCache(unsigned long long contentHash)
+{
+	if (!m_cacheFilePath.exists())
+	{
+		return false;
+	}
+
+	std::ifstream stream(m_cacheFilePath.str(), std::ios::in | std::ios::binary);
+	const unsigned long long fileByteSize = FileSystem::getFileByteSize(m_cacheFilePath);
+
+	std::string magic;
+	unsigned int version = 0;
+	unsigned long long hash = 0;
+	if (!readString(stream, fileByteSize, magic) || magic != s_cacheFileMagic ||
+		!stream.read(reinterpret_cast<char*>(&version), sizeof(version)) ||
+		version != s_cacheFileVersion ||
+		!stream.read(reinterpret_cast<char*>(&hash), sizeof(hash)) || hash != contentHash)
+	{
+		return false;
+	}
+
+	// the cache matches the database but is damaged, so the database gets loaded directly
+	const auto rejectCache = [this]() {
+		LOG_WARNING(
+			L"Ignoring damaged compilation database cache \"" + m_cacheFilePath.wstr() + L"\"");
+		return false;
+	};
+
+	// every count and string length takes 8 bytes, so a command line takes at least its argument
+	// count, an argument its length and a command the lengths of its strings and its index
+	const size_t minCommandLineByteSize = sizeof(unsigned long long);
+	const size_t minArgByteSize = sizeof(unsigned long long);
+	const size_t minCommandByteSize = 3 * sizeof(unsigned long long);
+
+	size_t droppedDuplicateCount = 0;
+	size_t commandLineCount = 0;
+	if (!readSize(stream, droppedDuplicateCount) ||
+		!readCount(stream, fileByteSize, minCommandLineByteSize, commandLineCount))
+	{
+		return rejectCache();
+	}
+
+	std::vector<std::shared_ptr<const std::vector<std::string>>> commandLines;
+	for (size_t i = 0; i < commandLineCount; i++)
+	{
+		size_t argCount = 0;
+		if (!readCount(stream, fileByteSize, minArgByteSize, argCount))
+		{
+			return rejectCache();
+		}
+
+		std::vector<std::string> commandLine(argCount);
+		for (std::string& arg: commandLine)
+		{
+			if (!readString(stream, fileByteSize, arg))
+			{
+				return rejectCache();
+			}
+		}
+		commandLines.push_back(
+			std::make_shared<const std::vector<std::string>>(std::move(commandLine)));
+	}
+
+	size_t commandCount = 0;
+	if (!readCount(stream, fileByteSize, minCommandByteSize, commandCount))
+	{
+		return rejectCache();
+	}
+
+	std::vector<CompilationDatabaseCommand> commands(commandCount);
+	for (CompilationDatabaseCommand& command: commands)
+	{
+		size_t commandLineIndex = 0;
+		if (!readString(stream, fileByteSize, command.directory) ||
+			!readString(stream, fileByteSize, command.filename) ||
+			!readSize(stream, commandLineIndex) || commandLineIndex >= commandLines.size())
+		{
+			return rejectCache();
+		}
+		command.commandLine = commandLines[commandLineIndex];
+	}
+
+	m_commands = std::move(commands);
+	m_droppedDuplicateCount = droppedDuplicateCount;
+	return true;
+}
+
+void CompilationDatabaseLoader::writeCache(unsigned long long contentHash) const
+{
+	FileSystem::createDirectory(m_cacheFilePath.getParentDirectory());
+
+	std::ofstream stream(m_cacheFilePath.str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!stream)
+	{
+		LOG_WARNING(
+			L"Unable to write compilation database cache \"" + m_cacheFilePath.wstr() + L"\"");
+		return;
+	}
+
+	writeString(stream, s_cacheFileMagic);
+	stream.write(reinterpret_cast<const char*>(&s_cacheFileVersion), sizeof(s_cacheFileVersion));
+	stream.write(reinterpret_cast<const char*>(&contentHash), sizeof(contentHash));
+	writeSize(stream, m_droppedDuplicateCount);
+
+	std::unordered_map<const std::vector<std::string>*, size_t> commandLineIndices;
+	std::vector<const std::vector<std::string>*> commandLines;
+	for (const CompilationDatabaseCommand& command: m_commands)
+	{
+		if (commandLineIndices.emplace(command.commandLine.get(), commandLines.size()).second)
+		{
+			commandLines.push_back(command.commandLine.get());
+		}
+	}
+
+	writeSize(stream, commandLines.size());
+	for (const std::vector<std::string>* commandLine: commandLines)
+	{
+		writeSize(stream, commandLine->size());
+		for (const std::string& arg: *commandLine)
+		{
+			writeString(stream, arg);
+		}
+	}
+
+	writeSize(stream, m_commands.size());
+	for (const CompilationDatabaseCommand& command: m_commands)
+	{
+		writeString(stream, command.directory);
+		writeString(stream, command.filename);
+		writeSize(stream, commandLineIndices[command.commandLine.get()]);
+	}
+}
+
+}	 // namespace utility
@@ -0,0 +1,77 @@
+#ifndef UTILITY_COMPILATION_DATABASE_LOADER_H
+#define UTILITY_COMPILATION_DATABASE_LOADER_H
+
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "FilePath.h"
+#include "FilePathFilter.h"
+
+namespace utility
+{
+struct CompilationDatabaseCommand
+{
+	std::string directory;
+	std::string filename;
+
+	// commands with identical command lines share the same instance
+	std::shared_ptr<const std::vector<std::string>> commandLine;
+
+	// absolute path of the compiled file, resolved against the directory of the command and the
+	// location of the compilation database
+	FilePath sourceFilePath;
+};
+
+// Loads the commands of a JSON compilation database without building a document tree. The file is
+// scanned once to find the boundaries of all command objects, which are then parsed in parallel
+// chunks. Identical commands are dropped and identical command lines are shared. If a cache file
+// path is provided, the parsed commands are stored there together with the hash of the database
+// content and are reused as long as the database does not change.
+class CompilationDatabaseLoader
+{
+public:
+	CompilationDatabaseLoader(const FilePath& cdbPath, const FilePath& cacheFilePath = FilePath());
+
+	bool load();
+
+	const std::vector<CompilationDatabaseCommand>& getCommands() const;
+	std::set<FilePath> getSourceFilePaths(const std::vector<FilePathFilter>& excludeFilters) const;
+
+	const std::string& getError() const;
+	bool isLoadedFromCache() const;
+	size_t getDroppedDuplicateCount() const;
+
+private:
+	struct ParsedCommand
+	{
+		std::string directory;
+		std::string filename;
+		std::vector<std::string> commandLine;
+	};
+
+	bool parse(const std::string& content);
+	bool parseCommands(
+		const std::string& content,
+		const std::vector<std::pair<size_t, size_t>>& objectRanges,
+		std::vector<ParsedCommand>& commands,
+		std::string& error) const;
+	void addCommands(std::vector<std::vector<ParsedCommand>>& parsedParts);
+	void resolveSourceFilePaths();
+
+	bool readCache(unsigned long long contentHash);
+	void writeCache(unsigned long long contentHash) const;
+
+	const FilePath m_cdbPath;
+	const FilePath m_cacheFilePath;
+
+	std::vector<CompilationDatabaseCommand> m_commands;
+	std::string m_error;
+	bool m_loadedFromCache;
+	size_t m_droppedDuplicateCount;
+};
+
+}	 // namespace utility
+
+#endif	  // UTILITY_COMPILATION_DATABASE_LOADER_H
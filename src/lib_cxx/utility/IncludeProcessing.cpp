@@ -10,6 +10,8 @@
 #include "IncludeDirective.h"
 #include "TextAccess.h"
 #include "TextCodec.h"
+#include "ThreadPool.h"
+#include "logging.h"
 #include "utility.h"
 #include "utilityString.h"
 
@@ -22,6 +24,17 @@ struct IncludeDirectiveComparator
 		return a.getIncludedFile() < b.getIncludedFile();
 	}
 };
+
+struct HeaderSearchResult
+{
+	FilePath includedFilePath;
+	FilePath headerSearchDirectory;
+};
+
+bool checkCanceled(const std::function<bool()>& isCanceled)
+{
+	return isCanceled && isCanceled();
+}
 }	 // namespace
 
 std::vector<IncludeDirective> IncludeProcessing::getUnresolvedIncludeDirectives(
@@ -29,20 +42,36 @@ std::vector<IncludeDirective> IncludeProcessing::getUnresolvedIncludeDirectives(
 	const std::set<FilePath>& indexedPaths,
 	const std::set<FilePath>& headerSearchDirectories,
 	const size_t desiredQuantileCount,
-	std::function<void(float)> progress)
+	std::function<void(float)> progress,
+	std::function<bool()> isCanceled)
 {
+	const TimeStamp startTime = TimeStamp::now();
+
 	std::unordered_set<std::wstring> processedFilePaths;
 	std::set<IncludeDirective, IncludeDirectiveComparator> unresolvedIncludeDirectives;
+	size_t processedFileCount = 0;
+
+	ConcurrentCache<IncludeKey, FilePath, IncludeKeyHasher> resolvedIncludeCache(
+		[&headerSearchDirectories](const IncludeKey& key) {
+			return resolveIncludeDirective(
+					   FilePath(key.second), FilePath(key.first), headerSearchDirectories)
+				.makeCanonical();
+		});
 
 	std::vector<std::vector<FilePath>> parts = utility::splitToEqualySizedParts(
 		utility::toVector(sourceFilePaths), desiredQuantileCount);
 
-	for (size_t i = 0; i < parts.size(); i++)
+	for (size_t i = 0; i < parts.size() && !checkCanceled(isCanceled); i++)
 	{
 		progress(float(i) / parts.size());
 
 		const std::vector<IncludeDirective> directives = doGetUnresolvedIncludeDirectives(
-			utility::toSet(parts[i]), processedFilePaths, indexedPaths, headerSearchDirectories);
+			utility::toSet(parts[i]),
+			processedFilePaths,
+			indexedPaths,
+			resolvedIncludeCache,
+			isCanceled,
+			processedFileCount);
 		std::copy(
 			directives.begin(),
 			directives.end(),
@@ -51,13 +80,23 @@ std::vector<IncludeDirective> IncludeProcessing::getUnresolvedIncludeDirectives(
 
 	std::vector<IncludeDirective> ret;
 
-	for (const IncludeDirective& directive: unresolvedIncludeDirectives)
+	if (!checkCanceled(isCanceled))
 	{
-		ret.push_back(directive);
+		for (const IncludeDirective& directive: unresolvedIncludeDirectives)
+		{
+			ret.push_back(directive);
+		}
 	}
 
 	progress(1.0f);
 
+	logThroughput(
+		"unresolved include detection",
+		processedFileCount,
+		startTime,
+		resolvedIncludeCache.getHitCount(),
+		resolvedIncludeCache.getMissCount());
+
 	return ret;
 }
 
@@ -66,28 +105,65 @@ std::set<FilePath> IncludeProcessing::getHeaderSearchDirectories(
 	const std::set<FilePath>& searchedPaths,
 	const std::set<FilePath>& currentHeaderSearchDirectories,
 	const size_t desiredQuantileCount,
-	std::function<void(float)> progress)
+	std::function<void(float)> progress,
+	std::function<bool()> isCanceled)
 {
 	progress(0.0f);
 
+	const TimeStamp startTime = TimeStamp::now();
+
 	std::vector<std::shared_ptr<FileTree>> existingFileTrees;
 	for (const FilePath& searchedPath: searchedPaths)
 	{
 		existingFileTrees.push_back(std::make_shared<FileTree>(searchedPath));
 	}
 
+	// only reads from the file trees, so it can be called from multiple threads
+	ConcurrentCache<IncludeKey, HeaderSearchResult, IncludeKeyHasher> headerSearchCache(
+		[&currentHeaderSearchDirectories, &existingFileTrees](const IncludeKey& key) {
+			const FilePath includedFilePath(key.second);
+
+			HeaderSearchResult result;
+			FilePath foundIncludedPath = resolveIncludeDirective(
+				includedFilePath, FilePath(key.first), currentHeaderSearchDirectories);
+			if (foundIncludedPath.empty())
+			{
+				for (std::shared_ptr<FileTree> existingFileTree: existingFileTrees)
+				{
+					// TODO: handle the case where a file can be found by two different paths
+					const FilePath rootPath = existingFileTree->getAbsoluteRootPathForRelativeFilePath(
+						includedFilePath);
+					if (!rootPath.empty())
+					{
+						foundIncludedPath = rootPath.getConcatenated(includedFilePath);
+						if (foundIncludedPath.exists())
+						{
+							result.headerSearchDirectory = rootPath;
+							break;
+						}
+					}
+				}
+			}
+			if (foundIncludedPath.exists())
+			{
+				result.includedFilePath = foundIncludedPath.makeCanonical();
+			}
+			return result;
+		});
+
 	std::set<FilePath> headerSearchDirectories;
 	std::unordered_set<std::wstring> processedFilePaths;
+	size_t processedFileCount = 0;
 	std::vector<std::vector<FilePath>> parts = utility::splitToEqualySizedParts(
 		utility::toVector(sourceFilePaths), desiredQuantileCount);
 
-	for (size_t i = 0; i < parts.size(); i++)
+	for (size_t i = 0; i < parts.size() && !checkCanceled(isCanceled); i++)
 	{
 		progress(float(i) / parts.size());
 
 		std::set<FilePath> unprocessedFilePaths(parts[i].begin(), parts[i].end());
 
-		while (!unprocessedFilePaths.empty())
+		while (!unprocessedFilePaths.empty() && !checkCanceled(isCanceled))
 		{
 			std::transform(
 				unprocessedFilePaths.begin(),
@@ -95,44 +171,37 @@ std::set<FilePath> IncludeProcessing::getHeaderSearchDirectories(
 				std::inserter(processedFilePaths, processedFilePaths.begin()),
 				[](const FilePath& p) { return p.getAbsolute().wstr(); });
 
+			// files of one iteration are processed in parallel, results are merged in order
+			const std::vector<FilePath> filePaths = utility::toVector(unprocessedFilePaths);
+			std::vector<std::vector<HeaderSearchResult>> results(filePaths.size());
+			ThreadPool::getInstance()->parallelFor(filePaths.size(), [&](size_t index) {
+				if (!checkCanceled(isCanceled))
+				{
+					for (const IncludeDirective& includeDirective:
+						 getIncludeDirectives(filePaths[index]))
+					{
+						results[index].push_back(
+							headerSearchCache.getValue(getIncludeKey(includeDirective)));
+					}
+				}
+			});
+			processedFileCount += filePaths.size();
+
 			std::set<FilePath> unprocessedFilePathsForNextIteration;
 
-			for (const FilePath& unprocessedFilePath: unprocessedFilePaths)
+			for (const std::vector<HeaderSearchResult>& fileResults: results)
 			{
-				for (const IncludeDirective& includeDirective:
-					 getIncludeDirectives(unprocessedFilePath))
+				for (const HeaderSearchResult& result: fileResults)
 				{
-					const FilePath includedFilePath = includeDirective.getIncludedFile();
-
-					FilePath foundIncludedPath = resolveIncludeDirective(
-						includeDirective, currentHeaderSearchDirectories);
-					if (foundIncludedPath.empty())
+					if (!result.headerSearchDirectory.empty())
 					{
-						for (std::shared_ptr<FileTree> existingFileTree: existingFileTrees)
-						{
-							// TODO: handle the case where a file can be found by two different paths
-							const FilePath rootPath =
-								existingFileTree->getAbsoluteRootPathForRelativeFilePath(
-									includedFilePath);
-							if (!rootPath.empty())
-							{
-								foundIncludedPath = rootPath.getConcatenated(includedFilePath);
-								if (foundIncludedPath.exists())
-								{
-									headerSearchDirectories.insert(rootPath);
-									break;
-								}
-							}
-						}
+						headerSearchDirectories.insert(result.headerSearchDirectory);
 					}
-					if (foundIncludedPath.exists())
-					{
-						foundIncludedPath.makeCanonical();
-						if (processedFilePaths.find(foundIncludedPath.wstr()) ==
+					if (!result.includedFilePath.empty() &&
+						processedFilePaths.find(result.includedFilePath.wstr()) ==
 							processedFilePaths.end())
-						{
-							unprocessedFilePathsForNextIteration.insert(foundIncludedPath);
-						}
+					{
+						unprocessedFilePathsForNextIteration.insert(result.includedFilePath);
 					}
 				}
 			}
@@ -141,8 +210,20 @@ std::set<FilePath> IncludeProcessing::getHeaderSearchDirectories(
 		}
 	}
 
+	if (checkCanceled(isCanceled))
+	{
+		headerSearchDirectories.clear();
+	}
+
 	progress(1.0f);
 
+	logThroughput(
+		"header search directory detection",
+		processedFileCount,
+		startTime,
+		headerSearchCache.getHitCount(),
+		headerSearchCache.getMissCount());
+
 	return headerSearchDirectories;
 }
 
@@ -194,15 +275,22 @@ std::vector<IncludeDirective> IncludeProcessing::getIncludeDirectives(
 	return includeDirectives;
 }
 
+size_t IncludeProcessing::IncludeKeyHasher::operator()(const IncludeKey& key) const
+{
+	return std::hash<std::wstring>()(key.first) ^ (std::hash<std::wstring>()(key.second) << 1);
+}
+
 std::vector<IncludeDirective> IncludeProcessing::doGetUnresolvedIncludeDirectives(
 	std::set<FilePath> filePathsToProcess,
 	std::unordered_set<std::wstring>& processedFilePaths,
 	const std::set<FilePath>& indexedPaths,
-	const std::set<FilePath>& headerSearchDirectories)
+	ConcurrentCache<IncludeKey, FilePath, IncludeKeyHasher>& resolvedIncludeCache,
+	std::function<bool()> isCanceled,
+	size_t& processedFileCount)
 {
 	std::vector<IncludeDirective> unresolvedIncludeDirectives;
 
-	while (!filePathsToProcess.empty())
+	while (!filePathsToProcess.empty() && !checkCanceled(isCanceled))
 	{
 		std::transform(
 			filePathsToProcess.begin(),
@@ -210,17 +298,32 @@ std::vector<IncludeDirective> IncludeProcessing::doGetUnresolvedIncludeDirective
 			std::inserter(processedFilePaths, processedFilePaths.begin()),
 			[](const FilePath& p) { return p.getAbsolute().makeCanonical().wstr(); });
 
+		// files of one iteration are processed in parallel, results are merged in order
+		const std::vector<FilePath> filePaths = utility::toVector(filePathsToProcess);
+		std::vector<std::vector<std::pair<IncludeDirective, FilePath>>> results(filePaths.size());
+		ThreadPool::getInstance()->parallelFor(filePaths.size(), [&](size_t index) {
+			if (!checkCanceled(isCanceled))
+			{
+				for (const IncludeDirective& includeDirective: getIncludeDirectives(filePaths[index]))
+				{
+					results[index].emplace_back(
+						includeDirective,
+						resolvedIncludeCache.getValue(getIncludeKey(includeDirective)));
+				}
+			}
+		});
+		processedFileCount += filePaths.size();
+
 		std::set<FilePath> filePathsToProcessForNextIteration;
 
-		for (const FilePath& filePath: filePathsToProcess)
+		for (const std::vector<std::pair<IncludeDirective, FilePath>>& fileResults: results)
 		{
-			for (const IncludeDirective& includeDirective: getIncludeDirectives(filePath))
+			for (const std::pair<IncludeDirective, FilePath>& result: fileResults)
 			{
-				const FilePath resolvedIncludePath =
-					resolveIncludeDirective(includeDirective, headerSearchDirectories).makeCanonical();
+				const FilePath& resolvedIncludePath = result.second;
 				if (resolvedIncludePath.empty())
 				{
-					unresolvedIncludeDirectives.push_back(includeDirective);
+					unresolvedIncludeDirectives.push_back(result.first);
 				}
 				else if (processedFilePaths.find(resolvedIncludePath.wstr()) == processedFilePaths.end())
 				{
@@ -242,11 +345,18 @@ std::vector<IncludeDirective> IncludeProcessing::doGetUnresolvedIncludeDirective
 	return unresolvedIncludeDirectives;
 }
 
-FilePath IncludeProcessing::resolveIncludeDirective(
-	const IncludeDirective& includeDirective, const std::set<FilePath>& headerSearchDirectories)
+IncludeProcessing::IncludeKey IncludeProcessing::getIncludeKey(const IncludeDirective& includeDirective)
 {
-	const FilePath includedFilePath = includeDirective.getIncludedFile();
+	return IncludeKey(
+		includeDirective.getIncludingFile().getParentDirectory().wstr(),
+		includeDirective.getIncludedFile().wstr());
+}
 
+FilePath IncludeProcessing::resolveIncludeDirective(
+	const FilePath& includedFilePath,
+	const FilePath& includingDirectoryPath,
+	const std::set<FilePath>& headerSearchDirectories)
+{
 	{
 		// check for an absolute include path
 		if (includedFilePath.isAbsolute())
@@ -261,8 +371,8 @@ FilePath IncludeProcessing::resolveIncludeDirective(
 
 	{
 		// check for an include path relative to the including path
-		const FilePath resolvedIncludePath =
-			includeDirective.getIncludingFile().getParentDirectory().concatenate(includedFilePath);
+		const FilePath resolvedIncludePath = includingDirectoryPath.getConcatenated(
+			includedFilePath);
 		if (resolvedIncludePath.exists())
 		{
 			return resolvedIncludePath;
@@ -284,3 +394,21 @@ FilePath IncludeProcessing::resolveIncludeDirective(
 
 	return FilePath();
 }
+
+void IncludeProcessing::logThroughput(
+	const std::string& operationName,
+	size_t processedFileCount,
+	const TimeStamp& startTime,
+	size_t cacheHitCount,
+	size_t cacheMissCount)
+{
+	const double seconds = TimeStamp::durationSeconds(startTime);
+	const size_t filesPerSecond = seconds > 0 ? static_cast<size_t>(processedFileCount / seconds)
+											  : processedFileCount;
+	LOG_INFO(
+		operationName + " processed " + std::to_string(processedFileCount) + " files in " +
+		TimeStamp::secondsToString(seconds) + " (" + std::to_string(filesPerSecond) +
+		" files/s) on " + std::to_string(ThreadPool::getInstance()->getThreadCount() + 1) +
+		" threads, include resolution cache hits: " + std::to_string(cacheHitCount) +
+		", misses: " + std::to_string(cacheMissCount));
+}
@@ -1,14 +1,17 @@
 #ifndef INCLUDE_PROCESSING_H
 #define INCLUDE_PROCESSING_H
 
+#include <functional>
 #include <memory>
 #include <set>
+#include <string>
 #include <unordered_set>
 #include <vector>
 
-#include "OrderedCache.h"
+#include "ConcurrentCache.h"
+#include "FilePath.h"
+#include "TimeStamp.h"
 
-class FilePath;
 class IncludeDirective;
 class TextAccess;
 
@@ -20,28 +23,50 @@ public:
 		const std::set<FilePath>& indexedPaths,
 		const std::set<FilePath>& headerSearchDirectories,
 		size_t quantileCount,
-		std::function<void(float)> progress);
+		std::function<void(float)> progress,
+		std::function<bool()> isCanceled = nullptr);
 
 	static std::set<FilePath> getHeaderSearchDirectories(
 		const std::set<FilePath>& sourceFilePaths,
 		const std::set<FilePath>& searchedPaths,
 		const std::set<FilePath>& currentHeaderSearchDirectories,
 		const size_t desiredQuantileCount,
-		std::function<void(float)> progress);
+		std::function<void(float)> progress,
+		std::function<bool()> isCanceled = nullptr);
 
 	static std::vector<IncludeDirective> getIncludeDirectives(const FilePath& filePath);
 
 	static std::vector<IncludeDirective> getIncludeDirectives(std::shared_ptr<TextAccess> textAccess);
 
 private:
+	typedef std::pair<std::wstring, std::wstring> IncludeKey;
+
+	struct IncludeKeyHasher
+	{
+		size_t operator()(const IncludeKey& key) const;
+	};
+
 	static std::vector<IncludeDirective> doGetUnresolvedIncludeDirectives(
 		std::set<FilePath> filePathsToProcess,
 		std::unordered_set<std::wstring>& processedFilePaths,
 		const std::set<FilePath>& indexedPaths,
-		const std::set<FilePath>& headerSearchDirectories);
+		ConcurrentCache<IncludeKey, FilePath, IncludeKeyHasher>& resolvedIncludeCache,
+		std::function<bool()> isCanceled,
+		size_t& processedFileCount);
+
+	static IncludeKey getIncludeKey(const IncludeDirective& includeDirective);
 
 	static FilePath resolveIncludeDirective(
-		const IncludeDirective& includeDirective, const std::set<FilePath>& headerSearchDirectories);
+		const FilePath& includedFilePath,
+		const FilePath& includingDirectoryPath,
+		const std::set<FilePath>& headerSearchDirectories);
+
+	static void logThroughput(
+		const std::string& operationName,
+		size_t processedFileCount,
+		const TimeStamp& startTime,
+		size_t cacheHitCount,
+		size_t cacheMissCount);
 
 	IncludeProcessing() = delete;
 };
@@ -4,6 +4,7 @@
 #include <QButtonGroup>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QPushButton>
 #include <QScrollBar>
 #include <QStyle>
 #include <QTimer>
@@ -16,6 +17,7 @@
 #include "MessageHistoryRedo.h"
 #include "MessageHistoryUndo.h"
 #include "MessageScrollCode.h"
+#include "MessageShowMoreFullTextSearchResults.h"
 #include "MessageTabOpenWith.h"
 #include "MessageToNextCodeReference.h"
 #include "QtCodeArea.h"
@@ -86,6 +88,18 @@ QtCodeNavigator::QtCodeNavigator(QWidget* parent)
 			m_refLabel->setObjectName(QStringLiteral("references_label"));
 			navLayout->addWidget(m_refLabel);
 
+			m_moreResultsButton = new QPushButton(QStringLiteral("show more"));
+			m_moreResultsButton->setObjectName(QStringLiteral("more_results_button"));
+			m_moreResultsButton->setToolTip(QStringLiteral("show more fulltext search results"));
+			m_moreResultsButton->hide();
+			navLayout->addWidget(m_moreResultsButton);
+
+			connect(
+				m_moreResultsButton,
+				&QPushButton::clicked,
+				this,
+				&QtCodeNavigator::showMoreResults);
+
 			navLayout->addStretch();
 		}
 
@@ -248,6 +262,11 @@ void QtCodeNavigator::updateReferenceCount(
 	m_localRefLabel->setVisible(localReferenceCount > 1);
 }
 
+void QtCodeNavigator::setHasMoreResults(bool hasMoreResults)
+{
+	m_moreResultsButton->setVisible(hasMoreResults);
+}
+
 void QtCodeNavigator::clear()
 {
 	clearSnippets();
@@ -900,6 +919,11 @@ void QtCodeNavigator::nextReference()
 	MessageCodeReference(MessageCodeReference::REFERENCE_NEXT, false).dispatch();
 }
 
+void QtCodeNavigator::showMoreResults()
+{
+	MessageShowMoreFullTextSearchResults().dispatch();
+}
+
 void QtCodeNavigator::previousLocalReference()
 {
 	MessageCodeReference(MessageCodeReference::REFERENCE_PREVIOUS, true).dispatch();
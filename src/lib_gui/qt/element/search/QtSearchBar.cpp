@@ -4,6 +4,7 @@
 
 #include "MessageActivateFullTextSearch.h"
 #include "MessageActivateOverview.h"
+#include "MessageFullTextSearchInterrupted.h"
 #include "MessageSearch.h"
 #include "MessageSearchAutocomplete.h"
 #include "QtSearchBarButton.h"
@@ -104,17 +105,20 @@ void QtSearchBar::homeButtonClicked()
 	MessageActivateOverview().dispatch();
 }
 
-void QtSearchBar::requestAutocomplete(const std::wstring& query, NodeTypeSet acceptedNodeTypes)
+void QtSearchBar::requestAutocomplete(
+	const std::wstring& query, NodeTypeSet acceptedNodeTypes, SearchFilter filter)
 {
-	MessageSearchAutocomplete(query, acceptedNodeTypes).dispatch();
+	MessageSearchAutocomplete(query, acceptedNodeTypes, filter).dispatch();
 }
 
 void QtSearchBar::requestSearch(const std::vector<SearchMatch>& matches, NodeTypeSet acceptedNodeTypes)
 {
+	MessageFullTextSearchInterrupted().dispatch();
 	MessageSearch(matches, acceptedNodeTypes).dispatch();
 }
 
 void QtSearchBar::requestFullTextSearch(const std::wstring& query, bool caseSensitive)
 {
+	MessageFullTextSearchInterrupted().dispatch();
 	MessageActivateFullTextSearch(query, caseSensitive).dispatch();
 }
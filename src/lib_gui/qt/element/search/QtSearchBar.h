@@ -6,6 +6,7 @@
 #include <QAbstractItemView>
 #include <QFrame>
 
+#include "SearchFilter.h"
 #include "SearchMatch.h"
 
 class QtSearchBarButton;
@@ -35,7 +36,8 @@ public:
 private slots:
 	void homeButtonClicked();
 
-	void requestAutocomplete(const std::wstring& query, NodeTypeSet acceptedNodeTypes);
+	void requestAutocomplete(
+		const std::wstring& query, NodeTypeSet acceptedNodeTypes, SearchFilter filter);
 	void requestSearch(const std::vector<SearchMatch>& matches, NodeTypeSet acceptedNodeTypes);
 	void requestFullTextSearch(const std::wstring& query, bool caseSensitive);
 
@@ -1066,7 +1066,8 @@ void QtSmartSearchBox::requestAutoCompletions()
 {
 	if (!text().isEmpty() && !text().startsWith(SearchMatch::FULLTEXT_SEARCH_CHARACTER))
 	{
-		emit autocomplete(text().toStdWString(), getMatchAcceptedNodeTypes());
+		emit autocomplete(
+			text().toStdWString(), getMatchAcceptedNodeTypes(), getMatchSearchFilter());
 	}
 	else
 	{
@@ -1123,13 +1124,14 @@ NodeTypeSet QtSmartSearchBox::getMatchAcceptedNodeTypes() const
 
 	for (const SearchMatch& match: m_matches)
 	{
-		if (match.isFilterCommand())
+		if (!match.isFilterCommand())
 		{
-			acceptedTypes.add(match.nodeType);
+			break;
 		}
-		else
+
+		if (match.getCommandType() == SearchMatch::COMMAND_NODE_FILTER)
 		{
-			break;
+			acceptedTypes.add(match.nodeType);
 		}
 	}
 
@@ -1141,6 +1143,23 @@ NodeTypeSet QtSmartSearchBox::getMatchAcceptedNodeTypes() const
 	return acceptedTypes;
 }
 
+SearchFilter QtSmartSearchBox::getMatchSearchFilter() const
+{
+	SearchFilter filter;
+
+	for (const SearchMatch& match: m_matches)
+	{
+		if (!match.isFilterCommand())
+		{
+			break;
+		}
+
+		filter.addFilter(match.name);
+	}
+
+	return filter;
+}
+
 bool QtSmartSearchBox::lastMatchIsNoFilter() const
 {
 	return m_matches.empty() || !m_matches.back().isFilterCommand();
@@ -8,6 +8,7 @@
 #include <QPushButton>
 
 #include "QtAutocompletionList.h"
+#include "SearchFilter.h"
 #include "SearchMatch.h"
 
 class NodeTypeSet;
@@ -32,7 +33,8 @@ class QtSmartSearchBox: public QLineEdit
 	Q_OBJECT
 
 signals:
-	void autocomplete(const std::wstring& query, NodeTypeSet acceptedNodeTypes);
+	void autocomplete(
+		const std::wstring& query, NodeTypeSet acceptedNodeTypes, SearchFilter filter);
 	void search(const std::vector<SearchMatch>& matches, NodeTypeSet acceptedNodeTypes);
 	void fullTextSearch(const std::wstring& query, bool caseSensitive);
 
@@ -109,6 +111,7 @@ private:
 	std::deque<SearchMatch> getMatchesForInput(const std::wstring& text) const;
 
 	NodeTypeSet getMatchAcceptedNodeTypes() const;
+	SearchFilter getMatchSearchFilter() const;
 	bool lastMatchIsNoFilter() const;
 
 	const QString m_placeholder;
@@ -338,6 +338,19 @@ void QtProjectWizardContentPreferences::populate(QGridLayout* layout, int& row)
 		layout,
 		row);
 
+	// indexer memory limit
+	m_indexerMemoryLimit = addLineEdit(
+		QStringLiteral("Indexer Memory<br />Limit (MB)"),
+		QStringLiteral(
+			"<p>Set the maximum amount of memory in MB that each C/C++ indexer process may use. Set "
+			"to 0 to disable the limit.</p>"
+			"<p>An indexer process exceeding this limit is restarted. The translation unit it was "
+			"working on is indexed again after all other files, first on its own and then without "
+			"template instantiations.</p>"
+			"<p>Requires multi process indexing.</p>"),
+		layout,
+		row);
+
 	addGap(layout, row);
 
 
@@ -452,6 +465,18 @@ void QtProjectWizardContentPreferences::populate(QGridLayout* layout, int& row)
 		addMavenPathDetection(layout, row);
 	}
 
+	// shared java indexer
+	m_sharedJavaIndexer = addCheckBox(
+		QStringLiteral("Shared Java<br />Indexer"),
+		QStringLiteral("Index Java files on multiple threads of a single JVM"),
+		QStringLiteral(
+			"<p>Index all Java files within one indexer that runs the selected number of threads "
+			"inside a single JVM, instead of starting a JVM for each indexer thread.</p>"
+			"<p>This lowers the memory consumption and lets all threads profit from the same "
+			"classpath caches and JIT warm-up.</p>"),
+		layout,
+		row);
+
 	addGap(layout, row);
 
 
@@ -543,6 +568,7 @@ void QtProjectWizardContentPreferences::load()
 		appSettings->getIndexerThreadCount());	  // index and value are the same
 	indexerThreadsChanges(m_threads->currentIndex());
 	m_multiProcessIndexing->setChecked(appSettings->getMultiProcessIndexingEnabled());
+	m_indexerMemoryLimit->setText(QString::number(appSettings->getIndexerMemoryLimitMb()));
 
 	if (m_javaPath)
 	{
@@ -556,6 +582,8 @@ void QtProjectWizardContentPreferences::load()
 		m_mavenPath->setText(QString::fromStdWString(appSettings->getMavenPath().wstr()));
 	}
 
+	m_sharedJavaIndexer->setChecked(appSettings->getSharedJavaIndexerEnabled());
+
 	m_pythonPostProcessing->setChecked(appSettings->getPythonPostProcessingEnabled());
 }
 
@@ -621,6 +649,10 @@ void QtProjectWizardContentPreferences::save()
 	appSettings->setIndexerThreadCount(m_threads->currentIndex());	  // index and value are the same
 	appSettings->setMultiProcessIndexingEnabled(m_multiProcessIndexing->isChecked());
 
+	int indexerMemoryLimit = m_indexerMemoryLimit->text().toInt();
+	if (indexerMemoryLimit >= 0)
+		appSettings->setIndexerMemoryLimitMb(indexerMemoryLimit);
+
 	if (m_javaPath)
 	{
 		appSettings->setJavaPath(FilePath(m_javaPath->getText().toStdWString()));
@@ -633,6 +665,8 @@ void QtProjectWizardContentPreferences::save()
 		appSettings->setMavenPath(FilePath(m_mavenPath->getText().toStdWString()));
 	}
 
+	appSettings->setSharedJavaIndexerEnabled(m_sharedJavaIndexer->isChecked());
+
 	appSettings->setPythonPostProcessingEnabled(m_pythonPostProcessing->isChecked());
 
 	appSettings->save();
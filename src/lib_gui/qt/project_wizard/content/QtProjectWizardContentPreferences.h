@@ -134,6 +134,7 @@ private:
 	QLabel* m_threadsInfoLabel;
 
 	QCheckBox* m_multiProcessIndexing;
+	QLineEdit* m_indexerMemoryLimit;
 
 	std::shared_ptr<CombinedPathDetector> m_javaPathDetector;
 	std::shared_ptr<CombinedPathDetector> m_jreSystemLibraryPathsDetector;
@@ -145,6 +146,7 @@ private:
 	QtLocationPicker* m_javaPath;
 	QtPathListBox* m_jreSystemLibraryPaths;
 	QtLocationPicker* m_mavenPath;
+	QCheckBox* m_sharedJavaIndexer;
 
 	QCheckBox* m_pythonPostProcessing;
 };
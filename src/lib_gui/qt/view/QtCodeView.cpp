@@ -257,6 +257,8 @@ void QtCodeView::setNavigationState(const CodeParams& params)
 		params.referenceIndex,
 		params.localReferenceCount,
 		params.localReferenceIndex);
+
+	m_widget->setHasMoreResults(params.hasMoreResults);
 }
 
 void QtCodeView::setStyleSheet() const
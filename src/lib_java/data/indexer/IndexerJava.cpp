@@ -14,3 +14,16 @@ void IndexerJava::doIndex(
 {
 	JavaParser(parserClient, m_indexerStateInfo).buildIndex(indexerCommand);
 }
+
+void IndexerJava::doIndexBatch(
+	const std::vector<std::shared_ptr<IndexerCommandJava>>& indexerCommands,
+	const std::vector<std::shared_ptr<ParserClientImpl>>& parserClients,
+	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo,
+	size_t threadCount)
+{
+	JavaParser::buildIndex(
+		indexerCommands,
+		std::vector<std::shared_ptr<ParserClient>>(parserClients.begin(), parserClients.end()),
+		m_indexerStateInfo,
+		threadCount);
+}
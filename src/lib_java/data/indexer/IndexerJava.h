@@ -16,6 +16,12 @@ private:
 		std::shared_ptr<IndexerCommandJava> indexerCommand,
 		std::shared_ptr<ParserClientImpl> parserClient,
 		std::shared_ptr<IndexerStateInfo> m_indexerStateInfo) override;
+
+	void doIndexBatch(
+		const std::vector<std::shared_ptr<IndexerCommandJava>>& indexerCommands,
+		const std::vector<std::shared_ptr<ParserClientImpl>>& parserClients,
+		std::shared_ptr<IndexerStateInfo> m_indexerStateInfo,
+		size_t threadCount) override;
 };
 
 #endif	  // INDEXER_JAVA_H
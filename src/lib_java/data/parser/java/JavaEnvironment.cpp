@@ -5,6 +5,31 @@
 #include "JavaEnvironmentFactory.h"
 #include "logging.h"
 
+namespace
+{
+jintArray toJIntArray(JNIEnv* env, const std::vector<int>& v)
+{
+	jintArray array = env->NewIntArray(static_cast<jsize>(v.size()));
+	std::vector<jint> values(v.begin(), v.end());
+	env->SetIntArrayRegion(array, 0, static_cast<jsize>(values.size()), values.data());
+	return array;
+}
+
+jobjectArray toJStringArray(JNIEnv* env, const std::vector<std::string>& v)
+{
+	jobjectArray array = env->NewObjectArray(
+		static_cast<jsize>(v.size()), env->FindClass("java/lang/String"), nullptr);
+	for (size_t i = 0; i < v.size(); i++)
+	{
+		// the local reference table is small, so each element is released right away
+		jstring element = env->NewStringUTF(v[i].c_str());
+		env->SetObjectArrayElement(array, static_cast<jsize>(i), element);
+		env->DeleteLocalRef(element);
+	}
+	return array;
+}
+}	 // namespace
+
 JavaEnvironment::~JavaEnvironment()
 {
 	JavaEnvironmentFactory::getInstance()->unregisterEnvironment();
@@ -22,6 +47,21 @@ bool JavaEnvironment::callStaticVoidMethod(std::string className, std::string me
 	return false;
 }
 
+bool JavaEnvironment::callStaticVoidMethod(
+	std::string className, std::string methodName, const std::string& arg1)
+{
+	jclass javaClass = getJavaClass(className);
+	jmethodID javaMethodId = getJavaStaticMethod(javaClass, methodName, "(Ljava/lang/String;)V");
+	if (javaMethodId != nullptr)
+	{
+		jstring jarg1 = m_env->NewStringUTF(arg1.c_str());
+		m_env->CallStaticVoidMethod(javaClass, javaMethodId, jarg1);
+		m_env->DeleteLocalRef(jarg1);
+		return true;
+	}
+	return false;
+}
+
 bool JavaEnvironment::callStaticVoidMethod(
 	std::string className,
 	std::string methodName,
@@ -73,6 +113,75 @@ bool JavaEnvironment::callStaticVoidMethod(
 	return false;
 }
 
+bool JavaEnvironment::callStaticVoidMethod(
+	std::string className,
+	std::string methodName,
+	int arg1,
+	std::string arg2,
+	std::string arg3,
+	std::string arg4,
+	std::string arg5,
+	int arg6,
+	int arg7)
+{
+	jclass javaClass = getJavaClass(className);
+	jmethodID javaMethodId = getJavaStaticMethod(
+		javaClass,
+		methodName,
+		"(ILjava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;II)V");
+	if (javaMethodId != nullptr)
+	{
+		jint jarg1 = arg1;
+		jstring jarg2 = m_env->NewStringUTF(arg2.c_str());
+		jstring jarg3 = m_env->NewStringUTF(arg3.c_str());
+		jstring jarg4 = m_env->NewStringUTF(arg4.c_str());
+		jstring jarg5 = m_env->NewStringUTF(arg5.c_str());
+		jint jarg6 = arg6;
+		jint jarg7 = arg7;
+		m_env->CallStaticVoidMethod(
+			javaClass, javaMethodId, jarg1, jarg2, jarg3, jarg4, jarg5, jarg6, jarg7);
+		return true;
+	}
+	return false;
+}
+
+bool JavaEnvironment::callStaticVoidMethod(
+	std::string className,
+	std::string methodName,
+	const std::vector<int>& arg1,
+	const std::vector<std::string>& arg2,
+	const std::vector<std::string>& arg3,
+	const std::vector<std::string>& arg4,
+	const std::vector<std::string>& arg5,
+	int arg6,
+	int arg7)
+{
+	jclass javaClass = getJavaClass(className);
+	jmethodID javaMethodId = getJavaStaticMethod(
+		javaClass,
+		methodName,
+		"([I[Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/String;II)V");
+	if (javaMethodId != nullptr)
+	{
+		jintArray jarg1 = toJIntArray(m_env, arg1);
+		jobjectArray jarg2 = toJStringArray(m_env, arg2);
+		jobjectArray jarg3 = toJStringArray(m_env, arg3);
+		jobjectArray jarg4 = toJStringArray(m_env, arg4);
+		jobjectArray jarg5 = toJStringArray(m_env, arg5);
+		jint jarg6 = arg6;
+		jint jarg7 = arg7;
+		m_env->CallStaticVoidMethod(
+			javaClass, javaMethodId, jarg1, jarg2, jarg3, jarg4, jarg5, jarg6, jarg7);
+		m_env->DeleteLocalRef(jarg1);
+		m_env->DeleteLocalRef(jarg2);
+		m_env->DeleteLocalRef(jarg3);
+		m_env->DeleteLocalRef(jarg4);
+		m_env->DeleteLocalRef(jarg5);
+		return true;
+	}
+	return false;
+}
+
 bool JavaEnvironment::callStaticStringMethod(
 	std::string className, std::string methodName, std::string& ret, const std::string& arg1)
 {
@@ -33,6 +33,8 @@ public:
 
 	~JavaEnvironment();
 	bool callStaticVoidMethod(std::string className, std::string methodName);
+	bool callStaticVoidMethod(
+		std::string className, std::string methodName, const std::string& arg1);
 	bool callStaticVoidMethod(
 		std::string className,
 		std::string methodName,
@@ -48,6 +50,26 @@ public:
 		std::string arg4,
 		std::string arg5,
 		int arg6);
+	bool callStaticVoidMethod(
+		std::string className,
+		std::string methodName,
+		int arg1,
+		std::string arg2,
+		std::string arg3,
+		std::string arg4,
+		std::string arg5,
+		int arg6,
+		int arg7);
+	bool callStaticVoidMethod(
+		std::string className,
+		std::string methodName,
+		const std::vector<int>& arg1,
+		const std::vector<std::string>& arg2,
+		const std::vector<std::string>& arg3,
+		const std::vector<std::string>& arg4,
+		const std::vector<std::string>& arg5,
+		int arg6,
+		int arg7);
 	bool callStaticStringMethod(
 		std::string className, std::string methodName, std::string& ret, const std::string& arg1);
 	bool callStaticStringMethod(
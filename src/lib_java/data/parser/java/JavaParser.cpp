@@ -1,5 +1,7 @@
 #include "JavaParser.h"
 
+#include <cstring>
+
 #include <jni.h>
 
 #include "ApplicationSettings.h"
@@ -11,9 +13,123 @@
 #include "ReferenceKind.h"
 #include "ResourcePaths.h"
 #include "TextAccess.h"
+#include "UserPaths.h"
 #include "utilityJava.h"
 #include "utilityString.h"
 
+namespace
+{
+// record opcodes, these have to match the ones used in JavaIndexerRecordBuffer.java
+enum RecordOpcode
+{
+	RECORD_STRING = 1,
+	RECORD_SYMBOL = 2,
+	RECORD_SYMBOL_WITH_LOCATION = 3,
+	RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE = 4,
+	RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE = 5,
+	RECORD_REFERENCE = 6,
+	RECORD_QUALIFIER_LOCATION = 7,
+	RECORD_LOCAL_SYMBOL = 8,
+	RECORD_COMMENT = 9,
+	RECORD_ERROR = 10
+};
+
+class RecordBatchReader
+{
+public:
+	RecordBatchReader(const char* data, size_t size): m_data(data), m_size(size), m_position(0) {}
+
+	bool atEnd() const
+	{
+		return m_position >= m_size;
+	}
+
+	bool canRead(size_t intCount) const
+	{
+		return m_size - m_position >= intCount * sizeof(int32_t);
+	}
+
+	int32_t readInt()
+	{
+		int32_t value;
+		std::memcpy(&value, m_data + m_position, sizeof(int32_t));
+		m_position += sizeof(int32_t);
+		return value;
+	}
+
+	bool readString(size_t length, std::string& str)
+	{
+		if (m_size - m_position < length)
+		{
+			return false;
+		}
+
+		str.assign(m_data + m_position, length);
+		m_position += length;
+		return true;
+	}
+
+private:
+	const char* m_data;
+	const size_t m_size;
+	size_t m_position;
+};
+
+size_t getRecordFieldCount(int32_t opcode)
+{
+	switch (opcode)
+	{
+	case RECORD_STRING:
+		return 1;
+	case RECORD_SYMBOL:
+		return 4;
+	case RECORD_SYMBOL_WITH_LOCATION:
+		return 8;
+	case RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE:
+		return 12;
+	case RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE:
+		return 16;
+	case RECORD_REFERENCE:
+		return 7;
+	case RECORD_QUALIFIER_LOCATION:
+	case RECORD_LOCAL_SYMBOL:
+		return 5;
+	case RECORD_COMMENT:
+		return 4;
+	case RECORD_ERROR:
+		return 7;
+	default:
+		break;
+	}
+	return 0;
+}
+
+std::string getClassPath(const IndexerCommandJava& indexerCommand)
+{
+	std::string classPath = "";
+	for (const FilePath& path: indexerCommand.getClassPath())
+	{
+		// the separator used here should be the same as the one used in JavaIndexer.java
+		classPath += path.str() + ";";
+	}
+	return classPath;
+}
+
+std::string getFileContent(std::shared_ptr<TextAccess> textAccess)
+{
+	// remove tabs because they screw with javaparser's location resolver
+	return utility::replace(textAccess->getText(), "\t", " ");
+}
+
+int getVerbose()
+{
+	return ApplicationSettings::getInstance()->getLoggingEnabled() &&
+			ApplicationSettings::getInstance()->getVerboseIndexerLoggingEnabled()
+		? 1
+		: 0;
+}
+}	 // namespace
+
 void JavaParser::clearCaches()
 {
 	std::shared_ptr<JavaEnvironmentFactory> factory = JavaEnvironmentFactory::getInstance();
@@ -27,9 +143,67 @@ void JavaParser::clearCaches()
 	}
 }
 
+void JavaParser::buildIndex(
+	const std::vector<std::shared_ptr<IndexerCommandJava>>& indexerCommands,
+	const std::vector<std::shared_ptr<ParserClient>>& clients,
+	std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+	size_t threadCount)
+{
+	if (indexerCommands.empty() || indexerCommands.size() != clients.size())
+	{
+		return;
+	}
+
+	std::vector<std::shared_ptr<JavaParser>> parsers;
+	std::vector<int> parserIds;
+	std::vector<std::string> filePaths;
+	std::vector<std::string> fileContents;
+	std::vector<std::string> languageStandards;
+	std::vector<std::string> classPaths;
+
+	for (size_t i = 0; i < indexerCommands.size(); i++)
+	{
+		std::shared_ptr<JavaParser> parser = std::make_shared<JavaParser>(
+			clients[i], indexerStateInfo);
+		if (!parser->m_javaEnvironment)
+		{
+			return;
+		}
+
+		const FilePath& sourceFilePath = indexerCommands[i]->getSourceFilePath();
+		parser->startFile(sourceFilePath);
+
+		parserIds.push_back(parser->m_id);
+		filePaths.push_back(sourceFilePath.str());
+		fileContents.push_back(getFileContent(TextAccess::createFromFile(sourceFilePath)));
+		languageStandards.push_back(
+			utility::encodeToUtf8(indexerCommands[i]->getLanguageStandard()));
+		classPaths.push_back(getClassPath(*indexerCommands[i]));
+		parsers.push_back(parser);
+	}
+
+	// all native calls of the worker threads are relayed to this thread by the Java indexer
+	parsers.front()->m_javaEnvironment->callStaticVoidMethod(
+		"com/sourcetrail/ParallelJavaIndexer",
+		"processFiles",
+		parserIds,
+		filePaths,
+		fileContents,
+		languageStandards,
+		classPaths,
+		getVerbose(),
+		static_cast<int>(threadCount));
+}
+
 JavaParser::JavaParser(
-	std::shared_ptr<ParserClient> client, std::shared_ptr<IndexerStateInfo> indexerStateInfo)
-	: Parser(client), m_indexerStateInfo(indexerStateInfo), m_id(s_nextParserId++), m_currentFileId(0)
+	std::shared_ptr<ParserClient> client,
+	std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+	bool recordBatchingEnabled)
+	: Parser(client)
+	, m_indexerStateInfo(indexerStateInfo)
+	, m_id(s_nextParserId++)
+	, m_recordBatchingEnabled(recordBatchingEnabled)
+	, m_currentFileId(0)
 {
 	const std::string errorString = utility::prepareJavaEnvironment();
 	if (!errorString.empty())
@@ -75,8 +249,16 @@ JavaParser::JavaParser(
 		methods.push_back({"recordComment", "(IIIII)V", (void*)&JavaParser::RecordComment});
 		methods.push_back(
 			{"recordError", "(ILjava/lang/String;IIIIII)V", (void*)&JavaParser::RecordError});
+		methods.push_back(
+			{"recordBatch", "(ILjava/nio/ByteBuffer;I)V", (void*)&JavaParser::RecordBatch});
 
 		m_javaEnvironment->registerNativeMethods("com/sourcetrail/JavaIndexer", methods);
+
+		// extracted aar files and the jar index are kept across runs if there is a user data folder
+		m_javaEnvironment->callStaticVoidMethod(
+			"com/sourcetrail/JavaIndexer",
+			"setCacheDirectory",
+			UserPaths::getUserDataPath().empty() ? "" : UserPaths::getJavaCachePath().str());
 	}
 	{
 		std::lock_guard<std::mutex> lock(s_parsersMutex);
@@ -91,17 +273,10 @@ JavaParser::~JavaParser()
 
 void JavaParser::buildIndex(std::shared_ptr<IndexerCommandJava> indexerCommand)
 {
-	std::string classPath = "";
-	for (const FilePath& path: indexerCommand->getClassPath())
-	{
-		// the separator used here should be the same as the one used in JavaIndexer.java
-		classPath += path.str() + ";";
-	}
-
 	buildIndex(
 		indexerCommand->getSourceFilePath(),
 		indexerCommand->getLanguageStandard(),
-		classPath,
+		getClassPath(*indexerCommand),
 		TextAccess::createFromFile(indexerCommand->getSourceFilePath()));
 }
 
@@ -118,27 +293,49 @@ void JavaParser::buildIndex(
 {
 	if (m_javaEnvironment)
 	{
-		m_currentFilePath = sourceFilePath;
-		m_currentFileId = m_client->recordFile(sourceFilePath, true);
-		m_client->recordFileLanguage(m_currentFileId, L"java");
-
-		// remove tabs because they screw with javaparser's location resolver
-		std::string fileContent = utility::replace(textAccess->getText(), "\t", " ");
-
-		int verbose = ApplicationSettings::getInstance()->getLoggingEnabled() &&
-				ApplicationSettings::getInstance()->getVerboseIndexerLoggingEnabled()
-			? 1
-			: 0;
+		startFile(sourceFilePath);
 
 		m_javaEnvironment->callStaticVoidMethod(
 			"com/sourcetrail/JavaIndexer",
 			"processFile",
 			m_id,
 			m_currentFilePath.str(),
-			fileContent,
+			getFileContent(textAccess),
 			utility::encodeToUtf8(languageStandard),
 			classPath,
-			verbose);
+			getVerbose(),
+			m_recordBatchingEnabled ? 1 : 0);
+	}
+}
+
+void JavaParser::startFile(const FilePath& sourceFilePath)
+{
+	m_currentFilePath = sourceFilePath;
+	m_currentFileId = m_client->recordFile(sourceFilePath, true);
+	m_client->recordFileLanguage(m_currentFileId, L"java");
+
+	m_batchStrings.clear();
+	m_batchStringSymbolIds.clear();
+}
+
+void JavaParser::RecordBatch(JNIEnv* env, jobject objectOrClass, jint parserId, jobject buffer, jint size)
+{
+	std::map<int, JavaParser*>::iterator it = s_parsers.find(int(parserId));
+	if (it != s_parsers.end())
+	{
+		const char* data = static_cast<const char*>(env->GetDirectBufferAddress(buffer));
+		if (data != nullptr && size >= 0)
+		{
+			it->second->doRecordBatch(data, size_t(size));
+		}
+		else
+		{
+			LOG_ERROR("record batch of parser " + std::to_string(parserId) + " is not accessible");
+		}
+	}
+	else
+	{
+		LOG_ERROR("parser with id " + std::to_string(parserId) + " not found");
 	}
 }
 
@@ -273,10 +470,13 @@ void JavaParser::doRecordReference(
 	jint endLine,
 	jint endColumn)
 {
+	// resolve the names in a fixed order, so symbol ids do not depend on argument evaluation order
+	Id referencedSymbolId = getOrCreateSymbolId(jReferencedName);
+	Id contextSymbolId = getOrCreateSymbolId(jContextName);
 	m_client->recordReference(
 		intToReferenceKind(jReferenceKind),
-		getOrCreateSymbolId(jReferencedName),
-		getOrCreateSymbolId(jContextName),
+		referencedSymbolId,
+		contextSymbolId,
 		ParseLocation(m_currentFileId, beginLine, beginColumn, endLine, endColumn));
 }
 
@@ -326,18 +526,162 @@ void JavaParser::doRecordError(
 		ParseLocation(m_currentFileId, beginLine, beginColumn));
 }
 
+void JavaParser::doRecordBatch(const char* data, size_t size)
+{
+	RecordBatchReader reader(data, size);
+
+	while (!reader.atEnd())
+	{
+		if (!reader.canRead(1))
+		{
+			LOG_ERROR("record batch ends with incomplete record");
+			return;
+		}
+
+		const int32_t opcode = reader.readInt();
+		const size_t fieldCount = getRecordFieldCount(opcode);
+		if (fieldCount == 0 || !reader.canRead(fieldCount))
+		{
+			LOG_ERROR("record batch contains invalid record with opcode " + std::to_string(opcode));
+			return;
+		}
+
+		int32_t f[16];
+		for (size_t i = 0; i < fieldCount; i++)
+		{
+			f[i] = reader.readInt();
+		}
+
+		if (opcode == RECORD_STRING)
+		{
+			std::string str;
+			if (f[0] < 0 || !reader.readString(size_t(f[0]), str))
+			{
+				LOG_ERROR("record batch contains invalid string");
+				return;
+			}
+			m_batchStrings.emplace_back(std::move(str));
+			m_batchStringSymbolIds.push_back(0);
+			continue;
+		}
+
+		// all records reference strings that were sent before
+		const size_t stringCount = m_batchStrings.size();
+		const bool validStrings = (opcode == RECORD_COMMENT) ||
+			(opcode == RECORD_REFERENCE
+				 ? size_t(f[1]) < stringCount && size_t(f[2]) < stringCount
+				 : size_t(f[0]) < stringCount);
+		if (!validStrings)
+		{
+			LOG_ERROR("record batch references unknown string");
+			return;
+		}
+
+		switch (opcode)
+		{
+		case RECORD_SYMBOL:
+		{
+			Id symbolId = getOrCreateBatchSymbolId(f[0]);
+			m_client->recordSymbolKind(symbolId, intToSymbolKind(f[1]));
+			m_client->recordAccessKind(symbolId, intToAccessKind(f[2]));
+			m_client->recordDefinitionKind(symbolId, intToDefinitionKind(f[3]));
+			break;
+		}
+		case RECORD_SYMBOL_WITH_LOCATION:
+		case RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE:
+		case RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE:
+		{
+			Id symbolId = getOrCreateBatchSymbolId(f[0]);
+			m_client->recordSymbolKind(symbolId, intToSymbolKind(f[1]));
+			m_client->recordLocation(
+				symbolId,
+				ParseLocation(m_currentFileId, f[2], f[3], f[4], f[5]),
+				ParseLocationType::TOKEN);
+			if (opcode != RECORD_SYMBOL_WITH_LOCATION)
+			{
+				m_client->recordLocation(
+					symbolId,
+					ParseLocation(m_currentFileId, f[6], f[7], f[8], f[9]),
+					ParseLocationType::SCOPE);
+			}
+			if (opcode == RECORD_SYMBOL_WITH_LOCATION_AND_SCOPE_AND_SIGNATURE)
+			{
+				m_client->recordLocation(
+					symbolId,
+					ParseLocation(m_currentFileId, f[10], f[11], f[12], f[13]),
+					ParseLocationType::SIGNATURE);
+			}
+			m_client->recordAccessKind(symbolId, intToAccessKind(f[fieldCount - 2]));
+			m_client->recordDefinitionKind(symbolId, intToDefinitionKind(f[fieldCount - 1]));
+			break;
+		}
+		case RECORD_REFERENCE:
+		{
+			ReferenceKind referenceKind = intToReferenceKind(f[0]);
+			Id referencedSymbolId = getOrCreateBatchSymbolId(f[1]);
+			Id contextSymbolId = getOrCreateBatchSymbolId(f[2]);
+			m_client->recordReference(
+				referenceKind,
+				referencedSymbolId,
+				contextSymbolId,
+				ParseLocation(m_currentFileId, f[3], f[4], f[5], f[6]));
+			break;
+		}
+		case RECORD_QUALIFIER_LOCATION:
+			m_client->recordLocation(
+				getOrCreateBatchSymbolId(f[0]),
+				ParseLocation(m_currentFileId, f[1], f[2], f[3], f[4]),
+				ParseLocationType::QUALIFIER);
+			break;
+		case RECORD_LOCAL_SYMBOL:
+			m_client->recordLocalSymbol(
+				NameHierarchy::deserialize(utility::decodeFromUtf8(m_batchStrings[f[0]]))
+					.getQualifiedName(),
+				ParseLocation(m_currentFileId, f[1], f[2], f[3], f[4]));
+			break;
+		case RECORD_COMMENT:
+			m_client->recordComment(ParseLocation(m_currentFileId, f[0], f[1], f[2], f[3]));
+			break;
+		case RECORD_ERROR:
+			m_client->recordError(
+				utility::decodeFromUtf8(m_batchStrings[f[0]]),
+				f[1] != 0,
+				f[2] != 0,
+				FilePath(),
+				ParseLocation(m_currentFileId, f[3], f[4]));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
 Id JavaParser::getOrCreateSymbolId(jstring jSymbolName)
 {
-	std::string name = m_javaEnvironment->toStdString(jSymbolName);
+	return getOrCreateSymbolId(m_javaEnvironment->toStdString(jSymbolName));
+}
 
-	auto it = m_symbolNameToIdMap.find(name);
+Id JavaParser::getOrCreateSymbolId(const std::string& symbolName)
+{
+	auto it = m_symbolNameToIdMap.find(symbolName);
 	if (it != m_symbolNameToIdMap.end())
 	{
 		return it->second;
 	}
 
-	Id symbolId = m_client->recordSymbol(NameHierarchy::deserialize(utility::decodeFromUtf8(name)));
+	Id symbolId = m_client->recordSymbol(
+		NameHierarchy::deserialize(utility::decodeFromUtf8(symbolName)));
+
+	m_symbolNameToIdMap.emplace(symbolName, symbolId);
+	return symbolId;
+}
 
-	m_symbolNameToIdMap.emplace(name, symbolId);
+Id JavaParser::getOrCreateBatchSymbolId(size_t stringIndex)
+{
+	Id& symbolId = m_batchStringSymbolIds[stringIndex];
+	if (!symbolId)
+	{
+		symbolId = getOrCreateSymbolId(m_batchStrings[stringIndex]);
+	}
 	return symbolId;
 }
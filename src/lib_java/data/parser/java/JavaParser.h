@@ -4,6 +4,7 @@
 #include <map>
 #include <mutex>
 #include <string>
+#include <vector>
 
 #include "FilePath.h"
 #include "IndexerCommandJava.h"
@@ -36,7 +37,20 @@ class JavaParser: public Parser
 public:
 	static void clearCaches();
 
-	JavaParser(std::shared_ptr<ParserClient> client, std::shared_ptr<IndexerStateInfo> indexerStateInfo);
+	// indexes all files with a single call into the Java indexer, which processes them on
+	// threadCount worker threads of the shared JVM. Each file is recorded to its own client.
+	static void buildIndex(
+		const std::vector<std::shared_ptr<IndexerCommandJava>>& indexerCommands,
+		const std::vector<std::shared_ptr<ParserClient>>& clients,
+		std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+		size_t threadCount);
+
+	// if batching is enabled the Java indexer sends its records in binary batches instead of
+	// calling a native method for each record
+	JavaParser(
+		std::shared_ptr<ParserClient> client,
+		std::shared_ptr<IndexerStateInfo> indexerStateInfo,
+		bool recordBatchingEnabled = true);
 	~JavaParser();
 
 	void buildIndex(std::shared_ptr<IndexerCommandJava> indexerCommand);
@@ -49,6 +63,8 @@ private:
 		const std::string& classPath,
 		std::shared_ptr<TextAccess> textAccess);
 
+	void startFile(const FilePath& sourceFilePath);
+
 // This macro makes available a variable T, the passed-in t. blablabla TODO: write somethign real here
 #define MAKE_PARAMS_0()
 #define MAKE_PARAMS_1(t1) , t1 arg1
@@ -246,6 +262,9 @@ private:
 		return false;
 	}
 
+	static void RecordBatch(
+		JNIEnv* env, jobject objectOrClass, jint parserId, jobject buffer, jint size);
+
 	static int s_nextParserId;
 	static std::map<int, JavaParser*> s_parsers;
 	static std::mutex s_parsersMutex;
@@ -325,16 +344,25 @@ private:
 		jint endLine,
 		jint endColumn);
 
+	void doRecordBatch(const char* data, size_t size);
+
 	Id getOrCreateSymbolId(jstring jSymbolName);
+	Id getOrCreateSymbolId(const std::string& symbolName);
+	Id getOrCreateBatchSymbolId(size_t stringIndex);
 
 	std::shared_ptr<JavaEnvironment> m_javaEnvironment;
 	std::shared_ptr<IndexerStateInfo> m_indexerStateInfo;
 	const int m_id;
+	const bool m_recordBatchingEnabled;
 
 	FilePath m_currentFilePath;
 	Id m_currentFileId;
 
 	std::map<std::string, Id> m_symbolNameToIdMap;
+
+	// string table of the record batches of the current file, symbol ids are resolved lazily
+	std::vector<std::string> m_batchStrings;
+	std::vector<Id> m_batchStringSymbolIds;
 };
 
 #endif	  // JAVA_PARSER_H
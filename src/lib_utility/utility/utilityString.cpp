@@ -79,6 +79,37 @@ std::wstring decodeFromUtf8(const std::string& s)
 	return boost::locale::conv::utf_to_utf<wchar_t>(s.c_str(), s.c_str() + s.size());
 }
 
+size_t getUtf8ByteSize(const std::wstring& s)
+{
+	size_t byteSize = 0;
+	for (wchar_t c: s)
+	{
+		const unsigned long codePoint = static_cast<unsigned long>(c);
+		if (codePoint < 0x80)
+		{
+			byteSize += 1;
+		}
+		else if (codePoint < 0x800)
+		{
+			byteSize += 2;
+		}
+		else if (codePoint >= 0xD800 && codePoint <= 0xDFFF)
+		{
+			// half of a surrogate pair
+			byteSize += 2;
+		}
+		else if (codePoint < 0x10000)
+		{
+			byteSize += 3;
+		}
+		else
+		{
+			byteSize += 4;
+		}
+	}
+	return byteSize;
+}
+
 std::deque<std::string> split(const std::string& str, char delimiter)
 {
 	return split<std::deque<std::string>>(str, std::string(1, delimiter));
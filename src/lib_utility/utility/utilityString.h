@@ -11,6 +11,8 @@ namespace utility
 {
 std::string encodeToUtf8(const std::wstring& s);
 std::wstring decodeFromUtf8(const std::string& s);
+// never less than the size of encodeToUtf8(s)
+size_t getUtf8ByteSize(const std::wstring& s);
 
 template <typename ContainerType>
 ContainerType split(const std::string& str, const std::string& delimiter);
@@ -0,0 +1,238 @@
+#include "catch.hpp"
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+
+#	include <fstream>
+#	include <iostream>
+
+#	include <clang/Tooling/JSONCompilationDatabase.h>
+
+#	include "CompilationDatabaseLoader.h"
+#	include "FileSystem.h"
+#	include "TimeStamp.h"
+#	include "utilityString.h"
+
+namespace
+{
+FilePath getDataDirectoryPath()
+{
+	return FilePath(L"data/CxxCompilationDatabaseLoaderTestSuite").makeAbsolute();
+}
+
+void writeFile(const FilePath& filePath, const std::string& content)
+{
+	FileSystem::createDirectory(filePath.getParentDirectory());
+	std::ofstream file;
+	file.open(filePath.str(), std::ios::out | std::ios::trunc);
+	file << content;
+	file.close();
+}
+
+std::string generateCompilationDatabase(size_t commandCount)
+{
+	const std::string directory = getDataDirectoryPath().str();
+
+	std::string content = "[\n";
+	for (size_t i = 0; i < commandCount; i++)
+	{
+		const std::string fileName = "src/file_" + std::to_string(i) + ".cpp";
+		content += i ? ",\n" : "";
+		content += "\t{\n\t\t\"directory\": \"" + directory + "\",\n";
+		if (i % 2)
+		{
+			content += "\t\t\"arguments\": [\"clang++\", \"-Iinclude/" + std::to_string(i % 10) +
+				"\", \"-DNAME=\\\"value\\\"\", \"-c\", \"" + fileName + "\"],\n";
+		}
+		else
+		{
+			content += "\t\t\"command\": \"ccache clang++ -Iinclude/" + std::to_string(i % 10) +
+				" -DNAME=\\\"a b\\\" -std=c++17 -c " + fileName + "\",\n";
+		}
+		content += "\t\t\"file\": \"" + fileName + "\",\n\t\t\"output\": \"" + fileName + ".o\"\n\t}";
+	}
+	content += "\n]\n";
+	return content;
+}
+}	 // namespace
+
+TEST_CASE("compilation database loader loads same commands as clang")
+{
+	const FilePath cdbPath = getDataDirectoryPath().concatenate(L"compile_commands.json");
+	writeFile(cdbPath, generateCompilationDatabase(500));
+
+	std::string error;
+	std::unique_ptr<clang::tooling::JSONCompilationDatabase> clangCdb =
+		clang::tooling::JSONCompilationDatabase::loadFromFile(
+			cdbPath.str(), error, clang::tooling::JSONCommandLineSyntax::AutoDetect);
+	REQUIRE(clangCdb);
+
+	utility::CompilationDatabaseLoader cdb(cdbPath);
+	REQUIRE(cdb.load());
+	REQUIRE(cdb.getError().empty());
+
+	const std::vector<clang::tooling::CompileCommand> clangCommands =
+		clangCdb->getAllCompileCommands();
+	REQUIRE(clangCommands.size() == cdb.getCommands().size());
+
+	for (size_t i = 0; i < clangCommands.size(); i++)
+	{
+		const utility::CompilationDatabaseCommand& command = cdb.getCommands()[i];
+		REQUIRE(clangCommands[i].Directory == command.directory);
+		REQUIRE(clangCommands[i].Filename == command.filename);
+		REQUIRE(clangCommands[i].CommandLine == *command.commandLine);
+		REQUIRE(
+			getDataDirectoryPath().concatenate(utility::decodeFromUtf8(command.filename)) ==
+			command.sourceFilePath);
+	}
+
+	FileSystem::remove(cdbPath);
+}
+
+TEST_CASE("compilation database loader drops duplicate commands and shares command lines")
+{
+	const FilePath cdbPath = getDataDirectoryPath().concatenate(L"compile_commands.json");
+	writeFile(
+		cdbPath,
+		"[\n"
+		"{\"directory\": \"/d\", \"command\": \"clang -c a.cpp\", \"file\": \"a.cpp\"},\n"
+		"{\"directory\": \"/d\", \"arguments\": [\"clang\", \"-c\", \"a.cpp\"], \"file\": "
+		"\"a.cpp\"},\n"
+		"{\"directory\": \"/d\", \"command\": \"clang -c a.cpp\", \"file\": \"./a.cpp\"}\n"
+		"]");
+
+	utility::CompilationDatabaseLoader cdb(cdbPath);
+	REQUIRE(cdb.load());
+
+	REQUIRE(cdb.getCommands().size() == 2);
+	REQUIRE(cdb.getDroppedDuplicateCount() == 1);
+	REQUIRE(cdb.getCommands()[0].commandLine == cdb.getCommands()[1].commandLine);
+
+	FileSystem::remove(cdbPath);
+}
+
+TEST_CASE("compilation database loader reuses cache while database is unchanged")
+{
+	const FilePath cdbPath = getDataDirectoryPath().concatenate(L"compile_commands.json");
+	const FilePath cachePath = getDataDirectoryPath().concatenate(L"cache/compile_commands.cache");
+	FileSystem::remove(cachePath);
+	writeFile(cdbPath, generateCompilationDatabase(100));
+
+	utility::CompilationDatabaseLoader firstCdb(cdbPath, cachePath);
+	REQUIRE(firstCdb.load());
+	REQUIRE(!firstCdb.isLoadedFromCache());
+	REQUIRE(cachePath.recheckExists());
+
+	utility::CompilationDatabaseLoader secondCdb(cdbPath, cachePath);
+	REQUIRE(secondCdb.load());
+	REQUIRE(secondCdb.isLoadedFromCache());
+	REQUIRE(firstCdb.getCommands().size() == secondCdb.getCommands().size());
+	for (size_t i = 0; i < firstCdb.getCommands().size(); i++)
+	{
+		const utility::CompilationDatabaseCommand& first = firstCdb.getCommands()[i];
+		const utility::CompilationDatabaseCommand& second = secondCdb.getCommands()[i];
+		REQUIRE(first.directory == second.directory);
+		REQUIRE(first.filename == second.filename);
+		REQUIRE(*first.commandLine == *second.commandLine);
+		REQUIRE(first.sourceFilePath == second.sourceFilePath);
+	}
+
+	writeFile(cdbPath, generateCompilationDatabase(101));
+
+	utility::CompilationDatabaseLoader thirdCdb(cdbPath, cachePath);
+	REQUIRE(thirdCdb.load());
+	REQUIRE(!thirdCdb.isLoadedFromCache());
+	REQUIRE(thirdCdb.getCommands().size() == 101);
+
+	FileSystem::remove(cachePath);
+	FileSystem::remove(cdbPath);
+}
+
+TEST_CASE("compilation database loader ignores cache with damaged count")
+{
+	const FilePath cdbPath = getDataDirectoryPath().concatenate(L"compile_commands.json");
+	const FilePath cachePath = getDataDirectoryPath().concatenate(L"cache/compile_commands.cache");
+	FileSystem::remove(cachePath);
+	writeFile(cdbPath, generateCompilationDatabase(100));
+
+	utility::CompilationDatabaseLoader firstCdb(cdbPath, cachePath);
+	REQUIRE(firstCdb.load());
+	REQUIRE(cachePath.recheckExists());
+
+	// the command line count follows the magic, the version, the hash and the duplicate count
+	{
+		std::fstream file(cachePath.str(), std::ios::in | std::ios::out | std::ios::binary);
+		file.seekp(8 + 9 + 4 + 8 + 8);
+		const unsigned long long commandLineCount = 1ull << 60;
+		file.write(reinterpret_cast<const char*>(&commandLineCount), sizeof(commandLineCount));
+	}
+
+	utility::CompilationDatabaseLoader secondCdb(cdbPath, cachePath);
+	REQUIRE(secondCdb.load());
+	REQUIRE(!secondCdb.isLoadedFromCache());
+	REQUIRE(secondCdb.getCommands().size() == 100);
+
+	// the cache is written again after loading the database directly
+	utility::CompilationDatabaseLoader thirdCdb(cdbPath, cachePath);
+	REQUIRE(thirdCdb.load());
+	REQUIRE(thirdCdb.isLoadedFromCache());
+	REQUIRE(thirdCdb.getCommands().size() == 100);
+
+	FileSystem::remove(cachePath);
+	FileSystem::remove(cdbPath);
+}
+
+TEST_CASE("compilation database loader reports error for invalid database")
+{
+	const FilePath cdbPath = getDataDirectoryPath().concatenate(L"compile_commands.json");
+	writeFile(cdbPath, "[{\"directory\": \"/d\", \"command\": \"clang -c a.cpp\"}]");
+
+	utility::CompilationDatabaseLoader cdb(cdbPath);
+	REQUIRE(!cdb.load());
+	REQUIRE(!cdb.getError().empty());
+	REQUIRE(cdb.getCommands().empty());
+
+	FileSystem::remove(cdbPath);
+}
+
+TEST_CASE("compilation database loader benchmark of large database", "[.benchmark]")
+{
+	const size_t commandCount = 100000;
+	const FilePath cdbPath = getDataDirectoryPath().concatenate(L"compile_commands.json");
+	const FilePath cachePath = getDataDirectoryPath().concatenate(L"cache/compile_commands.cache");
+	FileSystem::remove(cachePath);
+	writeFile(cdbPath, generateCompilationDatabase(commandCount));
+
+	{
+		const TimeStamp start = TimeStamp::now();
+		std::string error;
+		std::unique_ptr<clang::tooling::JSONCompilationDatabase> clangCdb =
+			clang::tooling::JSONCompilationDatabase::loadFromFile(
+				cdbPath.str(), error, clang::tooling::JSONCommandLineSyntax::AutoDetect);
+		REQUIRE(clangCdb->getAllCompileCommands().size() == commandCount);
+		std::cout << "clang json loader: " << TimeStamp::durationSeconds(start) << "s" << std::endl;
+	}
+
+	{
+		const TimeStamp start = TimeStamp::now();
+		utility::CompilationDatabaseLoader cdb(cdbPath, cachePath);
+		REQUIRE(cdb.load());
+		REQUIRE(cdb.getCommands().size() == commandCount);
+		std::cout << "loader without cache: " << TimeStamp::durationSeconds(start) << "s"
+				  << std::endl;
+	}
+
+	{
+		const TimeStamp start = TimeStamp::now();
+		utility::CompilationDatabaseLoader cdb(cdbPath, cachePath);
+		REQUIRE(cdb.load());
+		REQUIRE(cdb.isLoadedFromCache());
+		std::cout << "loader with cache: " << TimeStamp::durationSeconds(start) << "s" << std::endl;
+	}
+
+	FileSystem::remove(cachePath);
+	FileSystem::remove(cdbPath);
+}
+
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
@@ -4,6 +4,8 @@
 
 #if BUILD_CXX_LANGUAGE_PACKAGE
 
+#	include <atomic>
+
 #	include "IncludeDirective.h"
 #	include "IncludeProcessing.h"
 #	include "TextAccess.h"
@@ -176,4 +178,89 @@ TEST_CASE("header search path detection finds path included in future header sea
 			.makeAbsolute()));
 }
 
+TEST_CASE("unresolved include detection follows includes of indexed files")
+{
+	const FilePath projectPath = FilePath(
+		L"data/CxxIncludeProcessingTestSuite/"
+		L"test_unresolved_include_detection_follows_includes_of_indexed_files")
+									 .makeAbsolute();
+
+	const std::vector<IncludeDirective> unresolvedIncludeDirectives =
+		IncludeProcessing::getUnresolvedIncludeDirectives(
+			{projectPath.getConcatenated(L"a.cpp"), projectPath.getConcatenated(L"e.cpp")},
+			{projectPath.getConcatenated(L"include")},
+			{},
+			1,
+			[](float) {});
+
+	REQUIRE(unresolvedIncludeDirectives.size() == 3);
+	REQUIRE(L"missing_a.h" == unresolvedIncludeDirectives[0].getIncludedFile().wstr());
+	REQUIRE(
+		projectPath.getConcatenated(L"a.cpp").wstr() ==
+		unresolvedIncludeDirectives[0].getIncludingFile().wstr());
+	REQUIRE(L"missing_b.h" == unresolvedIncludeDirectives[1].getIncludedFile().wstr());
+	REQUIRE(2 == unresolvedIncludeDirectives[1].getLineNumber());
+	REQUIRE(L"missing_c.h" == unresolvedIncludeDirectives[2].getIncludedFile().wstr());
+	REQUIRE(
+		projectPath.getConcatenated(L"include/c.h").wstr() ==
+		unresolvedIncludeDirectives[2].getIncludingFile().wstr());
+}
+
+TEST_CASE("unresolved include detection returns same result for every quantile count")
+{
+	const FilePath projectPath = FilePath(
+		L"data/CxxIncludeProcessingTestSuite/"
+		L"test_unresolved_include_detection_follows_includes_of_indexed_files")
+									 .makeAbsolute();
+
+	const std::vector<IncludeDirective> expectedDirectives =
+		IncludeProcessing::getUnresolvedIncludeDirectives(
+			{projectPath.getConcatenated(L"a.cpp"), projectPath.getConcatenated(L"e.cpp")},
+			{projectPath.getConcatenated(L"include")},
+			{},
+			1,
+			[](float) {});
+
+	for (size_t quantileCount = 2; quantileCount < 4; quantileCount++)
+	{
+		const std::vector<IncludeDirective> directives =
+			IncludeProcessing::getUnresolvedIncludeDirectives(
+				{projectPath.getConcatenated(L"a.cpp"), projectPath.getConcatenated(L"e.cpp")},
+				{projectPath.getConcatenated(L"include")},
+				{},
+				quantileCount,
+				[](float) {});
+
+		REQUIRE(expectedDirectives.size() == directives.size());
+		for (size_t i = 0; i < directives.size(); i++)
+		{
+			REQUIRE(
+				expectedDirectives[i].getIncludedFile().wstr() ==
+				directives[i].getIncludedFile().wstr());
+			REQUIRE(
+				expectedDirectives[i].getIncludingFile().wstr() ==
+				directives[i].getIncludingFile().wstr());
+			REQUIRE(expectedDirectives[i].getLineNumber() == directives[i].getLineNumber());
+		}
+	}
+}
+
+TEST_CASE("unresolved include detection stops when canceled")
+{
+	const FilePath projectPath = FilePath(
+		L"data/CxxIncludeProcessingTestSuite/"
+		L"test_unresolved_include_detection_follows_includes_of_indexed_files")
+									 .makeAbsolute();
+
+	std::atomic<bool> canceled(true);
+	REQUIRE(IncludeProcessing::getUnresolvedIncludeDirectives(
+				{projectPath.getConcatenated(L"a.cpp")},
+				{projectPath.getConcatenated(L"include")},
+				{},
+				1,
+				[](float) {},
+				[&canceled]() { return canceled.load(); })
+				.empty());
+}
+
 #endif	  // BUILD_CXX_LANGUAGE_PACKAGE
@@ -5,6 +5,7 @@
 #if BUILD_CXX_LANGUAGE_PACKAGE
 
 #	include "TextAccess.h"
+#	include "TimeStamp.h"
 #	include "utility.h"
 #	include "utilityString.h"
 
@@ -18,13 +19,17 @@
 
 namespace
 {
-std::shared_ptr<TestStorage> parseCode(std::string code, std::vector<std::wstring> compilerFlags = {})
+std::shared_ptr<TestStorage> parseCode(
+	std::string code, std::vector<std::wstring> compilerFlags = {}, bool lowMemoryMode = false)
 {
+	std::shared_ptr<IndexerStateInfo> indexerStateInfo = std::make_shared<IndexerStateInfo>();
+	indexerStateInfo->lowMemoryMode = lowMemoryMode;
+
 	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
 	CxxParser parser(
 		std::make_shared<ParserClientImpl>(storage.get()),
 		std::make_shared<TestFileRegister>(),
-		std::make_shared<IndexerStateInfo>());
+		indexerStateInfo);
 	parser.buildIndex(
 		L"input.cc",
 		TextAccess::createFromString(code),
@@ -1159,6 +1164,27 @@ TEST_CASE("cxx parser finds function for implicit instantiation of template func
 		client->functions, L"int test<int>(int) <2:1 <2:1 <2:3 2:6> 2:11> 5:1>"));
 }
 
+TEST_CASE("cxx parser skips implicit instantiation of template function in low memory mode")
+{
+	std::shared_ptr<TestStorage> client = parseCode(
+		"template <typename T>\n"
+		"T test(T a)\n"
+		"{\n"
+		"	return a;\n"
+		"};\n"
+		"\n"
+		"int main()\n"
+		"{\n"
+		"	return test(1);\n"
+		"};\n",
+		{},
+		true);
+
+	REQUIRE(/*NOT!*/ !utility::containsElement<std::wstring>(
+		client->functions, L"int test<int>(int) <2:1 <2:1 <2:3 2:6> 2:11> 5:1>"));
+	REQUIRE(!client->functions.empty());
+}
+
 TEST_CASE(
 	"cxx parser skips implicit template method definition of implicit template class instantiation")
 {
@@ -4216,6 +4242,69 @@ TEST_CASE("cxx parser finds location of block comment")
 	REQUIRE(utility::containsElement<std::wstring>(client->comments, L"comment <1:1 2:17>"));
 }
 
+TEST_CASE("cxx parser reuses symbol ids of names that were recorded before")
+{
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	std::shared_ptr<ParserClientImpl> parserClient = std::make_shared<ParserClientImpl>(
+		storage.get());
+	CxxParser parser(
+		parserClient, std::make_shared<TestFileRegister>(), std::make_shared<IndexerStateInfo>());
+	parser.buildIndex(
+		L"input.cc",
+		TextAccess::createFromString(
+			"template <typename T>\n"
+			"class A\n"
+			"{\n"
+			"	A(): foo() {}\n"
+			"	T foo;\n"
+			"	A<T> bar(A<T> a) { return a; }\n"
+			"};\n"
+			"A<int> a;\n"),
+		std::vector<std::wstring>(1, L"-std=c++1z"));
+
+	std::shared_ptr<TestStorage> client = TestStorage::create(storage);
+
+	REQUIRE(utility::containsElement<std::wstring>(
+		client->usages, L"void A<typename T>::A<T>() -> T A<typename T>::foo <4:7 4:9>"));
+	REQUIRE(parserClient->getSymbolCacheHitCount() > 0);
+}
+
+TEST_CASE("cxx parser benchmark of template heavy code", "[.benchmark]")
+{
+	std::string code;
+	for (int i = 0; i < 50; i++)
+	{
+		const std::string className = "C" + std::to_string(i);
+		code += "template <typename T, typename U, int N>\nclass " + className + "\n{\npublic:\n";
+		for (int j = 0; j < 20; j++)
+		{
+			const std::string methodName = "m" + std::to_string(j);
+			code += "	" + className + "<T, U, N> " + methodName + "(const " + className +
+				"<T, U, N>& other) { return other." + (j ? "m" + std::to_string(j - 1) : methodName) +
+				"(other); }\n";
+		}
+		code += "};\n" + className + "<int, float, 1> v" + std::to_string(i) + ";\n";
+	}
+
+	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+	std::shared_ptr<ParserClientImpl> parserClient = std::make_shared<ParserClientImpl>(
+		storage.get());
+	CxxParser parser(
+		parserClient, std::make_shared<TestFileRegister>(), std::make_shared<IndexerStateInfo>());
+
+	const TimeStamp start = TimeStamp::now();
+	parser.buildIndex(
+		L"input.cc",
+		TextAccess::createFromString(code),
+		std::vector<std::wstring>(1, L"-std=c++1z"));
+
+	std::cout << "parsing template heavy code took " << TimeStamp::durationSeconds(start)
+			  << "s, symbol cache hits: " << parserClient->getSymbolCacheHitCount()
+			  << ", misses: " << parserClient->getSymbolCacheMissCount() << std::endl;
+
+	REQUIRE(parserClient->getSymbolCacheHitCount() > 0);
+}
+
 void _test_TEST()
 {
 	std::shared_ptr<TestStorage> client = parseCode(
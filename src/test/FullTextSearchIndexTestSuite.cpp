@@ -0,0 +1,335 @@
+#include "catch.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+#include <regex>
+#include <sstream>
+
+#include "FileSystem.h"
+#include "FullTextSearchIndex.h"
+#include "SuffixArray.h"
+#include "TrigramQuery.h"
+
+namespace
+{
+const FilePath s_indexFilePath(L"data/FullTextSearchIndexTestSuite/index_fulltext");
+
+std::map<Id, std::wstring> getFileTexts()
+{
+	return {
+		{1, L"int main()\n{\n\treturn foo(0);\n}\n"},
+		{2, L"int foo(int i)\n{\n\treturn i + Foo::bar;\n}\n"},
+		{3, L"struct Foo\n{\n\tstatic const int bar = 4;\n};\n"},
+		{4, L""}};
+}
+
+std::vector<FullTextSearchFileInfo> getFileInfos(const std::map<Id, std::wstring>& fileTexts)
+{
+	std::vector<FullTextSearchFileInfo> fileInfos;
+	for (const auto& it: fileTexts)
+	{
+		fileInfos.emplace_back(it.first, "2020-01-01 10:00:00");
+	}
+	return fileInfos;
+}
+
+std::map<Id, std::vector<int>> search(const FullTextSearchIndex& index, const std::wstring& term)
+{
+	std::map<Id, std::vector<int>> positions;
+	for (const FullTextSearchResult& result: index.searchForTerm(term))
+	{
+		positions[result.fileId] = result.positions;
+	}
+	return positions;
+}
+
+// returns the ids of the files with a line matching the regular expression
+std::vector<Id> searchLines(const std::map<Id, std::wstring>& fileTexts, const std::wregex& regex)
+{
+	std::vector<Id> fileIds;
+	for (const auto& it: fileTexts)
+	{
+		std::wistringstream stream(it.second);
+		std::wstring line;
+		while (std::getline(stream, line))
+		{
+			if (std::regex_search(line, regex))
+			{
+				fileIds.push_back(it.first);
+				break;
+			}
+		}
+	}
+	return fileIds;
+}
+
+// returns the positions of the term in the text by comparing it case-insensitively at each position
+std::vector<int> scanText(const std::wstring& text, const std::wstring& term)
+{
+	std::wstring lowerText = text;
+	std::transform(lowerText.begin(), lowerText.end(), lowerText.begin(), ::towlower);
+	std::wstring lowerTerm = term;
+	std::transform(lowerTerm.begin(), lowerTerm.end(), lowerTerm.begin(), ::towlower);
+
+	std::vector<int> positions;
+	for (size_t i = 0; i < lowerText.size(); i++)
+	{
+		if (lowerText.compare(i, lowerTerm.size(), lowerTerm) == 0)
+		{
+			positions.push_back(static_cast<int>(i));
+		}
+	}
+	return positions;
+}
+}	 // namespace
+
+TEST_CASE("fulltext search index file finds the same positions as index in memory")
+{
+	const std::map<Id, std::wstring> fileTexts = getFileTexts();
+
+	FullTextSearchIndex memoryIndex;
+	for (const auto& it: fileTexts)
+	{
+		memoryIndex.addFile(it.first, it.second);
+	}
+
+	FullTextSearchIndex fileIndex;
+	REQUIRE(fileIndex.updateFile(
+		s_indexFilePath, "UTF-8", getFileInfos(fileTexts), [&fileTexts](Id fileId) {
+			return fileTexts.at(fileId);
+		}));
+	REQUIRE(fileIndex.fileCount() == fileTexts.size());
+
+	for (const std::wstring& term: {L"foo", L"FOO", L"bar", L"int", L"\n", L"x", L"return i + "})
+	{
+		REQUIRE(search(fileIndex, term) == search(memoryIndex, term));
+	}
+
+	REQUIRE(search(fileIndex, L"foo").size() == 3);
+	REQUIRE(search(fileIndex, L"foo")[2] == std::vector<int>({4, 29}));
+
+	FileSystem::remove(s_indexFilePath);
+}
+
+TEST_CASE("fulltext search index file is loaded if it is up to date")
+{
+	const std::map<Id, std::wstring> fileTexts = getFileTexts();
+	std::vector<FullTextSearchFileInfo> fileInfos = getFileInfos(fileTexts);
+	{
+		FullTextSearchIndex index;
+		REQUIRE(index.updateFile(s_indexFilePath, "UTF-8", fileInfos, [&fileTexts](Id fileId) {
+			return fileTexts.at(fileId);
+		}));
+	}
+
+	FullTextSearchIndex index;
+	REQUIRE(!index.loadFile(s_indexFilePath, "ISO 8859-1"));
+	REQUIRE(index.fileCount() == 0);
+
+	REQUIRE(index.loadFile(s_indexFilePath, "UTF-8"));
+	REQUIRE(index.isUpToDate(fileInfos));
+	REQUIRE(search(index, L"foo").size() == 3);
+
+	fileInfos[1].modificationTime = "2020-01-02 10:00:00";
+	REQUIRE(!index.isUpToDate(fileInfos));
+
+	fileInfos.pop_back();
+	REQUIRE(index.isUpToDate(getFileInfos(fileTexts)));
+	REQUIRE(!index.isUpToDate(fileInfos));
+
+	FileSystem::remove(s_indexFilePath);
+}
+
+TEST_CASE("fulltext search index file update only indexes changed files")
+{
+	std::map<Id, std::wstring> fileTexts = getFileTexts();
+	std::vector<FullTextSearchFileInfo> fileInfos = getFileInfos(fileTexts);
+
+	std::vector<Id> indexedFileIds;
+	std::mutex indexedFileIdsMutex;
+	const auto getFileText = [&](Id fileId) {
+		std::lock_guard<std::mutex> lock(indexedFileIdsMutex);
+		indexedFileIds.push_back(fileId);
+		return fileTexts.at(fileId);
+	};
+
+	FullTextSearchIndex index;
+	REQUIRE(index.updateFile(s_indexFilePath, "UTF-8", fileInfos, getFileText));
+	REQUIRE(indexedFileIds.size() == fileTexts.size());
+
+	// file 2 changed, file 3 got removed and file 5 added
+	indexedFileIds.clear();
+	fileTexts[2] = L"int foo(int i)\n{\n\treturn i;\n}\n";
+	fileInfos[1].modificationTime = "2020-01-02 10:00:00";
+	fileTexts[5] = L"#include \"foo.h\"\n";
+	fileInfos.emplace_back(5, "2020-01-02 10:00:00");
+	fileTexts.erase(3);
+	fileInfos.erase(fileInfos.begin() + 2);
+
+	REQUIRE(index.updateFile(s_indexFilePath, "UTF-8", fileInfos, getFileText));
+	std::sort(indexedFileIds.begin(), indexedFileIds.end());
+	REQUIRE(indexedFileIds == std::vector<Id>({2, 5}));
+	REQUIRE(index.isUpToDate(fileInfos));
+
+	FullTextSearchIndex memoryIndex;
+	for (const auto& it: fileTexts)
+	{
+		memoryIndex.addFile(it.first, it.second);
+	}
+	for (const std::wstring& term: {L"foo", L"bar", L"int", L"i"})
+	{
+		REQUIRE(search(index, term) == search(memoryIndex, term));
+	}
+
+	FileSystem::remove(s_indexFilePath);
+}
+
+TEST_CASE("suffix array finds the same positions as scanning the text")
+{
+	// texts with single byte, two byte and four byte characters and lengths that make suffix array
+	// entries cross the boundaries of the words they are packed into
+	std::vector<std::wstring> texts = {
+		L"",
+		L"a",
+		L"Stra\u00dfe STRASSE stra\u00dfe",
+		L"\u041f\u0440\u0438\u0432\u0435\u0442 \u043f\u0440\u0438\u0432\u0435\u0442 foo",
+		L"emoji \U0001F600 and \U0001F600 again"};
+	for (size_t length: {63, 64, 65, 129, 1000, 5000})
+	{
+		std::wstring text;
+		for (size_t i = 0; text.size() < length; i++)
+		{
+			text += (i % 3 ? L"abra" : L"CADabra") + std::to_wstring(i % 7);
+		}
+		texts.push_back(text.substr(0, length));
+	}
+
+	for (const std::wstring& text: texts)
+	{
+		const SuffixArray array(text);
+		for (const std::wstring& term:
+			 {L"",
+			  L"a",
+			  L"abra",
+			  L"cadabra1",
+			  L"abra6ab",
+			  L"z",
+			  L"stra\u00dfe",
+			  L"\u043f\u0440\u0438",
+			  L"\U0001F600",
+			  L"\U0001F600 again"})
+		{
+			REQUIRE(array.searchForTerm(term) == scanText(text, term));
+		}
+	}
+
+	std::map<Id, std::wstring> fileTexts;
+	for (size_t i = 0; i < texts.size(); i++)
+	{
+		fileTexts[i + 1] = texts[i];
+	}
+
+	FullTextSearchIndex fileIndex;
+	REQUIRE(fileIndex.updateFile(
+		s_indexFilePath, "UTF-8", getFileInfos(fileTexts), [&fileTexts](Id fileId) {
+			return fileTexts.at(fileId);
+		}));
+	for (const std::wstring& term:
+		 {L"abra", L"stra\u00dfe", L"\u043f\u0440\u0438", L"\U0001F600"})
+	{
+		std::map<Id, std::vector<int>> positions;
+		for (const auto& it: fileTexts)
+		{
+			const std::vector<int> filePositions = scanText(it.second, term);
+			if (!filePositions.empty())
+			{
+				positions[it.first] = filePositions;
+			}
+		}
+		REQUIRE(!positions.empty());
+		REQUIRE(search(fileIndex, term) == positions);
+	}
+
+	FileSystem::remove(s_indexFilePath);
+}
+
+TEST_CASE("trigram query requires trigrams of literals in regular expression")
+{
+	REQUIRE(TrigramQuery::fromRegex(L"FooBar").toString() == L"bar foo oba oob");
+	REQUIRE(TrigramQuery::fromRegex(L"foo.*bar").toString() == L"bar foo");
+	REQUIRE(TrigramQuery::fromRegex(L"foo\\d+bar").toString() == L"bar foo");
+	REQUIRE(TrigramQuery::fromRegex(L"[Hh]ello").toString() == L"ell hel llo");
+	REQUIRE(TrigramQuery::fromRegex(L"(foo)+").toString() == L"foo");
+	REQUIRE(TrigramQuery::fromRegex(L"\\bint\\b").toString() == L"int");
+	REQUIRE(
+		TrigramQuery::fromRegex(L"(abc|def)gh").toString() == L"(abc bcg cgh)|(def efg fgh)");
+	REQUIRE(
+		TrigramQuery::fromRegex(L"get(Foo|Bar)?Id").toString() ==
+		L"(ari bar etb get rid tba)|(etf foo get oid ooi tfo)|(eti get tid)");
+}
+
+TEST_CASE("trigram query matches everything if regular expression has no required trigrams")
+{
+	REQUIRE(TrigramQuery::fromRegex(L"").toString() == L"*");
+	REQUIRE(TrigramQuery::fromRegex(L"a.b").toString() == L"*");
+	REQUIRE(TrigramQuery::fromRegex(L"\\w+").toString() == L"*");
+	REQUIRE(TrigramQuery::fromRegex(L"[^abc]xyz").toString() == L"xyz");
+	REQUIRE(TrigramQuery::fromRegex(L"foo|.").toString() == L"*");
+	REQUIRE(TrigramQuery::fromRegex(L"(foo){0,2}").toString() == L"*");
+	REQUIRE(TrigramQuery::fromRegex(L"x?yz").toString() == L"*");
+}
+
+TEST_CASE("fulltext search index finds all files matching regular expression")
+{
+	std::map<Id, std::wstring> fileTexts = getFileTexts();
+	fileTexts[5] = L"class FooBar\n{\n\tint getFooId() const;\n};\n";
+	fileTexts[6] = L"int get_foo_id();\nvoid set(const Foo& foo);\n";
+
+	FullTextSearchIndex memoryIndex;
+	for (const auto& it: fileTexts)
+	{
+		memoryIndex.addFile(it.first, it.second);
+	}
+
+	FullTextSearchIndex fileIndex;
+	REQUIRE(fileIndex.updateFile(
+		s_indexFilePath, "UTF-8", getFileInfos(fileTexts), [&fileTexts](Id fileId) {
+			return fileTexts.at(fileId);
+		}));
+
+	for (const std::wstring& regex:
+		 {L"foo",
+		  L"Foo::\\w+",
+		  L"get_?foo_?id",
+		  L"^int \\w+\\(",
+		  L"(static|const) int",
+		  L"\\bbar\\b",
+		  L"[Ff]oo(Bar)?",
+		  L"return [a-z]+;",
+		  L"x{2}",
+		  L"\\}"})
+	{
+		const std::wregex pattern(regex, std::regex::ECMAScript | std::regex::icase);
+		const std::vector<Id> matchingFileIds = searchLines(fileTexts, pattern);
+
+		for (const FullTextSearchIndex* index: {&memoryIndex, &fileIndex})
+		{
+			std::vector<Id> fileIds = index->getFilesForTrigramQuery(
+				TrigramQuery::fromRegex(regex));
+			std::sort(fileIds.begin(), fileIds.end());
+			REQUIRE(std::includes(
+				fileIds.begin(), fileIds.end(), matchingFileIds.begin(), matchingFileIds.end()));
+		}
+	}
+
+	REQUIRE(
+		fileIndex.getFilesForTrigramQuery(TrigramQuery::fromRegex(L"get_?foo_?id")) ==
+		std::vector<Id>({5, 6}));
+	REQUIRE(
+		memoryIndex.getFilesForTrigramQuery(TrigramQuery::fromRegex(L"(static|const) int")) ==
+		std::vector<Id>({3}));
+	REQUIRE(fileIndex.getFilesForTrigramQuery(TrigramQuery::fromRegex(L"x{2}")).size() == 6);
+
+	FileSystem::remove(s_indexFilePath);
+}
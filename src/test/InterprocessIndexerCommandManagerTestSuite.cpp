@@ -0,0 +1,115 @@
+#include "catch.hpp"
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+
+#	include <fstream>
+#	include <memory>
+
+#	include "FileSystem.h"
+#	include "IndexerCommandCxx.h"
+#	include "InterprocessIndexerCommandManager.h"
+#	include "utility.h"
+
+namespace
+{
+std::shared_ptr<IndexerCommand> createIndexerCommand(const FilePath& sourceFilePath)
+{
+	return std::make_shared<IndexerCommandCxx>(
+		sourceFilePath,
+		std::set<FilePath>(),
+		std::set<FilePathFilter>(),
+		std::set<FilePathFilter>(),
+		FilePath(),
+		std::vector<std::wstring>({L"-std=c++17"}));
+}
+
+// source files that do not exist are treated as empty
+std::vector<std::shared_ptr<IndexerCommand>> createIndexerCommands(size_t count)
+{
+	std::vector<std::shared_ptr<IndexerCommand>> indexerCommands;
+	for (size_t i = 0; i < count; i++)
+	{
+		indexerCommands.push_back(
+			createIndexerCommand(FilePath(L"data/tiny_" + std::to_wstring(i) + L".cpp")));
+	}
+	return indexerCommands;
+}
+
+void writeFile(const FilePath& filePath, size_t byteSize)
+{
+	FileSystem::createDirectory(filePath.getParentDirectory());
+	std::ofstream file;
+	file.open(filePath.str(), std::ios::out | std::ios::trunc);
+	file << std::string(byteSize, ' ');
+	file.close();
+}
+}	 // namespace
+
+TEST_CASE("interprocess indexer command manager fetches small source files together")
+{
+	const FilePath largeFilePath(L"data/InterprocessIndexerCommandManagerTestSuite/large.cpp");
+	writeFile(largeFilePath, 100000);
+
+	InterprocessIndexerCommandManager mainManager("command_manager_test", 0, true);
+	InterprocessIndexerCommandManager indexerManager("command_manager_test", 1, false);
+
+	std::vector<std::shared_ptr<IndexerCommand>> indexerCommands = {
+		createIndexerCommand(largeFilePath)};
+	utility::append(indexerCommands, createIndexerCommands(20));
+	mainManager.pushIndexerCommands(indexerCommands);
+
+	std::vector<std::shared_ptr<IndexerCommand>> fetchedCommands =
+		indexerManager.fetchIndexerCommands();
+	REQUIRE(fetchedCommands.size() == 1);
+	REQUIRE(fetchedCommands[0]->getSourceFilePath() == largeFilePath);
+
+	fetchedCommands = indexerManager.fetchIndexerCommands();
+	REQUIRE(fetchedCommands.size() == 8);
+	for (size_t i = 0; i < fetchedCommands.size(); i++)
+	{
+		REQUIRE(
+			fetchedCommands[i]->getSourceFilePath() == indexerCommands[i + 1]->getSourceFilePath());
+	}
+	REQUIRE(mainManager.indexerCommandCount() == 12);
+
+	FileSystem::remove(largeFilePath);
+}
+
+TEST_CASE("interprocess indexer command manager requeues fetched commands that were not started")
+{
+	InterprocessIndexerCommandManager mainManager("command_manager_test", 0, true);
+	InterprocessIndexerCommandManager indexerManager("command_manager_test", 1, false);
+
+	mainManager.pushIndexerCommands(createIndexerCommands(20));
+
+	const std::vector<std::shared_ptr<IndexerCommand>> fetchedCommands =
+		indexerManager.fetchIndexerCommands();
+	REQUIRE(fetchedCommands.size() == 8);
+	REQUIRE(mainManager.indexerCommandCount() == 12);
+
+	// the process stopped while indexing the third command
+	mainManager.requeueFetchedIndexerCommands(1, fetchedCommands[2]->getSourceFilePath());
+	REQUIRE(mainManager.indexerCommandCount() == 17);
+
+	const std::vector<std::shared_ptr<IndexerCommand>> refetchedCommands =
+		indexerManager.fetchIndexerCommands();
+	REQUIRE(refetchedCommands.size() == 8);
+	for (size_t i = 0; i < 5; i++)
+	{
+		REQUIRE(
+			refetchedCommands[i]->getSourceFilePath() ==
+			fetchedCommands[i + 3]->getSourceFilePath());
+	}
+
+	// the process stopped before starting any of the fetched commands
+	mainManager.requeueFetchedIndexerCommands(1, FilePath());
+	REQUIRE(mainManager.indexerCommandCount() == 17);
+
+	// commands are only handed back once
+	mainManager.requeueFetchedIndexerCommands(1, FilePath());
+	REQUIRE(mainManager.indexerCommandCount() == 17);
+}
+
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
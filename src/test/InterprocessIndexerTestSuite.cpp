@@ -0,0 +1,108 @@
+#include "catch.hpp"
+
+#include "language_packages.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE && !defined(_WIN32)
+
+#	include <chrono>
+#	include <thread>
+
+#	include <sys/wait.h>
+#	include <unistd.h>
+
+#	include "IndexerCommandCxx.h"
+#	include "InterprocessIndexer.h"
+#	include "LanguagePackageManager.h"
+#	include "NameHierarchy.h"
+#	include "TestIndexer.h"
+#	include "utilityMemory.h"
+
+namespace
+{
+// records symbols and grows its memory until the indexer process is stopped
+void recordGrowingTranslationUnit(
+	std::shared_ptr<IndexerCommandCxx> indexerCommand,
+	ParserClientImpl* parserClient,
+	IndexerStateInfo* indexerStateInfo)
+{
+	const Id fileId = parserClient->recordFile(indexerCommand->getSourceFilePath(), true);
+
+	std::vector<std::vector<char>> memory;
+	for (size_t i = 0; i < 2000 && !indexerStateInfo->indexingInterrupted; i++)
+	{
+		for (size_t j = 0; j < 100; j++)
+		{
+			NameHierarchy nameHierarchy(NAME_DELIMITER_CXX);
+			nameHierarchy.push(L"ns");
+			nameHierarchy.push(L"Symbol" + std::to_wstring(i * 100 + j));
+			const Id symbolId = parserClient->recordSymbol(nameHierarchy);
+			parserClient->recordLocation(
+				symbolId,
+				ParseLocation(fileId, i + 1, j + 1, i + 1, j + 2),
+				ParseLocationType::TOKEN);
+		}
+
+		memory.emplace_back(1 << 20, 'x');
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+}
+}	 // namespace
+
+TEST_CASE("interprocess indexer hands back chunked translation unit exceeding memory limit")
+{
+	const std::string uuid = "interprocess_indexer_test";
+	const Id processId = 1;
+	const FilePath sourceFilePath(L"data/InterprocessIndexerTestSuite/large.cpp");
+
+	InterprocessIndexerCommandManager commandManager(uuid, 0, true);
+	InterprocessIndexingStatusManager statusManager(uuid, 0, true);
+	InterprocessIntermediateStorageManager storageManager(uuid, processId, true);
+
+	commandManager.pushIndexerCommands({std::make_shared<IndexerCommandCxx>(
+		sourceFilePath,
+		std::set<FilePath>(),
+		std::set<FilePathFilter>(),
+		std::set<FilePathFilter>(),
+		FilePath(),
+		std::vector<std::wstring>())});
+
+	const pid_t pid = fork();
+	REQUIRE(pid >= 0);
+
+	if (pid == 0)
+	{
+		// the indexer process quits as soon as it exceeds its memory limit
+		LanguagePackageManager::getInstance()->addPackage(
+			std::make_shared<TestLanguagePackage<IndexerCommandCxx>>(recordGrowingTranslationUnit));
+
+		InterprocessIndexer indexer(
+			uuid,
+			processId,
+			utility::getProcessMemoryUsage() + (64 << 20),
+			false,
+			INDEXER_COMMAND_UNKNOWN,
+			0,
+			64 * 1024);
+		indexer.work();
+		_exit(0);
+	}
+
+	int status = 0;
+	REQUIRE(waitpid(pid, &status, 0) == pid);
+	REQUIRE(WIFEXITED(status));
+	REQUIRE(WEXITSTATUS(status) == InterprocessIndexer::s_memoryLimitExceededExitCode);
+
+	// the translation unit is indexed again from the start, so no chunks were handed over before
+	REQUIRE(storageManager.getIntermediateStorageCount() == 0);
+	REQUIRE(
+		statusManager.getCurrentlyIndexedSourceFilePaths() ==
+		std::vector<FilePath>({sourceFilePath}));
+	REQUIRE(statusManager.getCrashedSourceFilePaths().empty());
+
+	const std::vector<std::shared_ptr<IndexerCommand>> retryCommands =
+		commandManager.popRetryIndexerCommands();
+	REQUIRE(retryCommands.size() == 1);
+	REQUIRE(retryCommands[0]->getSourceFilePath() == sourceFilePath);
+}
+
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE && !defined(_WIN32)
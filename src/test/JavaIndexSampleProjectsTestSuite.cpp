@@ -9,6 +9,7 @@
 
 #	include "ApplicationSettings.h"
 #	include "FileRegister.h"
+#	include "FileSystem.h"
 #	include "IndexerCommandJava.h"
 #	include "JavaEnvironmentFactory.h"
 #	include "JavaParser.h"
@@ -16,6 +17,7 @@
 #	include "TestStorage.h"
 #	include "TextAccess.h"
 #	include "TimeStamp.h"
+#	include "UserPaths.h"
 #	include "utility.h"
 #	include "utilityJava.h"
 #	include "utilityPathDetection.h"
@@ -458,4 +460,60 @@ TEST_CASE("index javasymbolsolver 0 6 0 project")
 		classpath);
 }
 
+TEST_CASE("java sample parser benchmark of cold and warm classpath environment", "[.benchmark]")
+{
+	const FilePath projectDataRoot =
+		FilePath(L"data/JavaIndexSampleProjectsTestSuite/JavaSymbolSolver060").makeAbsolute();
+	const std::vector<FilePath> classpath = {
+		projectDataRoot.getConcatenated(L"lib/guava-21.0.jar"),
+		projectDataRoot.getConcatenated(L"lib/javaparser-core-3.3.0.jar"),
+		projectDataRoot.getConcatenated(L"lib/javaslang-2.0.3.jar"),
+		projectDataRoot.getConcatenated(L"lib/javassist-3.19.0-GA.jar"),
+		projectDataRoot.getConcatenated(L"src/java-symbol-solver-core"),
+		projectDataRoot.getConcatenated(L"src/java-symbol-solver-logic"),
+		projectDataRoot.getConcatenated(L"src/java-symbol-solver-model")};
+	const std::vector<FilePath> sourceFilePaths = {
+		FilePath(L"java-symbol-solver-core/com/github/javaparser/symbolsolver/"
+				 L"SourceFileInfoExtractor.java"),
+		FilePath(L"java-symbol-solver-core/com/github/javaparser/symbolsolver/javaparsermodel/"
+				 L"JavaParserFacade.java"),
+		FilePath(L"java-symbol-solver-core/com/github/javaparser/symbolsolver/javaparsermodel/"
+				 L"TypeExtractor.java"),
+		FilePath(L"java-symbol-solver-core/com/github/javaparser/symbolsolver/resolution/"
+				 L"MethodResolutionLogic.java")};
+
+	const FilePath userDataPath = UserPaths::getUserDataPath();
+	const FilePath cacheUserDataPath = projectDataRoot.getConcatenated(L"benchmark_user_data/");
+	UserPaths::setUserDataPath(cacheUserDataPath);
+	FileSystem::remove(UserPaths::getJavaCachePath().getConcatenated(L"jar_index.txt"));
+
+	setupJavaEnvironmentFactory();
+
+	const auto indexFiles = [&](const std::string& runName) {
+		JavaParser::clearCaches();
+		for (const FilePath& sourceFilePath: sourceFilePaths)
+		{
+			duration = 0;
+			parseCode(
+				projectDataRoot.getConcatenated(L"src").concatenate(sourceFilePath),
+				projectDataRoot.getConcatenated(L"src"),
+				classpath);
+			std::cout << runName << " - " << sourceFilePath.fileName() << ": " << duration << " ms"
+					  << std::endl;
+		}
+	};
+
+	// the first file of the cold run builds the jar index, the first file of the warm run only
+	// reads it from disk
+	indexFiles("cold");
+	REQUIRE(UserPaths::getJavaCachePath().getConcatenated(L"jar_index.txt").recheckExists());
+	indexFiles("warm");
+
+	FileSystem::remove(UserPaths::getJavaCachePath().getConcatenated(L"jar_index.txt"));
+	FileSystem::remove(UserPaths::getJavaCachePath());
+	FileSystem::remove(cacheUserDataPath);
+	UserPaths::setUserDataPath(userDataPath);
+	JavaParser::clearCaches();
+}
+
 #endif	  // BUILD_JAVA_LANGUAGE_PACKAGE
@@ -4,7 +4,11 @@
 
 #if BUILD_JAVA_LANGUAGE_PACKAGE
 
+#	include <fstream>
+
 #	include "ApplicationSettings.h"
+#	include "FileSystem.h"
+#	include "IndexerCommandJava.h"
 #	include "JavaEnvironmentFactory.h"
 #	include "JavaParser.h"
 #	include "ParserClientImpl.h"
@@ -55,13 +59,16 @@ std::string setupJavaEnvironmentFactory()
 	return "";
 }
 
-std::shared_ptr<TestStorage> parseCode(std::string code, bool logErrors = true)
+std::shared_ptr<TestStorage> parseCode(
+	std::string code, bool logErrors = true, bool recordBatchingEnabled = true)
 {
 	setupJavaEnvironmentFactory();
 
 	std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
 	JavaParser parser(
-		std::make_shared<ParserClientImpl>(storage.get()), std::make_shared<IndexerStateInfo>());
+		std::make_shared<ParserClientImpl>(storage.get()),
+		std::make_shared<IndexerStateInfo>(),
+		recordBatchingEnabled);
 	parser.buildIndex(FilePath(L"input.java"), TextAccess::createFromString(code));
 
 	return TestStorage::create(storage);
@@ -1679,5 +1686,113 @@ TEST_CASE("java parsersupports java 12 switch expression")
 		client->usages, L"void foo.Foo.foo() -> foo.Foo.FruitType.PEAR <12:9 12:12>"));
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// test transfer of records from the java indexer
+
+TEST_CASE("java parser records same storage with batched and unbatched record transfer")
+{
+	std::string code =
+		"package foo.bar;\n"
+		"\n"
+		"import java.util.List;\n"
+		"\n"
+		"/* block comment */\n"
+		"public class A<T extends Comparable<T>> extends Object implements Runnable\n"
+		"{\n"
+		"	// line comment\n"
+		"	@interface Note { int value() default 0; }\n"
+		"	enum E { X, Y }\n"
+		"	private static int s_count = 0;\n"
+		"	protected List<T> m_items;\n"
+		"	@Note(1) public void run()\n"
+		"	{\n"
+		"		String s = \"\u00e4\u00f6\u00fc\" + foo.bar.A.s_count;\n"
+		"		for (T item: m_items) { s += item.toString(); }\n"
+		"		E e = E.X;\n"
+		"		new Thread(() -> run()).start();\n"
+		"		unknownCall(s, e);\n"
+		"	}\n"
+		"}\n";
+
+	// grow the file, so the records do not fit into a single batch
+	for (int i = 0; i < 1000; i++)
+	{
+		code += "class B" + std::to_string(i) + " extends foo.bar.A<String> { int f" +
+			std::to_string(i) + "() { return B" + std::to_string(i) + ".this.hashCode(); } }\n";
+	}
+
+	std::shared_ptr<TestStorage> batchedStorage = parseCode(code, true, true);
+	std::shared_ptr<TestStorage> unbatchedStorage = parseCode(code, true, false);
+
+	REQUIRE(!batchedStorage->m_lines.empty());
+	REQUIRE(!batchedStorage->errors.empty());
+	REQUIRE(!batchedStorage->localSymbols.empty());
+	REQUIRE(!batchedStorage->comments.empty());
+	REQUIRE(!batchedStorage->qualifiers.empty());
+	REQUIRE(batchedStorage->m_lines.size() == unbatchedStorage->m_lines.size());
+	for (size_t i = 0; i < batchedStorage->m_lines.size(); i++)
+	{
+		REQUIRE(batchedStorage->m_lines[i] == unbatchedStorage->m_lines[i]);
+	}
+}
+
+TEST_CASE("java parser records same storages when indexing files in parallel")
+{
+	setupJavaEnvironmentFactory();
+
+	const FilePath dataPath = FilePath(L"data/JavaParserTestSuite/parallel/").makeAbsolute();
+	FileSystem::createDirectory(dataPath);
+
+	std::vector<std::shared_ptr<IndexerCommandJava>> indexerCommands;
+	for (int i = 0; i < 8; i++)
+	{
+		const std::string className = "C" + std::to_string(i);
+		const FilePath filePath = dataPath.getConcatenated(
+			utility::decodeFromUtf8(className + ".java"));
+
+		std::ofstream file;
+		file.open(filePath.str(), std::ios::out | std::ios::trunc);
+		file << "package parallel;\n"
+			 << "public class " << className << " extends java.util.ArrayList<String>\n"
+			 << "{\n"
+			 << "	// comment " << i << "\n"
+			 << "	int f() { int x = size() + " << i << "; return x + unknown(); }\n"
+			 << "}\n";
+		file.close();
+
+		indexerCommands.push_back(
+			std::make_shared<IndexerCommandJava>(filePath, L"12", std::vector<FilePath>()));
+	}
+
+	std::vector<std::shared_ptr<IntermediateStorage>> parallelStorages;
+	std::vector<std::shared_ptr<ParserClient>> clients;
+	for (size_t i = 0; i < indexerCommands.size(); i++)
+	{
+		parallelStorages.push_back(std::make_shared<IntermediateStorage>());
+		clients.push_back(std::make_shared<ParserClientImpl>(parallelStorages.back().get()));
+	}
+	JavaParser::buildIndex(indexerCommands, clients, std::make_shared<IndexerStateInfo>(), 4);
+
+	for (size_t i = 0; i < indexerCommands.size(); i++)
+	{
+		std::shared_ptr<IntermediateStorage> storage = std::make_shared<IntermediateStorage>();
+		JavaParser(
+			std::make_shared<ParserClientImpl>(storage.get()), std::make_shared<IndexerStateInfo>())
+			.buildIndex(indexerCommands[i]);
+
+		std::shared_ptr<TestStorage> parallelStorage = TestStorage::create(parallelStorages[i]);
+		std::shared_ptr<TestStorage> sequentialStorage = TestStorage::create(storage);
+
+		REQUIRE(!parallelStorage->m_lines.empty());
+		REQUIRE(!parallelStorage->errors.empty());
+		REQUIRE(!parallelStorage->comments.empty());
+		REQUIRE(parallelStorage->m_lines == sequentialStorage->m_lines);
+
+		FileSystem::remove(indexerCommands[i]->getSourceFilePath());
+	}
+
+	FileSystem::remove(dataPath);
+}
+
 
 #endif	  // BUILD_JAVA_LANGUAGE_PACKAGE
@@ -4,8 +4,8 @@
 
 #if BUILD_PYTHON_LANGUAGE_PACKAGE
 
-#	include <memory>
 #	include <fstream>
+#	include <memory>
 
 #	include "FileSystem.h"
 #	include "IndexerCommandCustom.h"
@@ -29,10 +29,8 @@ void deleteAllContents(const FilePath& tempPath)
 	}
 }
 
-std::shared_ptr<TestStorage> parseCode(std::string code)
+std::shared_ptr<PersistentStorage> indexCode(const FilePath& rootPath, const std::string& code)
 {
-	const FilePath rootPath = FilePath(L"data/PythonIndexerTestSuite/temp/").makeAbsolute();
-
 	if (!rootPath.exists())
 	{
 		FileSystem::createDirectory(rootPath);
@@ -80,12 +78,20 @@ std::shared_ptr<TestStorage> parseCode(std::string code)
 		REQUIRE(errorMessage.empty());
 	}
 
+	std::shared_ptr<PersistentStorage> persistentStorage = std::make_shared<PersistentStorage>(
+		tempDbPath, FilePath());
+	persistentStorage->setup();
+	persistentStorage->buildCaches();
+	return persistentStorage;
+}
+
+std::shared_ptr<TestStorage> parseCode(std::string code)
+{
+	const FilePath rootPath = FilePath(L"data/PythonIndexerTestSuite/temp/").makeAbsolute();
+
 	std::shared_ptr<TestStorage> testStorage;
 	{
-		std::shared_ptr<PersistentStorage> persistentStorage = std::make_shared<PersistentStorage>(
-			tempDbPath, FilePath());
-		persistentStorage->setup();
-		persistentStorage->buildCaches();
+		std::shared_ptr<PersistentStorage> persistentStorage = indexCode(rootPath, code);
 		TaskExecuteCustomCommands::runPythonPostProcessing(*(persistentStorage.get()));
 
 		testStorage = TestStorage::create(persistentStorage);
@@ -94,6 +100,23 @@ std::shared_ptr<TestStorage> parseCode(std::string code)
 	deleteAllContents(rootPath);
 	return testStorage;
 }
+
+// classes that call the constructor of their base class by class name and by super(), next to an
+// unrelated class with a constructor of the same name
+std::string generateClassHierarchyCode(size_t classCount)
+{
+	std::string code;
+	for (size_t i = 0; i < classCount; i++)
+	{
+		const std::string id = std::to_string(i);
+		code += "class A" + id + ":\n\tdef __init__(self):\n\t\tpass\n\n";
+		code += "class B" + id + "(A" + id + "):\n\tdef __init__(self):\n\t\tA" + id +
+			".__init__()\n\n";
+		code += "class C" + id + "(A" + id +
+			"):\n\tdef __init__(self):\n\t\tsuper().__init__()\n\n";
+	}
+	return code;
+}
 }	 // namespace
 
 TEST_CASE("python post processing regards class name in call context when adding ambiguous edges")
@@ -146,4 +169,24 @@ TEST_CASE("python post processing regards super() in call context when adding am
 		storage->calls, L"test.A1.__init__ -> test.B.__init__"));
 }
 
+TEST_CASE("python post processing resolves calls of all classes in larger file")
+{
+	const size_t classCount = 20;
+	std::shared_ptr<TestStorage> storage = parseCode(generateClassHierarchyCode(classCount));
+
+	for (size_t i = 0; i < classCount; i++)
+	{
+		const std::wstring id = std::to_wstring(i);
+		REQUIRE(utility::containsElement<std::wstring>(
+			storage->calls, L"test.B" + id + L".__init__ -> test.A" + id + L".__init__"));
+		REQUIRE(utility::containsElement<std::wstring>(
+			storage->calls, L"test.C" + id + L".__init__ -> test.A" + id + L".__init__"));
+
+		REQUIRE(!utility::containsElement<std::wstring>(
+			storage->calls, L"test.B" + id + L".__init__ -> test.C" + id + L".__init__"));
+		REQUIRE(!utility::containsElement<std::wstring>(
+			storage->calls, L"test.C" + id + L".__init__ -> test.B" + id + L".__init__"));
+	}
+}
+
 #endif	  // BUILD_PYTHON_LANGUAGE_PACKAGE
@@ -4,11 +4,10 @@
 
 #include "FileSystem.h"
 #include "PersistentStorage.h"
-#include "ProjectSettings.h"
 #include "RefreshInfo.h"
 #include "RefreshInfoGenerator.h"
 #include "SourceGroup.h"
-#include "SourceGroupSettings.h"
+#include "TestSourceGroup.h"
 #include "utility.h"
 
 namespace
@@ -17,91 +16,6 @@ FilePath m_indexDbPath = FilePath(L"data/RefreshInfoGeneratorTestSuite/project.s
 FilePath m_bookmarkDbPath = FilePath(L"data/RefreshInfoGeneratorTestSuite/project.srctrlbm");
 FilePath m_sourceFolder = FilePath(L"data/RefreshInfoGeneratorTestSuite/src");
 
-class SourceGroupSettingsTest: public SourceGroupSettings
-{
-public:
-	SourceGroupSettingsTest(const ProjectSettings* projectSettings)
-		: SourceGroupSettings(SOURCE_GROUP_UNKNOWN, "TEST_ID", projectSettings)
-	{
-	}
-
-	std::shared_ptr<SourceGroupSettings> createCopy() const override
-	{
-		return nullptr;
-	}
-
-	void loadSettings(const ConfigManager* config) override {}
-
-	void saveSettings(ConfigManager* config) override {}
-
-	bool equalsSettings(const SourceGroupSettingsBase* other) override
-	{
-		return true;
-	}
-};
-
-class SourceGroupTest: public SourceGroup
-{
-public:
-	SourceGroupTest(std::set<FilePath> sourceFilePaths)
-		: m_sourceFilePaths(sourceFilePaths), m_allFilePaths(sourceFilePaths)
-	{
-		m_sourceGroupSettings = std::make_shared<SourceGroupSettingsTest>(&m_projectSettings);
-	}
-
-	SourceGroupTest(std::set<FilePath> sourceFilePaths, std::set<FilePath> allFilePaths)
-		: m_sourceFilePaths(sourceFilePaths), m_allFilePaths(allFilePaths)
-	{
-		m_sourceGroupSettings = std::make_shared<SourceGroupSettingsTest>(&m_projectSettings);
-	}
-
-	std::set<FilePath> filterToContainedFilePaths(const std::set<FilePath>& filePaths) const override
-	{
-		std::set<FilePath> containedFilePaths;
-
-		for (const FilePath& filePath: filePaths)
-		{
-			if (m_allFilePaths.find(filePath) != m_allFilePaths.end())
-			{
-				containedFilePaths.insert(filePath);
-			}
-		}
-
-		return containedFilePaths;
-	}
-
-	std::set<FilePath> getAllSourceFilePaths() const override
-	{
-		return m_sourceFilePaths;
-	}
-
-	std::vector<std::shared_ptr<IndexerCommand>> getIndexerCommands(const RefreshInfo& info) const override
-	{
-		return std::vector<std::shared_ptr<IndexerCommand>>();
-	}
-
-	void setStatus(SourceGroupStatusType status)
-	{
-		m_sourceGroupSettings->setStatus(status);
-	}
-
-private:
-	std::shared_ptr<SourceGroupSettings> getSourceGroupSettings() override
-	{
-		return m_sourceGroupSettings;
-	}
-
-	std::shared_ptr<const SourceGroupSettings> getSourceGroupSettings() const override
-	{
-		return m_sourceGroupSettings;
-	}
-
-	ProjectSettings m_projectSettings;
-	std::shared_ptr<SourceGroupSettingsTest> m_sourceGroupSettings;
-	const std::set<FilePath> m_sourceFilePaths;
-	const std::set<FilePath> m_allFilePaths;
-};
-
 void cleanup()
 {
 	FileSystem::remove(m_indexDbPath);
@@ -1070,3 +984,48 @@ TEST_CASE(
 	}
 	cleanup();
 }
+
+TEST_CASE("refresh info for updated files indexes pending source files of interrupted indexing")
+{
+	cleanup();
+	{
+		const FilePath injectedSourceFilePath = m_sourceFolder.getConcatenated(
+			L"injected_file.cpp");
+		const FilePath pendingSourceFilePath = m_sourceFolder.getConcatenated(L"pending_file.cpp");
+		const FilePath removedSourceFilePath = m_sourceFolder.getConcatenated(L"removed_file.cpp");
+
+		std::vector<std::shared_ptr<SourceGroup>> sourceGroups;
+		sourceGroups.push_back(std::shared_ptr<SourceGroupTest>(
+			new SourceGroupTest({injectedSourceFilePath, pendingSourceFilePath})));
+
+		std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+			m_indexDbPath, m_bookmarkDbPath);
+		storage->setup();
+
+		storage->setPendingSourceFiles(
+			{injectedSourceFilePath, pendingSourceFilePath, removedSourceFilePath});
+		storage->addInjectedSourceFileChunkCounts({{injectedSourceFilePath, 0}});
+		storage->checkpointInjectedSourceFiles();
+
+		addVeryNewFileToStorage(injectedSourceFilePath, true, true, storage);
+		addFileToFileSystem(injectedSourceFilePath);
+		addVeryNewFileToStorage(pendingSourceFilePath, true, true, storage);
+		addFileToFileSystem(pendingSourceFilePath);
+
+		storage->buildCaches();
+
+		REQUIRE(
+			storage->getPendingSourceFiles() ==
+			std::set<FilePath>({pendingSourceFilePath, removedSourceFilePath}));
+
+		const RefreshInfo refreshInfo = RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
+			sourceGroups, storage);
+
+		// the stored data of the pending file may be incomplete, so it is cleared and indexed again
+		REQUIRE(REFRESH_UPDATED_FILES == refreshInfo.mode);
+		REQUIRE(0 == refreshInfo.nonIndexedFilesToClear.size());
+		REQUIRE(refreshInfo.filesToClear == std::set<FilePath>({pendingSourceFilePath}));
+		REQUIRE(refreshInfo.filesToIndex == std::set<FilePath>({pendingSourceFilePath}));
+	}
+	cleanup();
+}
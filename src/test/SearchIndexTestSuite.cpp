@@ -1,9 +1,89 @@
 #include "catch.hpp"
 
+#include <fstream>
+#include <map>
+
 #include "NameHierarchy.h"
 #include "SearchIndex.h"
 #include "utility.h"
 
+namespace
+{
+std::wstring createSymbolName(size_t i)
+{
+	const std::vector<std::wstring> words = {
+		L"Project",
+		L"detail",
+		L"Container",
+		L"Helper",
+		L"insert",
+		L"Element",
+		L"value",
+		L"Storage"};
+
+	std::wstring name;
+	for (size_t part = 0; part < 3; part++)
+	{
+		if (part)
+		{
+			name += L"::";
+		}
+		name += words[i % words.size()] + words[(i / words.size()) % words.size()];
+		name += std::to_wstring(i % 97);
+		i /= 7;
+	}
+	return name;
+}
+
+void addSymbolNames(SearchIndex* index, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		index->addNode(i + 1, createSymbolName(i * 7919));
+	}
+	index->finishSetup();
+}
+
+NodeType getSymbolType(size_t i)
+{
+	return NodeType(i % 10 ? NODE_FUNCTION : NODE_CLASS);
+}
+
+SearchIndex::ElementFlags getSymbolFlags(size_t i)
+{
+	return (i % 4 ? SearchIndex::ELEMENT_DEFINED : SearchIndex::ELEMENT_NON_INDEXED) |
+		(i % 3 ? SearchIndex::ELEMENT_LANGUAGE_CXX : SearchIndex::ELEMENT_LANGUAGE_JAVA);
+}
+
+// adds symbols where every tenth is a class and every fourth is not indexed
+void addTypedSymbolNames(SearchIndex* index, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		index->addNode(i + 1, createSymbolName(i * 7919), getSymbolType(i), getSymbolFlags(i));
+	}
+	index->finishSetup();
+}
+
+bool isEqual(const std::vector<SearchResult>& a, const std::vector<SearchResult>& b)
+{
+	if (a.size() != b.size())
+	{
+		return false;
+	}
+
+	for (size_t i = 0; i < a.size(); i++)
+	{
+		if (a[i].text != b[i].text || a[i].elementIds != b[i].elementIds ||
+			a[i].indices != b[i].indices || a[i].score != b[i].score)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+}	 // namespace
+
 TEST_CASE("search index finds id of element added")
 {
 	SearchIndex index;
@@ -91,3 +171,451 @@ TEST_CASE("search index rates higher on consecutive letters")
 	REQUIRE(L"ocbcabc" == results[0].text);
 	REQUIRE(L"oaabbcc" == results[1].text);
 }
+
+TEST_CASE("search index with cursor finds same results for extended queries")
+{
+	SearchIndex index;
+	addSymbolNames(&index, 2000);
+
+	const std::wstring query = L"projectDetail::HelperElem";
+
+	SearchIndex::SearchCursor cursor;
+	for (size_t i = 1; i <= query.size(); i++)
+	{
+		std::vector<SearchResult> results = index.search(
+			query.substr(0, i), NodeTypeSet::all(), 100, 0, &cursor);
+
+		REQUIRE(isEqual(index.search(query.substr(0, i), NodeTypeSet::all(), 100), results));
+	}
+}
+
+TEST_CASE("search index with cursor finds same results for edited queries")
+{
+	SearchIndex index;
+	addSymbolNames(&index, 2000);
+
+	SearchIndex::SearchCursor cursor;
+	for (const std::wstring& query: {L"cont", L"contv", L"cov", L"COVAL", L"s::h", L"s::he"})
+	{
+		std::vector<SearchResult> results = index.search(
+			query, NodeTypeSet::all(), 100, 0, &cursor);
+
+		REQUIRE(isEqual(index.search(query, NodeTypeSet::all(), 100), results));
+	}
+}
+
+TEST_CASE("search index with cursor finds nodes added after last query")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo");
+	index.finishSetup();
+
+	SearchIndex::SearchCursor cursor;
+	REQUIRE(1 == index.search(L"fo", NodeTypeSet::all(), 0, 0, &cursor).size());
+
+	index.addNode(2, L"fox");
+	index.finishSetup();
+	std::vector<SearchResult> results = index.search(L"fox", NodeTypeSet::all(), 0, 0, &cursor);
+
+	REQUIRE(1 == results.size());
+	REQUIRE(utility::containsElement<Id>(results[0].elementIds, 2));
+}
+
+TEST_CASE("search index finds same results on several threads as on one thread")
+{
+	SearchIndex singleThreadedIndex(1);
+	addSymbolNames(&singleThreadedIndex, 5000);
+
+	SearchIndex index(8);
+	addSymbolNames(&index, 5000);
+
+	for (const std::wstring& query: {L"c", L"de", L"HelEl", L"s::v", L"projectDetail::HelperElem"})
+	{
+		for (size_t maxResultCount: {0, 10, 300})
+		{
+			REQUIRE(isEqual(
+				singleThreadedIndex.search(query, NodeTypeSet::all(), maxResultCount, 100),
+				index.search(query, NodeTypeSet::all(), maxResultCount, 100)));
+		}
+	}
+
+	SearchIndex::SearchCursor cursor;
+	for (const std::wstring& query: {L"cont", L"contv", L"contval", L"contvalp"})
+	{
+		REQUIRE(isEqual(
+			singleThreadedIndex.search(query, NodeTypeSet::all(), 100),
+			index.search(query, NodeTypeSet::all(), 100, 0, &cursor)));
+	}
+}
+
+TEST_CASE("search index does not find removed node")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo");
+	index.addNode(2, L"foobar");
+	index.finishSetup();
+	index.removeNode(2);
+
+	std::vector<SearchResult> results = index.search(L"fb", NodeTypeSet::all(), 0);
+	REQUIRE(0 == results.size());
+
+	results = index.search(L"fo", NodeTypeSet::all(), 0);
+	REQUIRE(1 == results.size());
+	REQUIRE(utility::containsElement<Id>(results[0].elementIds, 1));
+}
+
+TEST_CASE("search index finds id added twice before setup once")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo");
+	index.addNode(1, L"foo");
+	index.addNode(2, L"foo");
+	index.addNode(3, L"foobar");
+	index.addNode(3, L"foobar");
+	index.removeNode(3);
+	index.finishSetup();
+
+	std::vector<SearchResult> results = index.search(L"fo", NodeTypeSet::all(), 0);
+	REQUIRE(1 == results.size());
+	REQUIRE(2 == results[0].elementIds.size());
+
+	index.removeNode(1);
+
+	results = index.search(L"fo", NodeTypeSet::all(), 0);
+	REQUIRE(1 == results.size());
+	REQUIRE(std::vector<Id>({2}) == results[0].elementIds);
+}
+
+TEST_CASE("search index with removed and added nodes finds same results as rebuilt index")
+{
+	const size_t nodeCount = 3000;
+	auto getType = [](size_t i) {
+		return NodeType(i % 3 ? NODE_FUNCTION : NODE_CLASS);
+	};
+
+	SearchIndex index;
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		index.addNode(i + 1, createSymbolName(i * 7919), getType(i));
+	}
+	index.finishSetup();
+
+	// remove every fifth node, add some of them again with other names and add new nodes
+	SearchIndex rebuiltIndex;
+	for (size_t i = 0; i < nodeCount; i++)
+	{
+		if (i % 5 == 0)
+		{
+			index.removeNode(i + 1);
+			if (i % 10 == 0)
+			{
+				index.addNode(i + 1, createSymbolName(i * 31), getType(i + 1));
+				rebuiltIndex.addNode(i + 1, createSymbolName(i * 31), getType(i + 1));
+			}
+		}
+		else
+		{
+			rebuiltIndex.addNode(i + 1, createSymbolName(i * 7919), getType(i));
+		}
+	}
+	for (size_t i = nodeCount; i < nodeCount + 300; i++)
+	{
+		index.addNode(i + 1, createSymbolName(i * 13), getType(i));
+		rebuiltIndex.addNode(i + 1, createSymbolName(i * 13), getType(i));
+	}
+	rebuiltIndex.finishSetup();
+
+	for (const std::wstring& query: {L"c", L"de", L"HelEl", L"s::v", L"projectDetail::HelperElem"})
+	{
+		for (const NodeTypeSet& types: {NodeTypeSet::all(), NodeTypeSet(NodeType(NODE_CLASS))})
+		{
+			for (size_t maxResultCount: {0, 10, 300})
+			{
+				REQUIRE(isEqual(
+					rebuiltIndex.search(query, types, maxResultCount, 100),
+					index.search(query, types, maxResultCount, 100)));
+			}
+		}
+	}
+}
+
+TEST_CASE("search index only finds elements with required flags")
+{
+	SearchIndex index;
+	index.addNode(1, L"foo", NodeType(NODE_CLASS), SearchIndex::ELEMENT_DEFINED);
+	index.addNode(2, L"foobar", NodeType(NODE_CLASS), SearchIndex::ELEMENT_NON_INDEXED);
+	index.addNode(
+		3,
+		L"foobaz",
+		NodeType(NODE_FUNCTION),
+		SearchIndex::ELEMENT_NON_INDEXED | SearchIndex::ELEMENT_LANGUAGE_JAVA);
+	index.finishSetup();
+
+	std::vector<SearchResult> results = index.search(
+		L"fo", SearchIndex::Filter(NodeTypeSet::all(), SearchIndex::ELEMENT_NON_INDEXED), 0);
+	REQUIRE(2 == results.size());
+
+	results = index.search(
+		L"fo",
+		SearchIndex::Filter(NodeType(NODE_CLASS), SearchIndex::ELEMENT_NON_INDEXED),
+		0);
+	REQUIRE(1 == results.size());
+	REQUIRE(results[0].elementIds == std::vector<Id>({2}));
+
+	results = index.search(
+		L"fo",
+		SearchIndex::Filter(
+			NodeTypeSet::all(),
+			SearchIndex::ELEMENT_NON_INDEXED | SearchIndex::ELEMENT_LANGUAGE_JAVA),
+		0);
+	REQUIRE(1 == results.size());
+	REQUIRE(results[0].elementIds == std::vector<Id>({3}));
+
+	results = index.search(
+		L"fo", SearchIndex::Filter(NodeType(NODE_FUNCTION), SearchIndex::ELEMENT_DEFINED), 0);
+	REQUIRE(0 == results.size());
+}
+
+TEST_CASE("search index with filter finds same results as filtering all results")
+{
+	// less than the 1000 results that are scored, so unfiltered searches don't drop any
+	SearchIndex index;
+	addTypedSymbolNames(&index, 900);
+
+	for (const std::wstring& query: {L"c", L"de", L"HelEl", L"s::v"})
+	{
+		const std::vector<SearchResult> allResults = index.search(query, NodeTypeSet::all(), 0);
+
+		for (const SearchIndex::Filter& filter:
+			 {SearchIndex::Filter(NodeType(NODE_CLASS)),
+			  SearchIndex::Filter(NodeTypeSet::all(), SearchIndex::ELEMENT_NON_INDEXED),
+			  SearchIndex::Filter(
+				  NodeType(NODE_CLASS),
+				  SearchIndex::ELEMENT_DEFINED | SearchIndex::ELEMENT_LANGUAGE_JAVA)})
+		{
+			std::map<std::wstring, std::vector<Id>> expectedIds;
+			for (const SearchResult& result: allResults)
+			{
+				for (Id id: result.elementIds)
+				{
+					if (filter.accepts(getSymbolType(id - 1), getSymbolFlags(id - 1)))
+					{
+						expectedIds[result.text].push_back(id);
+					}
+				}
+			}
+
+			std::map<std::wstring, std::vector<Id>> ids;
+			for (const SearchResult& result: index.search(query, filter, 0))
+			{
+				ids[result.text] = result.elementIds;
+			}
+
+			REQUIRE(!ids.empty());
+			REQUIRE(ids == expectedIds);
+		}
+	}
+}
+
+TEST_CASE("search element table returns same lists after pages were evicted")
+{
+	// two pages of budget, so most pages are only kept in the file
+	SearchElementTable table(2 * SearchElementTable::s_pageByteSize);
+
+	auto createList = [](size_t i, size_t version) {
+		std::vector<SearchElementTable::Element> elements;
+		for (size_t j = 0; j < 1 + (i + version) % 7; j++)
+		{
+			elements.emplace_back(
+				static_cast<Id>(i * 100 + j * (version + 1) * 1000003),
+				j % 2 ? NODE_CLASS : NODE_UNION,
+				static_cast<int>((i + j) % 16));
+		}
+		return elements;
+	};
+
+	std::vector<SearchElementTable::ListId> listIds;
+	for (size_t i = 0; i < 50000; i++)
+	{
+		listIds.push_back(table.addList(createList(i, 0)));
+	}
+	REQUIRE(table.getTotalByteSize() > 10 * SearchElementTable::s_pageByteSize);
+	REQUIRE(table.getResidentByteSize() <= 2 * SearchElementTable::s_pageByteSize);
+
+	// replacing and removing most lists rewrites the table
+	for (size_t i = 0; i < listIds.size(); i++)
+	{
+		if (i % 4 == 0)
+		{
+			table.removeList(listIds[i]);
+		}
+		else if (i % 4 != 1)
+		{
+			table.replaceList(listIds[i], createList(i, 1));
+		}
+	}
+	REQUIRE(table.getListCount() == 37500);
+	REQUIRE(table.getResidentByteSize() <= 2 * SearchElementTable::s_pageByteSize);
+
+	std::vector<SearchElementTable::Element> elements;
+	for (size_t i = 0; i < listIds.size(); i++)
+	{
+		if (i % 4)
+		{
+			REQUIRE(table.getList(listIds[i], &elements));
+			REQUIRE(elements == createList(i, i % 4 == 1 ? 0 : 1));
+		}
+	}
+	REQUIRE(table.getResidentByteSize() <= 3 * SearchElementTable::s_pageByteSize);
+}
+
+TEST_CASE("search element table only writes pages to file once they exceed the memory budget")
+{
+	const size_t memoryBudget = 8 * SearchElementTable::s_pageByteSize;
+	SearchElementTable table(memoryBudget);
+
+	std::vector<SearchElementTable::ListId> listIds;
+	auto addLists = [&](size_t count) {
+		for (size_t i = 0; i < count; i++)
+		{
+			const Id id = static_cast<Id>(listIds.size() * 1000003);
+			listIds.push_back(table.addList({SearchElementTable::Element(id, NODE_CLASS, 0)}));
+		}
+	};
+
+	addLists(30000);
+	REQUIRE(table.getTotalByteSize() > 2 * SearchElementTable::s_pageByteSize);
+	REQUIRE(table.getTotalByteSize() < 6 * SearchElementTable::s_pageByteSize);
+	REQUIRE(table.getFileByteSize() == 0);
+	REQUIRE(table.getResidentByteSize() == table.getTotalByteSize());
+
+	addLists(120000);
+	REQUIRE(table.getFileByteSize() > 0);
+	REQUIRE(table.getResidentByteSize() <= memoryBudget);
+
+	std::vector<SearchElementTable::Element> elements;
+	for (size_t i = 0; i < listIds.size(); i++)
+	{
+		REQUIRE(table.getList(listIds[i], &elements));
+		REQUIRE(
+			elements ==
+			std::vector<SearchElementTable::Element>(
+				{SearchElementTable::Element(static_cast<Id>(i * 1000003), NODE_CLASS, 0)}));
+	}
+}
+
+TEST_CASE("search element table reports lists it can't read from the file anymore")
+{
+	SearchElementTable table(2 * SearchElementTable::s_pageByteSize);
+
+	std::vector<SearchElementTable::ListId> listIds;
+	for (size_t i = 0; i < 50000; i++)
+	{
+		listIds.push_back(
+			table.addList({SearchElementTable::Element(static_cast<Id>(i + 1), NODE_CLASS, 0)}));
+	}
+	REQUIRE(table.getFileByteSize() > 0);
+	REQUIRE(!table.hasReadError());
+
+	// the evicted pages are gone once the file is truncated
+	std::ofstream(table.getFilePath(), std::ios::trunc);
+
+	std::vector<SearchElementTable::ListId> lostListIds;
+	std::vector<SearchElementTable::Element> elements;
+	for (size_t i = 0; i < listIds.size(); i++)
+	{
+		if (table.getList(listIds[i], &elements))
+		{
+			REQUIRE(
+				elements ==
+				std::vector<SearchElementTable::Element>(
+					{SearchElementTable::Element(static_cast<Id>(i + 1), NODE_CLASS, 0)}));
+		}
+		else
+		{
+			lostListIds.push_back(listIds[i]);
+		}
+	}
+	REQUIRE(!lostListIds.empty());
+	REQUIRE(table.hasReadError());
+
+	// replacing other lists doesn't turn the lost lists into empty ones
+	for (size_t i = 0; i < listIds.size(); i += 2)
+	{
+		table.replaceList(listIds[i], {SearchElementTable::Element(1, NODE_CLASS, 0)});
+	}
+	for (SearchElementTable::ListId listId: lostListIds)
+	{
+		if (listId % 2)
+		{
+			REQUIRE(!table.getList(listId, &elements));
+		}
+	}
+}
+
+TEST_CASE("search index with element memory budget finds same results as without budget")
+{
+	const size_t nodeCount = 60000;
+
+	SearchIndex index;
+	SearchIndex budgetIndex;
+	budgetIndex.setElementMemoryBudget(1);
+	addTypedSymbolNames(&index, nodeCount);
+	addTypedSymbolNames(&budgetIndex, nodeCount);
+
+	// change some nodes after the index is set up
+	for (SearchIndex* i: {&index, &budgetIndex})
+	{
+		for (size_t j = 0; j < nodeCount; j += 7)
+		{
+			i->removeNode(j + 1);
+			i->addNode(j + 1, createSymbolName(j * 31), getSymbolType(j + 1), getSymbolFlags(j));
+		}
+	}
+
+	const SearchElementTable& table = budgetIndex.getElementTable();
+	REQUIRE(table.getTotalByteSize() > 4 * SearchElementTable::s_pageByteSize);
+	REQUIRE(table.getResidentByteSize() <= 2 * SearchElementTable::s_pageByteSize);
+
+	for (const std::wstring& query: {L"c", L"de", L"HelEl", L"s::v", L"projectDetail::HelperElem"})
+	{
+		for (const SearchIndex::Filter& filter:
+			 {SearchIndex::Filter(NodeTypeSet::all()),
+			  SearchIndex::Filter(NodeType(NODE_CLASS), SearchIndex::ELEMENT_DEFINED)})
+		{
+			for (size_t maxResultCount: {10, 300})
+			{
+				REQUIRE(isEqual(
+					index.search(query, filter, maxResultCount, 100),
+					budgetIndex.search(query, filter, maxResultCount, 100)));
+			}
+		}
+	}
+	REQUIRE(table.getResidentByteSize() <= 2 * SearchElementTable::s_pageByteSize);
+}
+
+TEST_CASE("search index reports elements lost from the element page file")
+{
+	const size_t nodeCount = 60000;
+
+	SearchIndex index;
+	index.setElementMemoryBudget(1);
+	addTypedSymbolNames(&index, nodeCount);
+	REQUIRE(!index.hasLostElements());
+
+	std::ofstream(index.getElementTable().getFilePath(), std::ios::trunc);
+	index.search(L"e", SearchIndex::Filter(NodeTypeSet::all()), 0);
+	REQUIRE(index.hasLostElements());
+
+	// nodes whose element lists are lost stay lost instead of being replaced by partial lists
+	for (size_t j = 0; j < nodeCount; j += 7)
+	{
+		index.removeNode(j + 1);
+		index.addNode(j + 1, createSymbolName(j * 7919), getSymbolType(j), getSymbolFlags(j));
+	}
+	REQUIRE(index.hasLostElements());
+
+	index.clear();
+	addTypedSymbolNames(&index, nodeCount);
+	REQUIRE(!index.hasLostElements());
+}
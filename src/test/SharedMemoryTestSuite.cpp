@@ -96,3 +96,36 @@ TEST_CASE("shared memory")
 		}
 	}
 }
+
+TEST_CASE("shared memory byte size estimates match allocations")
+{
+	SharedMemory memory("memory_size", 1048576, SharedMemory::CREATE_AND_DELETE);
+	SharedMemory::ScopedAccess access(&memory);
+
+	SharedMemory::String* str = access.accessValueWithAllocator<SharedMemory::String>("string");
+	for (size_t length: {0, 5, 22, 23, 24, 40, 100, 1000, 4095})
+	{
+		const size_t freeMemory = access.getFreeMemorySize();
+		*str = SharedMemory::String(std::string(length, 'x').c_str(), access.getAllocator());
+		const size_t usedMemory = freeMemory - access.getFreeMemorySize();
+
+		REQUIRE(SharedMemory::getStringByteSize(length) >= usedMemory);
+		REQUIRE(SharedMemory::getStringByteSize(length) <= usedMemory + 16);
+
+		str->clear();
+		str->shrink_to_fit();
+	}
+
+	SharedMemory::Vector<int64_t>* nums =
+		access.accessValueWithAllocator<SharedMemory::Vector<int64_t>>("nums");
+	for (size_t count: {0, 1, 2, 3, 10, 1000})
+	{
+		const size_t freeMemory = access.getFreeMemorySize();
+		nums->reserve(count);
+		const size_t usedMemory = freeMemory - access.getFreeMemorySize();
+
+		REQUIRE(SharedMemory::getVectorByteSize<int64_t>(count) == usedMemory);
+
+		nums->shrink_to_fit();
+	}
+}
@@ -1,10 +1,58 @@
 #include "catch.hpp"
 
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <set>
+#include <thread>
+
+#include "language_packages.h"
 #include "utilityString.h"
 
+#include "Blackboard.h"
+#include "FileSystem.h"
+#include "FullTextSearchCursor.h"
+#include "IndexerCommandCustom.h"
 #include "IntermediateStorage.h"
 #include "ParseLocation.h"
+#include "ParserClientImpl.h"
 #include "PersistentStorage.h"
+#include "SourceLocation.h"
+#include "SourceLocationCollection.h"
+#include "StorageProvider.h"
+#include "TaskExecuteCustomCommands.h"
+#include "TaskInjectStorage.h"
+#include "TaskMergeStorages.h"
+#include "TestIndexer.h"
+#include "utility.h"
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+#	include <chrono>
+#	include <functional>
+#	include <mutex>
+
+#	include "DialogView.h"
+#	include "IndexerCommandCxx.h"
+#	include "LanguagePackageManager.h"
+#	include "MemoryIndexerCommandProvider.h"
+#	include "MessageIndexingInterrupted.h"
+#	include "MessageQueue.h"
+#	include "RefreshInfo.h"
+#	include "RefreshInfoGenerator.h"
+#	include "TaskBuildIndex.h"
+#	include "TaskDecoratorRepeat.h"
+#	include "TaskFillIndexerCommandQueue.h"
+#	include "TaskFinishParsing.h"
+#	include "TaskGroupParallel.h"
+#	include "TaskGroupSelector.h"
+#	include "TaskGroupSequence.h"
+#	include "TaskLambda.h"
+#	include "TaskParseWrapper.h"
+#	include "TaskReturnSuccessIf.h"
+#	include "TaskRunner.h"
+#	include "TaskSetValue.h"
+#	include "TestSourceGroup.h"
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
 
 namespace
 {
@@ -52,6 +100,383 @@ NameHierarchy createFunctionNameHierarchy(std::wstring ret, std::wstring name, s
 	nameHierarchy.push(NameElement(lastName, ret, parameters));
 	return nameHierarchy;
 }
+
+// writes a database like the one of a custom command that indexed fileCount files
+void createCustomCommandDatabase(
+	const FilePath& databaseFilePath, const std::wstring& prefix, size_t fileCount)
+{
+	FileSystem::remove(databaseFilePath);
+
+	std::shared_ptr<IntermediateStorage> intermediateStorage =
+		std::make_shared<IntermediateStorage>();
+	const Id sharedTypeId = intermediateStorage
+								->addNode(StorageNodeData(
+									nodeKindToInt(NODE_CLASS),
+									NameHierarchy::serialize(createNameHierarchy(L"shared_type"))))
+								.first;
+	for (size_t i = 0; i < fileCount; i++)
+	{
+		const std::wstring filePath = prefix + L"/file_" + std::to_wstring(i) + L".py";
+		const Id fileId =
+			intermediateStorage
+				->addNode(StorageNodeData(
+					nodeKindToInt(NODE_FILE),
+					NameHierarchy::serialize(NameHierarchy(filePath, NAME_DELIMITER_FILE))))
+				.first;
+		intermediateStorage->addFile(
+			StorageFile(fileId, filePath, L"python", "someTime", true, true));
+
+		const Id functionId = intermediateStorage
+								  ->addNode(StorageNodeData(
+									  nodeKindToInt(NODE_FUNCTION),
+									  NameHierarchy::serialize(createNameHierarchy(
+										  prefix + L"_function_" + std::to_wstring(i)))))
+								  .first;
+		intermediateStorage->addEdge(StorageEdgeData(
+			Edge::typeToInt(Edge::EDGE_TYPE_USAGE), functionId, sharedTypeId));
+	}
+
+	PersistentStorage storage(databaseFilePath, FilePath());
+	storage.setup();
+	storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+	storage.buildCaches();
+	storage.inject(intermediateStorage.get());
+}
+
+// records classes that call methods and use types of earlier classes, so data recorded later
+// refers to elements recorded much earlier
+void recordLargeTranslationUnit(
+	ParserClientImpl* client, size_t classCount, const std::wstring& fileName = L"large")
+{
+	const FilePath sourceFilePath(L"data/" + fileName + L".cpp");
+	const FilePath headerFilePath(L"data/" + fileName + L".h");
+	const Id sourceFileId = client->recordFile(sourceFilePath, true);
+	const Id headerFileId = client->recordFile(headerFilePath, true);
+	client->recordFileLanguage(sourceFileId, L"cpp");
+
+	const Id baseId = client->recordSymbol(createNameHierarchy(L"ns::Base"));
+
+	// named after its declaration like the parsers name local symbols, so it is only stored once
+	// even if it is used in several chunks
+	const std::wstring localSymbolName = sourceFilePath.fileName() + L"<1:1>";
+
+	Id previousMethodId = 0;
+	for (size_t i = 0; i < classCount; i++)
+	{
+		const std::wstring className = L"ns::Class" + std::to_wstring(i);
+		const size_t line = i * 10 + 1;
+
+		// the next class is used before it is recorded as a class
+		const Id nextClassId = client->recordSymbol(
+			createNameHierarchy(L"ns::Class" + std::to_wstring(i + 1)));
+
+		const Id classId = client->recordSymbol(createNameHierarchy(className));
+		client->recordSymbolKind(classId, SYMBOL_CLASS);
+		client->recordDefinitionKind(classId, DEFINITION_EXPLICIT);
+		client->recordLocation(
+			classId, ParseLocation(sourceFileId, line, 7, line, 12), ParseLocationType::TOKEN);
+		client->recordReference(
+			REFERENCE_INHERITANCE,
+			baseId,
+			classId,
+			ParseLocation(sourceFileId, line, 16, line, 19));
+
+		const Id methodId = client->recordSymbol(
+			createFunctionNameHierarchy(L"void", className + L"::run", L"()"));
+		client->recordSymbolKind(methodId, SYMBOL_METHOD);
+		client->recordDefinitionKind(methodId, DEFINITION_EXPLICIT);
+		client->recordAccessKind(methodId, ACCESS_PUBLIC);
+		client->recordLocation(
+			methodId,
+			ParseLocation(sourceFileId, line + 1, 7, line + 1, 9),
+			ParseLocationType::TOKEN);
+		client->recordLocation(
+			methodId,
+			ParseLocation(sourceFileId, line + 1, 1, line + 5, 1),
+			ParseLocationType::SCOPE);
+		client->recordComment(ParseLocation(sourceFileId, line + 2, 1, line + 2, 20));
+		client->recordLocalSymbol(
+			localSymbolName, ParseLocation(sourceFileId, line + 3, 3, line + 3, 3));
+
+		if (previousMethodId)
+		{
+			client->recordReference(
+				REFERENCE_CALL,
+				previousMethodId,
+				methodId,
+				ParseLocation(sourceFileId, line + 3, 5, line + 3, 7));
+		}
+		client->recordReference(
+			REFERENCE_TYPE_USAGE,
+			nextClassId,
+			methodId,
+			ParseLocation(sourceFileId, line + 4, 5, line + 4, 9));
+		client->recordReference(
+			REFERENCE_TYPE_USAGE,
+			baseId,
+			methodId,
+			ParseLocation(headerFileId, i + 1, 1, i + 1, 4));
+
+		if (i % 10 == 5)
+		{
+			client->recordError(
+				L"unknown type",
+				false,
+				true,
+				sourceFilePath,
+				ParseLocation(headerFileId, i + 1, 1));
+		}
+
+		previousMethodId = methodId;
+	}
+}
+
+// indexes a translation unit with the storage chunking of the indexers, so larger translation units
+// are handed over in several chunks
+std::vector<std::shared_ptr<IntermediateStorage>> indexTranslationUnit(
+	const std::wstring& fileName, size_t classCount, size_t chunkByteSize)
+{
+	TestIndexer<IndexerCommandCustom> indexer(
+		[&fileName, classCount](
+			std::shared_ptr<IndexerCommandCustom> indexerCommand,
+			ParserClientImpl* parserClient,
+			IndexerStateInfo* indexerStateInfo) {
+			recordLargeTranslationUnit(parserClient, classCount, fileName);
+		});
+
+	std::vector<std::shared_ptr<IntermediateStorage>> storages;
+	indexer.setStorageChunkCallback(
+		chunkByteSize,
+		[&storages](std::shared_ptr<IntermediateStorage> chunk) { storages.push_back(chunk); });
+	storages.push_back(indexer.index(std::make_shared<IndexerCommandCustom>(
+		L"", FilePath(), FilePath(), L"", FilePath(L"data/" + fileName + L".cpp"), false)));
+	return storages;
+}
+
+void injectStorages(
+	const FilePath& databaseFilePath,
+	const std::vector<std::shared_ptr<IntermediateStorage>>& storages)
+{
+	FileSystem::remove(databaseFilePath);
+
+	PersistentStorage storage(databaseFilePath, FilePath());
+	storage.setup();
+	storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+	storage.buildCaches();
+	for (const std::shared_ptr<IntermediateStorage>& intermediateStorage: storages)
+	{
+		storage.inject(intermediateStorage.get());
+	}
+}
+
+// describes the content of a database without the ids that depend on the order of insertion
+std::vector<std::wstring> describeDatabase(const FilePath& databaseFilePath)
+{
+	PersistentStorage storage(databaseFilePath, FilePath());
+
+	std::map<Id, std::wstring> elementNames;
+	for (const StorageNode& node: storage.getStorageNodes())
+	{
+		elementNames[node.id] = L"node " + std::to_wstring(node.type) + L" " + node.serializedName;
+	}
+	for (const StorageEdge& edge: storage.getStorageEdges())
+	{
+		elementNames[edge.id] = L"edge " + std::to_wstring(edge.type) + L" " +
+			elementNames[edge.sourceNodeId] + L" " + elementNames[edge.targetNodeId];
+	}
+	for (const StorageLocalSymbol& localSymbol: storage.getStorageLocalSymbols())
+	{
+		elementNames[localSymbol.id] = L"local symbol " + localSymbol.name;
+	}
+	for (const StorageError& error: storage.getErrors())
+	{
+		// errors are shared by all translation units with the same message, so the stored
+		// translation unit depends on the order of injection
+		elementNames[error.id] = L"error " + error.message + L" " + std::to_wstring(error.fatal) +
+			L" " + std::to_wstring(error.indexed);
+	}
+
+	std::map<Id, std::wstring> locationNames;
+	for (const StorageSourceLocation& location: storage.getStorageSourceLocations())
+	{
+		locationNames[location.id] = L"location " + elementNames[location.fileNodeId] + L" " +
+			std::to_wstring(location.startLine) + L":" + std::to_wstring(location.startCol) +
+			L" " + std::to_wstring(location.endLine) + L":" + std::to_wstring(location.endCol) +
+			L" " + std::to_wstring(location.type);
+	}
+
+	std::vector<std::wstring> lines;
+	for (const auto& it: elementNames)
+	{
+		lines.push_back(it.second);
+	}
+	for (const auto& it: locationNames)
+	{
+		lines.push_back(it.second);
+	}
+	for (const StorageFile& file: storage.getStorageFiles())
+	{
+		lines.push_back(
+			L"file " + file.filePath + L" " + file.languageIdentifier + L" " +
+			std::to_wstring(file.indexed) + L" " + std::to_wstring(file.complete));
+	}
+	for (const StorageSymbol& symbol: storage.getStorageSymbols())
+	{
+		lines.push_back(
+			L"symbol " + elementNames[symbol.id] + L" " + std::to_wstring(symbol.definitionKind));
+	}
+	for (const StorageOccurrence& occurrence: storage.getStorageOccurrences())
+	{
+		lines.push_back(
+			L"occurrence " + elementNames[occurrence.elementId] + L" " +
+			locationNames[occurrence.sourceLocationId]);
+	}
+	for (const StorageComponentAccess& componentAccess: storage.getComponentAccesses())
+	{
+		lines.push_back(
+			L"access " + elementNames[componentAccess.nodeId] + L" " +
+			std::to_wstring(componentAccess.type));
+	}
+
+	std::sort(lines.begin(), lines.end());
+	return lines;
+}
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+// lets the indexer finish the given number of translation units, the next one only finishes when
+// the indexing gets interrupted, so its index never reaches the storage
+struct IndexingGate
+{
+	std::mutex mutex;
+	size_t openCount = 0;
+	std::set<FilePath> indexedFilePaths;
+	bool blocked = false;
+};
+
+void recordGatedTranslationUnit(
+	std::shared_ptr<IndexingGate> gate,
+	std::shared_ptr<IndexerCommandCxx> indexerCommand,
+	ParserClientImpl* parserClient,
+	IndexerStateInfo* indexerStateInfo)
+{
+	const FilePath sourceFilePath = indexerCommand->getSourceFilePath();
+	recordLargeTranslationUnit(
+		parserClient, 20, L"StorageTestSuite/" + sourceFilePath.withoutExtension().fileName());
+
+	{
+		std::lock_guard<std::mutex> lock(gate->mutex);
+		if (gate->indexedFilePaths.size() < gate->openCount)
+		{
+			gate->indexedFilePaths.insert(sourceFilePath);
+			return;
+		}
+		gate->blocked = true;
+	}
+
+	while (!indexerStateInfo->indexingInterrupted)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+}
+
+// runs the parsing tasks of a project refresh with a single indexer thread and interrupts them as
+// soon as the given function returns true
+void runIndexingTasks(
+	std::shared_ptr<PersistentStorage> storage,
+	const std::set<FilePath>& sourceFilePaths,
+	std::function<bool()> interruptIf)
+{
+	const std::string appUUID = "storage_test_suite";
+	std::shared_ptr<DialogView> dialogView = std::make_shared<DialogView>(
+		DialogView::UseCase::INDEXING, nullptr);
+	std::shared_ptr<StorageProvider> storageProvider = std::make_shared<StorageProvider>();
+
+	std::vector<std::shared_ptr<IndexerCommand>> indexerCommands;
+	for (const FilePath& sourceFilePath: sourceFilePaths)
+	{
+		indexerCommands.push_back(std::make_shared<IndexerCommandCxx>(
+			sourceFilePath,
+			std::set<FilePath>(),
+			std::set<FilePathFilter>(),
+			std::set<FilePathFilter>(),
+			FilePath(),
+			std::vector<std::wstring>()));
+	}
+
+	const auto waitUntilSet = [](const std::string& valueName) {
+		return std::make_shared<TaskDecoratorRepeat>(
+				   TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+			->addChildTask(std::make_shared<TaskReturnSuccessIf<bool>>(
+				valueName, TaskReturnSuccessIf<bool>::CONDITION_EQUALS, false));
+	};
+	const auto repeatWhileIndexing = [](std::shared_ptr<Task> task) {
+		return std::make_shared<TaskDecoratorRepeat>(
+				   TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+			->addChildTask(std::make_shared<TaskGroupSelector>()->addChildTasks(
+				task,
+				std::make_shared<TaskReturnSuccessIf<bool>>(
+					"indexer_threads_stopped",
+					TaskReturnSuccessIf<bool>::CONDITION_EQUALS,
+					false)));
+	};
+
+	std::shared_ptr<TaskGroupParallel> taskParallelIndexing = std::make_shared<TaskGroupParallel>();
+	taskParallelIndexing->addTask(std::make_shared<TaskFillIndexerCommandsQueue>(
+		appUUID, std::make_unique<MemoryIndexerCommandProvider>(indexerCommands), 1));
+	taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
+		waitUntilSet("indexer_command_queue_started"),
+		std::make_shared<TaskBuildIndex>(
+			1, storageProvider, dialogView, appUUID, false, 0, INDEXER_COMMAND_UNKNOWN)));
+	taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
+		waitUntilSet("indexer_threads_started"),
+		repeatWhileIndexing(std::make_shared<TaskMergeStorages>(storageProvider))));
+	taskParallelIndexing->addTask(std::make_shared<TaskGroupSequence>()->addChildTasks(
+		waitUntilSet("indexer_threads_started"),
+		repeatWhileIndexing(std::make_shared<TaskInjectStorage>(storageProvider, storage))));
+
+	std::shared_ptr<TaskParseWrapper> taskParseWrapper = std::make_shared<TaskParseWrapper>(
+		storage, dialogView);
+	taskParseWrapper->setTask(taskParallelIndexing);
+
+	std::shared_ptr<TaskGroupSequence> taskSequential = std::make_shared<TaskGroupSequence>();
+	taskSequential->addTask(std::make_shared<TaskLambda>(
+		[storage, sourceFilePaths]() { storage->setPendingSourceFiles(sourceFilePaths); }));
+	taskSequential->addTask(std::make_shared<TaskSetValue<int>>(
+		"source_file_count", static_cast<int>(sourceFilePaths.size())));
+	taskSequential->addTask(std::make_shared<TaskSetValue<int>>("indexed_source_file_count", 0));
+	for (const std::string& valueName:
+		 {"interrupted_indexing",
+		  "indexer_threads_started",
+		  "indexer_threads_stopped",
+		  "indexer_command_queue_started",
+		  "indexer_command_queue_stopped"})
+	{
+		taskSequential->addTask(std::make_shared<TaskSetValue<bool>>(valueName, false));
+	}
+	taskSequential->addTask(taskParseWrapper);
+	taskSequential->addTask(
+		std::make_shared<TaskDecoratorRepeat>(
+			TaskDecoratorRepeat::CONDITION_WHILE_SUCCESS, Task::STATE_SUCCESS, 25)
+			->addChildTask(std::make_shared<TaskInjectStorage>(storageProvider, storage)));
+	taskSequential->addTask(std::make_shared<TaskFinishParsing>(storage, dialogView));
+
+	TaskRunner taskRunner(taskSequential);
+	std::shared_ptr<Blackboard> blackboard = std::make_shared<Blackboard>();
+	bool interrupted = false;
+	Task::TaskState state = Task::STATE_RUNNING;
+	while ((state = taskRunner.update(blackboard)) == Task::STATE_RUNNING)
+	{
+		if (!interrupted && interruptIf())
+		{
+			// the message loop does not run in the tests, so the message is handled right away
+			MessageQueue::getInstance()->processMessage(
+				std::make_shared<MessageIndexingInterrupted>(), false);
+			interrupted = true;
+		}
+	}
+	REQUIRE(state == Task::STATE_SUCCESS);
+}
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
 }	 // namespace
 
 TEST_CASE("storage saves file")
@@ -283,3 +708,665 @@ TEST_CASE("storage finds and removes depending file nodes")
 	// TS_ASSERT(!storage.getEdgeWithId(id4));
 	// TS_ASSERT(!storage.getEdgeWithId(id5));
 }
+
+TEST_CASE("storage of chunked parser client results equals storage of unchunked results")
+{
+	const size_t classCount = 200;
+
+	const std::vector<std::shared_ptr<IntermediateStorage>> storages =
+		indexTranslationUnit(L"large", classCount, 0);
+	REQUIRE(storages.size() == 1);
+	const std::shared_ptr<IntermediateStorage> storage = storages[0];
+
+	const std::vector<std::shared_ptr<IntermediateStorage>> chunks =
+		indexTranslationUnit(L"large", classCount, 4096);
+	REQUIRE(chunks.size() > 10);
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		REQUIRE(chunks[i]->isChunk() == (i + 1 < chunks.size()));
+
+		// each chunk only holds a part of the source locations
+		REQUIRE(chunks[i]->getSourceLocationCount() < storage->getSourceLocationCount() / 2);
+	}
+
+	const FilePath unchunkedFilePath(L"data/unchunked.sqlite");
+	const FilePath chunkedFilePath(L"data/chunked.sqlite");
+	injectStorages(unchunkedFilePath, {storage});
+	injectStorages(chunkedFilePath, chunks);
+
+	const std::vector<std::wstring> unchunkedDescription = describeDatabase(unchunkedFilePath);
+	const std::vector<std::wstring> chunkedDescription = describeDatabase(chunkedFilePath);
+	REQUIRE(unchunkedDescription.size() > classCount * 10);
+	REQUIRE(unchunkedDescription == chunkedDescription);
+
+	FileSystem::remove(unchunkedFilePath);
+	FileSystem::remove(chunkedFilePath);
+}
+
+TEST_CASE("storage resumed after interrupted injection equals storage of uninterrupted injection")
+{
+	const std::vector<std::wstring> fileNames = {L"a", L"b", L"c", L"d", L"e", L"f"};
+	const auto indexTranslationUnits = [&fileNames](const std::set<FilePath>& sourceFilePaths) {
+		std::vector<std::shared_ptr<IntermediateStorage>> storages;
+		for (size_t i = 0; i < fileNames.size(); i++)
+		{
+			if (sourceFilePaths.find(FilePath(L"data/" + fileNames[i] + L".cpp")) !=
+				sourceFilePaths.end())
+			{
+				// the first translation units are large enough to be chunked
+				utility::append(
+					storages, indexTranslationUnit(fileNames[i], i < 2 ? 100 : 10 + i, 4096));
+			}
+		}
+		return storages;
+	};
+
+	std::set<FilePath> sourceFilePaths;
+	for (const std::wstring& fileName: fileNames)
+	{
+		sourceFilePaths.insert(FilePath(L"data/" + fileName + L".cpp"));
+	}
+
+	const FilePath cleanFilePath(L"data/clean.sqlite");
+	injectStorages(cleanFilePath, indexTranslationUnits(sourceFilePaths));
+	const std::vector<std::wstring> cleanDescription = describeDatabase(cleanFilePath);
+	FileSystem::remove(cleanFilePath);
+
+	const FilePath resumedFilePath(L"data/resumed.sqlite");
+	for (size_t mergeCount: {0, 3})
+	{
+		for (size_t injectionCount: {0, 1, 4, 10, 1000})
+		{
+			FileSystem::remove(resumedFilePath);
+
+			// run the merge and inject tasks of the indexing pipeline until the interruption
+			std::set<FilePath> pendingSourceFilePaths;
+			{
+				std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+					resumedFilePath, FilePath());
+				storage->setup();
+				storage->setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+				storage->buildCaches();
+				storage->setPendingSourceFiles(sourceFilePaths);
+
+				std::shared_ptr<StorageProvider> storageProvider =
+					std::make_shared<StorageProvider>();
+				for (std::shared_ptr<IntermediateStorage> intermediateStorage:
+					 indexTranslationUnits(sourceFilePaths))
+				{
+					storageProvider->insert(intermediateStorage);
+				}
+
+				std::shared_ptr<Blackboard> blackboard = std::make_shared<Blackboard>();
+				TaskMergeStorages mergeTask(storageProvider);
+				TaskInjectStorage injectTask(storageProvider, storage);
+				for (size_t i = 0; i < mergeCount; i++)
+				{
+					mergeTask.update(blackboard);
+				}
+				for (size_t i = 0; i < injectionCount; i++)
+				{
+					injectTask.update(blackboard);
+				}
+
+				const bool interrupted = storageProvider->getStorageCount() > 0;
+				storageProvider->clear();
+
+				// same as finishing the parsing
+				if (interrupted)
+				{
+					storage->checkpointInjectedSourceFiles();
+				}
+				else
+				{
+					storage->setPendingSourceFiles({});
+				}
+
+				pendingSourceFilePaths = storage->getPendingSourceFiles();
+				REQUIRE(pendingSourceFilePaths.empty() == !interrupted);
+				if (injectionCount == 0)
+				{
+					REQUIRE(pendingSourceFilePaths == sourceFilePaths);
+				}
+			}
+
+			// index the pending source files again, like the refresh of a kept database does
+			{
+				PersistentStorage storage(resumedFilePath, FilePath());
+				storage.setup();
+				storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+				storage.buildCaches();
+				REQUIRE(storage.getPendingSourceFiles() == pendingSourceFilePaths);
+
+				storage.setPendingSourceFiles(pendingSourceFilePaths);
+				for (std::shared_ptr<IntermediateStorage> intermediateStorage:
+					 indexTranslationUnits(pendingSourceFilePaths))
+				{
+					storage.inject(intermediateStorage.get());
+					storage.addInjectedSourceFileChunkCounts(
+						intermediateStorage->getSourceFileChunkCounts());
+				}
+				storage.checkpointInjectedSourceFiles();
+				REQUIRE(storage.getPendingSourceFiles().empty());
+			}
+
+			REQUIRE(describeDatabase(resumedFilePath) == cleanDescription);
+		}
+	}
+
+	FileSystem::remove(resumedFilePath);
+}
+
+#if BUILD_CXX_LANGUAGE_PACKAGE
+TEST_CASE("indexing resumed after interrupted parsing tasks equals uninterrupted indexing")
+{
+	const FilePath directoryPath(L"data/StorageTestSuite");
+	FileSystem::createDirectory(directoryPath);
+
+	std::set<FilePath> sourceFilePaths;
+	std::set<FilePath> allFilePaths;
+	for (const std::wstring& fileName: {L"a", L"b", L"c", L"d", L"e", L"f"})
+	{
+		for (const std::wstring& extension: {L".cpp", L".h"})
+		{
+			const FilePath filePath = directoryPath.getConcatenated(fileName + extension);
+			std::ofstream file(filePath.str());
+			file << "// recorded by the test indexer\n";
+			allFilePaths.insert(filePath);
+		}
+		sourceFilePaths.insert(directoryPath.getConcatenated(fileName + L".cpp"));
+	}
+
+	std::shared_ptr<IndexingGate> gate = std::make_shared<IndexingGate>();
+	LanguagePackageManager::getInstance()->addPackage(
+		std::make_shared<TestLanguagePackage<IndexerCommandCxx>>(
+			[gate](
+				std::shared_ptr<IndexerCommandCxx> indexerCommand,
+				ParserClientImpl* parserClient,
+				IndexerStateInfo* indexerStateInfo) {
+				recordGatedTranslationUnit(gate, indexerCommand, parserClient, indexerStateInfo);
+			}));
+	const auto openGate = [gate](size_t openCount) {
+		std::lock_guard<std::mutex> lock(gate->mutex);
+		gate->openCount = openCount;
+		gate->indexedFilePaths.clear();
+		gate->blocked = false;
+	};
+	const auto isGateBlocked = [gate]() {
+		std::lock_guard<std::mutex> lock(gate->mutex);
+		return gate->blocked;
+	};
+
+	const auto openStorage = [](const FilePath& databaseFilePath) {
+		std::shared_ptr<PersistentStorage> storage = std::make_shared<PersistentStorage>(
+			databaseFilePath, FilePath());
+		storage->setup();
+		return storage;
+	};
+	const auto getRefreshInfo = [&allFilePaths, &sourceFilePaths, &openStorage](
+									const FilePath& databaseFilePath) {
+		std::shared_ptr<PersistentStorage> storage = openStorage(databaseFilePath);
+		storage->buildCaches();
+		return RefreshInfoGenerator::getRefreshInfoForUpdatedFiles(
+			{std::make_shared<SourceGroupTest>(sourceFilePaths, allFilePaths)}, storage);
+	};
+
+	const FilePath cleanFilePath(L"data/StorageTestSuite/clean.srctrldb");
+	const FilePath resumedFilePath(L"data/StorageTestSuite/resumed.srctrldb");
+	const auto removeDatabases = [&cleanFilePath, &resumedFilePath]() {
+		for (const FilePath& databaseFilePath: {cleanFilePath, resumedFilePath})
+		{
+			FileSystem::remove(databaseFilePath);
+			FileSystem::remove(PersistentStorage::getFullTextSearchIndexFilePath(databaseFilePath));
+		}
+	};
+	removeDatabases();
+
+	openGate(sourceFilePaths.size());
+	runIndexingTasks(openStorage(cleanFilePath), sourceFilePaths, []() { return false; });
+	const std::vector<std::wstring> cleanDescription = describeDatabase(cleanFilePath);
+
+	std::set<FilePath> pendingSourceFilePaths;
+	{
+		// interrupted after the first translation units reached a checkpoint
+		std::shared_ptr<PersistentStorage> storage = openStorage(resumedFilePath);
+		openGate(2);
+		runIndexingTasks(storage, sourceFilePaths, [&]() {
+			return isGateBlocked() && storage->getPendingSourceFiles().size() == 4;
+		});
+
+		pendingSourceFilePaths = sourceFilePaths;
+		for (const FilePath& indexedFilePath: gate->indexedFilePaths)
+		{
+			pendingSourceFilePaths.erase(indexedFilePath);
+		}
+		REQUIRE(pendingSourceFilePaths.size() == 4);
+		REQUIRE(storage->getPendingSourceFiles() == pendingSourceFilePaths);
+	}
+	{
+		const RefreshInfo refreshInfo = getRefreshInfo(resumedFilePath);
+		REQUIRE(refreshInfo.filesToIndex == pendingSourceFilePaths);
+		REQUIRE(refreshInfo.filesToClear.empty());
+	}
+
+	{
+		// interrupted in the middle of the first translation unit, before any checkpoint
+		std::shared_ptr<PersistentStorage> storage = openStorage(resumedFilePath);
+		openGate(0);
+		runIndexingTasks(storage, pendingSourceFilePaths, isGateBlocked);
+
+		REQUIRE(isGateBlocked());
+		REQUIRE(storage->getPendingSourceFiles() == pendingSourceFilePaths);
+	}
+	{
+		const RefreshInfo refreshInfo = getRefreshInfo(resumedFilePath);
+		REQUIRE(refreshInfo.filesToIndex == pendingSourceFilePaths);
+		REQUIRE(refreshInfo.filesToClear.empty());
+	}
+
+	// a chunk of a pending translation unit that reached the storage before an interruption, with
+	// a class the translation unit doesn't contain anymore
+	const FilePath partiallyStoredFilePath = *pendingSourceFilePaths.rbegin();
+	const size_t descriptionSize = describeDatabase(resumedFilePath).size();
+	{
+		TestIndexer<IndexerCommandCustom> indexer(
+			[&partiallyStoredFilePath](
+				std::shared_ptr<IndexerCommandCustom> indexerCommand,
+				ParserClientImpl* parserClient,
+				IndexerStateInfo* indexerStateInfo) {
+				const Id fileId = parserClient->recordFile(partiallyStoredFilePath, true);
+				const Id classId = parserClient->recordSymbol(createNameHierarchy(L"RemovedClass"));
+				parserClient->recordSymbolKind(classId, SYMBOL_CLASS);
+				parserClient->recordDefinitionKind(classId, DEFINITION_EXPLICIT);
+				parserClient->recordLocation(
+					classId, ParseLocation(fileId, 1, 7, 1, 18), ParseLocationType::TOKEN);
+			});
+
+		std::shared_ptr<PersistentStorage> storage = openStorage(resumedFilePath);
+		storage->setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		storage->buildCaches();
+		storage->inject(indexer
+							.index(std::make_shared<IndexerCommandCustom>(
+								L"", FilePath(), FilePath(), L"", partiallyStoredFilePath, false))
+							.get());
+	}
+	REQUIRE(describeDatabase(resumedFilePath).size() > descriptionSize);
+
+	{
+		// the refresh clears the stored chunk before the file is indexed again
+		const RefreshInfo refreshInfo = getRefreshInfo(resumedFilePath);
+		REQUIRE(refreshInfo.filesToIndex == pendingSourceFilePaths);
+		REQUIRE(refreshInfo.filesToClear.count(partiallyStoredFilePath) == 1);
+
+		std::shared_ptr<PersistentStorage> storage = openStorage(resumedFilePath);
+		storage->setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		storage->clearFileElements(
+			utility::toVector(
+				utility::concat(refreshInfo.filesToClear, refreshInfo.nonIndexedFilesToClear)),
+			[](int) {});
+
+		openGate(sourceFilePaths.size());
+		runIndexingTasks(storage, refreshInfo.filesToIndex, []() { return false; });
+
+		REQUIRE(gate->indexedFilePaths == pendingSourceFilePaths);
+		REQUIRE(storage->getPendingSourceFiles().empty());
+	}
+	REQUIRE(getRefreshInfo(resumedFilePath).filesToIndex.empty());
+	REQUIRE(describeDatabase(resumedFilePath) == cleanDescription);
+
+	LanguagePackageManager::destroyInstance();
+	removeDatabases();
+	for (const FilePath& filePath: allFilePaths)
+	{
+		FileSystem::remove(filePath);
+	}
+	FileSystem::remove(directoryPath);
+}
+#endif	  // BUILD_CXX_LANGUAGE_PACKAGE
+
+TEST_CASE("storage provider hands out the smallest storages for merging")
+{
+	StorageProvider storageProvider;
+	for (size_t classCount: {5, 40, 10, 20})
+	{
+		storageProvider.insert(indexTranslationUnit(L"file", classCount, 0).back());
+	}
+
+	std::pair<std::shared_ptr<IntermediateStorage>, std::shared_ptr<IntermediateStorage>> storages =
+		storageProvider.consumeStoragesToMerge();
+	REQUIRE(storages.first);
+	REQUIRE(storages.second);
+	REQUIRE(storages.first->getSourceLocationCount() > storages.second->getSourceLocationCount());
+	REQUIRE(storageProvider.getStorageCount() == 2);
+
+	// the largest storage is left for injection
+	const size_t mergedSourceLocationCount = storages.first->getSourceLocationCount();
+	storages = storageProvider.consumeStoragesToMerge();
+	REQUIRE(!storages.first);
+	REQUIRE(!storages.second);
+	REQUIRE(storageProvider.getStorageCount() == 2);
+
+	const std::shared_ptr<IntermediateStorage> largestStorage =
+		storageProvider.consumeLargestStorage();
+	const std::shared_ptr<IntermediateStorage> secondLargestStorage =
+		storageProvider.consumeLargestStorage();
+	REQUIRE(
+		largestStorage->getSourceLocationCount() > secondLargestStorage->getSourceLocationCount());
+	REQUIRE(secondLargestStorage->getSourceLocationCount() > mergedSourceLocationCount);
+}
+
+TEST_CASE("storage merged by parallel merge tasks equals storage of unmerged storages")
+{
+	const auto indexTranslationUnits = []() {
+		std::vector<std::shared_ptr<IntermediateStorage>> storages;
+		for (size_t i = 0; i < 40; i++)
+		{
+			utility::append(
+				storages, indexTranslationUnit(L"file" + std::to_wstring(i), 5 + i % 7 * 10, 4096));
+		}
+		return storages;
+	};
+
+	const FilePath unmergedFilePath(L"data/unmerged.sqlite");
+	const FilePath mergedFilePath(L"data/merged.sqlite");
+	injectStorages(unmergedFilePath, indexTranslationUnits());
+
+	std::shared_ptr<StorageProvider> storageProvider = std::make_shared<StorageProvider>();
+	for (std::shared_ptr<IntermediateStorage> storage: indexTranslationUnits())
+	{
+		storageProvider->insert(storage);
+	}
+
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < 4; i++)
+	{
+		threads.emplace_back([storageProvider]() {
+			std::shared_ptr<Blackboard> blackboard = std::make_shared<Blackboard>();
+			TaskMergeStorages mergeTask(storageProvider);
+			while (mergeTask.update(blackboard) == Task::STATE_SUCCESS)
+				;
+		});
+	}
+	for (std::thread& thread: threads)
+	{
+		thread.join();
+	}
+
+	REQUIRE(storageProvider->getStorageCount() == 2);
+
+	std::vector<std::shared_ptr<IntermediateStorage>> storages;
+	while (std::shared_ptr<IntermediateStorage> storage = storageProvider->consumeLargestStorage())
+	{
+		storages.push_back(storage);
+	}
+	injectStorages(mergedFilePath, storages);
+
+	REQUIRE(describeDatabase(unmergedFilePath) == describeDatabase(mergedFilePath));
+
+	FileSystem::remove(unmergedFilePath);
+	FileSystem::remove(mergedFilePath);
+}
+
+TEST_CASE("storage merges databases of custom commands into target database")
+{
+	const FilePath targetFilePath(L"data/custom_target.sqlite");
+	createCustomCommandDatabase(targetFilePath, L"thread0", 10);
+
+	std::vector<FilePath> sourceFilePaths;
+	for (int i = 1; i < 6; i++)
+	{
+		sourceFilePaths.push_back(
+			FilePath(L"data/custom_target.sqlite_thread" + std::to_wstring(i)));
+		createCustomCommandDatabase(sourceFilePaths.back(), L"thread" + std::to_wstring(i), 10);
+	}
+
+	TaskExecuteCustomCommands::mergeDatabases(targetFilePath, sourceFilePaths);
+
+	for (const FilePath& sourceFilePath: sourceFilePaths)
+	{
+		REQUIRE(!sourceFilePath.recheckExists());
+	}
+
+	{
+		PersistentStorage storage(targetFilePath, FilePath());
+		REQUIRE(storage.getStorageFiles().size() == 60);
+
+		// the type used by all databases is only stored once
+		size_t sharedTypeCount = 0;
+		for (const StorageNode& node: storage.getStorageNodes())
+		{
+			if (NameHierarchy::deserialize(node.serializedName).getQualifiedName() == L"shared_type")
+			{
+				sharedTypeCount++;
+			}
+		}
+		REQUIRE(sharedTypeCount == 1);
+	}
+
+	FileSystem::remove(targetFilePath);
+}
+
+TEST_CASE("storage with updated search index finds same symbols as storage with rebuilt index")
+{
+	const FilePath databaseFilePath(L"data/search_index.sqlite");
+	const FilePath tempDatabaseFilePath(L"data/search_index_temp.sqlite");
+
+	std::vector<std::shared_ptr<IntermediateStorage>> storages = indexTranslationUnit(
+		L"a", 30, 1 << 20);
+	utility::append(storages, indexTranslationUnit(L"b", 20, 1 << 20));
+	injectStorages(databaseFilePath, storages);
+
+	PersistentStorage::SearchIndices previousSearchIndices;
+	{
+		PersistentStorage storage(databaseFilePath, FilePath());
+		storage.buildCaches();
+		previousSearchIndices = storage.releaseSearchIndices();
+	}
+
+	// refresh the first translation unit with fewer classes, like a refresh of a kept database
+	FileSystem::remove(tempDatabaseFilePath);
+	FileSystem::copyFile(databaseFilePath, tempDatabaseFilePath);
+	std::set<Id> changedNodeIds;
+	{
+		PersistentStorage storage(tempDatabaseFilePath, FilePath());
+		storage.setup();
+		storage.setMode(SqliteIndexStorage::STORAGE_MODE_WRITE);
+		storage.clearFileElements({FilePath(L"data/a.cpp"), FilePath(L"data/a.h")}, [](int) {});
+		for (const std::shared_ptr<IntermediateStorage>& intermediateStorage:
+			 indexTranslationUnit(L"a", 10, 1 << 20))
+		{
+			storage.inject(intermediateStorage.get());
+		}
+		changedNodeIds = storage.getChangedNodeIds();
+	}
+	REQUIRE(!changedNodeIds.empty());
+
+	PersistentStorage updatedStorage(tempDatabaseFilePath, FilePath());
+	updatedStorage.buildCaches(std::move(previousSearchIndices), changedNodeIds);
+
+	PersistentStorage rebuiltStorage(tempDatabaseFilePath, FilePath());
+	rebuiltStorage.buildCaches();
+
+	for (const std::wstring& query: {L"class", L"cl2", L"cl25", L"run", L"base", L"a.cpp"})
+	{
+		const std::vector<SearchMatch> updatedMatches = updatedStorage.getAutocompletionMatches(
+			query, NodeTypeSet::all(), SearchFilter(), false);
+		const std::vector<SearchMatch> rebuiltMatches = rebuiltStorage.getAutocompletionMatches(
+			query, NodeTypeSet::all(), SearchFilter(), false);
+
+		REQUIRE(updatedMatches.size() == rebuiltMatches.size());
+		for (size_t i = 0; i < updatedMatches.size(); i++)
+		{
+			REQUIRE(updatedMatches[i].name == rebuiltMatches[i].name);
+			REQUIRE(updatedMatches[i].score == rebuiltMatches[i].score);
+			REQUIRE(updatedMatches[i].tokenIds == rebuiltMatches[i].tokenIds);
+		}
+	}
+	REQUIRE(!updatedStorage.getAutocompletionMatches(
+		L"run", NodeTypeSet::all(), SearchFilter(), false).empty());
+
+	FileSystem::remove(databaseFilePath);
+	FileSystem::remove(tempDatabaseFilePath);
+}
+
+TEST_CASE("storage autocompletion only returns symbols and files accepted by the search filter")
+{
+	const FilePath databaseFilePath(L"data/search_filter.sqlite");
+	injectStorages(databaseFilePath, indexTranslationUnit(L"filter", 3, 1 << 20));
+
+	PersistentStorage storage(databaseFilePath, FilePath());
+	storage.buildCaches();
+
+	auto getMatchNames = [&storage](const std::wstring& query, const SearchFilter& filter) {
+		std::set<std::wstring> names;
+		for (const SearchMatch& match:
+			 storage.getAutocompletionMatches(query, NodeTypeSet::all(), filter, false))
+		{
+			names.insert(match.name);
+		}
+		return names;
+	};
+
+	SearchFilter nonIndexedFilter;
+	nonIndexedFilter.definition = SearchFilter::DEFINITION_NON_INDEXED;
+	SearchFilter indexedFilter;
+	indexedFilter.definition = SearchFilter::DEFINITION_INDEXED;
+	SearchFilter cxxFilter;
+	cxxFilter.language = SearchFilter::LANGUAGE_CXX;
+	SearchFilter javaFilter;
+	javaFilter.language = SearchFilter::LANGUAGE_JAVA;
+
+	REQUIRE(getMatchNames(L"base", SearchFilter()).count(L"ns::Base") == 1);
+	REQUIRE(getMatchNames(L"base", nonIndexedFilter).count(L"ns::Base") == 1);
+	REQUIRE(getMatchNames(L"base", indexedFilter).count(L"ns::Base") == 0);
+	REQUIRE(getMatchNames(L"class1", indexedFilter).count(L"ns::Class1") == 1);
+	REQUIRE(getMatchNames(L"class1", cxxFilter).count(L"ns::Class1") == 1);
+	REQUIRE(getMatchNames(L"class", javaFilter).empty());
+
+	// files are defined and have no language
+	REQUIRE(getMatchNames(L"filter.cpp", indexedFilter).count(L"data/filter.cpp") == 1);
+	REQUIRE(getMatchNames(L"filter.cpp", nonIndexedFilter).empty());
+	REQUIRE(getMatchNames(L"filter.cpp", cxxFilter).empty());
+
+	// filters that are already set are not offered again
+	auto getCommandNames = [&storage](const std::wstring& query, const SearchFilter& filter) {
+		std::set<std::wstring> names;
+		for (const SearchMatch& match:
+			 storage.getAutocompletionMatches(query, NodeTypeSet::all(), filter, true))
+		{
+			if (match.searchType == SearchMatch::SEARCH_COMMAND)
+			{
+				REQUIRE(match.typeName == L"filter");
+				names.insert(match.name);
+			}
+		}
+		return names;
+	};
+
+	REQUIRE(getCommandNames(L"indexed", SearchFilter()).count(L"indexed") == 1);
+	REQUIRE(getCommandNames(L"indexed", indexedFilter).empty());
+	REQUIRE(getCommandNames(L"c/c++", indexedFilter).count(L"c/c++") == 1);
+	REQUIRE(getCommandNames(L"java", cxxFilter).empty());
+
+	FileSystem::remove(databaseFilePath);
+}
+
+TEST_CASE("storage passes fulltext search locations in chunks and continues stopped searches")
+{
+	const FilePath directoryPath(L"data/StorageTestSuite");
+	const FilePath databaseFilePath(L"data/fulltext.sqlite");
+	FileSystem::createDirectory(directoryPath);
+
+	// the files contain the search term once to five times, so the batches of files are chunks of
+	// different sizes
+	std::shared_ptr<IntermediateStorage> intermediateStorage =
+		std::make_shared<IntermediateStorage>();
+	std::vector<FilePath> filePaths;
+	size_t termCount = 0;
+	for (size_t i = 0; i < 40; i++)
+	{
+		filePaths.push_back(directoryPath.getConcatenated(L"file" + std::to_wstring(i) + L".cpp"));
+		{
+			std::ofstream file(filePaths.back().str());
+			for (size_t j = 0; j <= i % 5; j++)
+			{
+				file << "int value" << j << " = searchTerm();\n";
+				termCount++;
+			}
+		}
+
+		const Id fileId = intermediateStorage
+							  ->addNode(StorageNodeData(
+								  nodeKindToInt(NODE_FILE),
+								  NameHierarchy::serialize(
+									  NameHierarchy(filePaths.back().wstr(), NAME_DELIMITER_FILE))))
+							  .first;
+		intermediateStorage->addFile(
+			StorageFile(fileId, filePaths.back().wstr(), L"cpp", "", true, true));
+	}
+	injectStorages(databaseFilePath, {intermediateStorage});
+
+	PersistentStorage storage(databaseFilePath, FilePath());
+	storage.buildCaches();
+
+	size_t chunkCount = 0;
+	std::vector<std::wstring> locations;
+	std::set<Id> locationIds;
+	const auto onLocations = [&](std::shared_ptr<SourceLocationCollection> collection) {
+		chunkCount++;
+		collection->forEachSourceLocation([&](SourceLocation* location) {
+			if (location->isStartLocation())
+			{
+				locations.push_back(
+					location->getFilePath().wstr() + L" " +
+					std::to_wstring(location->getLineNumber()) + L":" +
+					std::to_wstring(location->getColumnNumber()));
+				locationIds.insert(location->getLocationId());
+			}
+		});
+		return true;
+	};
+
+	FullTextSearchCursor cursor;
+	REQUIRE(!storage.getFullTextSearchLocations(L"searchterm", false, 1000, onLocations, &cursor));
+	REQUIRE(chunkCount > 1);
+	REQUIRE(locations.size() == termCount);
+	REQUIRE(locationIds.size() == termCount);
+	const std::set<std::wstring> allLocations(locations.begin(), locations.end());
+	REQUIRE(allLocations.size() == termCount);
+
+	// a search stopped after its maximum location count continues with the remaining locations
+	locations.clear();
+	locationIds.clear();
+	REQUIRE(storage.getFullTextSearchLocations(L"searchTerm", true, 50, onLocations, &cursor));
+	REQUIRE(locations.size() == 50);
+	REQUIRE(storage.continueFullTextSearch(&cursor, 50, onLocations));
+	REQUIRE(locations.size() == 100);
+	REQUIRE(!storage.continueFullTextSearch(&cursor, 50, onLocations));
+	REQUIRE(locations.size() == termCount);
+	REQUIRE(locationIds.size() == termCount);
+	REQUIRE(std::set<std::wstring>(locations.begin(), locations.end()) == allLocations);
+
+	// a search stops as soon as the locations are not wanted anymore
+	chunkCount = 0;
+	REQUIRE(!storage.getFullTextSearchLocations(
+		L"searchTerm",
+		true,
+		1000,
+		[&chunkCount](std::shared_ptr<SourceLocationCollection> collection) {
+			chunkCount++;
+			return false;
+		},
+		&cursor));
+	REQUIRE(chunkCount == 1);
+	REQUIRE(!storage.continueFullTextSearch(&cursor, 1000, onLocations));
+	REQUIRE(chunkCount == 1);
+
+	FileSystem::remove(databaseFilePath);
+	FileSystem::remove(PersistentStorage::getFullTextSearchIndexFilePath(databaseFilePath));
+	for (const FilePath& filePath: filePaths)
+	{
+		FileSystem::remove(filePath);
+	}
+	FileSystem::remove(directoryPath);
+}
@@ -0,0 +1,56 @@
+#include "catch.hpp"
+
+#include <atomic>
+#include <vector>
+
+#include "ThreadPool.h"
+
+TEST_CASE("thread pool parallel for calls function once for every index")
+{
+	ThreadPool threadPool(3);
+
+	std::vector<std::atomic<int>> callCounts(1000);
+	for (std::atomic<int>& callCount: callCounts)
+	{
+		callCount = 0;
+	}
+
+	threadPool.parallelFor(callCounts.size(), [&callCounts](size_t index) { callCounts[index]++; });
+
+	for (const std::atomic<int>& callCount: callCounts)
+	{
+		REQUIRE(callCount == 1);
+	}
+}
+
+TEST_CASE("thread pool parallel for returns for zero count")
+{
+	ThreadPool threadPool(2);
+
+	bool called = false;
+	threadPool.parallelFor(0, [&called](size_t) { called = true; });
+
+	REQUIRE(!called);
+}
+
+TEST_CASE("thread pool parallel for can be nested")
+{
+	ThreadPool threadPool(2);
+
+	std::atomic<int> callCount(0);
+	threadPool.parallelFor(8, [&threadPool, &callCount](size_t) {
+		threadPool.parallelFor(8, [&callCount](size_t) { callCount++; });
+	});
+
+	REQUIRE(callCount == 64);
+}
+
+TEST_CASE("thread pool without threads runs parallel for on calling thread")
+{
+	ThreadPool threadPool(0);
+
+	int callCount = 0;
+	threadPool.parallelFor(10, [&callCount](size_t) { callCount++; });
+
+	REQUIRE(callCount == 10);
+}
@@ -379,3 +379,12 @@ TEST_CASE(
 {
 	REQUIRE_FALSE(utility::caseInsensitiveLess(L"ab_cD!E", L"aB_cd!"));
 }
+
+TEST_CASE("getUtf8ByteSize returns the size of the encoded string")
+{
+	for (const std::wstring& str:
+		 std::vector<std::wstring>({L"", L"abc", L"äbc", L"€ 5", L"a\U0001F600b"}))
+	{
+		REQUIRE(utility::getUtf8ByteSize(str) == utility::encodeToUtf8(str).size());
+	}
+}
@@ -0,0 +1,53 @@
+#ifndef TEST_INDEXER_H
+#define TEST_INDEXER_H
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "Indexer.h"
+#include "LanguagePackage.h"
+
+// Indexer that records its translation units with a function instead of a parser, so tests get
+// their storages finalized and chunked exactly like the ones of the real indexers.
+template <typename T>
+class TestIndexer: public Indexer<T>
+{
+public:
+	typedef std::function<void(std::shared_ptr<T>, ParserClientImpl*, IndexerStateInfo*)>
+		RecordFunction;
+
+	TestIndexer(RecordFunction recordFunction): m_recordFunction(recordFunction) {}
+
+private:
+	void doIndex(
+		std::shared_ptr<T> indexerCommand,
+		std::shared_ptr<ParserClientImpl> parserClient,
+		std::shared_ptr<IndexerStateInfo> indexerStateInfo) override
+	{
+		m_recordFunction(indexerCommand, parserClient.get(), indexerStateInfo.get());
+	}
+
+	RecordFunction m_recordFunction;
+};
+
+// hands out test indexers to the indexer threads and processes started by the indexing tasks
+template <typename T>
+class TestLanguagePackage: public LanguagePackage
+{
+public:
+	TestLanguagePackage(typename TestIndexer<T>::RecordFunction recordFunction)
+		: m_recordFunction(recordFunction)
+	{
+	}
+
+	std::vector<std::shared_ptr<IndexerBase>> instantiateSupportedIndexers() const override
+	{
+		return {std::make_shared<TestIndexer<T>>(m_recordFunction)};
+	}
+
+private:
+	typename TestIndexer<T>::RecordFunction m_recordFunction;
+};
+
+#endif	  // TEST_INDEXER_H
@@ -0,0 +1,95 @@
+#ifndef TEST_SOURCE_GROUP_H
+#define TEST_SOURCE_GROUP_H
+
+#include <set>
+
+#include "ProjectSettings.h"
+#include "SourceGroup.h"
+#include "SourceGroupSettings.h"
+
+class SourceGroupSettingsTest: public SourceGroupSettings
+{
+public:
+	SourceGroupSettingsTest(const ProjectSettings* projectSettings)
+		: SourceGroupSettings(SOURCE_GROUP_UNKNOWN, "TEST_ID", projectSettings)
+	{
+	}
+
+	std::shared_ptr<SourceGroupSettings> createCopy() const override
+	{
+		return nullptr;
+	}
+
+	void loadSettings(const ConfigManager* config) override {}
+
+	void saveSettings(ConfigManager* config) override {}
+
+	bool equalsSettings(const SourceGroupSettingsBase* other) override
+	{
+		return true;
+	}
+};
+
+class SourceGroupTest: public SourceGroup
+{
+public:
+	SourceGroupTest(std::set<FilePath> sourceFilePaths)
+		: m_sourceFilePaths(sourceFilePaths), m_allFilePaths(sourceFilePaths)
+	{
+		m_sourceGroupSettings = std::make_shared<SourceGroupSettingsTest>(&m_projectSettings);
+	}
+
+	SourceGroupTest(std::set<FilePath> sourceFilePaths, std::set<FilePath> allFilePaths)
+		: m_sourceFilePaths(sourceFilePaths), m_allFilePaths(allFilePaths)
+	{
+		m_sourceGroupSettings = std::make_shared<SourceGroupSettingsTest>(&m_projectSettings);
+	}
+
+	std::set<FilePath> filterToContainedFilePaths(const std::set<FilePath>& filePaths) const override
+	{
+		std::set<FilePath> containedFilePaths;
+
+		for (const FilePath& filePath: filePaths)
+		{
+			if (m_allFilePaths.find(filePath) != m_allFilePaths.end())
+			{
+				containedFilePaths.insert(filePath);
+			}
+		}
+
+		return containedFilePaths;
+	}
+
+	std::set<FilePath> getAllSourceFilePaths() const override
+	{
+		return m_sourceFilePaths;
+	}
+
+	std::vector<std::shared_ptr<IndexerCommand>> getIndexerCommands(const RefreshInfo& info) const override
+	{
+		return std::vector<std::shared_ptr<IndexerCommand>>();
+	}
+
+	void setStatus(SourceGroupStatusType status)
+	{
+		m_sourceGroupSettings->setStatus(status);
+	}
+
+private:
+	std::shared_ptr<SourceGroupSettings> getSourceGroupSettings() override
+	{
+		return m_sourceGroupSettings;
+	}
+
+	std::shared_ptr<const SourceGroupSettings> getSourceGroupSettings() const override
+	{
+		return m_sourceGroupSettings;
+	}
+
+	ProjectSettings m_projectSettings;
+	std::shared_ptr<SourceGroupSettingsTest> m_sourceGroupSettings;
+	const std::set<FilePath> m_sourceFilePaths;
+	const std::set<FilePath> m_allFilePaths;
+};
+
+#endif	  // TEST_SOURCE_GROUP_H